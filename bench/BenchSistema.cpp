@@ -0,0 +1,497 @@
+/**
+ * @file BenchSistema.cpp
+ * @brief Banco de pruebas de rendimiento (micro y macro) con salida JSON
+ * @details Mide ListaSensor<T> (insertar, buscar, calcularPromedio, eliminarMenor) con
+ * tamaños de 10 a 10^7, el registro de SistemaGestion (agregarSensor, buscarSensor) con
+ * 10^5 sensores, ciclos completos de procesarTodosSensores y procesarPorTipo y la rueda de
+ * PlanificadorSensores (programar, avanzar un tick, cancelar) con 10^5 sensores de
+ * periodos mezclados. Los datos
+ * se generan con una semilla fija, así que dos ejecuciones miden exactamente el mismo
+ * trabajo.
+ *
+ * Uso: sistema_iot_bench [--salida archivo.json] [--max-tamanio n] [--semilla s]
+ *
+ * Cada medida agrupa las operaciones en lotes cronometrados: la latencia de una muestra
+ * es el tiempo del lote dividido entre sus operaciones, y p50/p99 se calculan sobre
+ * esas muestras. Son percentiles de promedios por lote, no de operaciones sueltas (un
+ * pico aislado se diluye en su lote), de ahí las claves "p50_lote_ns" y "p99_lote_ns".
+ */
+
+#include "ListaSensor.h"
+#include "SistemaGestion.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "KernelsLectura.h"
+#include "PlanificadorSensores.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Flujo que descarta todo: la salida de consola no debe medirse
+ */
+class FlujoNulo : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+/**
+ * @brief Resultado de una medida
+ */
+struct Resultado {
+    std::string nombre;     ///< Operación medida
+    long long tamanio;      ///< Tamaño del historial o del registro
+    long long operaciones;  ///< Operaciones cronometradas
+    double segundos;        ///< Tiempo total cronometrado
+    double p50LoteNs;       ///< Mediana de la latencia media por operación de cada lote
+    double p99LoteNs;       ///< Percentil 99 de la latencia media por operación de cada lote
+};
+
+/**
+ * @brief Nanosegundos de un reloj monótono
+ */
+long long ahoraNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Acumula las muestras (lotes cronometrados) de una medida
+ */
+class Medidor {
+private:
+    std::vector<double> latencias;  ///< ns por operación de cada lote
+    long long operaciones;
+    long long totalNs;
+
+public:
+    Medidor() : operaciones(0), totalNs(0) {}
+
+    /**
+     * @brief Registra un lote
+     * @param ns Duración del lote
+     * @param ops Operaciones del lote
+     */
+    void muestra(long long ns, long long ops) {
+        if (ops <= 0) return;
+        latencias.push_back(static_cast<double>(ns) / static_cast<double>(ops));
+        operaciones += ops;
+        totalNs += ns;
+    }
+
+    Resultado resultado(const std::string& nombre, long long tamanio) {
+        Resultado r;
+        r.nombre = nombre;
+        r.tamanio = tamanio;
+        r.operaciones = operaciones;
+        r.segundos = static_cast<double>(totalNs) * 1e-9;
+        std::sort(latencias.begin(), latencias.end());
+        r.p50LoteNs = percentil(0.50);
+        r.p99LoteNs = percentil(0.99);
+        return r;
+    }
+
+private:
+    double percentil(double p) const {
+        if (latencias.empty()) return 0.0;
+        std::size_t i = static_cast<std::size_t>(p * static_cast<double>(latencias.size() - 1) + 0.5);
+        return latencias[i];
+    }
+};
+
+/**
+ * @brief Valores de lectura reproducibles
+ */
+template <typename T>
+struct GeneradorLecturas;
+
+template <>
+struct GeneradorLecturas<float> {
+    std::uniform_int_distribution<int> distribucion;
+    GeneradorLecturas() : distribucion(-4000, 6000) {}
+    float operator()(std::mt19937& rng) { return static_cast<float>(distribucion(rng)) / 100.0f; }
+    static const char* tipo() { return "float"; }
+};
+
+template <>
+struct GeneradorLecturas<int> {
+    std::uniform_int_distribution<int> distribucion;
+    GeneradorLecturas() : distribucion(900, 1100) {}
+    int operator()(std::mt19937& rng) { return distribucion(rng); }
+    static const char* tipo() { return "int"; }
+};
+
+/**
+ * @brief Configuración de la ejecución
+ */
+struct Configuracion {
+    long long maxTamanio;
+    unsigned semilla;
+    const char* salida;
+};
+
+template <typename T>
+std::string nombreOperacion(const char* operacion) {
+    return std::string("ListaSensor<") + GeneradorLecturas<T>::tipo() + ">::" + operacion;
+}
+
+template <typename T>
+void llenar(ListaSensor<T, TAM_BLOQUE_LECTURAS>& lista, long long n, std::mt19937& rng) {
+    GeneradorLecturas<T> generar;
+    for (long long i = 0; i < n; i++) {
+        lista.insertar(generar(rng));
+    }
+}
+
+long long acotar(long long valor, long long minimo, long long maximo) {
+    return valor < minimo ? minimo : (valor > maximo ? maximo : valor);
+}
+
+// ======================== Microbenchmarks de ListaSensor ========================
+
+template <typename T>
+void medirLista(long long n, const Configuracion& cfg, std::vector<Resultado>& resultados) {
+    typedef ListaSensor<T, TAM_BLOQUE_LECTURAS> Lista;
+    std::mt19937 rng(cfg.semilla);
+    GeneradorLecturas<T> generar;
+
+    // insertar: cada lote construye un historial de n lecturas desde cero
+    {
+        Medidor m;
+        long long lotes = acotar(10000000LL / n, 5, 1000);
+        for (long long l = 0; l < lotes; l++) {
+            Lista* lista = new Lista();
+            std::vector<T> valores(static_cast<std::size_t>(n));
+            for (long long i = 0; i < n; i++) valores[static_cast<std::size_t>(i)] = generar(rng);
+
+            long long t0 = ahoraNs();
+            for (long long i = 0; i < n; i++) lista->insertar(valores[static_cast<std::size_t>(i)]);
+            m.muestra(ahoraNs() - t0, n);
+            delete lista;
+        }
+        resultados.push_back(m.resultado(nombreOperacion<T>("insertar"), n));
+    }
+
+    Lista lista;
+    llenar(lista, n, rng);
+
+    // buscar: mitad de valores presentes, mitad ausentes (recorrido completo)
+    {
+        Medidor m;
+        long long consultas = acotar(1000000LL / n, 1, 10000);
+        long long lotes = acotar(200000000LL / (n * consultas), 10, 200);
+        volatile bool sumidero = false;
+        for (long long l = 0; l < lotes; l++) {
+            T objetivo = (l % 2 == 0) ? generar(rng) : static_cast<T>(-1000000);
+            long long t0 = ahoraNs();
+            for (long long q = 0; q < consultas; q++) sumidero = lista.buscar(objetivo);
+            m.muestra(ahoraNs() - t0, consultas);
+        }
+        (void)sumidero;
+        resultados.push_back(m.resultado(nombreOperacion<T>("buscar"), n));
+    }
+
+    // calcularPromedio: O(1) sobre los agregados incrementales
+    {
+        Medidor m;
+        volatile T sumidero = T();
+        for (int l = 0; l < 100; l++) {
+            long long t0 = ahoraNs();
+            for (int q = 0; q < 10000; q++) sumidero = lista.calcularPromedio();
+            m.muestra(ahoraNs() - t0, 10000);
+        }
+        (void)sumidero;
+        resultados.push_back(m.resultado(nombreOperacion<T>("calcularPromedio"), n));
+    }
+
+    // eliminarMenor: recorrido lineal y con índice de extremos
+    for (int conIndice = 0; conIndice < 2; conIndice++) {
+        Medidor m;
+        long long porLote = conIndice ? acotar(n / 2, 1, 100000) : acotar(2000000LL / n, 1, n / 2 > 0 ? n / 2 : 1);
+        long long lotes = acotar(2000000LL / n, 3, 200);
+        for (long long l = 0; l < lotes; l++) {
+            Lista copia;
+            llenar(copia, n, rng);
+            if (conIndice) copia.activarIndice();
+
+            long long t0 = ahoraNs();
+            for (long long q = 0; q < porLote; q++) copia.eliminarMenor();
+            m.muestra(ahoraNs() - t0, porLote);
+        }
+        resultados.push_back(m.resultado(nombreOperacion<T>(conIndice ? "eliminarMenor[indice]" : "eliminarMenor"), n));
+    }
+}
+
+// ======================== Registro de sensores ========================
+
+void nombreSensor(char* destino, const char* prefijo, long long i) {
+    snprintf(destino, 50, "%s-%06lld", prefijo, i);
+}
+
+void medirRegistro(long long sensores, const Configuracion& cfg, std::vector<Resultado>& resultados) {
+    const long long porLote = 1000;
+    char nombre[50];
+
+    // agregarSensor: sensores construidos fuera del cronómetro
+    Medidor mAgregar;
+    for (int repeticion = 0; repeticion < 3; repeticion++) {
+        SistemaGestion sistema;
+        std::vector<SensorBase*> nuevos;
+        nuevos.reserve(static_cast<std::size_t>(sensores));
+        for (long long i = 0; i < sensores; i++) {
+            nombreSensor(nombre, "T", i);
+            nuevos.push_back(new SensorTemperatura(nombre, sistema.obtenerArena()));
+        }
+        for (long long i = 0; i < sensores; i += porLote) {
+            long long fin = std::min(sensores, i + porLote);
+            long long t0 = ahoraNs();
+            for (long long k = i; k < fin; k++) sistema.agregarSensor(nuevos[static_cast<std::size_t>(k)]);
+            mAgregar.muestra(ahoraNs() - t0, fin - i);
+        }
+    }
+    resultados.push_back(mAgregar.resultado("SistemaGestion::agregarSensor", sensores));
+
+    // buscarSensor: nombres aleatorios, todos registrados
+    SistemaGestion sistema;
+    for (long long i = 0; i < sensores; i++) {
+        nombreSensor(nombre, "T", i);
+        sistema.agregarSensor(new SensorTemperatura(nombre, sistema.obtenerArena()));
+    }
+    std::mt19937 rng(cfg.semilla);
+    std::uniform_int_distribution<long long> elegir(0, sensores - 1);
+    std::vector<std::string> consultas(static_cast<std::size_t>(porLote));
+
+    Medidor mBuscar;
+    volatile bool sumidero = false;
+    for (int l = 0; l < 1000; l++) {
+        for (long long k = 0; k < porLote; k++) {
+            nombreSensor(nombre, "T", elegir(rng));
+            consultas[static_cast<std::size_t>(k)] = nombre;
+        }
+        long long t0 = ahoraNs();
+        for (long long k = 0; k < porLote; k++) {
+            sumidero = sistema.buscarSensor(consultas[static_cast<std::size_t>(k)].c_str()) != nullptr;
+        }
+        mBuscar.muestra(ahoraNs() - t0, porLote);
+    }
+    (void)sumidero;
+    resultados.push_back(mBuscar.resultado("SistemaGestion::buscarSensor", sensores));
+}
+
+// ======================== Ciclo completo de procesamiento ========================
+
+void medirProcesamiento(long long sensores, long long lecturas, int hilos, const Configuracion& cfg,
+                        std::vector<Resultado>& resultados) {
+    SistemaGestion sistema;
+    sistema.fijarHilosProcesamiento(hilos);
+
+    std::mt19937 rng(cfg.semilla);
+    GeneradorLecturas<float> temperatura;
+    GeneradorLecturas<int> presion;
+    char nombre[50];
+    for (long long i = 0; i < sensores; i++) {
+        if (i % 2 == 0) {
+            nombreSensor(nombre, "T", i);
+            SensorTemperatura* sensor = new SensorTemperatura(nombre, sistema.obtenerArena());
+            for (long long k = 0; k < lecturas; k++) sensor->registrarLectura(temperatura(rng));
+            sistema.agregarSensor(sensor);
+        } else {
+            nombreSensor(nombre, "P", i);
+            SensorPresion* sensor = new SensorPresion(nombre, sistema.obtenerArena());
+            for (long long k = 0; k < lecturas; k++) sensor->registrarLectura(presion(rng));
+            sistema.agregarSensor(sensor);
+        }
+    }
+
+    // Cada ciclo procesa todos los sensores; la muestra es el tiempo por sensor
+    Medidor m;
+    for (int ciclo = 0; ciclo < 20; ciclo++) {
+        long long t0 = ahoraNs();
+        sistema.procesarTodosSensores();
+        m.muestra(ahoraNs() - t0, sensores);
+    }
+
+    char etiqueta[80];
+    snprintf(etiqueta, sizeof(etiqueta), "SistemaGestion::procesarTodosSensores[hilos=%d]",
+             sistema.obtenerHilosProcesamiento());
+    resultados.push_back(m.resultado(etiqueta, sensores));
+    // Mismo trabajo por particiones de tipo, sin llamadas virtuales (solo secuencial)
+    if (sistema.obtenerHilosProcesamiento() == 1) {
+        Medidor mTipo;
+        for (int ciclo = 0; ciclo < 20; ciclo++) {
+            long long t0 = ahoraNs();
+            sistema.procesarPorTipo(std::cout);
+            mTipo.muestra(ahoraNs() - t0, sensores);
+        }
+        resultados.push_back(mTipo.resultado("SistemaGestion::procesarPorTipo", sensores));
+    }
+}
+
+// ======================== Planificador de procesamiento ========================
+
+void medirPlanificador(long long sensores, const Configuracion& cfg, std::vector<Resultado>& resultados) {
+    // Periodos en ticks de 100 ms: 1 s, 5 s, 1 min y 5 min
+    const unsigned periodos[] = {10, 50, 600, 3000};
+    const long long porLote = 1000;
+    SistemaGestion sistema;
+    std::mt19937 rng(cfg.semilla);
+    GeneradorLecturas<float> temperatura;
+    GeneradorLecturas<int> presion;
+    char nombre[50];
+    std::vector<SensorBase*> lista;
+    lista.reserve(static_cast<std::size_t>(sensores));
+    for (long long i = 0; i < sensores; i++) {
+        if (i % 2 == 0) {
+            nombreSensor(nombre, "T", i);
+            SensorTemperatura* sensor = new SensorTemperatura(nombre, sistema.obtenerArena());
+            for (int k = 0; k < 10; k++) sensor->registrarLectura(temperatura(rng));
+            lista.push_back(sensor);
+        } else {
+            nombreSensor(nombre, "P", i);
+            SensorPresion* sensor = new SensorPresion(nombre, sistema.obtenerArena());
+            for (int k = 0; k < 10; k++) sensor->registrarLectura(presion(rng));
+            lista.push_back(sensor);
+        }
+        sistema.agregarSensor(lista.back());
+    }
+
+    PlanificadorSensores planificador;
+    std::vector<TareaPlanificada*> tareas(static_cast<std::size_t>(sensores));
+    std::vector<unsigned> periodo(static_cast<std::size_t>(sensores));
+    std::vector<unsigned> primero(static_cast<std::size_t>(sensores));
+    for (long long i = 0; i < sensores; i++) {
+        std::size_t k = static_cast<std::size_t>(i);
+        periodo[k] = periodos[rng() % 4];
+        primero[k] = 1 + static_cast<unsigned>(rng() % periodo[k]);
+    }
+
+    Medidor mProgramar;
+    for (long long i = 0; i < sensores; i += porLote) {
+        long long fin = std::min(sensores, i + porLote);
+        long long t0 = ahoraNs();
+        for (long long k = i; k < fin; k++) {
+            std::size_t j = static_cast<std::size_t>(k);
+            tareas[j] = planificador.programar(lista[j], periodo[j], primero[j]);
+        }
+        mProgramar.muestra(ahoraNs() - t0, fin - i);
+    }
+    resultados.push_back(mProgramar.resultado("PlanificadorSensores::programar", sensores));
+
+    // Cada muestra es un tick: solo se procesan los sensores que vencen en él (un minuto)
+    const int ticks = 600;
+    Medidor mAvanzar;
+    long long procesados = 0;
+    for (int tick = 0; tick < ticks; tick++) {
+        long long t0 = ahoraNs();
+        procesados += planificador.avanzar(1, std::cout);
+        mAvanzar.muestra(ahoraNs() - t0, 1);
+    }
+    char etiqueta[80];
+    snprintf(etiqueta, sizeof(etiqueta), "PlanificadorSensores::avanzar[tick,procesados=%lld]", procesados / ticks);
+    resultados.push_back(mAvanzar.resultado(etiqueta, sensores));
+
+    std::shuffle(tareas.begin(), tareas.end(), rng);
+    Medidor mCancelar;
+    for (long long i = 0; i < sensores; i += porLote) {
+        long long fin = std::min(sensores, i + porLote);
+        long long t0 = ahoraNs();
+        for (long long k = i; k < fin; k++) planificador.cancelar(tareas[static_cast<std::size_t>(k)]);
+        mCancelar.muestra(ahoraNs() - t0, fin - i);
+    }
+    resultados.push_back(mCancelar.resultado("PlanificadorSensores::cancelar", sensores));
+}
+
+// ======================== Salida JSON ========================
+
+void escribirJson(std::ostream& salida, const std::vector<Resultado>& resultados, const Configuracion& cfg) {
+    salida << "{\n";
+    salida << "  \"simd\": \"" << KernelsSimd::implementacion() << "\",\n";
+    salida << "  \"hilos_hardware\": " << std::thread::hardware_concurrency() << ",\n";
+    salida << "  \"semilla\": " << cfg.semilla << ",\n";
+    salida << "  \"resultados\": [\n";
+    for (std::size_t i = 0; i < resultados.size(); i++) {
+        const Resultado& r = resultados[i];
+        double opsPorSegundo = r.segundos > 0.0 ? static_cast<double>(r.operaciones) / r.segundos : 0.0;
+        char linea[512];
+        snprintf(linea, sizeof(linea),
+                 "    {\"nombre\": \"%s\", \"tamanio\": %lld, \"operaciones\": %lld, "
+                 "\"segundos\": %.6f, \"ops_por_segundo\": %.1f, \"p50_lote_ns\": %.1f, \"p99_lote_ns\": %.1f}%s\n",
+                 r.nombre.c_str(), r.tamanio, r.operaciones, r.segundos, opsPorSegundo,
+                 r.p50LoteNs, r.p99LoteNs, i + 1 < resultados.size() ? "," : "");
+        salida << linea;
+    }
+    salida << "  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Configuracion cfg;
+    cfg.maxTamanio = 10000000LL;
+    cfg.semilla = 12345u;
+    cfg.salida = nullptr;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--salida") == 0) {
+            cfg.salida = argv[i + 1];
+        } else if (strcmp(argv[i], "--max-tamanio") == 0) {
+            cfg.maxTamanio = atoll(argv[i + 1]);
+        } else if (strcmp(argv[i], "--semilla") == 0) {
+            cfg.semilla = static_cast<unsigned>(strtoul(argv[i + 1], nullptr, 10));
+        } else {
+            std::cerr << "Uso: " << argv[0] << " [--salida archivo.json] [--max-tamanio n] [--semilla s]\n";
+            return 1;
+        }
+    }
+
+    // Los mensajes de SistemaGestion y de los sensores no forman parte de la medida
+    FlujoNulo nulo;
+    std::streambuf* consola = std::cout.rdbuf(&nulo);
+
+    std::vector<Resultado> resultados;
+    for (long long n = 10; n <= cfg.maxTamanio; n *= 10) {
+        std::cerr << "[bench] ListaSensor, n = " << n << "\n";
+        medirLista<float>(n, cfg, resultados);
+        medirLista<int>(n, cfg, resultados);
+    }
+
+    long long sensores = std::min(100000LL, cfg.maxTamanio);
+    std::cerr << "[bench] Registro, " << sensores << " sensores\n";
+    medirRegistro(sensores, cfg, resultados);
+
+    std::cerr << "[bench] Procesamiento\n";
+    long long sensoresCiclo = std::min(10000LL, cfg.maxTamanio);
+    medirProcesamiento(sensoresCiclo, 100, 1, cfg, resultados);
+    if (std::thread::hardware_concurrency() > 1) {
+        medirProcesamiento(sensoresCiclo, 100, 0, cfg, resultados);
+    }
+
+    std::cerr << "[bench] Planificador, " << sensores << " sensores\n";
+    medirPlanificador(sensores, cfg, resultados);
+
+    std::cout.rdbuf(consola);
+
+    if (cfg.salida != nullptr) {
+        std::ofstream archivo(cfg.salida);
+        if (!archivo) {
+            std::cerr << "[Error] No se pudo escribir '" << cfg.salida << "'\n";
+            return 1;
+        }
+        escribirJson(archivo, resultados, cfg);
+    } else {
+        escribirJson(std::cout, resultados, cfg);
+    }
+    return 0;
+}
@@ -1,48 +1,90 @@
 /**
  * @file sensor_simulator.ino
  * @brief Simulador de sensores IoT para ESP32
- * @details Envía lecturas simuladas de temperatura (float) y presión (int) por serial
+ * @details Envía lecturas simuladas de temperatura (float) y presión (int) por serial,
+ * en tramas binarias por lotes o, como respaldo, en líneas de texto
  * @platform ESP32
- * 
+ *
  * INSTRUCCIONES:
  * 1. Abrir en Arduino IDE o PlatformIO
  * 2. Seleccionar placa ESP32 Dev Module
  * 3. Configurar puerto serial a 115200 baudios
  * 4. Cargar el sketch al ESP32
- * 5. Abrir monitor serial para verificar transmisión
+ * 5. Abrir monitor serial para verificar transmisión (con PROTOCOLO_BINARIO 0 para
+ *    leer las lecturas como texto)
+ * 6. En el host: sistema_iot --ingesta /dev/ttyUSB0 --protocolo binario
  */
 
 // ========== CONFIGURACIÓN ==========
 #define BAUD_RATE 115200
-#define INTERVALO_ENVIO 3000  // Milisegundos entre envíos
+#define INTERVALO_ENVIO 3000    // Texto: ms entre envíos; binario: espera máxima de un lote incompleto
 #define TEMP_MIN 20.0
 #define TEMP_MAX 50.0
 #define PRESION_MIN 70
 #define PRESION_MAX 100
 
+#define PROTOCOLO_BINARIO 1     // 1 = tramas binarias por lotes; 0 = texto "TIPO|ID|VALOR"
+#define INTERVALO_MUESTREO 100  // Solo binario: ms entre lecturas de cada sensor (el texto
+                                // mantiene sus 3 lecturas cada INTERVALO_ENVIO)
+#define LECTURAS_POR_TRAMA 16   // Lecturas por trama (1..64)
+
+// ========== PROTOCOLO BINARIO ==========
+// 0xA5 0x5A | versión | tipo | id (u16) | n | n valores (i16) | CRC-32C (u32), little-endian
+#define SINCRONIA_0 0xA5
+#define SINCRONIA_1 0x5A
+#define VERSION_TRAMA 1
+#define CABECERA_TRAMA 7
+#define TIPO_TEMPERATURA 0      // Valores en centésimas de grado
+#define TIPO_PRESION 1
+
+/**
+ * @brief Lecturas de un sensor pendientes de enviar
+ */
+struct LoteSensor {
+  uint8_t tipo;                          // TIPO_TEMPERATURA o TIPO_PRESION
+  uint16_t id;                           // Id numérico (T-001 -> 1, P-105 -> 105)
+  int16_t valores[LECTURAS_POR_TRAMA];   // Lecturas acumuladas
+  uint8_t cantidad;                      // Lecturas en el lote
+};
+
 // ========== VARIABLES GLOBALES ==========
+unsigned long ultimaMuestra = 0;
 unsigned long ultimoEnvio = 0;
+unsigned long contadorTramas = 0;
 int contadorEnvios = 0;
 
+LoteSensor temperatura = {TIPO_TEMPERATURA, 1, {0}, 0};
+LoteSensor presion = {TIPO_PRESION, 105, {0}, 0};
+
+/// CRC-32C (Castagnoli) por nibbles: 64 bytes de tabla en lugar de 1 KB
+const uint32_t TABLA_CRC32C[16] = {
+  0x00000000, 0x105EC76F, 0x20BD8EDE, 0x30E349B1, 0x417B1DBC, 0x5125DAD3, 0x61C69362, 0x7198540D,
+  0x82F63B78, 0x92A8FC17, 0xA24BB5A6, 0xB21572C9, 0xC38D26C4, 0xD3D3E1AB, 0xE330A81A, 0xF36E6F75
+};
+
 /**
  * @brief Configuración inicial del ESP32
  */
 void setup() {
   // Inicializar comunicación serial
   Serial.begin(BAUD_RATE);
-  
+
   // Esperar a que el puerto serial esté listo
   delay(1000);
-  
+
   // Inicializar generador de números aleatorios
   randomSeed(analogRead(0));
-  
-  // Mensaje de inicio
+
+  // Mensaje de inicio (el host ignora las líneas que no son lecturas)
   Serial.println("\n========================================");
   Serial.println("  ESP32 - Simulador de Sensores IoT");
   Serial.println("========================================");
+#if PROTOCOLO_BINARIO
+  Serial.println("Enviando tramas binarias por lotes...\n");
+#else
   Serial.println("Enviando lecturas cada 3 segundos...\n");
-  
+#endif
+
   delay(500);
 }
 
@@ -89,59 +131,158 @@ void enviarLectura(String tipo, String id, int valor) {
 }
 
 /**
- * @brief Loop principal que simula envío periódico de lecturas
+ * @brief Calcula el CRC-32C de un bloque (el mismo que calcularCrc32c en el host)
+ */
+uint32_t calcularCrc32c(const uint8_t* datos, size_t longitud) {
+  uint32_t crc = 0xFFFFFFFF;
+  while (longitud--) {
+    crc ^= *datos++;
+    crc = (crc >> 4) ^ TABLA_CRC32C[crc & 0x0F];
+    crc = (crc >> 4) ^ TABLA_CRC32C[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+/**
+ * @brief Envía las lecturas acumuladas de un sensor en una trama y vacía el lote
+ * @param lote Sensor con lecturas pendientes (no envía nada si no hay)
+ */
+void enviarTrama(LoteSensor& lote) {
+  if (lote.cantidad == 0) return;
+
+  uint8_t trama[CABECERA_TRAMA + 2 * LECTURAS_POR_TRAMA + 4];
+  size_t n = 0;
+  trama[n++] = SINCRONIA_0;
+  trama[n++] = SINCRONIA_1;
+  trama[n++] = VERSION_TRAMA;
+  trama[n++] = lote.tipo;
+  trama[n++] = lote.id & 0xFF;
+  trama[n++] = lote.id >> 8;
+  trama[n++] = lote.cantidad;
+  for (uint8_t i = 0; i < lote.cantidad; i++) {
+    uint16_t valor = (uint16_t)lote.valores[i];
+    trama[n++] = valor & 0xFF;
+    trama[n++] = valor >> 8;
+  }
+  // El CRC cubre desde la versión hasta el último valor
+  uint32_t crc = calcularCrc32c(trama + 2, n - 2);
+  trama[n++] = crc & 0xFF;
+  trama[n++] = (crc >> 8) & 0xFF;
+  trama[n++] = (crc >> 16) & 0xFF;
+  trama[n++] = crc >> 24;
+
+  Serial.write(trama, n);
+  lote.cantidad = 0;
+  contadorTramas++;
+}
+
+/**
+ * @brief Acumula una lectura en el lote de su sensor y envía la trama al llenarse
+ * @param lote Sensor de la lectura
+ * @param valor Presión, o temperatura en centésimas de grado
+ */
+void registrarLectura(LoteSensor& lote, int16_t valor) {
+  lote.valores[lote.cantidad++] = valor;
+  if (lote.cantidad == LECTURAS_POR_TRAMA) {
+    enviarTrama(lote);
+  }
+}
+
+/**
+ * @brief Loop principal que simula el muestreo periódico de los sensores
  */
 void loop() {
   unsigned long tiempoActual = millis();
-  
+
+#if PROTOCOLO_BINARIO
+  // ========== MUESTREO ==========
+  if (tiempoActual - ultimaMuestra >= INTERVALO_MUESTREO) {
+    ultimaMuestra = tiempoActual;
+
+    // Temperatura en centésimas: la misma precisión que el texto con 2 decimales
+    float temp = generarTemperatura();
+    registrarLectura(temperatura, (int16_t)(temp * 100.0f + (temp >= 0 ? 0.5f : -0.5f)));
+    registrarLectura(presion, (int16_t)generarPresion());
+  }
+
+  // ========== ENVÍO DE LOTES INCOMPLETOS ==========
+  if (tiempoActual - ultimoEnvio >= INTERVALO_ENVIO) {
+    ultimoEnvio = tiempoActual;
+    enviarTrama(temperatura);
+    enviarTrama(presion);
+
+    // LED de actividad (si está disponible en el ESP32)
+
+    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+  }
+#else
   // Verificar si es momento de enviar nuevas lecturas
   if (tiempoActual - ultimoEnvio >= INTERVALO_ENVIO) {
     ultimoEnvio = tiempoActual;
     contadorEnvios++;
-    
+
     // ========== ENVÍO DE DATOS ==========
     Serial.println("\n--- Envío #" + String(contadorEnvios) + " ---");
-    
+
     // Simular lectura de Sensor de Temperatura T-001
     float temp1 = generarTemperatura();
     enviarLectura("TEMP", "T-001", temp1);
     Serial.print("[ESP32] Enviado: TEMP|T-001|");
     Serial.println(temp1, 2);
-    
+
     delay(100);  // Pequeña pausa entre lecturas
-    
+
     // Simular lectura de Sensor de Presión P-105
     int pres1 = generarPresion();
     enviarLectura("PRES", "P-105", pres1);
     Serial.print("[ESP32] Enviado: PRES|P-105|");
     Serial.println(pres1);
-    
+
     delay(100);
-    
+
     // Opcional: Enviar una segunda temperatura
     float temp2 = generarTemperatura();
     enviarLectura("TEMP", "T-001", temp2);
     Serial.print("[ESP32] Enviado: TEMP|T-001|");
     Serial.println(temp2, 2);
-    
+
     Serial.println("--- Fin Envío ---");
-    
+
     // LED de actividad (si está disponible en el ESP32)
-    
+
     digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
   }
-  
+#endif
+
   // Mantener el ESP32 activo
   delay(10);
 }
 
 /**
  * FORMATO DE SALIDA ESPERADO:
- * 
+ *
+ * Con PROTOCOLO_BINARIO 1, cada sensor se muestrea cada INTERVALO_MUESTREO ms y se
+ * envía una trama por lote de LECTURAS_POR_TRAMA lecturas (o menos, si pasa INTERVALO_ENVIO):
+ *
+ * A5 5A 01 00 01 00 10 B2 11 ... xx xx xx xx
+ * |     |  |  |     |  |          CRC-32C
+ * |     |  |  |     |  16 valores int16 (45.30 °C -> 4530 = 0x11B2)
+ * |     |  |  |     n = 16
+ * |     |  |  id = 1 (T-001)
+ * |     |  tipo = 0 (temperatura)
+ * |     versión
+ * sincronía
+ *
+ * Con 16 lecturas son 43 bytes, ~2,7 bytes por lectura frente a los 14-17 de una
+ * línea de texto: el enlace a 115200 baudios transporta varias veces más lecturas.
+ *
+ * Con PROTOCOLO_BINARIO 0 (respaldo), como siempre: tres lecturas cada INTERVALO_ENVIO,
+ * cada una seguida de su eco "[ESP32] Enviado: ..." (el host ignora ecos y cabeceras):
+ *
  * TEMP|T-001|45.30
  * PRES|P-105|82
  * TEMP|T-001|42.10
- * 
+ *
  * Este formato permite al sistema C++ parsear las lecturas:
  * - TEMP/PRES: Tipo de sensor
  * - T-001/P-105: ID del sensor
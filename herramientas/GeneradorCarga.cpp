@@ -0,0 +1,503 @@
+/**
+ * @file GeneradorCarga.cpp
+ * @brief Generador de carga y reproductor de trazas para la ingesta
+ * @details Emula N dispositivos como el simulador ESP32 (un sensor de temperatura y uno
+ * de presión cada uno, con las mismas distribuciones que generarTemperatura() y
+ * generarPresion()) y escribe sus lecturas a un archivo, una tubería, una pty o
+ * conexiones TCP locales (ServidorIngesta), a una tasa fija o tan rápido como se pueda.
+ * También graba un flujo real con marcas de tiempo y lo reproduce acelerado.
+ *
+ * Uso:
+ *   sistema_iot_carga [--dispositivos n] [--tasa lecturas/s] [--lecturas n | --duracion s]
+ *                     [--protocolo texto|binario] [--lote n] [--semilla s] [destino]
+ *   sistema_iot_carga --reproducir traza [--velocidad x] [--tasa lecturas/s] [destino]
+ *   sistema_iot_carga --grabar fuente [--salida traza]
+ *
+ * destino: --salida ruta ("-" = stdout, "pty" = crea una pty e indica su esclava)
+ *          o --tcp puerto [--conexiones n]
+ *
+ * Una traza tiene una línea por lectura, "<ms> TIPO|ID|VALOR"; las líneas sin marca
+ * (p. ej. una captura del puerto serie) se reproducen sin esperas o a --tasa.
+ */
+
+#include "ProtocoloBinario.h"
+#include "IngestaLecturas.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <netinet/in.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Reloj;
+
+/**
+ * @brief Configuración de la ejecución
+ */
+struct Configuracion {
+    long long dispositivos;  ///< Dispositivos emulados (2 sensores cada uno)
+    double tasa;             ///< Lecturas por segundo (0 = sin límite)
+    long long lecturas;      ///< Lecturas a emitir (0 = hasta duracion)
+    double duracion;         ///< Segundos de emisión (0 = hasta lecturas)
+    bool binario;            ///< Tramas binarias en lugar de texto
+    int lote;                ///< Lecturas por trama binaria
+    unsigned semilla;        ///< Semilla de los valores
+    const char* salida;      ///< Ruta, "-" o "pty"
+    int puertoTcp;           ///< Puerto de ServidorIngesta (-1 = usar salida)
+    int conexiones;          ///< Conexiones TCP
+    const char* reproducir;  ///< Traza a reproducir (nullptr = generar)
+    double velocidad;        ///< Factor de aceleración de la traza (0 = sin esperas)
+    const char* grabar;      ///< Fuente a grabar como traza (nullptr = no grabar)
+};
+
+/**
+ * @class Salida
+ * @brief Uno o varios descriptores de destino con un búfer de escritura cada uno
+ */
+class Salida {
+private:
+    static const std::size_t UMBRAL_TOTAL = 64 * 1024;  ///< Bytes en búfer entre todos los destinos
+
+    std::vector<int> descriptores;
+    std::vector<std::string> buferes;
+    std::size_t umbral;   ///< Bytes en búfer por destino antes de escribir
+    long long bytes;      ///< Bytes escritos
+    bool fallida;         ///< Un destino dejó de aceptar datos
+    bool esPty;           ///< El destino es el maestro de una pty
+
+    bool escribirTodo(int descriptor, const char* datos, std::size_t longitud) {
+        while (longitud > 0) {
+            ssize_t n = write(descriptor, datos, longitud);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "[carga] Escritura fallida: " << strerror(errno) << "\n";
+                return false;
+            }
+            datos += n;
+            longitud -= static_cast<std::size_t>(n);
+            bytes += n;
+        }
+        return true;
+    }
+
+public:
+    Salida() : umbral(UMBRAL_TOTAL), bytes(0), fallida(false), esPty(false) {}
+
+    ~Salida() {
+        vaciar();
+        if (esPty) {
+            // Dar tiempo al lector a vaciar la pty: al cerrar el maestro se descarta lo pendiente
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+        for (std::size_t i = 0; i < descriptores.size(); i++) {
+            if (descriptores[i] != STDOUT_FILENO) close(descriptores[i]);
+        }
+    }
+
+    Salida(const Salida&) = delete;
+    Salida& operator=(const Salida&) = delete;
+
+    bool abrir(const Configuracion& cfg) {
+        if (cfg.puertoTcp >= 0) {
+            sockaddr_in direccion;
+            memset(&direccion, 0, sizeof(direccion));
+            direccion.sin_family = AF_INET;
+            direccion.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            direccion.sin_port = htons(static_cast<uint16_t>(cfg.puertoTcp));
+            for (int i = 0; i < cfg.conexiones; i++) {
+                int s = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                if (s < 0 || connect(s, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) != 0) {
+                    std::cerr << "[carga] No se pudo conectar a 127.0.0.1:" << cfg.puertoTcp << ": "
+                              << strerror(errno) << "\n";
+                    if (s >= 0) close(s);
+                    return false;
+                }
+                descriptores.push_back(s);
+            }
+        } else if (strcmp(cfg.salida, "-") == 0) {
+            descriptores.push_back(STDOUT_FILENO);
+        } else if (strcmp(cfg.salida, "pty") == 0) {
+            int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+            if (maestro < 0 || grantpt(maestro) != 0 || unlockpt(maestro) != 0) {
+                std::cerr << "[carga] No se pudo crear la pty: " << strerror(errno) << "\n";
+                if (maestro >= 0) close(maestro);
+                return false;
+            }
+            // Modo crudo desde el principio: sin eco ni traducción de '\n'
+            termios opciones;
+            if (tcgetattr(maestro, &opciones) == 0) {
+                cfmakeraw(&opciones);
+                tcsetattr(maestro, TCSANOW, &opciones);
+            }
+            std::cerr << "[carga] pty: " << ptsname(maestro) << "\n";
+            descriptores.push_back(maestro);
+            esPty = true;
+        } else {
+            int d = open(cfg.salida, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (d < 0) {
+                std::cerr << "[carga] No se pudo abrir '" << cfg.salida << "': " << strerror(errno) << "\n";
+                return false;
+            }
+            descriptores.push_back(d);
+        }
+
+        buferes.resize(descriptores.size());
+        umbral = UMBRAL_TOTAL / descriptores.size();
+        if (umbral < 1024) umbral = 1024;
+        for (std::size_t i = 0; i < buferes.size(); i++) {
+            buferes[i].reserve(umbral + TAM_MAX_TRAMA + 64);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Búfer del destino de un dispositivo (siempre el mismo, para conservar el orden)
+     */
+    std::string& bufer(std::size_t dispositivo) {
+        return buferes[dispositivo % buferes.size()];
+    }
+
+    /**
+     * @brief Escribe el búfer del destino de un dispositivo si superó el umbral
+     */
+    void revisar(std::size_t dispositivo) {
+        std::size_t i = dispositivo % buferes.size();
+        if (buferes[i].size() >= umbral) vaciarUno(i);
+    }
+
+    void vaciarUno(std::size_t i) {
+        if (!fallida && !buferes[i].empty() && !escribirTodo(descriptores[i], buferes[i].data(), buferes[i].size())) {
+            fallida = true;
+        }
+        buferes[i].clear();
+    }
+
+    void vaciar() {
+        for (std::size_t i = 0; i < buferes.size(); i++) {
+            vaciarUno(i);
+        }
+    }
+
+    bool haFallado() const { return fallida; }
+    long long obtenerBytes() const { return bytes; }
+};
+
+const std::size_t Salida::UMBRAL_TOTAL;
+
+void anadirEntero(std::string& destino, int valor) {
+    char digitos[12];
+    int n = 0;
+    bool negativo = valor < 0;
+    unsigned v = negativo ? 0u - static_cast<unsigned>(valor) : static_cast<unsigned>(valor);
+    do {
+        digitos[n++] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (negativo) destino += '-';
+    while (n > 0) {
+        destino += digitos[--n];
+    }
+}
+
+/**
+ * @brief Espera hasta que emitir la lectura número emitidas no supere la tasa
+ */
+void regular(Salida& salida, double tasa, long long emitidas, Reloj::time_point inicio) {
+    if (tasa <= 0.0) return;
+    Reloj::time_point objetivo = inicio + std::chrono::duration_cast<Reloj::duration>(
+        std::chrono::duration<double>(static_cast<double>(emitidas) / tasa));
+    if (Reloj::now() < objetivo) {
+        salida.vaciar();
+        std::this_thread::sleep_until(objetivo);
+    }
+}
+
+double segundosDesde(Reloj::time_point inicio) {
+    return std::chrono::duration<double>(Reloj::now() - inicio).count();
+}
+
+void informar(long long lecturas, const Salida& salida, Reloj::time_point inicio) {
+    double s = segundosDesde(inicio);
+    std::cerr << "[carga] " << lecturas << " lecturas, " << salida.obtenerBytes() << " bytes en " << s << " s ("
+              << (s > 0 ? static_cast<double>(lecturas) / s : 0.0) << " lecturas/s, "
+              << (s > 0 ? static_cast<double>(salida.obtenerBytes()) / s / 1e6 : 0.0) << " MB/s)\n";
+}
+
+/**
+ * @brief Emite las lecturas de los dispositivos emulados
+ * @details Los sensores se recorren en turno rotatorio: el dispositivo d tiene T-d y P-d
+ */
+int generar(const Configuracion& cfg, Salida& salida) {
+    std::mt19937 rng(cfg.semilla);
+    // random(TEMP_MIN * 10, TEMP_MAX * 10) / 10.0 y random(PRESION_MIN, PRESION_MAX + 1)
+    std::uniform_int_distribution<int> decimas(200, 499);
+    std::uniform_int_distribution<int> presion(70, 100);
+
+    long long sensores = 2 * cfg.dispositivos;
+    std::vector<std::string> prefijos(static_cast<std::size_t>(sensores));
+    for (long long s = 0; s < sensores; s++) {
+        char nombre[8];
+        TipoLectura tipo = s % 2 == 0 ? LECTURA_TEMPERATURA : LECTURA_PRESION;
+        formatearIdSensor(tipo, static_cast<unsigned>(s / 2 + 1), nombre);
+        prefijos[static_cast<std::size_t>(s)] = std::string(tipo == LECTURA_TEMPERATURA ? "TEMP|" : "PRES|") + nombre + "|";
+    }
+
+    Reloj::time_point inicio = Reloj::now();
+    long long emitidas = 0;
+    long long siguienteControl = 0;
+    long long sensor = 0;
+    int16_t valores[MAX_VALORES_TRAMA];
+    uint8_t trama[TAM_MAX_TRAMA];
+
+    while (!salida.haFallado()) {
+        if (cfg.lecturas > 0 && emitidas >= cfg.lecturas) break;
+        if (emitidas >= siguienteControl) {
+            // Reloj y tasa cada 256 lecturas: consultar el reloj en cada una costaría más
+            if (cfg.duracion > 0.0 && segundosDesde(inicio) >= cfg.duracion) break;
+            regular(salida, cfg.tasa, emitidas, inicio);
+            siguienteControl = emitidas + 256;
+        }
+
+        std::size_t dispositivo = static_cast<std::size_t>(sensor / 2);
+        bool temperatura = sensor % 2 == 0;
+        std::string& bufer = salida.bufer(dispositivo);
+        if (cfg.binario) {
+            long long n = cfg.lote;
+            if (cfg.lecturas > 0 && cfg.lecturas - emitidas < n) n = cfg.lecturas - emitidas;
+            for (long long i = 0; i < n; i++) {
+                // Temperatura en centésimas, como la envía el simulador
+                valores[i] = static_cast<int16_t>(temperatura ? decimas(rng) * 10 : presion(rng));
+            }
+            std::size_t bytes = codificarTrama(temperatura ? LECTURA_TEMPERATURA : LECTURA_PRESION,
+                                               static_cast<unsigned>(dispositivo + 1), valores, static_cast<int>(n), trama);
+            bufer.append(reinterpret_cast<const char*>(trama), bytes);
+            emitidas += n;
+        } else {
+            // Mismo formato que Serial.println(valor, 2): "45.30"
+            bufer += prefijos[static_cast<std::size_t>(sensor)];
+            if (temperatura) {
+                int d = decimas(rng);
+                anadirEntero(bufer, d / 10);
+                bufer += '.';
+                bufer += static_cast<char>('0' + d % 10);
+                bufer += "0\n";
+            } else {
+                anadirEntero(bufer, presion(rng));
+                bufer += '\n';
+            }
+            emitidas++;
+        }
+        salida.revisar(dispositivo);
+        if (++sensor == sensores) sensor = 0;
+    }
+
+    // El último bloque también respeta la tasa
+    regular(salida, cfg.tasa, emitidas, inicio);
+    salida.vaciar();
+    informar(emitidas, salida, inicio);
+    return salida.haFallado() ? 1 : 0;
+}
+
+/**
+ * @brief Reproduce una traza respetando sus marcas, aceleradas por cfg.velocidad
+ */
+int reproducir(const Configuracion& cfg, Salida& salida) {
+    std::ifstream traza(cfg.reproducir);
+    if (!traza) {
+        std::cerr << "[carga] No se pudo abrir la traza '" << cfg.reproducir << "'\n";
+        return 1;
+    }
+
+    Reloj::time_point inicio = Reloj::now();
+    std::string linea;
+    long long lineas = 0;
+    long long primeraMarca = -1;
+    while (!salida.haFallado() && std::getline(traza, linea)) {
+        // Marca opcional "<ms> " al principio
+        std::size_t p = 0;
+        long long marca = 0;
+        while (p < linea.size() && linea[p] >= '0' && linea[p] <= '9') {
+            marca = marca * 10 + (linea[p] - '0');
+            p++;
+        }
+        bool conMarca = p > 0 && p < linea.size() && linea[p] == ' ';
+        const char* contenido = linea.c_str();
+        std::size_t longitud = linea.size();
+        if (conMarca) {
+            contenido += p + 1;
+            longitud -= p + 1;
+            if (primeraMarca < 0) primeraMarca = marca;
+            if (cfg.velocidad > 0.0) {
+                Reloj::time_point objetivo = inicio + std::chrono::duration_cast<Reloj::duration>(
+                    std::chrono::duration<double, std::milli>(static_cast<double>(marca - primeraMarca) / cfg.velocidad));
+                if (Reloj::now() < objetivo) {
+                    salida.vaciar();
+                    std::this_thread::sleep_until(objetivo);
+                }
+            }
+        } else if ((lineas & 255) == 0) {
+            regular(salida, cfg.tasa, lineas, inicio);
+        }
+
+        // Las lecturas de un mismo sensor van siempre por el mismo destino
+        const char* id = static_cast<const char*>(memchr(contenido, '|', longitud));
+        std::size_t destino = 0;
+        for (const char* c = id != nullptr ? id + 1 : contenido; c < contenido + longitud && *c != '|'; c++) {
+            destino = destino * 31 + static_cast<unsigned char>(*c);
+        }
+        std::string& bufer = salida.bufer(destino);
+        bufer.append(contenido, longitud);
+        bufer += '\n';
+        salida.revisar(destino);
+        lineas++;
+    }
+
+    salida.vaciar();
+    informar(lineas, salida, inicio);
+    return salida.haFallado() ? 1 : 0;
+}
+
+/**
+ * @brief Graba las líneas de una fuente con la marca en ms de su llegada
+ */
+int grabar(const Configuracion& cfg, Salida& salida) {
+    int fuente = STDIN_FILENO;
+    if (strcmp(cfg.grabar, "-") != 0) {
+        fuente = open(cfg.grabar, O_RDONLY | O_NOCTTY | O_CLOEXEC);
+        if (fuente < 0) {
+            std::cerr << "[carga] No se pudo abrir '" << cfg.grabar << "': " << strerror(errno) << "\n";
+            return 1;
+        }
+        if (isatty(fuente)) IngestaLecturas::configurarSerial(fuente);
+    }
+
+    Reloj::time_point inicio = Reloj::now();
+    std::vector<char> bufer(IngestaLecturas::TAM_BUFER);
+    std::string linea;
+    long long lineas = 0;
+    while (!salida.haFallado()) {
+        ssize_t n = read(fuente, bufer.data(), bufer.size());
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        long long marca = static_cast<long long>(segundosDesde(inicio) * 1000.0);
+        for (ssize_t i = 0; i < n; i++) {
+            if (bufer[static_cast<std::size_t>(i)] != '\n') {
+                linea += bufer[static_cast<std::size_t>(i)];
+                continue;
+            }
+            if (!linea.empty() && linea[linea.size() - 1] == '\r') linea.erase(linea.size() - 1);
+            std::string& destino = salida.bufer(0);
+            anadirEntero(destino, static_cast<int>(marca));
+            destino += ' ';
+            destino += linea;
+            destino += '\n';
+            salida.revisar(0);
+            linea.clear();
+            lineas++;
+        }
+        // Una traza en vivo debe poder leerse mientras se graba
+        salida.vaciar();
+    }
+
+    if (fuente != STDIN_FILENO) close(fuente);
+    salida.vaciar();
+    informar(lineas, salida, inicio);
+    return salida.haFallado() ? 1 : 0;
+}
+
+void mostrarUso(const char* programa) {
+    std::cerr << "Uso: " << programa << " [--dispositivos n] [--tasa lecturas/s] [--lecturas n | --duracion s]\n"
+              << "         [--protocolo texto|binario] [--lote n] [--semilla s] [destino]\n"
+              << "     " << programa << " --reproducir traza [--velocidad x] [--tasa lecturas/s] [destino]\n"
+              << "     " << programa << " --grabar fuente [--salida traza]\n"
+              << "destino: --salida ruta|-|pty, o --tcp puerto [--conexiones n]\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Configuracion cfg;
+    cfg.dispositivos = 1000;
+    cfg.tasa = 0.0;
+    cfg.lecturas = 0;
+    cfg.duracion = 0.0;
+    cfg.binario = false;
+    cfg.lote = 16;
+    cfg.semilla = 12345u;
+    cfg.salida = "-";
+    cfg.puertoTcp = -1;
+    cfg.conexiones = 1;
+    cfg.reproducir = nullptr;
+    cfg.velocidad = 1.0;
+    cfg.grabar = nullptr;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--dispositivos") == 0) {
+            cfg.dispositivos = atoll(argv[i + 1]);
+        } else if (strcmp(argv[i], "--tasa") == 0) {
+            cfg.tasa = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--lecturas") == 0) {
+            cfg.lecturas = atoll(argv[i + 1]);
+        } else if (strcmp(argv[i], "--duracion") == 0) {
+            cfg.duracion = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--protocolo") == 0) {
+            cfg.binario = strcmp(argv[i + 1], "binario") == 0;
+        } else if (strcmp(argv[i], "--lote") == 0) {
+            cfg.lote = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--semilla") == 0) {
+            cfg.semilla = static_cast<unsigned>(strtoul(argv[i + 1], nullptr, 10));
+        } else if (strcmp(argv[i], "--salida") == 0) {
+            cfg.salida = argv[i + 1];
+        } else if (strcmp(argv[i], "--tcp") == 0) {
+            cfg.puertoTcp = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--conexiones") == 0) {
+            cfg.conexiones = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--reproducir") == 0) {
+            cfg.reproducir = argv[i + 1];
+        } else if (strcmp(argv[i], "--velocidad") == 0) {
+            cfg.velocidad = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--grabar") == 0) {
+            cfg.grabar = argv[i + 1];
+        } else {
+            mostrarUso(argv[0]);
+            return 1;
+        }
+    }
+    if (argc % 2 == 0) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+    // Los id binarios son de 16 bits
+    if (cfg.dispositivos < 1 || cfg.dispositivos > 65535 || cfg.lote < 1 || cfg.lote > MAX_VALORES_TRAMA ||
+        cfg.conexiones < 1) {
+        std::cerr << "[carga] Se requiere 1 <= dispositivos <= 65535, 1 <= lote <= " << MAX_VALORES_TRAMA
+                  << " y conexiones >= 1\n";
+        return 1;
+    }
+    if (cfg.lecturas == 0 && cfg.duracion <= 0.0) {
+        cfg.lecturas = 1000000;
+    }
+
+    // Un lector que se cierra se detecta con EPIPE en lugar de terminar el proceso
+    signal(SIGPIPE, SIG_IGN);
+
+    Salida salida;
+    if (!salida.abrir(cfg)) return 1;
+    if (cfg.grabar != nullptr) return grabar(cfg, salida);
+    if (cfg.reproducir != nullptr) return reproducir(cfg, salida);
+    return generar(cfg, salida);
+}
@@ -0,0 +1,271 @@
+/**
+ * @file AlmacenSegmentos.h
+ * @brief Almacén en disco, solo de anexado, para las lecturas antiguas de un sensor
+ * @details Cuando el historial en memoria supera su límite, las lecturas más antiguas se
+ * sellan en un segmento comprimido (CompresionSegmento) al final del archivo del sensor.
+ * Cada segmento guarda en su cabecera conteo, suma, suma de cuadrados, mínimo y máximo,
+ * así que promedio y extremos del historial completo se responden sin leer los datos.
+ *
+ * Formato de cada segmento: CabeceraSegmento (48 bytes, little-endian) seguida de
+ * bytesDatos bytes comprimidos. Al abrir, una cola rota por un anexado interrumpido
+ * (cabecera incompleta o con CRC erróneo) se recorta.
+ */
+
+#ifndef ALMACEN_SEGMENTOS_H
+#define ALMACEN_SEGMENTOS_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "CompresionSegmento.h"
+#include "EstadisticasLectura.h"
+#include "ListaSensor.h"
+
+/**
+ * @brief Cabecera en disco de un segmento sellado
+ */
+struct CabeceraSegmento {
+    char magia[4];              ///< "SEG1"
+    uint32_t tipo;              ///< 1 = float (XOR), 2 = int (delta de delta)
+    uint32_t numLecturas;       ///< Lecturas del segmento
+    uint32_t bytesDatos;        ///< Bytes comprimidos tras la cabecera
+    unsigned char suma[8];      ///< Acumulador de la suma (double o long long)
+    double sumaCuadrados;       ///< Suma de los cuadrados de las lecturas
+    unsigned char minimo[4];    ///< Menor lectura
+    unsigned char maximo[4];    ///< Mayor lectura
+    uint32_t crcDatos;          ///< CRC-32C de los datos comprimidos
+    uint32_t crcCabecera;       ///< CRC-32C de los 44 bytes anteriores
+};
+
+static_assert(sizeof(CabeceraSegmento) == 48, "Formato de segmento");
+
+/**
+ * @class ArchivoSegmentos
+ * @brief E/S del archivo de segmentos (independiente del tipo de lectura)
+ * @details El archivo solo está abierto durante cada operación: un sistema con miles de
+ * sensores no consume un descriptor por sensor. Se crea con el primer segmento.
+ */
+class ArchivoSegmentos {
+private:
+    std::string ruta;               ///< Archivo de segmentos (vacío = sin abrir)
+    CabeceraSegmento* cabeceras;    ///< Cabeceras de los segmentos válidos
+    uint64_t* desplazamientos;      ///< Posición de los datos de cada segmento
+    int numSegmentos;               ///< Segmentos válidos
+    int capacidad;                  ///< Capacidad de los arreglos
+    uint64_t tamanio;               ///< Bytes válidos del archivo
+
+    void crecer();
+
+public:
+    ArchivoSegmentos();
+    ~ArchivoSegmentos();
+
+    ArchivoSegmentos(const ArchivoSegmentos&) = delete;
+    ArchivoSegmentos& operator=(const ArchivoSegmentos&) = delete;
+
+    /**
+     * @brief Carga las cabeceras de los segmentos del archivo, si existe
+     * @param archivo Ruta del archivo de segmentos
+     * @param tipo Tipo de lectura esperado; un segmento de otro tipo invalida el archivo
+     * @return false si no se pudo abrir o contiene segmentos de otro tipo
+     */
+    bool abrir(const char* archivo, uint32_t tipo);
+
+    /**
+     * @brief Anexa un segmento y lo lleva a disco (fdatasync)
+     * @param cabecera Cabecera completa salvo los CRC, que se calculan aquí
+     * @param datos bytesDatos bytes comprimidos
+     * @return false si hubo un error de E/S (el archivo se deja como estaba)
+     */
+    bool anexar(CabeceraSegmento cabecera, const unsigned char* datos);
+
+    /**
+     * @brief Lee y verifica los datos comprimidos de un segmento
+     * @param i Índice del segmento
+     * @param destino Búfer de obtenerCabecera(i).bytesDatos bytes
+     * @return false ante un error de lectura o de CRC
+     */
+    bool leerDatos(int i, unsigned char* destino) const;
+
+    int obtenerNumSegmentos() const { return numSegmentos; }
+    const CabeceraSegmento& obtenerCabecera(int i) const { return cabeceras[i]; }
+    uint64_t obtenerTamanio() const { return tamanio; }
+};
+
+/**
+ * @class AlmacenSegmentos
+ * @brief Segmentos sellados de un sensor con sus agregados en memoria
+ * @tparam T Tipo de lectura (float o int)
+ */
+template <typename T>
+class AlmacenSegmentos {
+    static_assert(sizeof(T) == 4, "Lecturas de 4 bytes");
+
+public:
+    typedef typename EstadisticasLectura<T>::Acumulador Acumulador;
+    static const uint32_t TIPO = std::is_integral<T>::value ? 2u : 1u;  ///< Tipo en disco
+
+private:
+    ArchivoSegmentos archivo;               ///< Archivo del sensor
+    EstadisticasLectura<T> estadisticas;    ///< Agregados de todos los segmentos
+    bool abierto;                           ///< false si el archivo no pudo abrirse
+
+    /**
+     * @brief Agregados de un segmento a partir de su cabecera
+     */
+    static EstadisticasLectura<T> agregadosDe(const CabeceraSegmento& cabecera) {
+        Acumulador suma;
+        T menor;
+        T mayor;
+        std::memcpy(&suma, cabecera.suma, sizeof(suma));
+        std::memcpy(&menor, cabecera.minimo, sizeof(menor));
+        std::memcpy(&mayor, cabecera.maximo, sizeof(mayor));
+        EstadisticasLectura<T> agregados;
+        agregados.reconstruir(static_cast<long long>(cabecera.numLecturas), suma, cabecera.sumaCuadrados, menor, mayor);
+        return agregados;
+    }
+
+public:
+    /**
+     * @brief Abre el archivo de segmentos y agrega sus cabeceras
+     * @param ruta Archivo del sensor (se crea al sellar el primer segmento)
+     */
+    explicit AlmacenSegmentos(const char* ruta) : abierto(archivo.abrir(ruta, TIPO)) {
+        for (int i = 0; abierto && i < archivo.obtenerNumSegmentos(); i++) {
+            estadisticas.combinar(agregadosDe(archivo.obtenerCabecera(i)));
+        }
+    }
+
+    AlmacenSegmentos(const AlmacenSegmentos&) = delete;
+    AlmacenSegmentos& operator=(const AlmacenSegmentos&) = delete;
+
+    /**
+     * @brief Indica si el archivo se abrió correctamente
+     */
+    bool estaAbierto() const { return abierto; }
+
+    /**
+     * @brief Comprime y anexa un bloque de lecturas como segmento nuevo
+     * @param datos Lecturas en orden
+     * @param n Número de lecturas
+     * @return false si no se pudo escribir (los agregados no cambian)
+     */
+    bool sellar(const T* datos, int n) {
+        if (!abierto || n <= 0) return false;
+
+        EstadisticasLectura<T> agregados;
+        Acumulador suma = KernelsLectura<T>::sumar(datos, n);
+        double sumaCuadrados = KernelsLectura<T>::sumarCuadrados(datos, n);
+        T menor = datos[KernelsLectura<T>::posicionMinimo(datos, n)];
+        T mayor = datos[KernelsLectura<T>::posicionMaximo(datos, n)];
+        agregados.reconstruir(n, suma, sumaCuadrados, menor, mayor);
+
+        CabeceraSegmento cabecera;
+        std::memset(&cabecera, 0, sizeof(cabecera));
+        std::memcpy(cabecera.magia, "SEG1", 4);
+        cabecera.tipo = TIPO;
+        cabecera.numLecturas = static_cast<uint32_t>(n);
+        std::memcpy(cabecera.suma, &suma, sizeof(suma));
+        cabecera.sumaCuadrados = sumaCuadrados;
+        std::memcpy(cabecera.minimo, &menor, sizeof(menor));
+        std::memcpy(cabecera.maximo, &mayor, sizeof(mayor));
+
+        unsigned char* comprimido = new unsigned char[CompresionSegmento::cotaComprimida(n)];
+        cabecera.bytesDatos = static_cast<uint32_t>(CompresionSegmento::comprimir(datos, n, comprimido));
+        bool escrito = archivo.anexar(cabecera, comprimido);
+        delete[] comprimido;
+
+        if (escrito) {
+            estadisticas.combinar(agregados);
+        }
+        return escrito;
+    }
+
+    /**
+     * @brief Visita en orden todas las lecturas selladas (descomprimiendo cada segmento)
+     * @param visitar Función llamada con cada valor
+     * @return false si algún segmento no pudo leerse o verificarse (se detiene ahí)
+     */
+    template <typename F>
+    bool recorrer(F visitar) const {
+        for (int s = 0; s < archivo.obtenerNumSegmentos(); s++) {
+            const CabeceraSegmento& cabecera = archivo.obtenerCabecera(s);
+            int n = static_cast<int>(cabecera.numLecturas);
+            unsigned char* comprimido = new unsigned char[cabecera.bytesDatos];
+            T* lecturas = new T[n];
+            bool correcto = archivo.leerDatos(s, comprimido) &&
+                            CompresionSegmento::descomprimir(comprimido, cabecera.bytesDatos, lecturas, n);
+            if (correcto) {
+                for (int i = 0; i < n; i++) visitar(lecturas[i]);
+            }
+            delete[] comprimido;
+            delete[] lecturas;
+            if (!correcto) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Agregados de todas las lecturas selladas (extremos siempre al día)
+     */
+    const EstadisticasLectura<T>& obtenerEstadisticas() const { return estadisticas; }
+
+    long long obtenerCantidad() const { return estadisticas.obtenerCantidad(); }
+    int obtenerNumSegmentos() const { return archivo.obtenerNumSegmentos(); }
+    uint64_t obtenerBytes() const { return archivo.obtenerTamanio(); }
+};
+
+template <typename T>
+const uint32_t AlmacenSegmentos<T>::TIPO;
+
+/**
+ * @brief Agregados del historial completo: lecturas selladas más las de memoria
+ * @param memoria Historial en memoria (las lecturas más recientes)
+ * @param sellados Segmentos del sensor
+ */
+template <typename T, int N>
+EstadisticasLectura<T> estadisticasCompletas(const ListaSensor<T, N>& memoria, const AlmacenSegmentos<T>& sellados) {
+    EstadisticasLectura<T> total = sellados.obtenerEstadisticas();
+    total.combinar(memoria.obtenerEstadisticas());
+    return total;
+}
+
+/**
+ * @class VistaSegmentada
+ * @brief Historial en memoria y segmentos vistos como un solo historial
+ * @tparam T Tipo de lectura
+ * @tparam N Lecturas por nodo de la lista
+ * @details Misma interfaz de consulta que ListaSensor/HistorialCircular, para que el
+ * procesamiento de los sensores no distinga dónde están las lecturas. Los segmentos son
+ * inmutables: eliminarMenor() solo retira lecturas de memoria.
+ */
+template <typename T, int N>
+class VistaSegmentada {
+private:
+    const ListaSensor<T, N>& memoria;
+    ListaSensor<T, N>* modificable;  ///< nullptr en una vista de solo lectura
+    const AlmacenSegmentos<T>& sellados;
+
+public:
+    VistaSegmentada(ListaSensor<T, N>& memoria, const AlmacenSegmentos<T>& sellados)
+        : memoria(memoria), modificable(&memoria), sellados(sellados) {}
+
+    VistaSegmentada(const ListaSensor<T, N>& memoria, const AlmacenSegmentos<T>& sellados)
+        : memoria(memoria), modificable(nullptr), sellados(sellados) {}
+
+    bool estaVacia() const { return obtenerTamanio() == 0; }
+    long long obtenerTamanio() const { return memoria.obtenerTamanio() + sellados.obtenerCantidad(); }
+    T calcularPromedio() const { return estadisticasCompletas(memoria, sellados).promedio(); }
+    double calcularVarianza() const { return estadisticasCompletas(memoria, sellados).varianza(); }
+    T obtenerMinimo() const { return estadisticasCompletas(memoria, sellados).obtenerMinimo(); }
+    T obtenerMaximo() const { return estadisticasCompletas(memoria, sellados).obtenerMaximo(); }
+
+    /**
+     * @brief Elimina la menor lectura en memoria
+     * @return Valor eliminado (T() si no quedan lecturas en memoria o la vista es de solo lectura)
+     */
+    T eliminarMenor() { return modificable != nullptr ? modificable->eliminarMenor() : T(); }
+};
+
+#endif // ALMACEN_SEGMENTOS_H
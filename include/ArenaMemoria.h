@@ -0,0 +1,268 @@
+/**
+ * @file ArenaMemoria.h
+ * @brief Arena de memoria por bloques (slabs) y pool tipado de nodos
+ * @details Sustituye el par new/delete por nodo de las listas enlazadas: los nodos se
+ * toman de bloques grandes reservados de una sola vez y se reciclan mediante listas
+ * libres por tamaño. Todos los bloques se devuelven al sistema de golpe con reiniciar().
+ * El primer bloque es pequeño y cada uno dobla al anterior hasta TAM_BLOQUE, así que un
+ * historial de pocas lecturas con arena propia no retiene un bloque completo.
+ */
+
+#ifndef ARENA_MEMORIA_H
+#define ARENA_MEMORIA_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+/**
+ * @class ArenaMemoria
+ * @brief Asignador por bloques con listas libres por clase de tamaño
+ * @details Una misma arena puede compartirse entre varias listas (por ejemplo, todas las
+ * de un SistemaGestion). Por defecto no es segura para uso concurrente; con
+ * fijarConcurrente(true) reservar se serializa con un cerrojo y liberar solo apila el
+ * hueco sin cerrojos, para devolverlo al desactivar el modo concurrente.
+ */
+class ArenaMemoria {
+public:
+    static const std::size_t TAM_BLOQUE = 64 * 1024;  ///< Bytes máximos reservados por bloque
+    static const std::size_t TAM_PRIMER_BLOQUE = 1024; ///< Bytes del primer bloque
+    static const std::size_t ALINEACION = 16;         ///< Granularidad de las clases de tamaño
+    static const std::size_t TAM_MAX_CLASE = 1024;    ///< Mayor tamaño servido desde los bloques
+
+    /**
+     * @brief Constructor - No reserva memoria hasta la primera petición
+     */
+    ArenaMemoria();
+
+    /**
+     * @brief Destructor - Devuelve todos los bloques al sistema
+     */
+    ~ArenaMemoria();
+
+    ArenaMemoria(const ArenaMemoria&) = delete;
+    ArenaMemoria& operator=(const ArenaMemoria&) = delete;
+
+    /**
+     * @brief Reserva memoria para un objeto
+     * @param bytes Tamaño solicitado
+     * @return Puntero alineado a ALINEACION bytes
+     * @details Tamaños mayores que TAM_MAX_CLASE se delegan en ::operator new, con una
+     * cabecera que los enlaza para que reiniciar() también los devuelva
+     */
+    void* reservar(std::size_t bytes);
+
+    /**
+     * @brief Devuelve a la arena memoria obtenida con reservar()
+     * @param p Puntero devuelto por reservar()
+     * @param bytes El mismo tamaño usado al reservar
+     */
+    void liberar(void* p, std::size_t bytes);
+
+    /**
+     * @brief Libera de golpe todos los bloques (liberación masiva)
+     * @details Invalida toda la memoria entregada; los objetos deben haberse destruido
+     * antes o tener destructor trivial
+     */
+    void reiniciar();
+
+    /**
+     * @brief Activa o desactiva el modo concurrente
+     * @param concurrente true si varios hilos van a usar la arena a la vez
+     * @details Solo debe cambiarse mientras ningún otro hilo usa la arena. En modo
+     * concurrente, liberar() difiere la devolución (las liberaciones no compiten por el
+     * cerrojo) y la memoria no se reutiliza hasta fijarConcurrente(false)
+     */
+    void fijarConcurrente(bool concurrente);
+
+    /**
+     * @brief Marca la arena como en desmontaje: liberar() deja de hacer nada
+     * @param desmontando true mientras el dueño destruye todos los objetos de la arena
+     * @details Las listas que la comparten omiten entonces la devolución nodo a nodo
+     * (PoolNodos::admiteLiberacionMasiva()); el dueño llama después a reiniciar()
+     */
+    void fijarDesmontaje(bool desmontando);
+
+    /**
+     * @brief Indica si la arena está en desmontaje
+     */
+    bool enDesmontaje() const;
+
+    /**
+     * @brief Número de bloques reservados actualmente
+     * @return Cantidad de bloques (de TAM_PRIMER_BLOQUE a TAM_BLOQUE bytes)
+     */
+    std::size_t obtenerBloques() const;
+
+private:
+    static const std::size_t NUM_CLASES = TAM_MAX_CLASE / ALINEACION;
+
+    /**
+     * @brief Hueco libre enlazado dentro de un bloque
+     */
+    struct Hueco {
+        Hueco* siguiente;  ///< Siguiente hueco libre de la misma clase
+    };
+
+    /**
+     * @brief Cabecera de cada bloque reservado
+     */
+    struct Bloque {
+        Bloque* siguiente;  ///< Bloque reservado previamente
+    };
+
+    /**
+     * @brief Liberación diferida en modo concurrente, escrita sobre la propia memoria
+     */
+    struct Diferido {
+        Diferido* siguiente;  ///< Liberación diferida anterior
+        std::size_t bytes;    ///< Tamaño pasado a liberar()
+    };
+
+    /**
+     * @brief Cabecera de una reserva mayor que TAM_MAX_CLASE
+     */
+    struct Grande {
+        Grande* siguiente;  ///< Reserva grande posterior
+        Grande* anterior;   ///< Reserva grande anterior (quitarla en O(1))
+        std::size_t bytes;  ///< Bytes reservados, cabecera incluida
+    };
+
+    /// Bytes de la cabecera Grande, redondeados para conservar la alineación
+    static const std::size_t CABECERA_GRANDE = (sizeof(Grande) + ALINEACION - 1) / ALINEACION * ALINEACION;
+
+    Bloque* bloques;                 ///< Lista de bloques reservados
+    Grande* grandes;                 ///< Reservas grandes vivas
+    char* libre;                     ///< Siguiente byte sin usar del bloque actual
+    char* fin;                       ///< Fin del bloque actual
+    Hueco* huecos[NUM_CLASES];       ///< Listas libres por clase de tamaño
+    std::size_t numBloques;          ///< Bloques reservados
+    std::size_t tamSiguiente;        ///< Bytes del próximo bloque
+    std::size_t bytesReservados;     ///< Bytes pedidos al sistema (bloques y reservas grandes)
+    bool concurrente;                ///< true si reservar/liberar toman el cerrojo
+    bool desmontando;                ///< true si liberar() no debe hacer nada
+    std::mutex cerrojo;              ///< Serializa reservar en modo concurrente
+    std::atomic<Diferido*> diferidos;  ///< Pila de liberaciones del modo concurrente (solo push)
+
+    /**
+     * @brief Devuelve a las listas libres las liberaciones diferidas
+     */
+    void aplicarDiferidos();
+
+    /**
+     * @brief Reserva un bloque nuevo y lo convierte en el bloque actual
+     * @param minimo Bytes que deben caber en él
+     */
+    void nuevoBloque(std::size_t minimo);
+
+    void* reservarLocal(std::size_t bytes);
+    void liberarLocal(void* p, std::size_t bytes);
+};
+
+/**
+ * @class PoolNodos
+ * @brief Pool tipado de nodos sobre una ArenaMemoria propia o compartida
+ * @tparam TNodo Tipo de nodo (Nodo<T, N>, NodoGestion, ...)
+ * @details La arena propia se crea con el primer nodo, así que un pool vacío (o del que
+ * se han movido los nodos) no reserva memoria
+ */
+template <typename TNodo>
+class PoolNodos {
+private:
+    ArenaMemoria* arena;  ///< Arena de la que se toman los nodos (nullptr = propia aún sin crear)
+    bool propia;          ///< true si el pool creó (y debe destruir) la arena
+
+public:
+    /**
+     * @brief Constructor
+     * @param compartida Arena externa a usar; nullptr usa una arena propia
+     */
+    explicit PoolNodos(ArenaMemoria* compartida = nullptr)
+        : arena(compartida), propia(compartida == nullptr) {}
+
+    /**
+     * @brief Destructor - Libera la arena solo si es propia
+     */
+    ~PoolNodos() {
+        if (propia) delete arena;
+    }
+
+    PoolNodos(const PoolNodos&) = delete;
+    PoolNodos& operator=(const PoolNodos&) = delete;
+
+    /**
+     * @brief Constructor de movimiento
+     * @param otro Pool cuyos nodos pasan a este; conserva la arena si es compartida
+     */
+    PoolNodos(PoolNodos&& otro) noexcept : arena(otro.arena), propia(otro.propia) {
+        if (otro.propia) {
+            otro.arena = nullptr;
+        }
+    }
+
+    /**
+     * @brief Intercambia arenas (y con ellas la propiedad de los nodos)
+     * @param otro Pool con el que intercambiar
+     */
+    void intercambiar(PoolNodos& otro) noexcept {
+        ArenaMemoria* arenaOtro = otro.arena;
+        bool propiaOtro = otro.propia;
+        otro.arena = arena;
+        otro.propia = propia;
+        arena = arenaOtro;
+        propia = propiaOtro;
+    }
+
+    /**
+     * @brief Construye un nodo en memoria de la arena
+     * @param valor Argumento para el constructor de TNodo
+     * @return Puntero al nodo creado
+     */
+    template <typename A>
+    TNodo* crear(const A& valor) {
+        if (arena == nullptr) {
+            arena = new ArenaMemoria();
+        }
+        return new (arena->reservar(sizeof(TNodo))) TNodo(valor);
+    }
+
+    /**
+     * @brief Destruye un nodo y devuelve su memoria a la arena
+     * @param nodo Nodo creado con crear()
+     */
+    void destruir(TNodo* nodo) {
+        nodo->~TNodo();
+        arena->liberar(nodo, sizeof(TNodo));
+    }
+
+    /**
+     * @brief Indica si los nodos pueden abandonarse sin devolverlos uno a uno
+     * @return true con arena propia (liberarTodo() la reinicia) o con una compartida en
+     * desmontaje (su dueño la reiniciará)
+     */
+    bool admiteLiberacionMasiva() const {
+        return propia || arena->enDesmontaje();
+    }
+
+    /**
+     * @brief Devuelve todos los bloques de una vez si la arena es propia
+     * @return true si se liberó en bloque; false si la arena es compartida
+     * @details Los nodos deben haberse destruido antes (o tener destructor trivial)
+     */
+    bool liberarTodo() {
+        if (!propia) return false;
+        if (arena != nullptr) arena->reiniciar();
+        return true;
+    }
+
+    /**
+     * @brief Arena compartida en uso
+     * @return La arena externa, o nullptr si el pool usa una arena propia
+     */
+    ArenaMemoria* arenaCompartida() const {
+        return propia ? nullptr : arena;
+    }
+};
+
+#endif // ARENA_MEMORIA_H
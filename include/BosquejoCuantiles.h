@@ -0,0 +1,271 @@
+/**
+ * @file BosquejoCuantiles.h
+ * @brief Bosquejo KLL de cuantiles en flujo (p50, p95, p99...) con memoria acotada
+ * @details Karnin-Lang-Liberty: una pila de compactadores donde el nivel h guarda
+ * lecturas con peso 2^h. Cuando un nivel se llena se ordena y la mitad de sus elementos
+ * (los pares o los impares, al azar) sube al nivel siguiente. El nivel superior tiene
+ * capacidad k y cada nivel inferior 2/3 del anterior, así que se retienen unos 3k
+ * elementos sea cual sea el número de lecturas.
+ *
+ * Cota de error: el rango del cuantil devuelto difiere del pedido en menos de ~1,65 % de
+ * n con 99 % de confianza para k = 200 (el error escala como 1/k). Dos bosquejos se
+ * combinan sin perder esa garantía, p. ej. para cuantiles de toda la flota.
+ */
+
+#ifndef BOSQUEJO_CUANTILES_H
+#define BOSQUEJO_CUANTILES_H
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @class BosquejoCuantiles
+ * @brief Bosquejo de cuantiles combinable
+ * @tparam T Tipo de lectura
+ */
+template <typename T>
+class BosquejoCuantiles {
+public:
+    static const int K_DEFECTO = 200;    ///< Precisión por defecto
+
+private:
+    /**
+     * @brief Elementos de un compactador (peso 2^nivel)
+     */
+    struct Nivel {
+        T* elementos;    ///< Lecturas retenidas (desordenadas hasta compactar)
+        int cantidad;    ///< Elementos en uso
+        int reservados;  ///< Capacidad del arreglo
+        int capacidad;   ///< Elementos a partir de los que se compacta
+    };
+
+    /**
+     * @brief Elemento con su peso para responder consultas
+     */
+    struct Ponderado {
+        T valor;
+        long long peso;
+        bool operator<(const Ponderado& otro) const { return valor < otro.valor; }
+    };
+
+    int k;                             ///< Capacidad del nivel superior
+    Nivel* niveles;                    ///< Compactadores, del 0 (peso 1) hacia arriba
+    int numNiveles;                    ///< Niveles en uso
+    int retenidos;                     ///< Elementos retenidos en todos los niveles
+    int maxRetenidos;                  ///< Suma de capacidades: al alcanzarla se compacta
+    long long n;                       ///< Lecturas agregadas
+    T minimo;                          ///< Menor lectura exacta
+    T maximo;                          ///< Mayor lectura exacta
+    uint32_t azar;                     ///< Estado xorshift para elegir pares o impares
+
+    /**
+     * @brief Añade un nivel y recalcula las capacidades (k · (2/3)^profundidad)
+     */
+    void crecer() {
+        // Pocos niveles (log2(n / k)): se copian en cada crecimiento
+        Nivel* nuevos = new Nivel[numNiveles + 1];
+        std::copy(niveles, niveles + numNiveles, nuevos);
+        delete[] niveles;
+        niveles = nuevos;
+
+        Nivel& nuevo = niveles[numNiveles++];
+        nuevo.elementos = nullptr;
+        nuevo.cantidad = 0;
+        nuevo.reservados = 0;
+
+        maxRetenidos = 0;
+        double capacidad = k;
+        for (int h = numNiveles - 1; h >= 0; h--) {
+            niveles[h].capacidad = static_cast<int>(capacidad + 0.999999) + 1;
+            if (niveles[h].capacidad < 2) niveles[h].capacidad = 2;
+            maxRetenidos += niveles[h].capacidad;
+            capacidad *= 2.0 / 3.0;
+        }
+    }
+
+    void anexar(int h, T valor) {
+        Nivel& nivel = niveles[h];
+        if (nivel.cantidad == nivel.reservados) {
+            int nuevaReserva = nivel.reservados == 0 ? 8 : nivel.reservados * 2;
+            T* nuevos = new T[nuevaReserva];
+            std::copy(nivel.elementos, nivel.elementos + nivel.cantidad, nuevos);
+            delete[] nivel.elementos;
+            nivel.elementos = nuevos;
+            nivel.reservados = nuevaReserva;
+        }
+        nivel.elementos[nivel.cantidad++] = valor;
+    }
+
+    uint32_t siguienteAzar() {
+        azar ^= azar << 13;
+        azar ^= azar >> 17;
+        azar ^= azar << 5;
+        return azar;
+    }
+
+    /**
+     * @brief Ordena el nivel h y sube la mitad de sus elementos a h + 1
+     * @details Con un número impar, el menor se queda en h
+     */
+    void compactar(int h) {
+        if (h + 1 == numNiveles) {
+            crecer();
+        }
+        Nivel& nivel = niveles[h];
+        std::sort(nivel.elementos, nivel.elementos + nivel.cantidad);
+
+        int inicio = nivel.cantidad & 1;
+        int desplazamiento = static_cast<int>(siguienteAzar() & 1u);
+        for (int i = inicio + desplazamiento; i < nivel.cantidad; i += 2) {
+            anexar(h + 1, nivel.elementos[i]);
+        }
+        retenidos -= (nivel.cantidad - inicio) / 2;
+        nivel.cantidad = inicio;
+    }
+
+    /**
+     * @brief Compacta niveles llenos, de abajo arriba, hasta volver bajo el máximo
+     */
+    void comprimir() {
+        for (int h = 0; h < numNiveles && retenidos >= maxRetenidos; h++) {
+            if (niveles[h].cantidad >= niveles[h].capacidad) {
+                compactar(h);
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor
+     * @param k Precisión: mayor k, menor error y más memoria (~3k elementos)
+     */
+    explicit BosquejoCuantiles(int k = K_DEFECTO)
+        : k(k < 8 ? 8 : k), niveles(nullptr), numNiveles(0), retenidos(0), maxRetenidos(0), n(0),
+          minimo(T()), maximo(T()), azar(0x9E3779B9u) {
+        crecer();
+    }
+
+    ~BosquejoCuantiles() {
+        for (int h = 0; h < numNiveles; h++) {
+            delete[] niveles[h].elementos;
+        }
+        delete[] niveles;
+    }
+
+    BosquejoCuantiles(const BosquejoCuantiles&) = delete;
+    BosquejoCuantiles& operator=(const BosquejoCuantiles&) = delete;
+
+    /**
+     * @brief Incorpora una lectura (O(1) amortizado más una ordenación por compactación)
+     * @param valor Lectura
+     */
+    void agregar(T valor) {
+        if (n == 0 || valor < minimo) minimo = valor;
+        if (n == 0 || maximo < valor) maximo = valor;
+        n++;
+        anexar(0, valor);
+        retenidos++;
+        if (retenidos >= maxRetenidos) {
+            comprimir();
+        }
+    }
+
+    /**
+     * @brief Incorpora otro bosquejo (lecturas disjuntas, p. ej. de otro sensor)
+     * @param otro Bosquejo a combinar; no se modifica
+     */
+    void combinar(const BosquejoCuantiles<T>& otro) {
+        if (otro.n == 0) return;
+        if (n == 0 || otro.minimo < minimo) minimo = otro.minimo;
+        if (n == 0 || maximo < otro.maximo) maximo = otro.maximo;
+        n += otro.n;
+
+        while (numNiveles < otro.numNiveles) {
+            crecer();
+        }
+        for (int h = 0; h < otro.numNiveles; h++) {
+            for (int i = 0; i < otro.niveles[h].cantidad; i++) {
+                anexar(h, otro.niveles[h].elementos[i]);
+            }
+            retenidos += otro.niveles[h].cantidad;
+        }
+        while (retenidos >= maxRetenidos) {
+            comprimir();
+        }
+    }
+
+    /**
+     * @brief Calcula varios cuantiles con una sola ordenación
+     * @param q Fracciones en [0, 1] (0 = mínimo, 1 = máximo exactos)
+     * @param resultado Cuantil estimado de cada fracción
+     * @param m Número de fracciones
+     */
+    void cuantiles(const double* q, T* resultado, int m) const {
+        if (n == 0) {
+            for (int j = 0; j < m; j++) resultado[j] = T();
+            return;
+        }
+
+        Ponderado* todos = new Ponderado[retenidos];
+        int total = 0;
+        for (int h = 0; h < numNiveles; h++) {
+            for (int i = 0; i < niveles[h].cantidad; i++) {
+                todos[total].valor = niveles[h].elementos[i];
+                todos[total].peso = 1LL << h;
+                total++;
+            }
+        }
+        std::sort(todos, todos + total);
+        long long pesoTotal = 0;
+        for (int i = 0; i < total; i++) pesoTotal += todos[i].peso;
+
+        for (int j = 0; j < m; j++) {
+            if (q[j] <= 0.0) {
+                resultado[j] = minimo;
+                continue;
+            }
+            if (q[j] >= 1.0) {
+                resultado[j] = maximo;
+                continue;
+            }
+            // Primer elemento cuyo peso acumulado alcanza q · peso total
+            double objetivo = q[j] * static_cast<double>(pesoTotal);
+            long long acumulado = 0;
+            resultado[j] = maximo;
+            for (int i = 0; i < total; i++) {
+                acumulado += todos[i].peso;
+                if (static_cast<double>(acumulado) >= objetivo) {
+                    resultado[j] = todos[i].valor;
+                    break;
+                }
+            }
+        }
+        delete[] todos;
+    }
+
+    /**
+     * @brief Cuantil estimado
+     * @param q Fracción en [0, 1] (0,5 = mediana, 0,99 = p99)
+     * @return Lectura estimada (T() si el bosquejo está vacío)
+     */
+    T cuantil(double q) const {
+        T valor;
+        cuantiles(&q, &valor, 1);
+        return valor;
+    }
+
+    /**
+     * @brief Lecturas agregadas (incluidas las combinadas)
+     */
+    long long obtenerCantidad() const { return n; }
+
+    /**
+     * @brief Elementos retenidos (la memoria usada es proporcional a esto)
+     */
+    int obtenerRetenidos() const { return retenidos; }
+};
+
+template <typename T>
+const int BosquejoCuantiles<T>::K_DEFECTO;
+
+#endif // BOSQUEJO_CUANTILES_H
@@ -0,0 +1,133 @@
+/**
+ * @file ColaLecturas.h
+ * @brief Cola acotada sin cerrojos de varios productores y un consumidor (MPSC)
+ * @details Las lecturas pasan por esta cola antes de aplicarse al historial: varios hilos
+ * de ingesta encolan sin exclusión mutua y el hilo que procesa el sensor las drena por
+ * lotes. Cada celda lleva un número de secuencia que indica si está libre o publicada
+ * (esquema de Vyukov), así que no hay reservas por lectura.
+ */
+
+#ifndef COLA_LECTURAS_H
+#define COLA_LECTURAS_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class ColaLecturas
+ * @brief Búfer circular de capacidad potencia de dos
+ * @tparam T Tipo de lectura (copiable)
+ * @details encolar() es seguro desde cualquier número de hilos; drenar() solo puede
+ * llamarse desde un hilo a la vez
+ */
+template <typename T>
+class ColaLecturas {
+private:
+    static const std::size_t LINEA_CACHE = 64;
+
+    /**
+     * @brief Celda del búfer
+     */
+    struct Celda {
+        std::atomic<std::size_t> secuencia;  ///< == posición: libre; == posición + 1: publicada
+        T valor;                             ///< Lectura
+    };
+
+    Celda* celdas;          ///< Búfer circular
+    std::size_t mascara;    ///< Capacidad - 1
+    char relleno0[LINEA_CACHE];
+    std::atomic<std::size_t> cola;  ///< Siguiente posición a reservar (productores)
+    char relleno1[LINEA_CACHE];
+    std::size_t cabeza;     ///< Siguiente posición a leer (solo el consumidor)
+    char relleno2[LINEA_CACHE];
+
+public:
+    /**
+     * @brief Constructor - Reserva todas las celdas
+     * @param capacidad Lecturas en vuelo (se redondea a la potencia de dos superior)
+     */
+    explicit ColaLecturas(std::size_t capacidad) : cola(0), cabeza(0) {
+        std::size_t tam = 2;
+        while (tam < capacidad) tam <<= 1;
+        mascara = tam - 1;
+        celdas = new Celda[tam];
+        for (std::size_t i = 0; i < tam; i++) {
+            celdas[i].secuencia.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Destructor - Libera el búfer (las lecturas pendientes se pierden)
+     */
+    ~ColaLecturas() {
+        delete[] celdas;
+    }
+
+    ColaLecturas(const ColaLecturas&) = delete;
+    ColaLecturas& operator=(const ColaLecturas&) = delete;
+
+    /**
+     * @brief Publica una lectura (multi-productor, sin cerrojos)
+     * @param valor Lectura a encolar
+     * @return false si la cola está llena
+     */
+    bool encolar(const T& valor) {
+        std::size_t posicion = cola.load(std::memory_order_relaxed);
+        Celda* celda;
+        while (true) {
+            celda = &celdas[posicion & mascara];
+            std::size_t secuencia = celda->secuencia.load(std::memory_order_acquire);
+            long diferencia = static_cast<long>(secuencia) - static_cast<long>(posicion);
+            if (diferencia == 0) {
+                if (cola.compare_exchange_weak(posicion, posicion + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diferencia < 0) {
+                return false;
+            } else {
+                posicion = cola.load(std::memory_order_relaxed);
+            }
+        }
+
+        celda->valor = valor;
+        celda->secuencia.store(posicion + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Extrae por lotes las lecturas publicadas (consumidor único)
+     * @param destino Arreglo de al menos maximo elementos
+     * @param maximo Lecturas a extraer como mucho
+     * @return Lecturas copiadas en destino, en orden de publicación
+     */
+    int drenar(T* destino, int maximo) {
+        int n = 0;
+        while (n < maximo) {
+            Celda& celda = celdas[cabeza & mascara];
+            if (celda.secuencia.load(std::memory_order_acquire) != cabeza + 1) break;
+            destino[n++] = celda.valor;
+            // Liberar la celda para la siguiente vuelta del búfer
+            celda.secuencia.store(cabeza + mascara + 1, std::memory_order_release);
+            cabeza++;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Indica si no hay lecturas publicadas pendientes (solo el consumidor)
+     * @return true si drenar() no extraería nada
+     */
+    bool estaVacia() const {
+        return celdas[cabeza & mascara].secuencia.load(std::memory_order_acquire) != cabeza + 1;
+    }
+
+    /**
+     * @brief Capacidad real de la cola
+     * @return Número de celdas
+     */
+    std::size_t obtenerCapacidad() const {
+        return mascara + 1;
+    }
+};
+
+#endif // COLA_LECTURAS_H
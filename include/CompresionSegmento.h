@@ -0,0 +1,50 @@
+/**
+ * @file CompresionSegmento.h
+ * @brief Compresión sin pérdida de bloques de lecturas para los segmentos en disco
+ * @details float: codificación XOR al estilo Gorilla (cada valor se compara bit a bit con
+ * el anterior y solo se guardan los bits significativos del XOR; lecturas repetidas
+ * ocupan un bit). int: delta de delta en zigzag + varint (series regulares ocupan un
+ * byte por lectura).
+ */
+
+#ifndef COMPRESION_SEGMENTO_H
+#define COMPRESION_SEGMENTO_H
+
+#include <cstddef>
+
+/**
+ * @class CompresionSegmento
+ * @brief Codificadores por tipo de lectura (sobrecargados para float e int)
+ */
+class CompresionSegmento {
+public:
+    /**
+     * @brief Bytes máximos que puede ocupar un bloque comprimido
+     * @param n Número de lecturas
+     * @return Tamaño del búfer que deben recibir comprimir()
+     */
+    static std::size_t cotaComprimida(int n);
+
+    /**
+     * @brief Comprime un bloque de lecturas
+     * @param datos Lecturas en orden
+     * @param n Número de lecturas
+     * @param destino Búfer de al menos cotaComprimida(n) bytes
+     * @return Bytes escritos
+     */
+    static std::size_t comprimir(const float* datos, int n, unsigned char* destino);
+    static std::size_t comprimir(const int* datos, int n, unsigned char* destino);
+
+    /**
+     * @brief Descomprime un bloque
+     * @param origen Bytes comprimidos
+     * @param bytes Longitud de origen
+     * @param destino Arreglo de n lecturas
+     * @param n Número de lecturas codificadas
+     * @return false si los datos se acaban antes de tiempo o no son válidos
+     */
+    static bool descomprimir(const unsigned char* origen, std::size_t bytes, float* destino, int n);
+    static bool descomprimir(const unsigned char* origen, std::size_t bytes, int* destino, int n);
+};
+
+#endif // COMPRESION_SEGMENTO_H
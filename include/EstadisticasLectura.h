@@ -0,0 +1,243 @@
+/**
+ * @file EstadisticasLectura.h
+ * @brief Agregados incrementales (conteo, suma, mínimo, máximo, varianza) de un historial
+ * @details Se actualizan en O(1) en cada inserción/eliminación, de modo que las consultas
+ * de estadísticas no recorren la lista
+ */
+
+#ifndef ESTADISTICAS_LECTURA_H
+#define ESTADISTICAS_LECTURA_H
+
+#include <type_traits>
+
+/**
+ * @brief Tipo del acumulador de la suma según el tipo de lectura
+ * @tparam T Tipo de lectura
+ * @details Enteros se suman en long long (no desborda en historiales largos);
+ * flotantes en double con compensación de Kahan
+ */
+template <typename T, bool EsEntero = std::is_integral<T>::value>
+struct AcumuladorLectura {
+    typedef double tipo;
+};
+
+template <typename T>
+struct AcumuladorLectura<T, true> {
+    typedef long long tipo;
+};
+
+/**
+ * @class EstadisticasLectura
+ * @brief Estadísticas corrientes de un conjunto de lecturas
+ * @tparam T Tipo de lectura
+ * @details Mínimo y máximo no pueden deshacerse en O(1) tras eliminar el extremo: en ese
+ * caso se marcan como inválidos y el propietario debe recalcularlos con fijarExtremos()
+ */
+template <typename T>
+class EstadisticasLectura {
+public:
+    typedef typename AcumuladorLectura<T>::tipo Acumulador;
+
+private:
+    long long cantidad;       ///< Número de lecturas agregadas (con segmentos supera 2^31)
+    Acumulador suma;          ///< Suma de las lecturas
+    Acumulador compensacion;  ///< Error de redondeo acumulado (Kahan, solo flotantes)
+    double media;             ///< Media corriente (Welford)
+    double m2;                ///< Suma de cuadrados de desviaciones (Welford)
+    T minimo;                 ///< Menor lectura
+    T maximo;                 ///< Mayor lectura
+    bool extremosValidos;     ///< false si minimo/maximo deben recalcularse
+
+    /**
+     * @brief Suma compensada: sin efecto de redondeo para enteros
+     * @param valor Cantidad a acumular (negativa para restar)
+     */
+    void acumular(Acumulador valor) {
+        if (std::is_integral<T>::value) {
+            suma += valor;
+            return;
+        }
+        Acumulador y = valor - compensacion;
+        Acumulador t = suma + y;
+        compensacion = (t - suma) - y;
+        suma = t;
+    }
+
+public:
+    /**
+     * @brief Constructor - Estadísticas vacías
+     */
+    EstadisticasLectura() { reiniciar(); }
+
+    /**
+     * @brief Vuelve al estado vacío
+     */
+    void reiniciar() {
+        cantidad = 0;
+        suma = Acumulador();
+        compensacion = Acumulador();
+        media = 0.0;
+        m2 = 0.0;
+        minimo = T();
+        maximo = T();
+        extremosValidos = true;
+    }
+
+    /**
+     * @brief Incorpora una lectura
+     * @param valor Lectura insertada
+     */
+    void agregar(T valor) {
+        acumular(static_cast<Acumulador>(valor));
+
+        cantidad++;
+        double delta = static_cast<double>(valor) - media;
+        media += delta / cantidad;
+        m2 += delta * (static_cast<double>(valor) - media);
+
+        if (cantidad == 1) {
+            minimo = valor;
+            maximo = valor;
+            extremosValidos = true;
+        } else if (extremosValidos) {
+            if (valor < minimo) minimo = valor;
+            if (maximo < valor) maximo = valor;
+        }
+    }
+
+    /**
+     * @brief Retira una lectura previamente agregada
+     * @param valor Lectura eliminada
+     */
+    void quitar(T valor) {
+        if (cantidad <= 1) {
+            reiniciar();
+            return;
+        }
+
+        acumular(-static_cast<Acumulador>(valor));
+
+        double x = static_cast<double>(valor);
+        double mediaPrevia = media;
+        cantidad--;
+        media = (mediaPrevia * (cantidad + 1) - x) / cantidad;
+        m2 -= (x - mediaPrevia) * (x - media);
+        if (m2 < 0.0) m2 = 0.0;
+
+        if (!(minimo < valor) || !(valor < maximo)) {
+            extremosValidos = false;
+        }
+    }
+
+    /**
+     * @brief Incorpora los agregados de otro conjunto disjunto de lecturas
+     * @param otra Estadísticas de las lecturas añadidas
+     * @details Fórmula de Chan para combinar medias y varianzas en O(1)
+     */
+    void combinar(const EstadisticasLectura<T>& otra) {
+        if (otra.cantidad == 0) return;
+        if (cantidad == 0) {
+            *this = otra;
+            return;
+        }
+
+        acumular(otra.suma);
+        acumular(-otra.compensacion);
+
+        long long total = cantidad + otra.cantidad;
+        double delta = otra.media - media;
+        m2 += otra.m2 + delta * delta * (static_cast<double>(cantidad) * static_cast<double>(otra.cantidad) / total);
+        media += delta * static_cast<double>(otra.cantidad) / static_cast<double>(total);
+        cantidad = total;
+
+        if (extremosValidos && otra.extremosValidos) {
+            if (otra.minimo < minimo) minimo = otra.minimo;
+            if (maximo < otra.maximo) maximo = otra.maximo;
+        } else {
+            extremosValidos = false;
+        }
+    }
+
+    /**
+     * @brief Reemplaza todos los agregados por los de un recorrido completo
+     * @param n Número de lecturas
+     * @param total Suma de las lecturas
+     * @param sumaCuadrados Suma de los cuadrados de las lecturas
+     * @param menor Mínimo
+     * @param mayor Máximo
+     */
+    void reconstruir(long long n, Acumulador total, double sumaCuadrados, T menor, T mayor) {
+        if (n == 0) {
+            reiniciar();
+            return;
+        }
+        cantidad = n;
+        suma = total;
+        compensacion = Acumulador();
+        media = static_cast<double>(total) / static_cast<double>(n);
+        m2 = sumaCuadrados - media * static_cast<double>(total);
+        if (m2 < 0.0) m2 = 0.0;
+        fijarExtremos(menor, mayor);
+    }
+
+    /**
+     * @brief Fija los extremos tras recalcularlos sobre los datos
+     * @param menor Mínimo actual
+     * @param mayor Máximo actual
+     */
+    void fijarExtremos(T menor, T mayor) {
+        minimo = menor;
+        maximo = mayor;
+        extremosValidos = true;
+    }
+
+    /**
+     * @brief Indica si minimo/maximo están al día
+     * @return false si deben recalcularse con fijarExtremos()
+     */
+    bool extremosAlDia() const { return extremosValidos || cantidad == 0; }
+
+    /**
+     * @brief Número de lecturas agregadas
+     * @return Conteo actual
+     */
+    long long obtenerCantidad() const { return cantidad; }
+
+    /**
+     * @brief Suma de las lecturas en el acumulador ancho
+     * @return Suma (compensada para flotantes)
+     */
+    Acumulador obtenerSuma() const { return suma; }
+
+    /**
+     * @brief Promedio de las lecturas
+     * @return Suma / conteo convertido a T (T() si está vacío)
+     */
+    T promedio() const {
+        if (cantidad == 0) return T();
+        return static_cast<T>(suma / cantidad);
+    }
+
+    /**
+     * @brief Varianza poblacional de las lecturas
+     * @return Varianza (0 con menos de dos lecturas)
+     */
+    double varianza() const {
+        if (cantidad < 2) return 0.0;
+        return m2 / cantidad;
+    }
+
+    /**
+     * @brief Menor lectura (requiere extremosAlDia())
+     * @return Mínimo, o T() si está vacío
+     */
+    T obtenerMinimo() const { return minimo; }
+
+    /**
+     * @brief Mayor lectura (requiere extremosAlDia())
+     * @return Máximo, o T() si está vacío
+     */
+    T obtenerMaximo() const { return maximo; }
+};
+
+#endif // ESTADISTICAS_LECTURA_H
@@ -0,0 +1,467 @@
+/**
+ * @file HistorialCircular.h
+ * @brief Historial de capacidad fija (búfer circular) con políticas de retención
+ * @details Variante acotada de ListaSensor<T>: un único búfer reservado al construirse,
+ * sin reservas por lectura, de modo que la memoria por sensor es constante.
+ */
+
+#ifndef HISTORIAL_CIRCULAR_H
+#define HISTORIAL_CIRCULAR_H
+
+#include <chrono>
+#include <iostream>
+#include "EstadisticasLectura.h"
+#include "KernelsLectura.h"
+#include "Registro.h"
+
+/**
+ * @brief Política de retención de un historial acotado
+ */
+struct PoliticaRetencion {
+    int capacidad;           ///< Máximo de lecturas retenidas (tamaño del búfer)
+    long long edadMaximaMs;  ///< Descarta lecturas más antiguas que esto (0 = sin límite)
+    int factorDiezmado;      ///< > 1: al llenarse, promedia la mitad antigua en grupos de este tamaño
+                             ///< (ponderando cada posición por las lecturas que ya resume)
+
+    /**
+     * @brief Constructor
+     * @param capacidad Conservar solo las últimas capacidad lecturas
+     * @param edadMaximaMs Edad máxima en milisegundos (0 = sin límite)
+     * @param factorDiezmado Factor de submuestreo de las lecturas antiguas (<= 1 = descartar)
+     */
+    explicit PoliticaRetencion(int capacidad, long long edadMaximaMs = 0, int factorDiezmado = 1)
+        : capacidad(capacidad), edadMaximaMs(edadMaximaMs), factorDiezmado(factorDiezmado) {}
+};
+
+/**
+ * @brief Milisegundos de un reloj monótono (marca de tiempo por defecto de las lecturas)
+ * @return Milisegundos desde un origen arbitrario
+ */
+inline long long milisegundosMonotonos() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @class HistorialCircular
+ * @brief Búfer circular de lecturas con la misma interfaz que ListaSensor
+ * @tparam T Tipo de dato de las lecturas
+ * @details Al llenarse descarta la lectura más antigua o, si la política lo pide,
+ * submuestrea la mitad más antigua. Los agregados se mantienen como en ListaSensor.
+ * Con edad máxima, cada consulta descarta antes las lecturas caducadas según
+ * milisegundosMonotonos(), así que tras un periodo sin lecturas no se ven datos viejos;
+ * las marcas explícitas deben venir de ese mismo reloj.
+ */
+template <typename T>
+class HistorialCircular {
+private:
+    T* valores;            ///< Búfer de lecturas
+    long long* marcas;     ///< Marca de tiempo (ms) de cada lectura
+    int* muestras;         ///< Lecturas originales que resume cada posición (1 salvo tras diezmar)
+    PoliticaRetencion politica;  ///< Política de retención
+    mutable int inicio;    ///< Posición física de la lectura más antigua (las consultas caducan)
+    mutable int tamanio;   ///< Lecturas retenidas
+    mutable EstadisticasLectura<T> estadisticas;  ///< Agregados incrementales
+
+public:
+    /**
+     * @brief Constructor - Reserva el búfer completo
+     * @param politica Capacidad y reglas de retención (capacidad mínima 1)
+     */
+    explicit HistorialCircular(const PoliticaRetencion& politica);
+
+    /**
+     * @brief Destructor - Libera el búfer
+     */
+    ~HistorialCircular();
+
+    /**
+     * @brief Constructor de copia (Regla de los Tres)
+     */
+    HistorialCircular(const HistorialCircular<T>& otro);
+
+    /**
+     * @brief Operador de asignación (Regla de los Tres)
+     */
+    HistorialCircular<T>& operator=(const HistorialCircular<T>& otro);
+
+    /**
+     * @brief Inserta una lectura con la hora actual del reloj monótono
+     * @param valor Valor a insertar
+     */
+    void insertar(T valor);
+
+    /**
+     * @brief Inserta una lectura con marca de tiempo explícita
+     * @param valor Valor a insertar
+     * @param marcaMs Marca de tiempo en milisegundos (no decreciente)
+     */
+    void insertar(T valor, long long marcaMs);
+
+    /**
+     * @brief Descarta las lecturas que superan la edad máxima
+     * @param ahoraMs Hora de referencia en milisegundos
+     */
+    void aplicarEdad(long long ahoraMs);
+
+    bool buscar(T valor) const;
+    T calcularPromedio() const;
+    double calcularVarianza() const;
+    T obtenerMinimo() const;
+    T obtenerMaximo() const;
+
+    /**
+     * @brief Elimina el valor más bajo (desplaza las lecturas posteriores)
+     * @return El valor eliminado (T() si está vacío)
+     */
+    T eliminarMenor();
+
+    int obtenerTamanio() const;
+    bool estaVacia() const;
+    void mostrar() const;
+
+    /**
+     * @brief Capacidad configurada
+     * @return Máximo de lecturas retenidas
+     */
+    int obtenerCapacidad() const;
+
+    /**
+     * @brief Lectura por orden lógico (0 = más antigua)
+     * @param i Índice lógico, menor que el último obtenerTamanio() (no caduca lecturas)
+     * @return Referencia a la lectura
+     */
+    const T& obtener(int i) const;
+
+    /**
+     * @brief Marca de tiempo por orden lógico
+     * @param i Índice lógico
+     * @return Milisegundos de la lectura
+     */
+    long long obtenerMarca(int i) const;
+
+    /**
+     * @brief Lecturas originales que resume una posición
+     * @param i Índice lógico
+     * @return 1 para una lectura sin diezmar; el total del grupo para un promedio
+     */
+    int obtenerMuestras(int i) const;
+
+    /**
+     * @brief Visita las lecturas de la más antigua a la más reciente
+     * @param visitar Función llamada con cada valor
+     */
+    template <typename F>
+    void recorrer(F visitar) const {
+        caducar();
+        for (int i = 0; i < tamanio; i++) visitar(obtener(i));
+    }
+
+    /**
+     * @brief Vacía el historial sin liberar el búfer
+     */
+    void vaciar();
+
+private:
+    int fisica(int i) const { return (inicio + i) % politica.capacidad; }
+
+    /**
+     * @brief Descarta la lectura más antigua
+     */
+    void descartarAntigua() const;
+
+    /**
+     * @brief Descarta las lecturas más antiguas que la edad máxima respecto a ahoraMs
+     */
+    void descartarCaducadas(long long ahoraMs) const;
+
+    /**
+     * @brief Aplica la edad máxima con el reloj monótono antes de una consulta
+     */
+    void caducar() const;
+
+    /**
+     * @brief Promedia la mitad más antigua en grupos de factorDiezmado
+     * @details El promedio de cada grupo pondera cada posición por sus muestras, así que un
+     * promedio anterior cuenta tantas veces como lecturas resume
+     * @return false si no hay suficientes lecturas para formar un grupo
+     */
+    bool diezmar();
+
+    /**
+     * @brief Recalcula mínimo y máximo si una eliminación los invalidó
+     */
+    void actualizarExtremos() const;
+
+    void copiarDe(const HistorialCircular<T>& otro);
+};
+
+// ======================== IMPLEMENTACIÓN ========================
+
+template <typename T>
+HistorialCircular<T>::HistorialCircular(const PoliticaRetencion& p)
+    : valores(nullptr), marcas(nullptr), muestras(nullptr), politica(p), inicio(0), tamanio(0) {
+    if (politica.capacidad < 1) politica.capacidad = 1;
+    valores = new T[politica.capacidad];
+    marcas = new long long[politica.capacidad];
+    muestras = new int[politica.capacidad];
+    REGISTRO_DEPURACION("[Log] HistorialCircular<T> creado. Capacidad: " << politica.capacidad << "\n");
+}
+
+template <typename T>
+HistorialCircular<T>::~HistorialCircular() {
+    REGISTRO_DEPURACION("[Destructor HistorialCircular] Liberando " << tamanio << " lectura(s).\n");
+    delete[] valores;
+    delete[] marcas;
+    delete[] muestras;
+}
+
+template <typename T>
+HistorialCircular<T>::HistorialCircular(const HistorialCircular<T>& otro)
+    : valores(new T[otro.politica.capacidad]), marcas(new long long[otro.politica.capacidad]),
+      muestras(new int[otro.politica.capacidad]), politica(otro.politica), inicio(0), tamanio(0) {
+    copiarDe(otro);
+}
+
+template <typename T>
+HistorialCircular<T>& HistorialCircular<T>::operator=(const HistorialCircular<T>& otro) {
+    if (this != &otro) {
+        if (politica.capacidad != otro.politica.capacidad) {
+            delete[] valores;
+            delete[] marcas;
+            delete[] muestras;
+            valores = new T[otro.politica.capacidad];
+            marcas = new long long[otro.politica.capacidad];
+            muestras = new int[otro.politica.capacidad];
+        }
+        politica = otro.politica;
+        copiarDe(otro);
+    }
+    return *this;
+}
+
+template <typename T>
+void HistorialCircular<T>::copiarDe(const HistorialCircular<T>& otro) {
+    for (int i = 0; i < otro.tamanio; i++) {
+        valores[i] = otro.obtener(i);
+        marcas[i] = otro.obtenerMarca(i);
+        muestras[i] = otro.obtenerMuestras(i);
+    }
+    inicio = 0;
+    tamanio = otro.tamanio;
+    estadisticas = otro.estadisticas;
+}
+
+template <typename T>
+void HistorialCircular<T>::insertar(T valor) {
+    insertar(valor, milisegundosMonotonos());
+}
+
+template <typename T>
+void HistorialCircular<T>::insertar(T valor, long long marcaMs) {
+    aplicarEdad(marcaMs);
+
+    if (tamanio == politica.capacidad) {
+        if (politica.factorDiezmado <= 1 || !diezmar()) {
+            descartarAntigua();
+        }
+    }
+
+    int posicion = fisica(tamanio);
+    valores[posicion] = valor;
+    marcas[posicion] = marcaMs;
+    muestras[posicion] = 1;
+    tamanio++;
+    estadisticas.agregar(valor);
+    REGISTRO_TRAZA("[Log] Lectura insertada en historial circular. Valor: " << valor << "\n");
+}
+
+template <typename T>
+void HistorialCircular<T>::aplicarEdad(long long ahoraMs) {
+    descartarCaducadas(ahoraMs);
+}
+
+template <typename T>
+void HistorialCircular<T>::descartarCaducadas(long long ahoraMs) const {
+    if (politica.edadMaximaMs <= 0) return;
+    while (tamanio > 0 && ahoraMs - marcas[inicio] > politica.edadMaximaMs) {
+        descartarAntigua();
+    }
+}
+
+template <typename T>
+void HistorialCircular<T>::caducar() const {
+    // El reloj solo se consulta si hay edad máxima
+    if (politica.edadMaximaMs > 0) descartarCaducadas(milisegundosMonotonos());
+}
+
+template <typename T>
+bool HistorialCircular<T>::buscar(T valor) const {
+    caducar();
+    // Dos tramos contiguos: [inicio, fin del búfer) y [0, resto)
+    int primerTramo = tamanio < politica.capacidad - inicio ? tamanio : politica.capacidad - inicio;
+    if (KernelsLectura<T>::buscar(valores + inicio, primerTramo, valor) >= 0) return true;
+    return tamanio > primerTramo &&
+           KernelsLectura<T>::buscar(valores, tamanio - primerTramo, valor) >= 0;
+}
+
+template <typename T>
+T HistorialCircular<T>::calcularPromedio() const {
+    caducar();
+    return estadisticas.promedio();
+}
+
+template <typename T>
+double HistorialCircular<T>::calcularVarianza() const {
+    caducar();
+    return estadisticas.varianza();
+}
+
+template <typename T>
+T HistorialCircular<T>::obtenerMinimo() const {
+    caducar();
+    actualizarExtremos();
+    return estadisticas.obtenerMinimo();
+}
+
+template <typename T>
+T HistorialCircular<T>::obtenerMaximo() const {
+    caducar();
+    actualizarExtremos();
+    return estadisticas.obtenerMaximo();
+}
+
+template <typename T>
+T HistorialCircular<T>::eliminarMenor() {
+    caducar();
+    if (tamanio == 0) return T();
+
+    // Mínimo de cada tramo contiguo; en empate gana el más antiguo
+    int primerTramo = tamanio < politica.capacidad - inicio ? tamanio : politica.capacidad - inicio;
+    int menor = KernelsLectura<T>::posicionMinimo(valores + inicio, primerTramo);
+    if (tamanio > primerTramo) {
+        int otro = KernelsLectura<T>::posicionMinimo(valores, tamanio - primerTramo);
+        if (valores[otro] < valores[inicio + menor]) menor = primerTramo + otro;
+    }
+
+    T valorMenor = obtener(menor);
+    for (int i = menor + 1; i < tamanio; i++) {
+        valores[fisica(i - 1)] = valores[fisica(i)];
+        marcas[fisica(i - 1)] = marcas[fisica(i)];
+        muestras[fisica(i - 1)] = muestras[fisica(i)];
+    }
+    tamanio--;
+    estadisticas.quitar(valorMenor);
+
+    REGISTRO_TRAZA("[Log] Lectura " << valorMenor << " (menor) eliminada del historial circular.\n");
+    return valorMenor;
+}
+
+template <typename T>
+int HistorialCircular<T>::obtenerTamanio() const {
+    caducar();
+    return tamanio;
+}
+
+template <typename T>
+bool HistorialCircular<T>::estaVacia() const {
+    caducar();
+    return tamanio == 0;
+}
+
+template <typename T>
+void HistorialCircular<T>::mostrar() const {
+    caducar();
+    std::cout << "[Historial] { ";
+    for (int i = 0; i < tamanio; i++) {
+        if (i > 0) std::cout << ", ";
+        std::cout << obtener(i);
+    }
+    std::cout << " }\n";
+}
+
+template <typename T>
+int HistorialCircular<T>::obtenerCapacidad() const {
+    return politica.capacidad;
+}
+
+template <typename T>
+const T& HistorialCircular<T>::obtener(int i) const {
+    return valores[fisica(i)];
+}
+
+template <typename T>
+long long HistorialCircular<T>::obtenerMarca(int i) const {
+    return marcas[fisica(i)];
+}
+
+template <typename T>
+int HistorialCircular<T>::obtenerMuestras(int i) const {
+    return muestras[fisica(i)];
+}
+
+template <typename T>
+void HistorialCircular<T>::vaciar() {
+    inicio = 0;
+    tamanio = 0;
+    estadisticas.reiniciar();
+}
+
+template <typename T>
+void HistorialCircular<T>::descartarAntigua() const {
+    estadisticas.quitar(valores[inicio]);
+    inicio = (inicio + 1) % politica.capacidad;
+    tamanio--;
+}
+
+template <typename T>
+bool HistorialCircular<T>::diezmar() {
+    int factor = politica.factorDiezmado;
+    int grupos = (tamanio / 2) / factor;
+    if (grupos == 0) return false;
+
+    // Cada grupo de lecturas antiguas se sustituye por su promedio ponderado y su última marca
+    typedef typename EstadisticasLectura<T>::Acumulador Acumulador;
+    int consumidas = grupos * factor;
+    for (int g = 0; g < grupos; g++) {
+        Acumulador suma = Acumulador();
+        int total = 0;
+        long long marca = 0;
+        for (int k = 0; k < factor; k++) {
+            int i = g * factor + k;
+            suma += static_cast<Acumulador>(obtener(i)) * obtenerMuestras(i);
+            total += obtenerMuestras(i);
+            estadisticas.quitar(obtener(i));
+            marca = obtenerMarca(i);
+        }
+        T promedio = static_cast<T>(suma / total);
+        valores[fisica(g)] = promedio;
+        marcas[fisica(g)] = marca;
+        muestras[fisica(g)] = total;
+        estadisticas.agregar(promedio);
+    }
+
+    // Desplazar las lecturas recientes a continuación de los promedios
+    for (int i = consumidas; i < tamanio; i++) {
+        valores[fisica(grupos + i - consumidas)] = valores[fisica(i)];
+        marcas[fisica(grupos + i - consumidas)] = marcas[fisica(i)];
+        muestras[fisica(grupos + i - consumidas)] = muestras[fisica(i)];
+    }
+    tamanio -= consumidas - grupos;
+    return true;
+}
+
+template <typename T>
+void HistorialCircular<T>::actualizarExtremos() const {
+    if (estadisticas.extremosAlDia()) return;
+
+    T menor = obtener(0);
+    T mayor = obtener(0);
+    for (int i = 1; i < tamanio; i++) {
+        if (obtener(i) < menor) menor = obtener(i);
+        if (mayor < obtener(i)) mayor = obtener(i);
+    }
+    estadisticas.fijarExtremos(menor, mayor);
+}
+
+#endif // HISTORIAL_CIRCULAR_H
@@ -0,0 +1,276 @@
+/**
+ * @file IndiceExtremos.h
+ * @brief Índice auxiliar para extraer el mínimo y el máximo en O(log n)
+ * @details Mantiene dos montículos binarios (mínimo y máximo) de pares (valor, posición)
+ * junto a la lista en orden de inserción. Las lecturas extraídas se marcan como muertas
+ * en un mapa de bits; la lista propietaria las compacta cuando superan a las vivas.
+ */
+
+#ifndef INDICE_EXTREMOS_H
+#define INDICE_EXTREMOS_H
+
+/**
+ * @class IndiceExtremos
+ * @brief Montículos de mínimo y máximo con borrado perezoso
+ * @tparam T Tipo de lectura
+ * @details La posición de una lectura es su orden físico en la lista (0, 1, 2...).
+ * Una entrada extraída por un montículo queda obsoleta en el otro y se descarta al
+ * llegar a la cima, así que cada extracción cuesta O(log n) amortizado.
+ */
+template <typename T>
+class IndiceExtremos {
+private:
+    /**
+     * @brief Entrada de los montículos
+     */
+    struct Entrada {
+        T valor;       ///< Lectura indexada
+        int posicion;  ///< Posición física de la lectura en la lista
+    };
+
+    Entrada* menores;       ///< Montículo de mínimo
+    Entrada* mayores;       ///< Montículo de máximo
+    int numMenores;         ///< Entradas en el montículo de mínimo
+    int numMayores;         ///< Entradas en el montículo de máximo
+    int capacidad;          ///< Capacidad de ambos montículos
+    unsigned char* vivos;   ///< Mapa de bits: 1 = lectura aún presente
+    int posiciones;         ///< Posiciones físicas registradas
+    int extraidas;          ///< Posiciones marcadas como muertas
+
+public:
+    /**
+     * @brief Constructor - Índice vacío
+     */
+    IndiceExtremos()
+        : menores(nullptr), mayores(nullptr), numMenores(0), numMayores(0), capacidad(0),
+          vivos(nullptr), posiciones(0), extraidas(0) {}
+
+    /**
+     * @brief Destructor - Libera montículos y mapa de bits
+     */
+    ~IndiceExtremos() {
+        delete[] menores;
+        delete[] mayores;
+        delete[] vivos;
+    }
+
+    IndiceExtremos(const IndiceExtremos&) = delete;
+    IndiceExtremos& operator=(const IndiceExtremos&) = delete;
+
+    /**
+     * @brief Vacía el índice conservando la memoria reservada
+     */
+    void reiniciar() {
+        numMenores = 0;
+        numMayores = 0;
+        posiciones = 0;
+        extraidas = 0;
+    }
+
+    /**
+     * @brief Indexa la lectura añadida al final de la lista
+     * @param valor Lectura insertada (su posición es la siguiente libre)
+     */
+    void registrar(T valor) {
+        if (posiciones == capacidad) {
+            crecer();
+        }
+        int posicion = posiciones++;
+        vivos[posicion / 8] |= static_cast<unsigned char>(1u << (posicion % 8));
+
+        Entrada entrada = { valor, posicion };
+        menores[numMenores] = entrada;
+        subir(menores, numMenores++, true);
+        mayores[numMayores] = entrada;
+        subir(mayores, numMayores++, false);
+    }
+
+    /**
+     * @brief Indexa un bloque de lecturas añadidas al final de la lista
+     * @param datos Lecturas en orden de inserción
+     * @param n Número de lecturas
+     * @details Si el bloque es al menos tan grande como lo ya indexado, reconstruye ambos
+     * montículos en O(n) en vez de pagar O(log n) por lectura.
+     */
+    void registrarBloque(const T* datos, int n) {
+        if (n <= 0) return;
+        if (n < numMenores) {
+            for (int i = 0; i < n; i++) registrar(datos[i]);
+            return;
+        }
+        anexarSinOrden(datos, n);
+        ordenarMonticulos();
+    }
+
+    /**
+     * @brief Añade lecturas al final de los montículos sin restaurar su orden
+     * @param datos Lecturas en orden de inserción
+     * @param n Número de lecturas
+     * @details Debe seguirle ordenarMonticulos() antes de cualquier consulta o extracción.
+     */
+    void anexarSinOrden(const T* datos, int n) {
+        while (posiciones + n > capacidad) {
+            crecer();
+        }
+        for (int i = 0; i < n; i++) {
+            int posicion = posiciones++;
+            vivos[posicion / 8] |= static_cast<unsigned char>(1u << (posicion % 8));
+            Entrada entrada = { datos[i], posicion };
+            menores[numMenores++] = entrada;
+            mayores[numMayores++] = entrada;
+        }
+    }
+
+    /**
+     * @brief Restaura el orden de ambos montículos en O(n) (construcción de Floyd)
+     */
+    void ordenarMonticulos() {
+        for (int i = numMenores / 2 - 1; i >= 0; i--) bajar(menores, numMenores, i, true);
+        for (int i = numMayores / 2 - 1; i >= 0; i--) bajar(mayores, numMayores, i, false);
+    }
+
+    /**
+     * @brief Extrae la menor lectura viva (la primera insertada en caso de empate)
+     * @param valor Salida: lectura extraída
+     * @return false si no quedan lecturas
+     */
+    bool extraerMenor(T& valor) {
+        return extraer(menores, numMenores, true, valor);
+    }
+
+    /**
+     * @brief Extrae la mayor lectura viva (la primera insertada en caso de empate)
+     * @param valor Salida: lectura extraída
+     * @return false si no quedan lecturas
+     */
+    bool extraerMayor(T& valor) {
+        return extraer(mayores, numMayores, false, valor);
+    }
+
+    /**
+     * @brief Consulta la menor lectura viva sin extraerla
+     * @param valor Salida: menor lectura
+     * @return false si no quedan lecturas
+     */
+    bool consultarMenor(T& valor) {
+        if (!limpiarCima(menores, numMenores, true)) return false;
+        valor = menores[0].valor;
+        return true;
+    }
+
+    /**
+     * @brief Consulta la mayor lectura viva sin extraerla
+     * @param valor Salida: mayor lectura
+     * @return false si no quedan lecturas
+     */
+    bool consultarMayor(T& valor) {
+        if (!limpiarCima(mayores, numMayores, false)) return false;
+        valor = mayores[0].valor;
+        return true;
+    }
+
+    /**
+     * @brief Indica si la lectura de una posición física sigue presente
+     * @param posicion Posición física en la lista
+     * @return true si no ha sido extraída
+     */
+    bool vivo(int posicion) const {
+        return (vivos[posicion / 8] >> (posicion % 8)) & 1u;
+    }
+
+    /**
+     * @brief Número de lecturas extraídas pendientes de compactar
+     * @return Posiciones muertas
+     */
+    int obtenerExtraidas() const { return extraidas; }
+
+private:
+    /**
+     * @brief Orden de los montículos: valor y, a igualdad, posición más antigua
+     */
+    static bool antes(const Entrada& a, const Entrada& b, bool esMenor) {
+        if (esMenor ? a.valor < b.valor : b.valor < a.valor) return true;
+        if (esMenor ? b.valor < a.valor : a.valor < b.valor) return false;
+        return a.posicion < b.posicion;
+    }
+
+    static void subir(Entrada* monticulo, int i, bool esMenor) {
+        Entrada entrada = monticulo[i];
+        while (i > 0) {
+            int padre = (i - 1) / 2;
+            if (!antes(entrada, monticulo[padre], esMenor)) break;
+            monticulo[i] = monticulo[padre];
+            i = padre;
+        }
+        monticulo[i] = entrada;
+    }
+
+    static void bajar(Entrada* monticulo, int cantidad, int i, bool esMenor) {
+        Entrada entrada = monticulo[i];
+        while (true) {
+            int hijo = 2 * i + 1;
+            if (hijo >= cantidad) break;
+            if (hijo + 1 < cantidad && antes(monticulo[hijo + 1], monticulo[hijo], esMenor)) {
+                hijo++;
+            }
+            if (!antes(monticulo[hijo], entrada, esMenor)) break;
+            monticulo[i] = monticulo[hijo];
+            i = hijo;
+        }
+        monticulo[i] = entrada;
+    }
+
+    static void quitarCima(Entrada* monticulo, int& cantidad, bool esMenor) {
+        cantidad--;
+        if (cantidad > 0) {
+            monticulo[0] = monticulo[cantidad];
+            bajar(monticulo, cantidad, 0, esMenor);
+        }
+    }
+
+    /**
+     * @brief Descarta entradas obsoletas de la cima
+     * @return true si la cima es una lectura viva
+     */
+    bool limpiarCima(Entrada* monticulo, int& cantidad, bool esMenor) {
+        while (cantidad > 0 && !vivo(monticulo[0].posicion)) {
+            quitarCima(monticulo, cantidad, esMenor);
+        }
+        return cantidad > 0;
+    }
+
+    bool extraer(Entrada* monticulo, int& cantidad, bool esMenor, T& valor) {
+        if (!limpiarCima(monticulo, cantidad, esMenor)) return false;
+
+        int posicion = monticulo[0].posicion;
+        valor = monticulo[0].valor;
+        vivos[posicion / 8] &= static_cast<unsigned char>(~(1u << (posicion % 8)));
+        extraidas++;
+        quitarCima(monticulo, cantidad, esMenor);
+        return true;
+    }
+
+    /**
+     * @brief Duplica la capacidad de montículos y mapa de bits
+     */
+    void crecer() {
+        int nuevaCapacidad = capacidad == 0 ? 64 : capacidad * 2;
+
+        Entrada* nuevosMenores = new Entrada[nuevaCapacidad];
+        Entrada* nuevosMayores = new Entrada[nuevaCapacidad];
+        unsigned char* nuevosVivos = new unsigned char[nuevaCapacidad / 8]();
+        for (int i = 0; i < numMenores; i++) nuevosMenores[i] = menores[i];
+        for (int i = 0; i < numMayores; i++) nuevosMayores[i] = mayores[i];
+        for (int i = 0; i < capacidad / 8; i++) nuevosVivos[i] = vivos[i];
+
+        delete[] menores;
+        delete[] mayores;
+        delete[] vivos;
+        menores = nuevosMenores;
+        mayores = nuevosMayores;
+        vivos = nuevosVivos;
+        capacidad = nuevaCapacidad;
+    }
+};
+
+#endif // INDICE_EXTREMOS_H
@@ -0,0 +1,115 @@
+/**
+ * @file IndiceSensores.h
+ * @brief Índice hash de direccionamiento abierto para el registro de sensores
+ * @details Asocia el nombre de cada sensor con su NodoGestion para que agregar, buscar
+ * y eliminar cuesten O(1) esperado en lugar de recorrer la lista de gestión.
+ */
+
+#ifndef INDICE_SENSORES_H
+#define INDICE_SENSORES_H
+
+struct NodoGestion;
+
+/**
+ * @class IndiceSensores
+ * @brief Tabla hash con sondeo lineal y borrado por desplazamiento hacia atrás
+ * @details Las claves son los nombres de los sensores (no se copian: se leen del sensor
+ * al comparar). La tabla crece al superar un factor de carga de 1/2, y el borrado no deja
+ * lápidas, así que las búsquedas no se degradan tras muchas eliminaciones.
+ */
+class IndiceSensores {
+public:
+    /**
+     * @brief Constructor - Tabla vacía
+     */
+    IndiceSensores();
+
+    /**
+     * @brief Destructor - Libera la tabla (no los nodos)
+     */
+    ~IndiceSensores();
+
+    IndiceSensores(const IndiceSensores&) = delete;
+    IndiceSensores& operator=(const IndiceSensores&) = delete;
+
+    /**
+     * @brief Indexa un nodo por el nombre de su sensor
+     * @param nodo Nodo de gestión cuyo sensor da la clave
+     * @return false si ya existe un sensor con ese nombre
+     */
+    bool insertar(NodoGestion* nodo);
+
+    /**
+     * @brief Busca el nodo de un sensor
+     * @param nombre Identificador del sensor
+     * @return Nodo encontrado o nullptr
+     */
+    NodoGestion* buscar(const char* nombre) const;
+
+    /**
+     * @brief Busca el nodo de un sensor a partir de un nombre no terminado en '\0'
+     * @param nombre Primer carácter del identificador (p. ej. dentro de un búfer de entrada)
+     * @param longitud Número de caracteres del identificador
+     * @return Nodo encontrado o nullptr
+     */
+    NodoGestion* buscar(const char* nombre, int longitud) const;
+
+    /**
+     * @brief Quita un sensor del índice
+     * @param nombre Identificador del sensor
+     * @return Nodo que estaba indexado o nullptr si no existía
+     */
+    NodoGestion* eliminar(const char* nombre);
+
+    /**
+     * @brief Vacía el índice conservando la tabla reservada
+     */
+    void vaciar();
+
+    /**
+     * @brief Número de sensores indexados
+     * @return Cantidad de entradas
+     */
+    int obtenerCantidad() const;
+
+    /**
+     * @brief Hash FNV-1a de un nombre
+     * @param nombre Cadena terminada en '\0'
+     * @return Valor hash de 32 bits
+     */
+    static unsigned int hashNombre(const char* nombre);
+
+    /**
+     * @brief Hash FNV-1a de los primeros caracteres de un nombre
+     * @param nombre Primer carácter
+     * @param longitud Número de caracteres
+     * @return Valor hash de 32 bits (igual al de la cadena terminada equivalente)
+     */
+    static unsigned int hashNombre(const char* nombre, int longitud);
+
+private:
+    /**
+     * @brief Ranura de la tabla
+     */
+    struct Ranura {
+        unsigned int hash;  ///< Hash del nombre (evita strcmp en la mayoría de colisiones)
+        NodoGestion* nodo;  ///< Nodo indexado (nullptr = ranura libre)
+    };
+
+    Ranura* ranuras;  ///< Tabla de ranuras
+    int capacidad;    ///< Número de ranuras (potencia de 2)
+    int cantidad;     ///< Ranuras ocupadas
+
+    /**
+     * @brief Posición de la ranura con ese nombre
+     * @return Índice de la ranura o -1 si no está
+     */
+    int localizar(const char* nombre, int longitud, unsigned int hash) const;
+
+    /**
+     * @brief Duplica la tabla y reubica las entradas
+     */
+    void crecer();
+};
+
+#endif // INDICE_SENSORES_H
@@ -0,0 +1,360 @@
+/**
+ * @file IngestaLecturas.h
+ * @brief Ingesta en flujo de las lecturas "TIPO|ID|VALOR" hacia SistemaGestion
+ * @details Lee de un puerto serie, una pty, un archivo o stdin, analiza las líneas sin
+ * copiarlas (ProtocoloTexto) y despacha las lecturas por lotes al sensor correspondiente.
+ */
+
+#ifndef INGESTA_LECTURAS_H
+#define INGESTA_LECTURAS_H
+
+#include "ProtocoloTexto.h"
+#include "ProtocoloBinario.h"
+#include "HistorialCircular.h"
+#include <cstddef>
+#include <cstring>
+
+class SistemaGestion;
+class SistemaFragmentado;
+class SensorBase;
+class MotorReglas;
+class PlanificadorSensores;
+
+/**
+ * @brief Contadores de una sesión de ingesta
+ */
+struct EstadisticasIngesta {
+    long long lineas;           ///< Líneas completas leídas
+    long long lecturas;         ///< Lecturas registradas en algún sensor
+    long long ignoradas;        ///< Cabeceras, ecos y líneas vacías
+    long long invalidas;        ///< Lecturas mal formadas o líneas demasiado largas
+    long long descartadas;      ///< Lecturas sin sensor destino o de tipo incompatible
+    long long sensoresCreados;  ///< Sensores registrados automáticamente
+    long long tramas;           ///< Tramas binarias válidas
+    long long tramasInvalidas;  ///< Tramas binarias con cabecera o CRC incorrectos, o truncadas
+
+    EstadisticasIngesta()
+        : lineas(0), lecturas(0), ignoradas(0), invalidas(0), descartadas(0), sensoresCreados(0),
+          tramas(0), tramasInvalidas(0) {}
+};
+
+/**
+ * @class IngestaLecturas
+ * @brief Tubería de lectura, análisis y despacho por lotes
+ * @details Usa un único búfer reservado al construirse; las líneas se analizan en el
+ * propio búfer y las lecturas se acumulan en un lote fijo de TAM_LOTE antes de
+ * despacharse, de modo que el camino caliente no reserva memoria.
+ */
+class IngestaLecturas {
+public:
+    static const int TAM_LOTE = 256;                  ///< Lecturas por lote de despacho
+    static const std::size_t TAM_BUFER = 64 * 1024;   ///< Bytes del búfer de lectura
+
+    /**
+     * @brief Constructor
+     * @param sistema Sistema de gestión que recibe las lecturas
+     */
+    explicit IngestaLecturas(SistemaGestion& sistema);
+
+    /**
+     * @brief Constructor para un sistema fragmentado
+     * @param fragmentos Sistema que reparte las lecturas entre sus fragmentos
+     * @details Las lecturas de cada lote se envían al fragmento dueño de su sensor, que
+     * las registra (y crea los sensores) en su propio hilo; por eso lecturas, descartadas
+     * y sensoresCreados se cuentan en SistemaFragmentado::obtenerEstadisticas() y no aquí.
+     * fijarCrearDesconocidos(), fijarSegmentos(), fijarReglas(), fijarIndiceExtremos(),
+     * fijarRetencion() y fijarResumenes() se aplican a los fragmentos
+     */
+    explicit IngestaLecturas(SistemaFragmentado& fragmentos);
+
+    /**
+     * @brief Destructor - Cierra la fuente y libera el búfer
+     */
+    ~IngestaLecturas();
+
+    IngestaLecturas(const IngestaLecturas&) = delete;
+    IngestaLecturas& operator=(const IngestaLecturas&) = delete;
+
+    /**
+     * @brief Registra automáticamente los sensores desconocidos (activo por defecto)
+     * @param crear true para crear SensorTemperatura/SensorPresion según el tipo de línea
+     */
+    void fijarCrearDesconocidos(bool crear);
+
+    /**
+     * @brief Entrega las lecturas por la cola de cada sensor en lugar de insertarlas
+     * @param cola true para usar encolarLectura() (varias ingestas en paralelo)
+     * @details En este modo los sensores deben estar registrados y con activarCola()
+     * antes de empezar: no se crean sensores desconocidos, porque el registro no admite
+     * cambios concurrentes. Las lecturas a una cola llena cuentan como descartadas
+     */
+    void fijarModoCola(bool cola);
+
+    /**
+     * @brief Envía a segmentos en disco las lecturas antiguas de los sensores que se creen
+     * @param directorio Directorio de los archivos de segmentos (nullptr = solo memoria)
+     * @param lecturasEnMemoria Lecturas que cada sensor mantiene en memoria
+     * @details Se aplica a los sensores desconocidos registrados durante la ingesta;
+     * para los ya registrados, usar fijarSegmentos() en cada sensor
+     */
+    void fijarSegmentos(const char* directorio, int lecturasEnMemoria = 65536);
+
+    /**
+     * @brief Evalúa reglas de alerta en los sensores que se creen
+     * @param motor Motor con las reglas compiladas (nullptr = ninguno)
+     * @details Como fijarSegmentos(), solo afecta a los sensores registrados durante la ingesta
+     */
+    void fijarReglas(MotorReglas* motor);
+
+    /**
+     * @brief Indexa los extremos de los sensores de temperatura que se creen
+     * @param activo true para llamar a SensorTemperatura::activarIndiceExtremos() en ellos
+     * @details Como fijarSegmentos(), solo afecta a los sensores registrados durante la ingesta
+     */
+    void fijarIndiceExtremos(bool activo);
+
+    /**
+     * @brief Acota el historial de los sensores que se creen
+     * @param politica Capacidad, edad máxima y submuestreo (capacidad 0 = sin acotar)
+     * @details Como fijarSegmentos(), solo afecta a los sensores registrados durante la
+     * ingesta; incompatible con los segmentos, que ya limitan la memoria
+     */
+    void fijarRetencion(const PoliticaRetencion& politica);
+
+    /**
+     * @brief Mantiene resúmenes por ventana de tiempo en los sensores que se creen
+     * @param activo true para llamar a activarResumenes() con la política por defecto
+     * @details Como fijarSegmentos(), solo afecta a los sensores registrados durante la ingesta
+     */
+    void fijarResumenes(bool activo);
+
+    /**
+     * @brief Programa el procesamiento periódico de los sensores que se creen
+     * @param planificador Rueda en la que programarlos (nullptr = ninguna); debe seguir
+     * válida mientras vivan los sensores
+     * @param periodoTemperatura Ticks entre procesamientos de un sensor de temperatura (0 = no programarlos)
+     * @param periodoPresion Ticks entre procesamientos de un sensor de presión (0 = no programarlos)
+     * @details El primer vencimiento se reparte dentro del periodo para que los sensores
+     * creados juntos no venzan en el mismo tick. Sin efecto con fragmentos: el planificador
+     * no es seguro entre hilos y los sensores se crean en los de los fragmentos
+     */
+    void fijarPlanificador(PlanificadorSensores* planificador, unsigned periodoTemperatura, unsigned periodoPresion);
+
+    /**
+     * @brief Acepta tramas del protocolo binario intercaladas con el texto
+     * @param activo true para separar las tramas (ProtocoloBinario) del texto, que sigue
+     * admitiéndose como respaldo; false para el camino de solo texto, sin copias
+     */
+    void fijarProtocoloBinario(bool activo);
+
+    /**
+     * @brief Indica si se aceptan tramas binarias
+     * @return true tras fijarProtocoloBinario(true)
+     */
+    bool protocoloBinario() const;
+
+    /**
+     * @brief Abre la fuente de lecturas
+     * @param ruta Dispositivo serie, pty o archivo; "-" para stdin
+     * @return false si no se pudo abrir
+     * @details Si la fuente es un terminal se configura en modo crudo a 115200 baudios
+     */
+    bool abrir(const char* ruta);
+
+    /**
+     * @brief Cierra la fuente (no cierra stdin)
+     */
+    void cerrar();
+
+    /**
+     * @brief Lee y despacha hasta fin de archivo o error
+     * @return false si la lectura terminó por un error
+     */
+    bool procesarFuente();
+
+    /**
+     * @brief Consume un bloque de bytes ya en memoria (p. ej. de otra fuente)
+     * @param datos Bytes del flujo de texto
+     * @param longitud Número de bytes
+     * @details Las líneas completas se analizan directamente sobre datos; solo una
+     * línea partida al final se copia al búfer interno hasta recibir su '\n'
+     */
+    void consumir(const char* datos, std::size_t longitud);
+
+    /**
+     * @brief Procesa la línea final sin '\n' pendiente y despacha el lote
+     */
+    void finalizar();
+
+    /**
+     * @brief Analiza líneas completas sin despachar el lote al terminar
+     * @param datos Bytes formados solo por líneas terminadas en '\n'
+     * @param longitud Número de bytes
+     * @details Para quien gestiona las líneas partidas por su cuenta (ServidorIngesta):
+     * las lecturas pueden quedar en el lote apuntando a datos, que debe seguir válido
+     * hasta la siguiente llamada a despacharLote()
+     */
+    void acumularLineas(const char* datos, std::size_t longitud);
+
+    /**
+     * @brief Separa las tramas binarias del texto de un bloque de uno de varios flujos
+     * @tparam Texto Destino del texto con consumirTexto(datos, longitud) y
+     * descartarLineaPartida() (true si había una línea partida)
+     * @param enCurso Trama en curso del flujo
+     * @param datos Bytes recibidos
+     * @param longitud Número de bytes
+     * @param texto Destino del texto del flujo, que guarda su propia línea partida
+     * @details Para quien atiende varios flujos (ServidorIngesta). Las tramas válidas se
+     * despachan al momento junto con lo que hubiera en el lote; el texto que se reexamina
+     * tras una trama corrupta llega desde enCurso.bytes, que se sobrescribe al volver
+     */
+    template <typename Texto>
+    void demultiplexar(TramaEnCurso& enCurso, const char* datos, std::size_t longitud, Texto& texto);
+
+    /**
+     * @brief Descarta la trama cortada al cerrarse un flujo (cuenta como inválida)
+     * @param enCurso Trama en curso del flujo
+     */
+    void descartarTrama(TramaEnCurso& enCurso);
+
+    /**
+     * @brief Entrega el lote a los sensores y lo vacía
+     * @details Debe llamarse antes de reutilizar la memoria a la que apunta el lote
+     */
+    void despacharLote();
+
+    /**
+     * @brief Despacha lecturas ya analizadas por otro (p. ej. el hilo de un fragmento)
+     * @param lecturas Lecturas cuyos identificadores siguen válidos durante la llamada
+     * @param n Número de lecturas
+     */
+    void entregarLecturas(const LecturaTexto* lecturas, int n);
+
+    /**
+     * @brief Configura un terminal serie en modo crudo a 115200 baudios (8N1)
+     * @param descriptor Descriptor abierto del terminal
+     * @return false si no se pudo configurar
+     */
+    static bool configurarSerial(int descriptor);
+
+    /**
+     * @brief Contadores acumulados
+     * @return Estadísticas de la sesión
+     */
+    const EstadisticasIngesta& obtenerEstadisticas() const;
+
+private:
+    SistemaGestion* sistema;       ///< Destino de las lecturas (nullptr si se fragmenta)
+    SistemaFragmentado* fragmentos;  ///< Reparto por fragmentos (nullptr = sistema)
+    int descriptor;                ///< Descriptor de la fuente (-1 = cerrada)
+    bool propio;                   ///< true si el descriptor debe cerrarse
+    bool crearDesconocidos;        ///< Crear sensores no registrados
+    bool modoCola;                 ///< Entregar por ColaLecturas (encolarLectura)
+    const char* dirSegmentos;      ///< Directorio de segmentos de los sensores creados (nullptr = ninguno)
+    int lecturasEnMemoria;         ///< Límite en memoria de los sensores con segmentos
+    MotorReglas* reglas;           ///< Reglas de los sensores creados (nullptr = ninguna)
+    bool indiceExtremos;           ///< Indexar los extremos de los sensores de temperatura creados
+    PoliticaRetencion retencion;   ///< Retención de los sensores creados (capacidad 0 = sin acotar)
+    bool resumenes;                ///< Resúmenes temporales en los sensores creados
+    PlanificadorSensores* planificador;  ///< Rueda de los sensores creados (nullptr = ninguna)
+    unsigned periodoTemperatura;   ///< Ticks entre procesamientos de los de temperatura
+    unsigned periodoPresion;       ///< Ticks entre procesamientos de los de presión
+    char* bufer;                   ///< Búfer de lectura y de línea partida
+    std::size_t pendiente;         ///< Bytes de una línea incompleta al inicio del búfer
+    bool descartandoLinea;         ///< Se está saltando una línea mayor que el búfer
+    char* entrada;                 ///< Búfer de lectura con protocolo binario (nullptr = solo texto)
+    TramaEnCurso trama;            ///< Trama binaria en curso de la fuente
+    LecturaTexto lote[TAM_LOTE];   ///< Lecturas analizadas pendientes de despacho
+    int enLote;                    ///< Lecturas en el lote
+    EstadisticasIngesta estadisticas;  ///< Contadores
+
+    /**
+     * @brief Analiza las líneas completas de un bloque
+     * @return Bytes consumidos (hasta el último '\n' inclusive)
+     */
+    std::size_t analizarLineas(const char* datos, std::size_t longitud);
+
+    /**
+     * @brief Analiza una línea y la añade al lote si es una lectura
+     */
+    void analizarUna(const char* inicio, const char* fin);
+
+    /**
+     * @brief Consume texto: líneas completas en su sitio, la partida en el búfer
+     */
+    void consumirTexto(const char* datos, std::size_t longitud);
+
+    /**
+     * @brief Olvida la línea partida de la fuente (destino de texto de demultiplexar())
+     * @return true si había una
+     */
+    bool descartarLineaPartida();
+
+    /**
+     * @brief Despacha las lecturas de una trama como un lote
+     */
+    void entregarTrama(const TramaBinaria& t);
+
+    /**
+     * @brief Entrega lecturas a sus sensores y actualiza los contadores
+     */
+    void despachar(const LecturaTexto* lecturas, int n);
+
+    /**
+     * @brief Localiza (o crea) el sensor destino de una lectura
+     * @return Sensor o nullptr si no existe y no se crean desconocidos
+     */
+    SensorBase* resolverSensor(const LecturaTexto& lectura);
+};
+
+template <typename Texto>
+void IngestaLecturas::demultiplexar(TramaEnCurso& enCurso, const char* datos, std::size_t longitud, Texto& texto) {
+    while (true) {
+        if (enCurso.cantidad == 0) {
+            // Texto hasta el siguiente byte de sincronía, sin copiarlo
+            const char* sincronia = static_cast<const char*>(memchr(datos, SINCRONIA_TRAMA_0, longitud));
+            std::size_t bytesTexto = sincronia != nullptr ? static_cast<std::size_t>(sincronia - datos) : longitud;
+            if (bytesTexto > 0) texto.consumirTexto(datos, bytesTexto);
+            if (sincronia == nullptr) return;
+            datos += bytesTexto;
+            longitud -= bytesTexto;
+        }
+
+        // Completar la trama en curso
+        std::size_t copiar = longitud < TAM_MAX_TRAMA - enCurso.cantidad ? longitud : TAM_MAX_TRAMA - enCurso.cantidad;
+        memcpy(enCurso.bytes + enCurso.cantidad, datos, copiar);
+        enCurso.cantidad += copiar;
+        datos += copiar;
+        longitud -= copiar;
+
+        TramaBinaria t;
+        std::size_t bytes = 0;
+        ResultadoTrama resultado = analizarTrama(enCurso.bytes, enCurso.cantidad, t, bytes);
+        if (resultado == TRAMA_INCOMPLETA) return;
+        if (resultado == TRAMA_VALIDA) {
+            estadisticas.tramas++;
+            // El emisor no parte líneas con tramas: lo pendiente era ruido previo a la trama
+            if (texto.descartarLineaPartida()) estadisticas.invalidas++;
+            entregarTrama(t);
+        } else {
+            // Resincronizar: el byte de sincronía pasa como texto y se busca desde el siguiente
+            if (enCurso.cantidad >= 2 && enCurso.bytes[1] == SINCRONIA_TRAMA_1) estadisticas.tramasInvalidas++;
+            bytes = 1;
+            texto.consumirTexto(reinterpret_cast<const char*>(enCurso.bytes), 1);
+        }
+
+        // Lo que sobra de la trama se vuelve a examinar: texto hasta la próxima sincronía
+        enCurso.cantidad -= bytes;
+        memmove(enCurso.bytes, enCurso.bytes + bytes, enCurso.cantidad);
+        while (enCurso.cantidad > 0 && enCurso.bytes[0] != SINCRONIA_TRAMA_0) {
+            const uint8_t* sincronia = static_cast<const uint8_t*>(memchr(enCurso.bytes, SINCRONIA_TRAMA_0, enCurso.cantidad));
+            std::size_t bytesTexto = sincronia != nullptr ? static_cast<std::size_t>(sincronia - enCurso.bytes) : enCurso.cantidad;
+            texto.consumirTexto(reinterpret_cast<const char*>(enCurso.bytes), bytesTexto);
+            enCurso.cantidad -= bytesTexto;
+            memmove(enCurso.bytes, enCurso.bytes + bytesTexto, enCurso.cantidad);
+        }
+        if (enCurso.cantidad == 0 && longitud == 0) return;
+    }
+}
+
+#endif // INGESTA_LECTURAS_H
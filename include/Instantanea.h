@@ -0,0 +1,51 @@
+/**
+ * @file Instantanea.h
+ * @brief Instantánea binaria del registro y de los historiales de todos los sensores
+ * @details Se escribe de forma secuencial y se restaura con mmap: las lecturas se copian
+ * por bloques desde las páginas mapeadas a los nodos, sin análisis ni lecturas
+ * intermedias. Cada registro lleva un CRC-32C y se verifica todo el archivo antes de
+ * modificar el sistema, así que una instantánea dañada no deja una restauración a medias.
+ *
+ * Formato (little-endian, cada sección alineada a 8 bytes):
+ * - CabeceraArchivo: "IOTSNAP1", versión, número de sensores, CRC de la cabecera
+ * - Por sensor: CabeceraSensor (tipo, longitud del nombre, lecturas, CRC de la
+ *   cabecera), nombre, lecturas (float o int de 4 bytes) y PieSensor (CRC del nombre
+ *   y las lecturas)
+ * - PieArchivo: "IOTSNEND" y tamaño total, para detectar archivos truncados
+ */
+
+#ifndef INSTANTANEA_H
+#define INSTANTANEA_H
+
+class SistemaGestion;
+
+/**
+ * @class Instantanea
+ * @brief Guardado y restauración de un SistemaGestion completo
+ * @details No se guardan las políticas de retención ni las lecturas aún encoladas
+ * (ColaLecturas): la instantánea debe tomarse sin ingesta en curso
+ */
+class Instantanea {
+public:
+    static const unsigned VERSION = 1;  ///< Versión del formato
+
+    /**
+     * @brief Escribe la instantánea de todos los sensores
+     * @param sistema Sistema a guardar
+     * @param ruta Archivo destino; se escribe en "<ruta>.tmp" y se renombra al terminar
+     * @return false si hubo un error de E/S (el archivo anterior no se modifica)
+     */
+    static bool guardar(const SistemaGestion& sistema, const char* ruta);
+
+    /**
+     * @brief Restaura los sensores de una instantánea
+     * @param sistema Sistema destino; los sensores existentes con el mismo nombre y tipo
+     * reciben las lecturas al final de su historial
+     * @param ruta Archivo de instantánea
+     * @return false si el archivo no existe, está truncado o algún CRC no coincide
+     * (en ese caso el sistema no se modifica)
+     */
+    static bool restaurar(SistemaGestion& sistema, const char* ruta);
+};
+
+#endif // INSTANTANEA_H
@@ -0,0 +1,111 @@
+/**
+ * @file KernelsLectura.h
+ * @brief Kernels de reducción sobre bloques contiguos de lecturas
+ * @details Suma, suma de cuadrados, posición del mínimo/máximo y búsqueda por igualdad.
+ * Para float e int se usan versiones vectoriales (SSE2 siempre en x86-64, AVX2 si la CPU
+ * lo soporta, elegido en tiempo de ejecución); el resto de tipos usa la versión escalar.
+ * La opción de CMake SISTEMA_IOT_SIMD=OFF fuerza la versión escalar en todos los casos.
+ */
+
+#ifndef KERNELS_LECTURA_H
+#define KERNELS_LECTURA_H
+
+#include "EstadisticasLectura.h"
+
+/**
+ * @class KernelsSimd
+ * @brief Implementaciones vectoriales para float e int
+ * @details Mínimo/máximo devuelven la primera posición en caso de empate, igual que el
+ * recorrido escalar. Las sumas de float se acumulan en double.
+ */
+class KernelsSimd {
+public:
+    static double sumar(const float* datos, int n);
+    static long long sumar(const int* datos, int n);
+    static double sumarCuadrados(const float* datos, int n);
+    static double sumarCuadrados(const int* datos, int n);
+    static int posicionMinimo(const float* datos, int n);
+    static int posicionMinimo(const int* datos, int n);
+    static int posicionMaximo(const float* datos, int n);
+    static int posicionMaximo(const int* datos, int n);
+    static int buscar(const float* datos, int n, float valor);
+    static int buscar(const int* datos, int n, int valor);
+
+    /**
+     * @brief Nombre de la implementación elegida ("avx2", "sse2" o "escalar")
+     */
+    static const char* implementacion();
+};
+
+/**
+ * @brief Kernels genéricos (escalares) para cualquier tipo de lectura
+ * @tparam T Tipo de lectura
+ */
+template <typename T>
+struct KernelsLectura {
+    typedef typename AcumuladorLectura<T>::tipo Acumulador;
+
+    static Acumulador sumar(const T* datos, int n) {
+        Acumulador suma = Acumulador();
+        for (int i = 0; i < n; i++) suma += static_cast<Acumulador>(datos[i]);
+        return suma;
+    }
+
+    static double sumarCuadrados(const T* datos, int n) {
+        double suma = 0.0;
+        for (int i = 0; i < n; i++) {
+            double x = static_cast<double>(datos[i]);
+            suma += x * x;
+        }
+        return suma;
+    }
+
+    static int posicionMinimo(const T* datos, int n) {
+        int posicion = 0;
+        for (int i = 1; i < n; i++) {
+            if (datos[i] < datos[posicion]) posicion = i;
+        }
+        return posicion;
+    }
+
+    static int posicionMaximo(const T* datos, int n) {
+        int posicion = 0;
+        for (int i = 1; i < n; i++) {
+            if (datos[posicion] < datos[i]) posicion = i;
+        }
+        return posicion;
+    }
+
+    static int buscar(const T* datos, int n, T valor) {
+        for (int i = 0; i < n; i++) {
+            if (datos[i] == valor) return i;
+        }
+        return -1;
+    }
+};
+
+/**
+ * @brief Especialización vectorial para lecturas de temperatura
+ */
+template <>
+struct KernelsLectura<float> {
+    static double sumar(const float* datos, int n) { return KernelsSimd::sumar(datos, n); }
+    static double sumarCuadrados(const float* datos, int n) { return KernelsSimd::sumarCuadrados(datos, n); }
+    static int posicionMinimo(const float* datos, int n) { return KernelsSimd::posicionMinimo(datos, n); }
+    static int posicionMaximo(const float* datos, int n) { return KernelsSimd::posicionMaximo(datos, n); }
+    static int buscar(const float* datos, int n, float valor) { return KernelsSimd::buscar(datos, n, valor); }
+};
+
+/**
+ * @brief Especialización vectorial para lecturas de presión
+ */
+template <>
+struct KernelsLectura<int> {
+    static long long sumar(const int* datos, int n) { return KernelsSimd::sumar(datos, n); }
+    static double sumarCuadrados(const int* datos, int n) { return KernelsSimd::sumarCuadrados(datos, n); }
+    static int posicionMinimo(const int* datos, int n) { return KernelsSimd::posicionMinimo(datos, n); }
+    static int posicionMaximo(const int* datos, int n) { return KernelsSimd::posicionMaximo(datos, n); }
+    static int buscar(const int* datos, int n, int valor) { return KernelsSimd::buscar(datos, n, valor); }
+};
+
+#endif // KERNELS_LECTURA_H
@@ -1,272 +1,997 @@
 /**
  * @file ListaSensor.h
  * @brief Implementación de Lista Enlazada Simple Genérica para sensores IoT
- * @details Template que permite almacenar lecturas de cualquier tipo (int, float, double)
+ * @details Template que permite almacenar lecturas de cualquier tipo (int, float, double).
+ * Cada nodo guarda un bloque contiguo de hasta N lecturas (lista "desenrollada"):
+ * con N = 1 se comporta como la lista enlazada clásica de un dato por nodo.
  */
 
 #ifndef LISTA_SENSOR_H
 #define LISTA_SENSOR_H
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <type_traits>
+#include <utility>
+#include "ArenaMemoria.h"
+#include "EstadisticasLectura.h"
+#include "IndiceExtremos.h"
+#include "KernelsLectura.h"
+#include "Registro.h"
+
+/**
+ * @brief Número de lecturas por nodo usado por los historiales de los sensores
+ * @details 32 lecturas de 4 bytes ocupan dos líneas de caché por nodo
+ */
+const int TAM_BLOQUE_LECTURAS = 32;
 
 /**
  * @brief Estructura de nodo genérico para lista enlazada
  * @tparam T Tipo de dato a almacenar (int, float, double, etc.)
+ * @tparam N Capacidad del bloque de lecturas del nodo
  */
-template <typename T>
+template <typename T, int N = 1>
 struct Nodo {
-    T dato;              ///< Valor almacenado en el nodo
-    Nodo<T>* siguiente;  ///< Puntero al siguiente nodo
-    
+    T datos[N];             ///< Bloque contiguo de valores almacenados
+    int cantidad;           ///< Número de posiciones ocupadas en el bloque
+    Nodo<T, N>* siguiente;  ///< Puntero al siguiente nodo
+
     /**
      * @brief Constructor del nodo
-     * @param valor Valor a almacenar en el nodo
+     * @param valor Primer valor a almacenar en el bloque
      */
-    Nodo(T valor) : dato(valor), siguiente(nullptr) {}
+    Nodo(T valor) : cantidad(1), siguiente(nullptr) {
+        datos[0] = valor;
+    }
 };
 
 /**
  * @brief Lista Enlazada Simple Genérica para gestionar lecturas de sensores
  * @tparam T Tipo de dato de las lecturas
- * @details Implementa la Regla de los Tres (Destructor, Constructor de Copia, Operador de Asignación)
+ * @tparam N Lecturas por nodo (1 = un nodo por lectura)
+ * @details Implementa la Regla de los Cinco: la copia es lineal (bloque a bloque) y el
+ * movimiento solo transfiere punteros, junto con el pool dueño de los nodos.
+ * Los nodos se toman de un PoolNodos: propio de la lista (liberación masiva al destruirla)
+ * o sobre una ArenaMemoria compartida, p. ej. la de SistemaGestion.
+ * Las lecturas conservan el orden de inserción; los recorridos avanzan sobre
+ * bloques contiguos y solo siguen un puntero cada N elementos.
+ * Con activarIndice(), eliminarMenor/eliminarMayor usan un IndiceExtremos en O(log n)
+ * amortizado: las lecturas extraídas quedan marcadas y se compactan en bloque.
  */
-template <typename T>
+template <typename T, int N = 1>
 class ListaSensor {
+    static_assert(N > 0, "El bloque debe tener al menos una lectura");
+
 private:
-    Nodo<T>* cabeza;  ///< Puntero al primer nodo de la lista
-    int tamanio;      ///< Número de elementos en la lista
+    Nodo<T, N>* cabeza;  ///< Puntero al primer nodo de la lista
+    Nodo<T, N>* cola;    ///< Puntero al último nodo (inserción en O(1))
+    int tamanio;         ///< Número de elementos en la lista
+    PoolNodos<Nodo<T, N> > pool;  ///< Pool del que se toman los nodos
+    mutable EstadisticasLectura<T> estadisticas;  ///< Agregados mantenidos en cada inserción/eliminación
+    IndiceExtremos<T>* indice;  ///< Índice opcional de extremos (nullptr = desactivado)
 
 public:
     /**
-     * @brief Constructor por defecto
+     * @brief Constructor
+     * @param arena Arena compartida para los nodos; nullptr usa un pool propio
      */
-    ListaSensor();
-    
+    explicit ListaSensor(ArenaMemoria* arena = nullptr);
+
     /**
      * @brief Destructor - Libera toda la memoria de los nodos
      */
     ~ListaSensor();
-    
+
     /**
-     * @brief Constructor de copia (Regla de los Tres)
+     * @brief Constructor de copia (Regla de los Cinco)
      * @param otra Lista a copiar
+     * @details O(n): copia bloque a bloque. La copia usa la misma arena que otra si esta
+     * es compartida
      */
-    ListaSensor(const ListaSensor<T>& otra);
-    
+    ListaSensor(const ListaSensor<T, N>& otra);
+
     /**
-     * @brief Operador de asignación (Regla de los Tres)
+     * @brief Operador de asignación (Regla de los Cinco)
      * @param otra Lista a asignar
      * @return Referencia a esta lista
      */
-    ListaSensor<T>& operator=(const ListaSensor<T>& otra);
-    
+    ListaSensor<T, N>& operator=(const ListaSensor<T, N>& otra);
+
+    /**
+     * @brief Constructor de movimiento (Regla de los Cinco)
+     * @param otra Lista cuyos nodos, agregados e índice pasan a esta; queda vacía y sin índice
+     */
+    ListaSensor(ListaSensor<T, N>&& otra) noexcept;
+
+    /**
+     * @brief Asignación por movimiento (Regla de los Cinco)
+     * @param otra Lista cuyos nodos pasan a esta; queda vacía y sin índice
+     * @return Referencia a esta lista
+     */
+    ListaSensor<T, N>& operator=(ListaSensor<T, N>&& otra) noexcept;
+
+    /**
+     * @brief Intercambia el contenido con otra lista en O(1)
+     * @param otra Lista con la que intercambiar (nodos, pools, agregados e índices)
+     */
+    void intercambiar(ListaSensor<T, N>& otra) noexcept;
+
+    /**
+     * @brief Mueve todas las lecturas de otra al final de esta (splice)
+     * @param otra Lista que queda vacía
+     * @details O(1) reenlazando los nodos si esta lista está vacía o ambas comparten la
+     * misma arena; si no, los nodos no pueden cambiar de dueño y se copian por bloques.
+     * Con el índice activo, las lecturas recibidas se indexan en O(m log n)
+     */
+    void empalmar(ListaSensor<T, N>& otra);
+
+    /**
+     * @brief Fusiona dos listas ordenadas en una sola ordenada (merge)
+     * @param otra Lista ordenada según menor; queda vacía
+     * @param menor Comparador de orden estricto
+     * @details O(n + m), estable (en empate van primero las lecturas de esta lista).
+     * Reserva un nodo por bloque de N lecturas, no uno por lectura
+     */
+    template <typename Comparador>
+    void fusionar(ListaSensor<T, N>& otra, Comparador menor);
+
+    /**
+     * @brief Fusiona dos listas ordenadas de menor a mayor
+     * @param otra Lista ordenada; queda vacía
+     */
+    void fusionar(ListaSensor<T, N>& otra) { fusionar(otra, std::less<T>()); }
+
     /**
      * @brief Inserta un elemento al final de la lista
      * @param valor Valor a insertar
+     * @details Solo reserva un nodo nuevo cuando el bloque de la cola está lleno
      */
     void insertar(T valor);
-    
+
+    /**
+     * @brief Inserta al final un arreglo de lecturas
+     * @param datos Lecturas en orden
+     * @param n Número de lecturas
+     * @details Copia bloques enteros en los nodos y calcula los agregados del arreglo
+     * con los kernels vectoriales, sin trabajo por lectura (p. ej. al restaurar)
+     */
+    void insertarBloque(const T* datos, int n);
+
     /**
      * @brief Busca un valor en la lista
      * @param valor Valor a buscar
      * @return true si se encuentra, false en caso contrario
      */
     bool buscar(T valor) const;
-    
+
     /**
      * @brief Calcula el promedio de todos los elementos
      * @return Promedio de los valores (retorna 0 si la lista está vacía)
+     * @details O(1): usa la suma mantenida incrementalmente (acumulador ancho)
      */
     T calcularPromedio() const;
-    
+
+    /**
+     * @brief Varianza poblacional de las lecturas
+     * @return Varianza (0 con menos de dos lecturas)
+     */
+    double calcularVarianza() const;
+
+    /**
+     * @brief Obtiene el valor más bajo de la lista
+     * @return Mínimo (T() si la lista está vacía)
+     * @details O(1) salvo justo después de eliminar el extremo, que obliga a un recorrido
+     */
+    T obtenerMinimo() const;
+
+    /**
+     * @brief Obtiene el valor más alto de la lista
+     * @return Máximo (T() si la lista está vacía)
+     * @details O(1) salvo justo después de eliminar el extremo, que obliga a un recorrido
+     */
+    T obtenerMaximo() const;
+
+    /**
+     * @brief Agregados actuales de la lista (extremos al día)
+     * @return Estadísticas para combinarlas con las de otras lecturas
+     */
+    const EstadisticasLectura<T>& obtenerEstadisticas() const;
+
+    /**
+     * @brief Recalcula todos los agregados con un recorrido completo
+     * @details Usa los kernels vectoriales sobre cada bloque; pensado para reagregar
+     * historiales completos (p. ej. tras restaurar) o corregir deriva numérica
+     */
+    void recalcularEstadisticas();
+
     /**
      * @brief Encuentra y elimina el valor más bajo de la lista
      * @return El valor más bajo eliminado (retorna T() si la lista está vacía)
      */
     T eliminarMenor();
-    
+
+    /**
+     * @brief Encuentra y elimina el valor más alto de la lista
+     * @return El valor más alto eliminado (retorna T() si la lista está vacía)
+     */
+    T eliminarMayor();
+
+    /**
+     * @brief Activa el índice de extremos para eliminarMenor/eliminarMayor en O(log n)
+     * @details Indexa las lecturas actuales en O(n); a partir de aquí cada inserción también
+     * actualiza el índice en O(log n)
+     */
+    void activarIndice();
+
+    /**
+     * @brief Indica si el índice de extremos está activo
+     * @return true si eliminarMenor/eliminarMayor son logarítmicos
+     */
+    bool indiceActivo() const;
+
     /**
      * @brief Obtiene el tamaño actual de la lista
      * @return Número de elementos
      */
     int obtenerTamanio() const;
-    
+
     /**
      * @brief Muestra todos los elementos de la lista
      */
     void mostrar() const;
-    
+
     /**
      * @brief Verifica si la lista está vacía
      * @return true si está vacía, false en caso contrario
      */
     bool estaVacia() const;
 
+    /**
+     * @brief Visita las lecturas en orden de inserción
+     * @param visitar Función llamada con cada valor
+     */
+    template <typename F>
+    void recorrer(F visitar) const {
+        int posicion = 0;
+        for (Nodo<T, N>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            for (int i = 0; i < actual->cantidad; i++, posicion++) {
+                if (lecturaVisible(posicion)) visitar(actual->datos[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Elimina todas las lecturas
+     */
+    void vaciar();
+
+    /**
+     * @brief Copia las lecturas más antiguas
+     * @param destino Arreglo de al menos n lecturas
+     * @param n Lecturas a copiar
+     * @return Lecturas copiadas (menos de n si la lista es más corta)
+     */
+    int copiarPrimeros(T* destino, int n) const;
+
+    /**
+     * @brief Elimina las lecturas más antiguas (p. ej. tras sellarlas en disco)
+     * @param n Lecturas a eliminar
+     * @details Libera los bloques completos de la cabeza y recalcula los agregados y el
+     * índice con un recorrido de lo que queda: pensado para retirar lotes grandes
+     */
+    void descartarPrimeros(int n);
+
 private:
+    /**
+     * @brief Recalcula mínimo y máximo si una eliminación los invalidó
+     */
+    void actualizarExtremos() const;
+
+    /**
+     * @brief Indica si la lectura en una posición física sigue presente
+     * @param posicion Posición física contando desde la cabeza
+     * @return false si el índice la extrajo y aún no se ha compactado
+     */
+    bool lecturaVisible(int posicion) const;
+
+    /**
+     * @brief Elimina físicamente las lecturas extraídas por el índice
+     * @details O(n log n), ejecutado solo cuando las extraídas superan a las vivas
+     */
+    void compactar();
+
+    /**
+     * @brief Vuelve a indexar todas las lecturas con sus posiciones físicas actuales
+     */
+    void reindexar();
+
+    /**
+     * @brief Extracción de un extremo mediante recorrido lineal (sin índice)
+     * @param menor true para el mínimo, false para el máximo
+     * @return Valor eliminado
+     */
+    T eliminarExtremoLineal(bool menor);
+
+    /**
+     * @brief Elimina la lectura en una posición de un bloque
+     * @param previo Nodo anterior a nodo (nullptr si nodo es la cabeza)
+     * @param nodo Nodo que contiene la lectura
+     * @param posicion Índice de la lectura dentro del bloque
+     * @details Desplaza el resto del bloque para conservar el orden y fusiona
+     * el bloque con su sucesor cuando ambos caben en un solo nodo
+     */
+    void eliminarEn(Nodo<T, N>* previo, Nodo<T, N>* nodo, int posicion);
+
     /**
      * @brief Libera toda la memoria de los nodos (método auxiliar)
      */
     void liberarNodos();
-    
+
     /**
-     * @brief Copia los nodos de otra lista (método auxiliar)
+     * @brief Añade al final, bloque a bloque, las lecturas visibles de otra lista
      * @param otra Lista fuente
+     * @details O(m): sin registro por lectura y con los agregados combinados en O(1)
+     */
+    void copiarNodos(const ListaSensor<T, N>& otra);
+
+    /**
+     * @brief Añade una lectura al final sin actualizar agregados ni registrar
+     * @param valor Lectura
      */
-    void copiarNodos(const ListaSensor<T>& otra);
+    void anexar(T valor);
+
+    /**
+     * @brief Deja la lista vacía sin liberar nodos (ya transferidos a otra lista)
+     */
+    void soltarNodos();
 };
 
+/**
+ * @brief Intercambio para algoritmos genéricos (std::swap vía ADL)
+ */
+template <typename T, int N>
+void swap(ListaSensor<T, N>& a, ListaSensor<T, N>& b) noexcept {
+    a.intercambiar(b);
+}
+
 // ======================== IMPLEMENTACIÓN ========================
 
-template <typename T>
-ListaSensor<T>::ListaSensor() : cabeza(nullptr), tamanio(0) {
-    std::cout << "[Log] ListaSensor<T> creada.\n";
+template <typename T, int N>
+ListaSensor<T, N>::ListaSensor(ArenaMemoria* arena)
+    : cabeza(nullptr), cola(nullptr), tamanio(0), pool(arena), indice(nullptr) {
+    REGISTRO_DEPURACION("[Log] ListaSensor<T> creada.\n");
 }
 
-template <typename T>
-ListaSensor<T>::~ListaSensor() {
-    std::cout << "[Destructor ListaSensor] Liberando lista interna...\n";
+template <typename T, int N>
+ListaSensor<T, N>::~ListaSensor() {
+    REGISTRO_DEPURACION("[Destructor ListaSensor] Liberando lista interna...\n");
     liberarNodos();
+    delete indice;
 }
 
-template <typename T>
-ListaSensor<T>::ListaSensor(const ListaSensor<T>& otra) : cabeza(nullptr), tamanio(0) {
+template <typename T, int N>
+ListaSensor<T, N>::ListaSensor(const ListaSensor<T, N>& otra)
+    : cabeza(nullptr), cola(nullptr), tamanio(0), pool(otra.pool.arenaCompartida()),
+      indice(otra.indice != nullptr ? new IndiceExtremos<T>() : nullptr) {
     copiarNodos(otra);
 }
 
-template <typename T>
-ListaSensor<T>& ListaSensor<T>::operator=(const ListaSensor<T>& otra) {
+template <typename T, int N>
+ListaSensor<T, N>& ListaSensor<T, N>::operator=(const ListaSensor<T, N>& otra) {
     if (this != &otra) {
         liberarNodos();
+        if (otra.indice == nullptr) {
+            delete indice;
+            indice = nullptr;
+        } else if (indice == nullptr) {
+            indice = new IndiceExtremos<T>();
+        }
         copiarNodos(otra);
     }
     return *this;
 }
 
-template <typename T>
-void ListaSensor<T>::insertar(T valor) {
-    Nodo<T>* nuevo = new Nodo<T>(valor);
-    
+template <typename T, int N>
+ListaSensor<T, N>::ListaSensor(ListaSensor<T, N>&& otra) noexcept
+    : cabeza(otra.cabeza), cola(otra.cola), tamanio(otra.tamanio), pool(std::move(otra.pool)),
+      estadisticas(otra.estadisticas), indice(otra.indice) {
+    otra.indice = nullptr;
+    otra.soltarNodos();
+}
+
+template <typename T, int N>
+ListaSensor<T, N>& ListaSensor<T, N>::operator=(ListaSensor<T, N>&& otra) noexcept {
+    if (this != &otra) {
+        // Los nodos anteriores se liberan con su propio pool al destruir el temporal
+        ListaSensor<T, N> temporal(std::move(otra));
+        intercambiar(temporal);
+    }
+    return *this;
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::intercambiar(ListaSensor<T, N>& otra) noexcept {
+    std::swap(cabeza, otra.cabeza);
+    std::swap(cola, otra.cola);
+    std::swap(tamanio, otra.tamanio);
+    pool.intercambiar(otra.pool);
+    std::swap(estadisticas, otra.estadisticas);
+    std::swap(indice, otra.indice);
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::empalmar(ListaSensor<T, N>& otra) {
+    if (this == &otra || otra.cabeza == nullptr) return;
+    if (otra.indice != nullptr && otra.indice->obtenerExtraidas() > 0) {
+        otra.compactar();
+    }
+
     if (cabeza == nullptr) {
-        cabeza = nuevo;
+        // Sin nodos propios: basta con adoptar el pool de otra
+        pool.intercambiar(otra.pool);
+    } else if (pool.arenaCompartida() == nullptr || pool.arenaCompartida() != otra.pool.arenaCompartida()) {
+        copiarNodos(otra);
+        otra.liberarNodos();
+        return;
+    }
+
+    Nodo<T, N>* primero = otra.cabeza;
+    if (cabeza == nullptr) {
+        cabeza = primero;
     } else {
-        Nodo<T>* actual = cabeza;
-        while (actual->siguiente != nullptr) {
-            actual = actual->siguiente;
+        cola->siguiente = primero;
+    }
+    cola = otra.cola;
+    tamanio += otra.tamanio;
+    estadisticas.combinar(otra.estadisticas);
+    if (indice != nullptr) {
+        for (Nodo<T, N>* actual = primero; actual != nullptr; actual = actual->siguiente) {
+            for (int i = 0; i < actual->cantidad; i++) {
+                indice->registrar(actual->datos[i]);
+            }
+        }
+    }
+    otra.soltarNodos();
+    REGISTRO_DEPURACION("[Log] ListaSensor<T> empalmada. Tamaño: " << tamanio << "\n");
+}
+
+template <typename T, int N>
+template <typename Comparador>
+void ListaSensor<T, N>::fusionar(ListaSensor<T, N>& otra, Comparador menor) {
+    if (this == &otra || otra.cabeza == nullptr) return;
+    if (indice != nullptr && indice->obtenerExtraidas() > 0) compactar();
+    if (otra.indice != nullptr && otra.indice->obtenerExtraidas() > 0) otra.compactar();
+
+    // Se construye la cadena fusionada en nodos nuevos y después se liberan las dos
+    // cadenas originales: un nodo por bloque, nunca uno por lectura
+    Nodo<T, N>* a = cabeza;
+    Nodo<T, N>* b = otra.cabeza;
+    int i = 0;
+    int j = 0;
+    Nodo<T, N>* viejaCabeza = cabeza;
+    int total = tamanio + otra.tamanio;
+    EstadisticasLectura<T> combinadas = estadisticas;
+    combinadas.combinar(otra.estadisticas);
+
+    soltarNodos();
+    while (a != nullptr || b != nullptr) {
+        bool deOtra = a == nullptr || (b != nullptr && menor(b->datos[j], a->datos[i]));
+        if (deOtra) {
+            anexar(b->datos[j]);
+            if (++j == b->cantidad) {
+                b = b->siguiente;
+                j = 0;
+            }
+        } else {
+            anexar(a->datos[i]);
+            if (++i == a->cantidad) {
+                a = a->siguiente;
+                i = 0;
+            }
+        }
+    }
+
+    while (viejaCabeza != nullptr) {
+        Nodo<T, N>* siguiente = viejaCabeza->siguiente;
+        pool.destruir(viejaCabeza);
+        viejaCabeza = siguiente;
+    }
+    otra.liberarNodos();
+
+    tamanio = total;
+    estadisticas = combinadas;
+    if (indice != nullptr) {
+        indice->reiniciar();
+        for (Nodo<T, N>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            indice->anexarSinOrden(actual->datos, actual->cantidad);
         }
-        actual->siguiente = nuevo;
+        indice->ordenarMonticulos();
     }
-    
+    REGISTRO_DEPURACION("[Log] ListaSensor<T> fusionada. Tamaño: " << tamanio << "\n");
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::insertar(T valor) {
+    anexar(valor);
+
     tamanio++;
-    std::cout << "[Log] Nodo<T> insertado. Valor: " << valor << "\n";
+    estadisticas.agregar(valor);
+    if (indice != nullptr) {
+        indice->registrar(valor);
+    }
+    REGISTRO_TRAZA("[Log] Nodo<T> insertado. Valor: " << valor << "\n");
 }
 
-template <typename T>
-bool ListaSensor<T>::buscar(T valor) const {
-    Nodo<T>* actual = cabeza;
+template <typename T, int N>
+void ListaSensor<T, N>::insertarBloque(const T* datos, int n) {
+    if (n <= 0) return;
+
+    EstadisticasLectura<T> agregadas;
+    agregadas.reconstruir(n, KernelsLectura<T>::sumar(datos, n), KernelsLectura<T>::sumarCuadrados(datos, n),
+                          datos[KernelsLectura<T>::posicionMinimo(datos, n)],
+                          datos[KernelsLectura<T>::posicionMaximo(datos, n)]);
+
+    int i = 0;
+    while (i < n) {
+        if (cola == nullptr || cola->cantidad == N) {
+            anexar(datos[i++]);
+            continue;
+        }
+        int copiar = N - cola->cantidad < n - i ? N - cola->cantidad : n - i;
+        std::copy(datos + i, datos + i + copiar, cola->datos + cola->cantidad);
+        cola->cantidad += copiar;
+        i += copiar;
+    }
+
+    tamanio += n;
+    estadisticas.combinar(agregadas);
+    if (indice != nullptr) {
+        indice->registrarBloque(datos, n);
+    }
+    REGISTRO_DEPURACION("[Log] ListaSensor<T>: " << n << " lecturas insertadas en bloque.\n");
+}
+
+template <typename T, int N>
+bool ListaSensor<T, N>::buscar(T valor) const {
+    Nodo<T, N>* actual = cabeza;
+    int posicion = 0;
     while (actual != nullptr) {
-        if (actual->dato == valor) {
-            return true;
+        int desde = 0;
+        while (desde < actual->cantidad) {
+            int i = KernelsLectura<T>::buscar(actual->datos + desde, actual->cantidad - desde, valor);
+            if (i < 0) break;
+            if (lecturaVisible(posicion + desde + i)) {
+                return true;
+            }
+            desde += i + 1;
         }
+        posicion += actual->cantidad;
         actual = actual->siguiente;
     }
     return false;
 }
 
-template <typename T>
-T ListaSensor<T>::calcularPromedio() const {
+template <typename T, int N>
+T ListaSensor<T, N>::calcularPromedio() const {
+    return estadisticas.promedio();
+}
+
+template <typename T, int N>
+double ListaSensor<T, N>::calcularVarianza() const {
+    return estadisticas.varianza();
+}
+
+template <typename T, int N>
+T ListaSensor<T, N>::obtenerMinimo() const {
+    actualizarExtremos();
+    return estadisticas.obtenerMinimo();
+}
+
+template <typename T, int N>
+T ListaSensor<T, N>::obtenerMaximo() const {
+    actualizarExtremos();
+    return estadisticas.obtenerMaximo();
+}
+
+template <typename T, int N>
+const EstadisticasLectura<T>& ListaSensor<T, N>::obtenerEstadisticas() const {
+    actualizarExtremos();
+    return estadisticas;
+}
+
+template <typename T, int N>
+T ListaSensor<T, N>::eliminarMenor() {
     if (tamanio == 0) return T();
-    
-    T suma = T();
-    Nodo<T>* actual = cabeza;
-    
+
+    T valorMenor = T();
+    if (indice != nullptr) {
+        indice->extraerMenor(valorMenor);
+        estadisticas.quitar(valorMenor);
+        tamanio--;
+        if (indice->obtenerExtraidas() > tamanio) {
+            compactar();
+        }
+    } else {
+        valorMenor = eliminarExtremoLineal(true);
+    }
+
+    REGISTRO_TRAZA("[Log] Nodo<T> " << valorMenor << " (menor) eliminado.\n");
+    return valorMenor;
+}
+
+template <typename T, int N>
+T ListaSensor<T, N>::eliminarMayor() {
+    if (tamanio == 0) return T();
+
+    T valorMayor = T();
+    if (indice != nullptr) {
+        indice->extraerMayor(valorMayor);
+        estadisticas.quitar(valorMayor);
+        tamanio--;
+        if (indice->obtenerExtraidas() > tamanio) {
+            compactar();
+        }
+    } else {
+        valorMayor = eliminarExtremoLineal(false);
+    }
+
+    REGISTRO_TRAZA("[Log] Nodo<T> " << valorMayor << " (mayor) eliminado.\n");
+    return valorMayor;
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::activarIndice() {
+    if (indice != nullptr) return;
+
+    indice = new IndiceExtremos<T>();
+    Nodo<T, N>* actual = cabeza;
     while (actual != nullptr) {
-        suma = suma + actual->dato;
+        indice->anexarSinOrden(actual->datos, actual->cantidad);
         actual = actual->siguiente;
     }
-    
-    return suma / tamanio;
+    indice->ordenarMonticulos();
+}
+
+template <typename T, int N>
+bool ListaSensor<T, N>::indiceActivo() const {
+    return indice != nullptr;
+}
+
+template <typename T, int N>
+int ListaSensor<T, N>::obtenerTamanio() const {
+    return tamanio;
 }
 
-template <typename T>
-T ListaSensor<T>::eliminarMenor() {
-    if (cabeza == nullptr) return T();
-    
-    // Buscar el menor valor y su predecesor
-    Nodo<T>* menorNodo = cabeza;
-    Nodo<T>* previoMenor = nullptr;
-    Nodo<T>* actual = cabeza->siguiente;
-    Nodo<T>* previo = cabeza;
-    
+template <typename T, int N>
+void ListaSensor<T, N>::mostrar() const {
+    Nodo<T, N>* actual = cabeza;
+    bool primero = true;
+    int posicion = 0;
+    std::cout << "[Lista] { ";
     while (actual != nullptr) {
-        if (actual->dato < menorNodo->dato) {
-            menorNodo = actual;
-            previoMenor = previo;
+        for (int i = 0; i < actual->cantidad; i++, posicion++) {
+            if (!lecturaVisible(posicion)) continue;
+            if (!primero) std::cout << ", ";
+            std::cout << actual->datos[i];
+            primero = false;
+        }
+        actual = actual->siguiente;
+    }
+    std::cout << " }\n";
+}
+
+template <typename T, int N>
+bool ListaSensor<T, N>::estaVacia() const {
+    return tamanio == 0;
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::vaciar() {
+    liberarNodos();
+}
+
+template <typename T, int N>
+int ListaSensor<T, N>::copiarPrimeros(T* destino, int n) const {
+    int copiadas = 0;
+    int posicion = 0;
+    for (Nodo<T, N>* actual = cabeza; actual != nullptr && copiadas < n; actual = actual->siguiente) {
+        for (int i = 0; i < actual->cantidad && copiadas < n; i++, posicion++) {
+            if (lecturaVisible(posicion)) destino[copiadas++] = actual->datos[i];
+        }
+    }
+    return copiadas;
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::descartarPrimeros(int n) {
+    if (n <= 0) return;
+    if (n >= tamanio) {
+        liberarNodos();
+        return;
+    }
+    if (indice != nullptr && indice->obtenerExtraidas() > 0) {
+        compactar();
+    }
+
+    int restantes = n;
+    while (restantes > 0) {
+        if (cabeza->cantidad <= restantes) {
+            // Bloque completo: desenlazarlo
+            Nodo<T, N>* siguiente = cabeza->siguiente;
+            restantes -= cabeza->cantidad;
+            pool.destruir(cabeza);
+            cabeza = siguiente;
+        } else {
+            std::copy(cabeza->datos + restantes, cabeza->datos + cabeza->cantidad, cabeza->datos);
+            cabeza->cantidad -= restantes;
+            restantes = 0;
+        }
+    }
+
+    tamanio -= n;
+    recalcularEstadisticas();
+    if (indice != nullptr) {
+        reindexar();
+    }
+    REGISTRO_DEPURACION("[Log] ListaSensor<T>: " << n << " lecturas antiguas descartadas.\n");
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::actualizarExtremos() const {
+    if (estadisticas.extremosAlDia()) return;
+
+    if (indice != nullptr) {
+        T menor = T();
+        T mayor = T();
+        indice->consultarMenor(menor);
+        indice->consultarMayor(mayor);
+        estadisticas.fijarExtremos(menor, mayor);
+        return;
+    }
+
+    T menor = cabeza->datos[0];
+    T mayor = cabeza->datos[0];
+    Nodo<T, N>* actual = cabeza;
+    while (actual != nullptr) {
+        T menorBloque = actual->datos[KernelsLectura<T>::posicionMinimo(actual->datos, actual->cantidad)];
+        T mayorBloque = actual->datos[KernelsLectura<T>::posicionMaximo(actual->datos, actual->cantidad)];
+        if (menorBloque < menor) menor = menorBloque;
+        if (mayor < mayorBloque) mayor = mayorBloque;
+        actual = actual->siguiente;
+    }
+    estadisticas.fijarExtremos(menor, mayor);
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::recalcularEstadisticas() {
+    if (indice != nullptr && indice->obtenerExtraidas() > 0) {
+        compactar();
+    }
+    if (cabeza == nullptr) {
+        estadisticas.reiniciar();
+        return;
+    }
+
+    typename EstadisticasLectura<T>::Acumulador suma = typename EstadisticasLectura<T>::Acumulador();
+    double sumaCuadrados = 0.0;
+    T menor = cabeza->datos[0];
+    T mayor = cabeza->datos[0];
+    Nodo<T, N>* actual = cabeza;
+    while (actual != nullptr) {
+        suma += KernelsLectura<T>::sumar(actual->datos, actual->cantidad);
+        sumaCuadrados += KernelsLectura<T>::sumarCuadrados(actual->datos, actual->cantidad);
+        T menorBloque = actual->datos[KernelsLectura<T>::posicionMinimo(actual->datos, actual->cantidad)];
+        T mayorBloque = actual->datos[KernelsLectura<T>::posicionMaximo(actual->datos, actual->cantidad)];
+        if (menorBloque < menor) menor = menorBloque;
+        if (mayor < mayorBloque) mayor = mayorBloque;
+        actual = actual->siguiente;
+    }
+    estadisticas.reconstruir(tamanio, suma, sumaCuadrados, menor, mayor);
+}
+
+template <typename T, int N>
+bool ListaSensor<T, N>::lecturaVisible(int posicion) const {
+    return indice == nullptr || indice->vivo(posicion);
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::compactar() {
+    // Copiar las lecturas vivas hacia el frente, bloque a bloque
+    Nodo<T, N>* escritura = cabeza;
+    int ocupadas = 0;
+    int posicion = 0;
+    Nodo<T, N>* actual = cabeza;
+    while (actual != nullptr) {
+        for (int i = 0; i < actual->cantidad; i++, posicion++) {
+            if (!indice->vivo(posicion)) continue;
+            if (ocupadas == N) {
+                escritura->cantidad = N;
+                escritura = escritura->siguiente;
+                ocupadas = 0;
+            }
+            escritura->datos[ocupadas++] = actual->datos[i];
         }
-        previo = actual;
         actual = actual->siguiente;
     }
-    
-    T valorMenor = menorNodo->dato;
-    
-    // Eliminar el nodo menor
-    if (previoMenor == nullptr) {
-        // El menor es la cabeza
-        cabeza = cabeza->siguiente;
+
+    // Liberar los bloques sobrantes
+    Nodo<T, N>* sobrante;
+    if (ocupadas == 0) {
+        sobrante = cabeza;
+        cabeza = nullptr;
+        cola = nullptr;
     } else {
-        previoMenor->siguiente = menorNodo->siguiente;
+        escritura->cantidad = ocupadas;
+        sobrante = escritura->siguiente;
+        escritura->siguiente = nullptr;
+        cola = escritura;
     }
-    
-    std::cout << "[Log] Nodo<T> " << valorMenor << " (menor) eliminado.\n";
-    delete menorNodo;
-    tamanio--;
-    
-    return valorMenor;
+    while (sobrante != nullptr) {
+        Nodo<T, N>* siguiente = sobrante->siguiente;
+        pool.destruir(sobrante);
+        sobrante = siguiente;
+    }
+
+    // Reindexar con las nuevas posiciones físicas
+    reindexar();
 }
 
-template <typename T>
-int ListaSensor<T>::obtenerTamanio() const {
-    return tamanio;
+template <typename T, int N>
+void ListaSensor<T, N>::reindexar() {
+    indice->reiniciar();
+    for (Nodo<T, N>* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+        for (int i = 0; i < actual->cantidad; i++) {
+            indice->registrar(actual->datos[i]);
+        }
+    }
 }
 
-template <typename T>
-void ListaSensor<T>::mostrar() const {
-    Nodo<T>* actual = cabeza;
-    std::cout << "[Lista] { ";
+template <typename T, int N>
+T ListaSensor<T, N>::eliminarExtremoLineal(bool menor) {
+    // Buscar el extremo, su bloque y el predecesor del bloque
+    Nodo<T, N>* extremoNodo = cabeza;
+    Nodo<T, N>* previoExtremo = nullptr;
+    int posicionExtremo = 0;
+    Nodo<T, N>* actual = cabeza;
+    Nodo<T, N>* previo = nullptr;
+
     while (actual != nullptr) {
-        std::cout << actual->dato;
-        if (actual->siguiente != nullptr) std::cout << ", ";
+        int i = menor ? KernelsLectura<T>::posicionMinimo(actual->datos, actual->cantidad)
+                      : KernelsLectura<T>::posicionMaximo(actual->datos, actual->cantidad);
+        T candidato = actual->datos[i];
+        T elegido = extremoNodo->datos[posicionExtremo];
+        if (menor ? candidato < elegido : elegido < candidato) {
+            extremoNodo = actual;
+            previoExtremo = previo;
+            posicionExtremo = i;
+        }
+        previo = actual;
         actual = actual->siguiente;
     }
-    std::cout << " }\n";
+
+    T valor = extremoNodo->datos[posicionExtremo];
+    eliminarEn(previoExtremo, extremoNodo, posicionExtremo);
+    return valor;
 }
 
-template <typename T>
-bool ListaSensor<T>::estaVacia() const {
-    return cabeza == nullptr;
+template <typename T, int N>
+void ListaSensor<T, N>::eliminarEn(Nodo<T, N>* previo, Nodo<T, N>* nodo, int posicion) {
+    estadisticas.quitar(nodo->datos[posicion]);
+
+    // Desplazar el resto del bloque para conservar el orden de inserción
+    for (int i = posicion + 1; i < nodo->cantidad; i++) {
+        nodo->datos[i - 1] = nodo->datos[i];
+    }
+    nodo->cantidad--;
+    tamanio--;
+
+    if (nodo->cantidad == 0) {
+        // Bloque vacío: desenlazarlo
+        if (previo == nullptr) {
+            cabeza = nodo->siguiente;
+        } else {
+            previo->siguiente = nodo->siguiente;
+        }
+        if (cola == nodo) {
+            cola = previo;
+        }
+        pool.destruir(nodo);
+        return;
+    }
+
+    // Fusionar con el sucesor si ambos bloques caben en uno
+    Nodo<T, N>* sucesor = nodo->siguiente;
+    if (sucesor != nullptr && nodo->cantidad + sucesor->cantidad <= N) {
+        for (int i = 0; i < sucesor->cantidad; i++) {
+            nodo->datos[nodo->cantidad + i] = sucesor->datos[i];
+        }
+        nodo->cantidad += sucesor->cantidad;
+        nodo->siguiente = sucesor->siguiente;
+        if (cola == sucesor) {
+            cola = nodo;
+        }
+        pool.destruir(sucesor);
+    }
 }
 
-template <typename T>
-void ListaSensor<T>::liberarNodos() {
-    Nodo<T>* actual = cabeza;
+template <typename T, int N>
+void ListaSensor<T, N>::liberarNodos() {
+    // Con nodos triviales y arena propia (o compartida en desmontaje), los bloques se
+    // devuelven de una sola vez y no hace falta recorrer la lista
+    const bool liberacionMasiva = std::is_trivially_destructible<Nodo<T, N> >::value
+                                  && pool.admiteLiberacionMasiva();
+    bool recorrer = !liberacionMasiva;
+#if NIVEL_LOG_COMPILADO <= NIVEL_LOG_TRAZA
+    recorrer = recorrer || Registro::habilitado(NIVEL_LOG_TRAZA);
+#endif
+
+    Nodo<T, N>* actual = recorrer ? cabeza : nullptr;
+    int posicion = 0;
     while (actual != nullptr) {
-        Nodo<T>* siguiente = actual->siguiente;
-        std::cout << "  [Log] Nodo<T> " << actual->dato << " liberado.\n";
-        delete actual;
+        Nodo<T, N>* siguiente = actual->siguiente;
+        for (int i = 0; i < actual->cantidad; i++, posicion++) {
+            if (!lecturaVisible(posicion)) continue;
+            REGISTRO_TRAZA("  [Log] Nodo<T> " << actual->datos[i] << " liberado.\n");
+        }
+        if (!liberacionMasiva) {
+            pool.destruir(actual);
+        }
         actual = siguiente;
     }
+    if (liberacionMasiva) {
+        pool.liberarTodo();
+    }
     cabeza = nullptr;
+    cola = nullptr;
     tamanio = 0;
+    estadisticas.reiniciar();
+    if (indice != nullptr) {
+        indice->reiniciar();
+    }
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::copiarNodos(const ListaSensor<T, N>& otra) {
+    int posicion = 0;
+    for (Nodo<T, N>* actual = otra.cabeza; actual != nullptr; actual = actual->siguiente) {
+        for (int i = 0; i < actual->cantidad; i++, posicion++) {
+            if (!otra.lecturaVisible(posicion)) continue;
+            anexar(actual->datos[i]);
+            if (indice != nullptr) {
+                indice->registrar(actual->datos[i]);
+            }
+        }
+    }
+    tamanio += otra.tamanio;
+    estadisticas.combinar(otra.estadisticas);
+}
+
+template <typename T, int N>
+void ListaSensor<T, N>::anexar(T valor) {
+    if (cola != nullptr && cola->cantidad < N) {
+        cola->datos[cola->cantidad++] = valor;
+        return;
+    }
+
+    Nodo<T, N>* nuevo = pool.crear(valor);
+    if (cabeza == nullptr) {
+        cabeza = nuevo;
+    } else {
+        cola->siguiente = nuevo;
+    }
+    cola = nuevo;
 }
 
-template <typename T>
-void ListaSensor<T>::copiarNodos(const ListaSensor<T>& otra) {
-    if (otra.cabeza == nullptr) return;
-    
-    Nodo<T>* actualOtra = otra.cabeza;
-    while (actualOtra != nullptr) {
-        insertar(actualOtra->dato);
-        actualOtra = actualOtra->siguiente;
+template <typename T, int N>
+void ListaSensor<T, N>::soltarNodos() {
+    cabeza = nullptr;
+    cola = nullptr;
+    tamanio = 0;
+    estadisticas.reiniciar();
+    if (indice != nullptr) {
+        indice->reiniciar();
     }
 }
 
-#endif // LISTA_SENSOR_H
\ No newline at end of file
+#endif // LISTA_SENSOR_H
@@ -0,0 +1,241 @@
+/**
+ * @file Metricas.h
+ * @brief Contadores, histogramas de latencia e indicadores de memoria de las rutas calientes
+ * @details Cada hilo escribe en su propio fragmento (sin cerrojos ni líneas de caché
+ * compartidas); la exportación suma los fragmentos de todos los hilos. Cada punto
+ * instrumentado cuenta todas sus llamadas y cronometra una de cada N (el reloj cuesta
+ * más que las operaciones más rápidas). Los histogramas usan cubetas logarítmico-lineales
+ * al estilo HDR: 8 subcubetas por potencia de dos, es decir, un error relativo máximo del
+ * 12,5 % entre 1 ns y ~39 h.
+ *
+ * Las macros METRICA_* solo existen si se compila con SISTEMA_IOT_METRICAS (opción de CMake
+ * del mismo nombre); sin ella se expanden a nada y no queda código en las rutas calientes.
+ */
+
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+/**
+ * @brief Puntos instrumentados: cada uno tiene un contador de llamadas y un histograma
+ * de latencia (nanosegundos)
+ */
+enum HistogramaMetrica {
+    HISTOGRAMA_REGISTRAR,  ///< registrarLectura
+    HISTOGRAMA_PROCESAR,   ///< procesarLectura de un sensor
+    HISTOGRAMA_BUSCAR,     ///< buscarSensor
+    HISTOGRAMA_CICLO,      ///< Ciclo de procesarTodosSensores/procesarPorTipo
+    NUM_HISTOGRAMAS
+};
+
+/**
+ * @brief Indicadores (valores que suben y bajan)
+ */
+enum IndicadorMetrica {
+    INDICADOR_SENSORES,          ///< Sensores registrados en todos los sistemas
+    INDICADOR_LECTURAS_MEMORIA,  ///< Lecturas en memoria al final del último ciclo
+    INDICADOR_BYTES_ARENA,       ///< Bytes reservados por las arenas (bloques de 64 KB)
+    NUM_INDICADORES
+};
+
+/**
+ * @class Metricas
+ * @brief Registro global de métricas y su exportación en formato de texto de Prometheus
+ */
+class Metricas {
+public:
+    static const int SUBCUBETAS = 8;     ///< Subcubetas por potencia de dos (3 bits)
+    static const int NUM_CUBETAS = 368;  ///< Cubre hasta 2^48 ns
+
+    /**
+     * @brief Métricas escritas por un hilo
+     * @details Solo su hilo escribe (carga y almacenamiento relajados, sin instrucciones
+     * atómicas de lectura-modificación-escritura); el exportador solo lee
+     */
+    struct Fragmento {
+        std::atomic<uint64_t> llamadas[NUM_HISTOGRAMAS];               ///< Llamadas de cada punto
+        std::atomic<uint64_t> cubetas[NUM_HISTOGRAMAS][NUM_CUBETAS];  ///< Muestras por cubeta
+        std::atomic<uint64_t> sumasNs[NUM_HISTOGRAMAS];                ///< Suma de las muestras
+        Fragmento* siguiente;                                          ///< Fragmento de otro hilo
+    };
+
+    /**
+     * @brief Indica si el binario se compiló con las macros de instrumentación
+     */
+    static bool habilitadas();
+
+    /**
+     * @brief Anota una latencia en su histograma
+     */
+    static void registrarLatencia(HistogramaMetrica histograma, uint64_t ns) {
+        Fragmento* f = fragmentoLocal();
+        sumar(f->cubetas[histograma][cubetaDe(ns)], 1);
+        sumar(f->sumasNs[histograma], ns);
+    }
+
+    /**
+     * @brief Cuenta una llamada y decide si se cronometra (una de cada periodo, por hilo)
+     * @param histograma Punto instrumentado
+     * @param periodo Potencia de dos (1 = cronometrar todas)
+     * @return true si la llamada debe cronometrarse
+     */
+    static bool contarLlamada(HistogramaMetrica histograma, uint64_t periodo) {
+        std::atomic<uint64_t>& llamadas = fragmentoLocal()->llamadas[histograma];
+        uint64_t previas = llamadas.load(std::memory_order_relaxed);
+        llamadas.store(previas + 1, std::memory_order_relaxed);
+        return (previas & (periodo - 1)) == 0;
+    }
+
+    /**
+     * @brief Suma (o resta) a un indicador compartido
+     */
+    static void ajustarIndicador(IndicadorMetrica indicador, long long delta);
+
+    /**
+     * @brief Fija el valor de un indicador compartido
+     */
+    static void fijarIndicador(IndicadorMetrica indicador, long long valor);
+
+    /**
+     * @brief Nanosegundos de un reloj monótono
+     */
+    static uint64_t nanosegundos() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief Índice de la cubeta de una latencia
+     * @details Menos de 8 ns: cubeta exacta; si no, 8 subcubetas por potencia de dos
+     */
+    static int cubetaDe(uint64_t ns) {
+        if (ns < static_cast<uint64_t>(SUBCUBETAS)) return static_cast<int>(ns);
+        int exponente = 63 - cerosIzquierda(ns);
+        int indice = (exponente - 2) * SUBCUBETAS + static_cast<int>((ns >> (exponente - 3)) & 7u);
+        return indice < NUM_CUBETAS ? indice : NUM_CUBETAS - 1;
+    }
+
+    /**
+     * @brief Mayor latencia que cae en una cubeta
+     */
+    static uint64_t limiteCubeta(int indice);
+
+    /**
+     * @brief Percentil aproximado de un histograma (suma de todos los hilos)
+     * @param histograma Histograma a consultar
+     * @param q Fracción en [0, 1]
+     * @return Límite superior de la cubeta del percentil (0 sin muestras)
+     */
+    static uint64_t percentil(HistogramaMetrica histograma, double q);
+
+    /**
+     * @brief Llamadas totales a un punto instrumentado (suma de todos los hilos)
+     */
+    static uint64_t totalLlamadas(HistogramaMetrica histograma);
+
+    /**
+     * @brief Escribe todas las métricas en formato de texto de Prometheus
+     */
+    static void exportarPrometheus(std::ostream& salida);
+
+    /**
+     * @brief Escribe las métricas en un archivo de forma atómica (temporal + rename)
+     * @return false si no se pudo escribir
+     */
+    static bool exportarArchivo(const char* ruta);
+
+    /**
+     * @brief Exporta a un archivo periódicamente desde un hilo propio
+     * @param ruta Archivo destino (p. ej. para el colector textfile de node_exporter)
+     * @param intervaloMs Periodo entre exportaciones
+     * @details Reemplaza una exportación periódica anterior
+     */
+    static void iniciarExportacion(const char* ruta, int intervaloMs = 1000);
+
+    /**
+     * @brief Detiene la exportación periódica tras una última escritura
+     */
+    static void detenerExportacion();
+
+private:
+    /**
+     * @brief Fragmento del hilo actual (se crea y enlaza en el primer uso)
+     */
+    static Fragmento* fragmentoLocal() {
+        static thread_local Fragmento* local = nullptr;
+        if (local == nullptr) {
+            local = crearFragmento();
+        }
+        return local;
+    }
+
+    static Fragmento* crearFragmento();
+
+    static void sumar(std::atomic<uint64_t>& valor, uint64_t n) {
+        valor.store(valor.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static int cerosIzquierda(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(x);
+#else
+        int n = 0;
+        while (!(x & 0x8000000000000000ull)) {
+            x <<= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+};
+
+/**
+ * @class CronometroMetrica
+ * @brief Cronometra un ámbito y anota la latencia al salir de él
+ */
+class CronometroMetrica {
+private:
+    HistogramaMetrica histograma;
+    uint64_t inicio;
+    bool activo;
+
+public:
+    /**
+     * @param histograma Histograma destino
+     * @param periodo Cronometrar una de cada periodo llamadas (potencia de dos; 1 = todas)
+     */
+    CronometroMetrica(HistogramaMetrica histograma, uint64_t periodo)
+        : histograma(histograma), inicio(0), activo(Metricas::contarLlamada(histograma, periodo)) {
+        if (activo) inicio = Metricas::nanosegundos();
+    }
+
+    ~CronometroMetrica() {
+        if (activo) Metricas::registrarLatencia(histograma, Metricas::nanosegundos() - inicio);
+    }
+
+    CronometroMetrica(const CronometroMetrica&) = delete;
+    CronometroMetrica& operator=(const CronometroMetrica&) = delete;
+};
+
+#ifdef SISTEMA_IOT_METRICAS
+#define METRICA_CONCATENAR_(a, b) a##b
+#define METRICA_CONCATENAR(a, b) METRICA_CONCATENAR_(a, b)
+
+/// Cuenta la llamada y cronometra el resto del ámbito, una de cada periodo llamadas
+#define METRICA_CRONOMETRAR(histograma, periodo) \
+    CronometroMetrica METRICA_CONCATENAR(cronometro_, __LINE__)(histograma, periodo)
+/// Suma delta a un indicador
+#define METRICA_AJUSTAR(indicador, delta) Metricas::ajustarIndicador(indicador, delta)
+/// Fija un indicador
+#define METRICA_FIJAR(indicador, valor) Metricas::fijarIndicador(indicador, valor)
+#else
+#define METRICA_CRONOMETRAR(histograma, periodo) do {} while (0)
+#define METRICA_AJUSTAR(indicador, delta) do {} while (0)
+#define METRICA_FIJAR(indicador, valor) do {} while (0)
+#endif
+
+#endif // METRICAS_H
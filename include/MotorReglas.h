@@ -0,0 +1,235 @@
+/**
+ * @file MotorReglas.h
+ * @brief Reglas de alerta por umbral evaluadas de forma incremental en cada lectura
+ * @details Las reglas se compilan una vez desde un archivo de texto, una por línea:
+ *
+ *     # nombre       tipo         condición
+ *     T_ALTA         temperatura  valor > 45
+ *     T_SOSTENIDA    temperatura  valor > 45 durante 3
+ *     P_MEDIA_ALTA   presion      promedio 10 > 90
+ *
+ * con los operadores >, >=, < y <=. Toda condición se reduce a "señal > umbral", donde
+ * la señal es la lectura, el mínimo de las N últimas ("durante N": N lecturas seguidas
+ * por encima equivale a que la menor de ellas lo esté) o su promedio; "<" y "<=" se
+ * evalúan sobre la lectura negada. En las reglas de temperatura el límite y el promedio se
+ * redondean a float, el tipo de la lectura. Las reglas que comparten señal se agrupan, con sus
+ * umbrales ordenados: las que se cumplen son siempre un prefijo, así que cada lectura
+ * cuesta O(1) por señal para actualizarla más una búsqueda binaria entre sus umbrales,
+ * y solo se tocan las reglas que cambian de estado. Añadir reglas sobre una señal
+ * existente no añade trabajo por lectura.
+ *
+ * Cada cambio de estado (activación o resolución) se publica como EventoAlerta en una
+ * ColaLecturas, que puede drenar otro hilo.
+ */
+
+#ifndef MOTOR_REGLAS_H
+#define MOTOR_REGLAS_H
+
+#include "ColaLecturas.h"
+#include <atomic>
+#include <string>
+
+/**
+ * @brief Tipo de sensor al que se aplica una regla
+ */
+enum TipoReglas {
+    REGLAS_TEMPERATURA,
+    REGLAS_PRESION,
+    NUM_TIPOS_REGLAS
+};
+
+/**
+ * @brief Cambio de estado de una regla en un sensor
+ */
+struct EventoAlerta {
+    char sensor[50];  ///< Nombre del sensor
+    int regla;        ///< Índice de la regla (MotorReglas::obtenerNombreRegla)
+    double valor;     ///< Valor de la señal que provocó el cambio
+    bool activa;      ///< true = la condición empieza a cumplirse; false = deja de cumplirse
+};
+
+/**
+ * @brief Señal compartida por un grupo de reglas y sus umbrales ordenados
+ */
+struct SenalReglas {
+    /**
+     * @brief Magnitud comparada con los umbrales
+     */
+    enum Tipo {
+        VALOR,     ///< Lectura actual
+        MINIMO,    ///< Mínimo de las N últimas lecturas
+        PROMEDIO   ///< Promedio de las N últimas lecturas
+    };
+
+    Tipo tipo;           ///< Magnitud
+    int ventana;         ///< N (1 para VALOR)
+    bool negada;         ///< true si se evalúa sobre -lectura (operadores < y <=)
+    double* umbrales;    ///< Umbrales ascendentes: la regla k se cumple si señal > umbrales[k]
+    int* reglas;         ///< Índice de regla de cada umbral
+    int numUmbrales;     ///< Umbrales del grupo
+};
+
+/**
+ * @class ReglasCompiladas
+ * @brief Señales y umbrales de todas las reglas de un tipo de sensor
+ */
+class ReglasCompiladas {
+private:
+    SenalReglas* senales;  ///< Señales distintas
+    int numSenales;        ///< Señales en uso
+    int capacidad;         ///< Capacidad del arreglo
+
+    void crecer();
+
+public:
+    ReglasCompiladas();
+    ~ReglasCompiladas();
+
+    ReglasCompiladas(const ReglasCompiladas&) = delete;
+    ReglasCompiladas& operator=(const ReglasCompiladas&) = delete;
+
+    /**
+     * @brief Añade el umbral de una regla a su señal (creándola si no existe)
+     * @param tipo Magnitud de la señal
+     * @param ventana N de la señal
+     * @param negada true si la señal es la lectura negada
+     * @param umbral La regla se cumple si señal > umbral
+     * @param regla Índice de la regla
+     */
+    void agregar(SenalReglas::Tipo tipo, int ventana, bool negada, double umbral, int regla);
+
+    /**
+     * @brief Libera todas las señales
+     */
+    void vaciar();
+
+    /**
+     * @brief Intercambia el contenido con otro conjunto
+     */
+    void intercambiar(ReglasCompiladas& otro);
+
+    int obtenerNumSenales() const { return numSenales; }
+    const SenalReglas& obtenerSenal(int i) const { return senales[i]; }
+};
+
+class MotorReglas;
+
+/**
+ * @class EstadoReglas
+ * @brief Estado incremental de las reglas en un sensor concreto
+ * @details Cada sensor con reglas tiene el suyo: ventanas de las señales y número de
+ * umbrales que se cumplen en cada una. Solo lo usa el hilo que registra las lecturas
+ * del sensor. Las reglas del motor no deben recompilarse mientras exista.
+ */
+class EstadoReglas {
+private:
+    /**
+     * @brief Ventana deslizante de una señal
+     */
+    struct Ventana {
+        double* valores;        ///< Anillo con las N últimas lecturas (PROMEDIO) o la cola monótona (MINIMO)
+        long long* posiciones;  ///< Número de lectura de cada elemento de la cola monótona (MINIMO)
+        int inicio;             ///< Primer elemento del anillo o de la cola
+        int cantidad;           ///< Elementos ocupados
+        double suma;            ///< Suma de la ventana (PROMEDIO)
+        int hastaRecalculo;     ///< Lecturas hasta recalcular la suma desde cero (PROMEDIO)
+        int cumplidas;          ///< Umbrales que la señal supera ahora (prefijo)
+    };
+
+    const ReglasCompiladas& compiladas;  ///< Reglas del tipo de sensor
+    MotorReglas& motor;                  ///< Destino de los eventos
+    const char* sensor;                  ///< Nombre del sensor (vive tanto como él)
+    TipoReglas tipo;                     ///< Tipo del sensor (temperatura: señales float)
+    Ventana* ventanas;                   ///< Una por señal
+    int numVentanas;                     ///< Señales al crear el estado
+    long long lecturas;                  ///< Lecturas evaluadas
+
+    /**
+     * @brief Incorpora la lectura a la ventana de una señal
+     * @return true si la señal está definida (ya hay N lecturas)
+     */
+    bool actualizar(const SenalReglas& senal, Ventana& ventana, double x, double& valor);
+
+public:
+    /**
+     * @param motor Motor con las reglas compiladas y la cola de alertas
+     * @param tipo Tipo del sensor
+     * @param sensor Nombre del sensor
+     */
+    EstadoReglas(MotorReglas& motor, TipoReglas tipo, const char* sensor);
+    ~EstadoReglas();
+
+    EstadoReglas(const EstadoReglas&) = delete;
+    EstadoReglas& operator=(const EstadoReglas&) = delete;
+
+    /**
+     * @brief Evalúa una lectura y publica los cambios de estado
+     * @param lectura Valor registrado
+     */
+    void evaluar(double lectura);
+};
+
+/**
+ * @class MotorReglas
+ * @brief Reglas compiladas por tipo de sensor y cola de alertas
+ */
+class MotorReglas {
+private:
+    ReglasCompiladas compiladas[NUM_TIPOS_REGLAS];  ///< Reglas de cada tipo de sensor
+    std::string* nombres;                           ///< Nombre de cada regla
+    std::string* condiciones;                       ///< Condición de cada regla tal como se escribió
+    int numReglas;                                  ///< Reglas compiladas
+    ColaLecturas<EventoAlerta> alertas;             ///< Eventos pendientes de drenar
+    std::atomic<long long> perdidas;                ///< Eventos descartados por cola llena
+
+public:
+    /**
+     * @param capacidadAlertas Eventos en vuelo antes de empezar a descartar
+     */
+    explicit MotorReglas(std::size_t capacidadAlertas = 4096);
+    ~MotorReglas();
+
+    MotorReglas(const MotorReglas&) = delete;
+    MotorReglas& operator=(const MotorReglas&) = delete;
+
+    /**
+     * @brief Compila las reglas de un archivo y reemplaza las actuales
+     * @param archivo Ruta del archivo de reglas
+     * @return false si no se pudo leer o alguna línea es inválida (las reglas no cambian)
+     * @details Debe llamarse antes de asociar el motor a los sensores
+     */
+    bool cargar(const char* archivo);
+
+    /**
+     * @brief Compila reglas a partir de texto con el formato del archivo
+     * @param texto Reglas separadas por saltos de línea
+     * @param origen Nombre del origen para los mensajes de error
+     * @return false si alguna línea es inválida (las reglas no cambian)
+     */
+    bool compilar(const char* texto, const char* origen = "reglas");
+
+    /**
+     * @brief Publica un evento (desde cualquier hilo, sin cerrojos)
+     */
+    void publicar(const EventoAlerta& evento);
+
+    /**
+     * @brief Extrae eventos pendientes (un solo consumidor)
+     * @param destino Arreglo de al menos maximo eventos
+     * @param maximo Eventos a extraer como mucho
+     * @return Eventos copiados, en orden de publicación
+     */
+    int drenarAlertas(EventoAlerta* destino, int maximo);
+
+    const ReglasCompiladas& obtenerReglas(TipoReglas tipo) const { return compiladas[tipo]; }
+    int obtenerNumReglas() const { return numReglas; }
+    const char* obtenerNombreRegla(int regla) const { return nombres[regla].c_str(); }
+    const char* obtenerCondicion(int regla) const { return condiciones[regla].c_str(); }
+
+    /**
+     * @brief Eventos descartados porque la cola estaba llena
+     */
+    long long obtenerPerdidas() const { return perdidas.load(std::memory_order_relaxed); }
+};
+
+#endif // MOTOR_REGLAS_H
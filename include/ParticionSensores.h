@@ -0,0 +1,103 @@
+/**
+ * @file ParticionSensores.h
+ * @brief Arreglo contiguo de punteros a los sensores de un mismo tipo concreto
+ * @details SistemaGestion reparte los sensores registrados en una partición por tipo
+ * (temperatura, presión, resto). Recorrer una partición es un bucle sobre un arreglo de
+ * punteros del tipo exacto, así que cada llamada se resuelve en compilación en lugar de
+ * saltar por la tabla virtual de SensorBase. Los sensores siguen en el montículo: solo
+ * los punteros son contiguos.
+ */
+
+#ifndef PARTICION_SENSORES_H
+#define PARTICION_SENSORES_H
+
+/**
+ * @class ParticionSensores
+ * @brief Sensores de un tipo, con su nodo de gestión para eliminar en O(1)
+ * @tparam S Tipo de sensor almacenado
+ * @tparam TNodo Nodo de gestión, con un campo int posicion
+ * @details El orden no es el de registro: eliminar mueve el último elemento al hueco y
+ * actualiza la posición guardada en su TNodo.
+ */
+template <typename S, typename TNodo>
+class ParticionSensores {
+private:
+    S** sensores;          ///< Punteros a los sensores de la partición, contiguos
+    TNodo** nodos;         ///< Nodo de gestión de cada sensor (mismo índice)
+    int cantidad;          ///< Sensores en uso
+    int capacidad;         ///< Capacidad de los arreglos
+
+    void crecer() {
+        int nuevaCapacidad = capacidad == 0 ? 16 : capacidad * 2;
+        S** nuevosSensores = new S*[nuevaCapacidad];
+        TNodo** nuevosNodos = new TNodo*[nuevaCapacidad];
+        for (int i = 0; i < cantidad; i++) {
+            nuevosSensores[i] = sensores[i];
+            nuevosNodos[i] = nodos[i];
+        }
+        delete[] sensores;
+        delete[] nodos;
+        sensores = nuevosSensores;
+        nodos = nuevosNodos;
+        capacidad = nuevaCapacidad;
+    }
+
+public:
+    ParticionSensores() : sensores(nullptr), nodos(nullptr), cantidad(0), capacidad(0) {}
+
+    ~ParticionSensores() {
+        delete[] sensores;
+        delete[] nodos;
+    }
+
+    ParticionSensores(const ParticionSensores&) = delete;
+    ParticionSensores& operator=(const ParticionSensores&) = delete;
+
+    /**
+     * @brief Añade un sensor y anota su posición en el nodo
+     * @param sensor Sensor del tipo exacto S
+     * @param nodo Nodo de gestión del sensor
+     */
+    void agregar(S* sensor, TNodo* nodo) {
+        if (cantidad == capacidad) {
+            crecer();
+        }
+        sensores[cantidad] = sensor;
+        nodos[cantidad] = nodo;
+        nodo->posicion = cantidad;
+        cantidad++;
+    }
+
+    /**
+     * @brief Quita el sensor de un nodo (O(1): el último ocupa su lugar)
+     * @param nodo Nodo agregado antes a esta partición
+     */
+    void quitar(TNodo* nodo) {
+        int i = nodo->posicion;
+        cantidad--;
+        sensores[i] = sensores[cantidad];
+        nodos[i] = nodos[cantidad];
+        nodos[i]->posicion = i;
+    }
+
+    /**
+     * @brief Vacía la partición conservando la memoria reservada
+     */
+    void vaciar() { cantidad = 0; }
+
+    /**
+     * @brief Visita los sensores de la partición (en orden de almacenamiento)
+     * @param visitar Función llamada con cada S*
+     */
+    template <typename F>
+    void paraCada(F visitar) const {
+        for (int i = 0; i < cantidad; i++) {
+            visitar(sensores[i]);
+        }
+    }
+
+    S* const* obtenerSensores() const { return sensores; }
+    int obtenerCantidad() const { return cantidad; }
+};
+
+#endif // PARTICION_SENSORES_H
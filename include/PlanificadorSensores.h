@@ -0,0 +1,159 @@
+/**
+ * @file PlanificadorSensores.h
+ * @brief Rueda temporal jerárquica que procesa cada sensor según su propio periodo
+ * @details procesarTodosSensores() recorre todos los sensores en cada llamada. Con
+ * periodos distintos por sensor (unos cada segundo, otros cada minuto) basta procesar los
+ * que vencen: PlanificadorSensores los guarda en NIVELES ruedas de RANURAS ranuras, cada
+ * nivel RANURAS veces más grueso que el anterior. Una tarea se coloca en el nivel más bajo
+ * en el que su vencimiento y el tick actual solo difieren dentro de ese nivel, y baja de
+ * nivel (cascada) cuando el tick actual entra en su ranura. Así programar y cancelar son
+ * O(1), y avanzar solo toca las tareas que vencen y las ranuras que se vacían en cascada:
+ * un mapa de bits por nivel permite saltar los ticks sin tareas.
+ *
+ * El planificador no mide el tiempo: el llamador decide cuánto dura un tick y lo avanza.
+ */
+
+#ifndef PLANIFICADOR_SENSORES_H
+#define PLANIFICADOR_SENSORES_H
+
+#include "ArenaMemoria.h"
+#include <cstdint>
+#include <iosfwd>
+
+class SensorBase;
+
+/**
+ * @brief Procesamiento periódico de un sensor dentro de la rueda
+ * @details Devuelto por PlanificadorSensores::programar() como identificador para cancelar
+ * o reprogramar; deja de ser válido al cancelarse
+ */
+struct TareaPlanificada {
+    SensorBase* sensor;          ///< Sensor a procesar (no es propiedad del planificador)
+    uint64_t vencimiento;        ///< Tick del siguiente procesamiento
+    unsigned periodo;            ///< Ticks entre procesamientos
+    int nivel;                   ///< Rueda en la que está (-1 = fuera, durante una cascada)
+    int ranura;                  ///< Ranura dentro de la rueda
+    TareaPlanificada* siguiente; ///< Siguiente tarea de la ranura
+    TareaPlanificada* anterior;  ///< Tarea previa de la ranura (cancelación en O(1))
+
+    /**
+     * @brief Constructor de la tarea
+     * @param s Sensor a procesar
+     */
+    TareaPlanificada(SensorBase* s)
+        : sensor(s), vencimiento(0), periodo(1), nivel(-1), ranura(0), siguiente(nullptr), anterior(nullptr) {}
+};
+
+/**
+ * @class PlanificadorSensores
+ * @brief Rueda temporal jerárquica de NIVELES x RANURAS ranuras
+ * @details Las tareas que vencen en el mismo tick se procesan en el orden en que entraron
+ * en su ranura: el de programación en su primer vencimiento; después, una tarea de
+ * periodo corto que vuelve a la ranura queda detrás de las que ya esperaban en ella.
+ * Los sensores deben seguir vivos mientras estén programados: cancelar su tarea antes
+ * de eliminarlos. No es seguro entre hilos.
+ */
+class PlanificadorSensores {
+public:
+    static const int BITS_RANURA = 6;                 ///< log2 de las ranuras por rueda
+    static const int RANURAS = 1 << BITS_RANURA;      ///< Ranuras por rueda (bits de un uint64_t)
+    static const int NIVELES = 4;                     ///< Ruedas: horizonte de RANURAS^NIVELES ticks
+
+    /**
+     * @brief Constructor
+     * @param inicio Tick inicial
+     */
+    explicit PlanificadorSensores(uint64_t inicio = 0);
+
+    PlanificadorSensores(const PlanificadorSensores&) = delete;
+    PlanificadorSensores& operator=(const PlanificadorSensores&) = delete;
+
+    /**
+     * @brief Programa el procesamiento periódico de un sensor
+     * @param sensor Sensor a procesar
+     * @param periodo Ticks entre procesamientos (0 se trata como 1)
+     * @param primero Ticks hasta el primer procesamiento (0 = un periodo)
+     * @return Tarea para cancelar() o reprogramar()
+     * @details Repartir primero entre 1 y periodo evita que todos los sensores de un mismo
+     * periodo venzan en el mismo tick
+     */
+    TareaPlanificada* programar(SensorBase* sensor, unsigned periodo, unsigned primero = 0);
+
+    /**
+     * @brief Deja de procesar un sensor en O(1)
+     * @param tarea Tarea devuelta por programar() (deja de ser válida)
+     */
+    void cancelar(TareaPlanificada* tarea);
+
+    /**
+     * @brief Cambia el periodo de una tarea; el siguiente procesamiento es dentro de un periodo
+     * @param tarea Tarea programada
+     * @param periodo Nuevo periodo en ticks
+     */
+    void reprogramar(TareaPlanificada* tarea, unsigned periodo);
+
+    /**
+     * @brief Avanza el tiempo y procesa los sensores que vencen
+     * @param destino Tick hasta el que avanzar (si no es posterior al actual, no hace nada)
+     * @param salida Flujo donde escriben los sensores procesados
+     * @return Sensores procesados
+     * @details Un sensor cuyo periodo es menor que el avance se procesa una vez por cada
+     * vencimiento, en orden de tick
+     */
+    int avanzarHasta(uint64_t destino, std::ostream& salida);
+
+    /**
+     * @brief Avanza un número de ticks
+     * @see avanzarHasta()
+     */
+    int avanzar(uint64_t ticks, std::ostream& salida);
+
+    /**
+     * @brief Tick actual (todos los vencimientos anteriores o iguales ya se procesaron)
+     */
+    uint64_t obtenerTick() const;
+
+    /**
+     * @brief Tareas programadas
+     */
+    int obtenerCantidad() const;
+
+private:
+    static const uint64_t MASCARA_RANURA = RANURAS - 1;
+
+    uint64_t actual;                                 ///< Tick actual
+    TareaPlanificada* cabezas[NIVELES][RANURAS];     ///< Primera tarea de cada ranura
+    TareaPlanificada* colas[NIVELES][RANURAS];       ///< Última tarea (inserción en orden)
+    uint64_t ocupadas[NIVELES];                      ///< Bit r: la ranura r tiene tareas
+    int cantidad;                                    ///< Tareas programadas
+    PoolNodos<TareaPlanificada> tareas;              ///< Memoria de las tareas
+
+    /**
+     * @brief Coloca una tarea según su vencimiento relativo al tick actual
+     */
+    void insertar(TareaPlanificada* tarea);
+
+    /**
+     * @brief Saca una tarea de su ranura
+     */
+    void desenlazar(TareaPlanificada* tarea);
+
+    /**
+     * @brief Saca todas las tareas de una ranura
+     * @return Primera tarea de la lista extraída
+     */
+    TareaPlanificada* vaciarRanura(int nivel, int ranura);
+
+    /**
+     * @brief Redistribuye las ranuras de los niveles superiores en las que entra el tick actual
+     */
+    void cascada();
+
+    /**
+     * @brief Procesa y vuelve a programar las tareas de la ranura del tick actual
+     * @return Sensores procesados
+     */
+    int disparar(std::ostream& salida);
+};
+
+#endif // PLANIFICADOR_SENSORES_H
@@ -0,0 +1,100 @@
+/**
+ * @file PoolHilos.h
+ * @brief Pool de hilos con robo de trabajo para bucles paralelos
+ * @details Cada hilo tiene su propia cola de rangos de índices: toma trabajo del final
+ * de la suya y, cuando se vacía, roba del principio de las colas de los demás. Así un
+ * sensor con un historial enorme no deja ociosos al resto de hilos.
+ */
+
+#ifndef POOL_HILOS_H
+#define POOL_HILOS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class PoolHilos
+ * @brief Ejecuta una tarea sobre un rango [0, n) repartido entre varios hilos
+ * @details paraCada() bloquea hasta que terminan todas las iteraciones. Las llamadas
+ * a paraCada() desde varios hilos se serializan.
+ */
+class PoolHilos {
+public:
+    /**
+     * @brief Constructor - Arranca los hilos trabajadores
+     * @param hilos Número de hilos (0 = núcleos disponibles)
+     */
+    explicit PoolHilos(int hilos = 0);
+
+    /**
+     * @brief Destructor - Detiene y une los hilos
+     */
+    ~PoolHilos();
+
+    PoolHilos(const PoolHilos&) = delete;
+    PoolHilos& operator=(const PoolHilos&) = delete;
+
+    /**
+     * @brief Llama a tarea(i) para cada i en [0, n)
+     * @param n Número de iteraciones
+     * @param tarea Función a ejecutar; debe ser segura entre índices distintos
+     * @param grano Iteraciones por rango robable (0 = automático)
+     */
+    void paraCada(int n, const std::function<void(int)>& tarea, int grano = 0);
+
+    /**
+     * @brief Número de hilos trabajadores
+     * @return Cantidad de hilos
+     */
+    int obtenerHilos() const;
+
+private:
+    /**
+     * @brief Rango de iteraciones pendiente
+     */
+    struct Rango {
+        int inicio;                              ///< Primera iteración
+        int fin;                                 ///< Una más allá de la última
+        const std::function<void(int)>* tarea;   ///< Tarea de la llamada que lo creó
+    };
+
+    /**
+     * @brief Cola de rangos de un hilo (el dueño saca del final, los ladrones del principio)
+     */
+    struct ColaTrabajo {
+        std::mutex cerrojo;         ///< Protege rangos
+        std::deque<Rango> rangos;   ///< Trabajo pendiente
+    };
+
+    int numHilos;                           ///< Hilos del pool (fijo antes de arrancarlos)
+    std::vector<std::thread> trabajadores;  ///< Hilos del pool
+    std::vector<ColaTrabajo*> colas;        ///< Una cola por hilo
+    std::mutex cerrojoEspera;               ///< Protege generacion/detener
+    std::condition_variable hayTrabajo;     ///< Despierta a los hilos en cada llamada
+    std::condition_variable terminado;      ///< Despierta al llamador al acabar
+    unsigned long generacion;               ///< Se incrementa en cada paraCada()
+    bool detener;                           ///< true al destruir el pool
+    std::atomic<int> restantes;             ///< Rangos sin completar de la llamada actual
+    std::mutex cerrojoLlamada;              ///< Serializa las llamadas a paraCada()
+
+    /**
+     * @brief Bucle de cada hilo trabajador
+     * @param id Índice de su cola
+     */
+    void trabajar(int id);
+
+    /**
+     * @brief Obtiene un rango: primero de la cola propia, si no robando
+     * @param id Índice de la cola propia
+     * @param rango Rango obtenido
+     * @return false si todas las colas están vacías
+     */
+    bool tomar(int id, Rango& rango);
+};
+
+#endif // POOL_HILOS_H
@@ -0,0 +1,87 @@
+/**
+ * @file ProtocoloBinario.h
+ * @brief Protocolo binario por tramas del simulador ESP32 (lotes de lecturas con CRC)
+ * @details Cada trama lleva un lote de lecturas de un mismo sensor:
+ *
+ *     0xA5 0x5A | versión | tipo | id (u16) | n | n valores (i16) | CRC-32C (u32)
+ *
+ * con enteros en little-endian. El tipo es 0 (temperatura, en centésimas de grado) o
+ * 1 (presión). El id numérico se corresponde con el nombre de texto "T-001"/"P-105"
+ * (ver formatearIdSensor). El CRC cubre desde la versión hasta el último valor.
+ *
+ * El primer byte de sincronía no es ASCII, así que las tramas pueden intercalarse con
+ * líneas del protocolo de texto: todo lo que no forma una trama válida se trata como
+ * texto, y tras una trama corrupta la búsqueda se reanuda en el byte siguiente.
+ */
+
+#ifndef PROTOCOLO_BINARIO_H
+#define PROTOCOLO_BINARIO_H
+
+#include "ProtocoloTexto.h"
+#include <cstddef>
+#include <cstdint>
+
+const uint8_t SINCRONIA_TRAMA_0 = 0xA5;   ///< Primer byte de sincronía (fuera de ASCII)
+const uint8_t SINCRONIA_TRAMA_1 = 0x5A;   ///< Segundo byte de sincronía
+const uint8_t VERSION_TRAMA = 1;          ///< Versión del formato
+const int MAX_VALORES_TRAMA = 64;         ///< Lecturas por trama como máximo
+const std::size_t CABECERA_TRAMA = 7;     ///< Sincronía, versión, tipo, id y n
+const std::size_t TAM_MAX_TRAMA = CABECERA_TRAMA + 2 * MAX_VALORES_TRAMA + 4;  ///< Trama más larga
+
+/**
+ * @brief Lote de lecturas decodificado
+ */
+struct TramaBinaria {
+    TipoLectura tipo;                    ///< Tipo de sensor
+    unsigned id;                         ///< Id numérico del sensor
+    int cantidad;                        ///< Lecturas del lote (1..MAX_VALORES_TRAMA)
+    int16_t valores[MAX_VALORES_TRAMA];  ///< Presión o temperatura en centésimas
+};
+
+/**
+ * @brief Trama a medio recibir de un flujo (cada flujo mantiene la suya)
+ */
+struct TramaEnCurso {
+    uint8_t bytes[TAM_MAX_TRAMA];  ///< Bytes recibidos desde la sincronía
+    std::size_t cantidad;           ///< Bytes recibidos (0 = ninguna trama en curso)
+
+    TramaEnCurso() : cantidad(0) {}
+};
+
+/**
+ * @brief Resultado de analizar el inicio de un bloque como trama
+ */
+enum ResultadoTrama {
+    TRAMA_VALIDA,      ///< Trama completa con CRC correcto
+    TRAMA_INCOMPLETA,  ///< La cabecera es plausible pero faltan bytes
+    TRAMA_INVALIDA     ///< No empieza una trama (sincronía, cabecera o CRC incorrectos)
+};
+
+/**
+ * @brief Analiza la trama que empieza en datos[0]
+ * @param datos Bytes recibidos
+ * @param longitud Bytes disponibles
+ * @param trama Salida cuando el resultado es TRAMA_VALIDA
+ * @param bytes Longitud de la trama cuando el resultado es TRAMA_VALIDA
+ */
+ResultadoTrama analizarTrama(const uint8_t* datos, std::size_t longitud, TramaBinaria& trama, std::size_t& bytes);
+
+/**
+ * @brief Codifica un lote de lecturas como trama
+ * @param tipo Tipo de sensor
+ * @param id Id numérico (0..65535)
+ * @param valores Presiones o temperaturas en centésimas
+ * @param n Lecturas (1..MAX_VALORES_TRAMA)
+ * @param destino Búfer de al menos TAM_MAX_TRAMA bytes
+ * @return Bytes escritos (0 si n está fuera de rango)
+ */
+std::size_t codificarTrama(TipoLectura tipo, unsigned id, const int16_t* valores, int n, uint8_t* destino);
+
+/**
+ * @brief Nombre de texto de un id numérico: "T-001", "P-105", "T-1234"...
+ * @param destino Búfer de al menos 8 caracteres
+ * @return Longitud del nombre (sin el '\0')
+ */
+int formatearIdSensor(TipoLectura tipo, unsigned id, char* destino);
+
+#endif // PROTOCOLO_BINARIO_H
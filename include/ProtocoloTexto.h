@@ -0,0 +1,51 @@
+/**
+ * @file ProtocoloTexto.h
+ * @brief Parser del protocolo de texto "TIPO|ID|VALOR" del simulador ESP32
+ * @details El parser no copia ni reserva memoria: el identificador se devuelve como
+ * puntero + longitud dentro del búfer de entrada, válido mientras ese búfer no cambie.
+ */
+
+#ifndef PROTOCOLO_TEXTO_H
+#define PROTOCOLO_TEXTO_H
+
+/**
+ * @brief Tipo de lectura según el prefijo de la línea
+ */
+enum TipoLectura {
+    LECTURA_TEMPERATURA,  ///< "TEMP": valor float
+    LECTURA_PRESION       ///< "PRES": valor int
+};
+
+/**
+ * @brief Resultado de analizar una línea
+ */
+enum ResultadoLinea {
+    LINEA_LECTURA,   ///< Lectura válida
+    LINEA_IGNORADA,  ///< Línea vacía, cabecera o eco del simulador
+    LINEA_INVALIDA   ///< Empieza como lectura pero está mal formada
+};
+
+/**
+ * @brief Vista de una lectura dentro del búfer de entrada
+ */
+struct LecturaTexto {
+    TipoLectura tipo;     ///< Tipo de sensor
+    const char* id;       ///< Identificador (no terminado en '\0')
+    int longitudId;       ///< Caracteres del identificador
+    float valorFloat;     ///< Valor si tipo == LECTURA_TEMPERATURA
+    int valorInt;         ///< Valor si tipo == LECTURA_PRESION
+};
+
+/**
+ * @brief Analiza una línea del protocolo
+ * @param inicio Primer carácter de la línea
+ * @param fin Un carácter después del último (sin el '\n'; un '\r' final se tolera)
+ * @param lectura Salida cuando el resultado es LINEA_LECTURA
+ * @return Clasificación de la línea
+ * @details Solo las líneas que empiezan por "TEMP|" o "PRES|" son lecturas; el resto
+ * (cabecera, "--- Envío #n ---", "[ESP32] Enviado: ...") se ignora. El identificador
+ * solo admite [A-Za-z0-9_-]; cualquier otro carácter hace la línea LINEA_INVALIDA
+ */
+ResultadoLinea analizarLinea(const char* inicio, const char* fin, LecturaTexto& lectura);
+
+#endif // PROTOCOLO_TEXTO_H
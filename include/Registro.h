@@ -0,0 +1,154 @@
+/**
+ * @file Registro.h
+ * @brief Subsistema de registro (logging) con niveles eliminables en compilación
+ * @details Las macros REGISTRO_* desaparecen por completo (ni se evalúan sus argumentos)
+ * cuando su nivel es menor que NIVEL_LOG_COMPILADO, definido por la opción de CMake
+ * SISTEMA_IOT_NIVEL_LOG. Los niveles que se conservan escriben de forma síncrona en
+ * std::cout o, tras Registro::iniciarAsincrono(), en un búfer doble que vacía un hilo
+ * escritor.
+ */
+
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+#include <cstddef>
+#include <sstream>
+
+#define NIVEL_LOG_TRAZA      0  ///< Mensajes por lectura (rutas calientes)
+#define NIVEL_LOG_DEPURACION 1  ///< Ciclo de vida de objetos (constructores/destructores)
+#define NIVEL_LOG_INFO       2  ///< Eventos del sistema de gestión
+#define NIVEL_LOG_AVISO      3  ///< Situaciones anómalas recuperables
+#define NIVEL_LOG_ERROR      4  ///< Errores
+#define NIVEL_LOG_NINGUNO    5  ///< Sin registro
+
+#ifndef NIVEL_LOG_COMPILADO
+#define NIVEL_LOG_COMPILADO NIVEL_LOG_INFO
+#endif
+
+/**
+ * @class Registro
+ * @brief Destino global de los mensajes de registro
+ */
+class Registro {
+public:
+    /**
+     * @brief Filtro de nivel en tiempo de ejecución (solo para niveles compilados)
+     * @param nivel Nivel mínimo a emitir (NIVEL_LOG_*)
+     */
+    static void fijarNivel(int nivel);
+
+    /**
+     * @brief Indica si un nivel compilado está habilitado en tiempo de ejecución
+     * @param nivel Nivel del mensaje
+     * @return true si debe emitirse
+     */
+    static bool habilitado(int nivel);
+
+    /**
+     * @brief Activa el destino asíncrono con búfer doble
+     * @param capacidad Bytes de cada uno de los dos búferes
+     * @details Los productores solo copian el texto al búfer activo; un hilo escritor
+     * lo intercambia y lo vuelca con fwrite. Si el búfer se llena, el productor espera
+     * al escritor (contrapresión) en lugar de perder mensajes.
+     */
+    static void iniciarAsincrono(std::size_t capacidad = 1 << 20);
+
+    /**
+     * @brief Vuelca lo pendiente, detiene el hilo escritor y vuelve al modo síncrono
+     */
+    static void detenerAsincrono();
+
+    /**
+     * @brief Escribe un mensaje ya formateado en el destino actual
+     * @param texto Caracteres del mensaje
+     * @param longitud Número de caracteres
+     */
+    static void escribir(const char* texto, std::size_t longitud);
+
+    /**
+     * @class Linea
+     * @brief Formateador de un mensaje sin memoria dinámica para tipos básicos
+     * @details Acumula en un arreglo fijo y escribe al destruirse
+     */
+    class Linea {
+    public:
+        Linea() : longitud(0) {}
+        ~Linea() { Registro::escribir(texto, longitud); }
+
+        Linea(const Linea&) = delete;
+        Linea& operator=(const Linea&) = delete;
+
+        Linea& operator<<(const char* valor);
+        Linea& operator<<(char valor);
+        Linea& operator<<(int valor);
+        Linea& operator<<(long valor);
+        Linea& operator<<(long long valor);
+        Linea& operator<<(unsigned int valor);
+        Linea& operator<<(unsigned long valor);
+        Linea& operator<<(unsigned long long valor);
+        Linea& operator<<(float valor);
+        Linea& operator<<(double valor);
+
+        /**
+         * @brief Formato para otros tipos mediante su operator<< de ostream
+         */
+        template <typename U>
+        Linea& operator<<(const U& valor) {
+            std::ostringstream flujo;
+            flujo << valor;
+            return *this << flujo.str().c_str();
+        }
+
+    private:
+        static const std::size_t CAPACIDAD = 256;  ///< Longitud máxima de un mensaje
+
+        char texto[CAPACIDAD];  ///< Mensaje formateado
+        std::size_t longitud;   ///< Caracteres ocupados
+    };
+};
+
+/**
+ * @brief Emite un mensaje si su nivel está compilado y habilitado
+ * @details Uso: REGISTRO_INFO("Sensor " << nombre << "\n");
+ */
+#define REGISTRO_EMITIR(nivel, mensaje)                  \
+    do {                                                 \
+        if (Registro::habilitado(nivel)) {               \
+            Registro::Linea lineaRegistro_;              \
+            lineaRegistro_ << mensaje;                   \
+        }                                                \
+    } while (0)
+
+#define REGISTRO_NADA() do {} while (0)
+
+#if NIVEL_LOG_COMPILADO <= NIVEL_LOG_TRAZA
+#define REGISTRO_TRAZA(mensaje) REGISTRO_EMITIR(NIVEL_LOG_TRAZA, mensaje)
+#else
+#define REGISTRO_TRAZA(mensaje) REGISTRO_NADA()
+#endif
+
+#if NIVEL_LOG_COMPILADO <= NIVEL_LOG_DEPURACION
+#define REGISTRO_DEPURACION(mensaje) REGISTRO_EMITIR(NIVEL_LOG_DEPURACION, mensaje)
+#else
+#define REGISTRO_DEPURACION(mensaje) REGISTRO_NADA()
+#endif
+
+#if NIVEL_LOG_COMPILADO <= NIVEL_LOG_INFO
+#define REGISTRO_INFO(mensaje) REGISTRO_EMITIR(NIVEL_LOG_INFO, mensaje)
+#else
+#define REGISTRO_INFO(mensaje) REGISTRO_NADA()
+#endif
+
+#if NIVEL_LOG_COMPILADO <= NIVEL_LOG_AVISO
+#define REGISTRO_AVISO(mensaje) REGISTRO_EMITIR(NIVEL_LOG_AVISO, mensaje)
+#else
+#define REGISTRO_AVISO(mensaje) REGISTRO_NADA()
+#endif
+
+#if NIVEL_LOG_COMPILADO <= NIVEL_LOG_ERROR
+#define REGISTRO_ERROR(mensaje) REGISTRO_EMITIR(NIVEL_LOG_ERROR, mensaje)
+#else
+#define REGISTRO_ERROR(mensaje) REGISTRO_NADA()
+#endif
+
+#endif // REGISTRO_H
@@ -0,0 +1,247 @@
+/**
+ * @file ResumenTemporal.h
+ * @brief Resúmenes por ventanas de tiempo (1 s, 1 min, 1 h) mantenidos en cada lectura
+ * @details Cada resolución es un anillo de cubetas {conteo, suma, mínimo, máximo}
+ * indexado por la marca de tiempo: registrar una lectura actualiza una cubeta por
+ * resolución en O(1), y una consulta de ventana combina cubetas enteras de la resolución
+ * más gruesa que encaja, así que cuesta O(cubetas) y no O(lecturas).
+ */
+
+#ifndef RESUMEN_TEMPORAL_H
+#define RESUMEN_TEMPORAL_H
+
+#include <climits>
+#include "EstadisticasLectura.h"
+
+/**
+ * @brief Cubetas retenidas por cada resolución
+ * @details Los valores por defecto cubren 10 minutos a 1 s, un día a 1 min y una
+ * semana a 1 h (unos 70 KB por sensor con lecturas float)
+ */
+struct PoliticaResumen {
+    int segundos;  ///< Cubetas de 1 s
+    int minutos;   ///< Cubetas de 1 min
+    int horas;     ///< Cubetas de 1 h
+
+    explicit PoliticaResumen(int segundos = 600, int minutos = 1440, int horas = 168)
+        : segundos(segundos), minutos(minutos), horas(horas) {}
+};
+
+/**
+ * @brief Agregados de una ventana de tiempo
+ * @tparam T Tipo de lectura
+ */
+template <typename T>
+struct ResumenVentana {
+    typedef typename AcumuladorLectura<T>::tipo Acumulador;
+
+    long long cantidad;  ///< Lecturas en la ventana
+    Acumulador suma;     ///< Suma de las lecturas
+    T minimo;            ///< Menor lectura (T() si está vacía)
+    T maximo;            ///< Mayor lectura (T() si está vacía)
+
+    ResumenVentana() : cantidad(0), suma(Acumulador()), minimo(T()), maximo(T()) {}
+
+    /**
+     * @brief Promedio de la ventana
+     * @return Suma / conteo convertido a T (T() si está vacía)
+     */
+    T promedio() const {
+        if (cantidad == 0) return T();
+        return static_cast<T>(suma / cantidad);
+    }
+
+    /**
+     * @brief Incorpora los agregados de otra ventana disjunta
+     */
+    void combinar(long long otraCantidad, Acumulador otraSuma, T otroMinimo, T otroMaximo) {
+        if (otraCantidad == 0) return;
+        if (cantidad == 0 || otroMinimo < minimo) minimo = otroMinimo;
+        if (cantidad == 0 || maximo < otroMaximo) maximo = otroMaximo;
+        cantidad += otraCantidad;
+        suma += otraSuma;
+    }
+};
+
+/**
+ * @class ResumenTemporal
+ * @brief Motor de resúmenes a varias resoluciones
+ * @tparam T Tipo de lectura
+ * @details Las marcas de tiempo están en milisegundos y pueden llegar desordenadas
+ * mientras caigan dentro de la retención de cada resolución; las más antiguas se ignoran
+ * en esa resolución. Las ventanas se redondean hacia fuera a cubetas de 1 s, o a las de
+ * la resolución más fina que aún cubra ese tramo si es más antiguo.
+ */
+template <typename T>
+class ResumenTemporal {
+public:
+    typedef typename AcumuladorLectura<T>::tipo Acumulador;
+    static const int NIVELES = 3;  ///< Resoluciones: 1 s, 1 min, 1 h
+
+private:
+    static const long long NINGUNA = LLONG_MIN;  ///< Cubeta o nivel sin lecturas
+
+    /**
+     * @brief Agregados de un intervalo [inicio, inicio + anchura)
+     */
+    struct Cubeta {
+        long long inicio;  ///< Marca inicial (NINGUNA = cubeta vacía)
+        int cantidad;      ///< Lecturas en la cubeta
+        Acumulador suma;   ///< Suma de las lecturas
+        T minimo;          ///< Menor lectura
+        T maximo;          ///< Mayor lectura
+    };
+
+    /**
+     * @brief Anillo de cubetas de una resolución
+     */
+    struct Nivel {
+        long long anchuraMs;  ///< Duración de cada cubeta
+        int capacidad;        ///< Cubetas retenidas
+        Cubeta* cubetas;      ///< Anillo indexado por (marca / anchura) % capacidad
+        long long ultima;     ///< Índice de la cubeta más reciente (NINGUNA = sin lecturas)
+    };
+
+    Nivel niveles[NIVELES];
+
+    /**
+     * @brief División entera redondeada hacia abajo (marcas negativas incluidas)
+     */
+    static long long dividirAbajo(long long a, long long b) {
+        long long q = a / b;
+        return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    }
+
+    /**
+     * @brief Indica si la cubeta de índice i sigue dentro de la retención del nivel
+     */
+    static bool retiene(const Nivel& nivel, long long i) {
+        return nivel.ultima != NINGUNA && i > nivel.ultima - nivel.capacidad;
+    }
+
+    static Cubeta& cubetaDe(const Nivel& nivel, long long i) {
+        long long posicion = i % nivel.capacidad;
+        if (posicion < 0) posicion += nivel.capacidad;
+        return nivel.cubetas[posicion];
+    }
+
+public:
+    /**
+     * @brief Constructor - Reserva todas las cubetas de una vez
+     * @param politica Cubetas retenidas por resolución (al menos una)
+     */
+    explicit ResumenTemporal(const PoliticaResumen& politica = PoliticaResumen()) {
+        const long long anchuras[NIVELES] = {1000LL, 60LL * 1000, 3600LL * 1000};
+        const int capacidades[NIVELES] = {politica.segundos, politica.minutos, politica.horas};
+        for (int k = 0; k < NIVELES; k++) {
+            niveles[k].anchuraMs = anchuras[k];
+            niveles[k].capacidad = capacidades[k] > 0 ? capacidades[k] : 1;
+            niveles[k].cubetas = new Cubeta[niveles[k].capacidad];
+            niveles[k].ultima = NINGUNA;
+            for (int c = 0; c < niveles[k].capacidad; c++) {
+                niveles[k].cubetas[c].inicio = NINGUNA;
+            }
+        }
+    }
+
+    ~ResumenTemporal() {
+        for (int k = 0; k < NIVELES; k++) {
+            delete[] niveles[k].cubetas;
+        }
+    }
+
+    ResumenTemporal(const ResumenTemporal&) = delete;
+    ResumenTemporal& operator=(const ResumenTemporal&) = delete;
+
+    /**
+     * @brief Incorpora una lectura a las cubetas de todas las resoluciones
+     * @param valor Lectura
+     * @param marcaMs Marca de tiempo en milisegundos
+     */
+    void agregar(T valor, long long marcaMs) {
+        for (int k = 0; k < NIVELES; k++) {
+            Nivel& nivel = niveles[k];
+            long long i = dividirAbajo(marcaMs, nivel.anchuraMs);
+            if (nivel.ultima != NINGUNA && i <= nivel.ultima - nivel.capacidad) {
+                continue;  // Más antigua que la retención de este nivel
+            }
+
+            Cubeta& cubeta = cubetaDe(nivel, i);
+            long long inicio = i * nivel.anchuraMs;
+            if (cubeta.inicio != inicio) {
+                // Reutilizar la ranura de una cubeta ya fuera de la retención
+                cubeta.inicio = inicio;
+                cubeta.cantidad = 0;
+                cubeta.suma = Acumulador();
+            }
+            if (cubeta.cantidad == 0 || valor < cubeta.minimo) cubeta.minimo = valor;
+            if (cubeta.cantidad == 0 || cubeta.maximo < valor) cubeta.maximo = valor;
+            cubeta.cantidad++;
+            cubeta.suma += static_cast<Acumulador>(valor);
+            if (nivel.ultima == NINGUNA || i > nivel.ultima) nivel.ultima = i;
+        }
+    }
+
+    /**
+     * @brief Agregados de las lecturas con marca en [desdeMs, hastaMs)
+     * @param desdeMs Inicio de la ventana
+     * @param hastaMs Fin (exclusivo) de la ventana
+     * @return Resumen combinado de las cubetas que cubren la ventana
+     */
+    ResumenVentana<T> consultar(long long desdeMs, long long hastaMs) const {
+        ResumenVentana<T> resumen;
+        const Nivel& fino = niveles[0];
+        const Nivel& grueso = niveles[NIVELES - 1];
+        if (fino.ultima == NINGUNA) return resumen;
+
+        // Antes de la retención del nivel más grueso no queda nada; después de la última
+        // cubeta fina, tampoco
+        long long t = desdeMs;
+        long long primera = (grueso.ultima - grueso.capacidad + 1) * grueso.anchuraMs;
+        if (t < primera) t = primera;
+        long long fin = (fino.ultima + 1) * fino.anchuraMs;
+        if (hastaMs < fin) fin = hastaMs;
+
+        while (t < fin) {
+            // Cubeta entera de la resolución más gruesa que empiece en t y quepa en la ventana
+            int usado = -1;
+            for (int k = NIVELES - 1; k >= 0 && usado < 0; k--) {
+                const Nivel& nivel = niveles[k];
+                if (t % nivel.anchuraMs == 0 && t + nivel.anchuraMs <= hastaMs &&
+                    retiene(nivel, t / nivel.anchuraMs)) {
+                    usado = k;
+                }
+            }
+            // Si no: borde de la ventana, redondeado a la resolución más fina que cubra t
+            for (int k = 0; k < NIVELES && usado < 0; k++) {
+                if (retiene(niveles[k], dividirAbajo(t, niveles[k].anchuraMs))) usado = k;
+            }
+            if (usado < 0) break;
+
+            const Nivel& nivel = niveles[usado];
+            long long i = dividirAbajo(t, nivel.anchuraMs);
+            const Cubeta& cubeta = cubetaDe(nivel, i);
+            if (cubeta.inicio == i * nivel.anchuraMs) {
+                resumen.combinar(cubeta.cantidad, cubeta.suma, cubeta.minimo, cubeta.maximo);
+            }
+            t = (i + 1) * nivel.anchuraMs;
+        }
+        return resumen;
+    }
+
+    /**
+     * @brief Marca de tiempo de la cubeta de 1 s más reciente
+     * @return Inicio de esa cubeta en ms, o LLONG_MIN si no hay lecturas
+     */
+    long long obtenerUltimaMarca() const {
+        return niveles[0].ultima == NINGUNA ? NINGUNA : niveles[0].ultima * niveles[0].anchuraMs;
+    }
+};
+
+template <typename T>
+const int ResumenTemporal<T>::NIVELES;
+
+template <typename T>
+const long long ResumenTemporal<T>::NINGUNA;
+
+#endif // RESUMEN_TEMPORAL_H
@@ -7,6 +7,8 @@
 #ifndef SENSOR_BASE_H
 #define SENSOR_BASE_H
 
+#include <iosfwd>
+
 /**
  * @class SensorBase
  * @brief Clase abstracta que define la interfaz para todos los sensores
@@ -16,6 +18,12 @@ class SensorBase {
 protected:
     char nombre[50];  ///< Identificador único del sensor (máx. 50 caracteres)
 
+    /**
+     * @brief Indica si el nombre puede usarse como nombre de archivo dentro de un directorio
+     * @return false si está vacío, empieza por '.' o contiene '/' (saldría del directorio)
+     */
+    bool nombreValidoComoArchivo() const;
+
 public:
     /**
      * @brief Constructor con nombre del sensor
@@ -34,6 +42,24 @@ public:
      * @details Cada sensor implementa su propia lógica de procesamiento
      */
     virtual void procesarLectura() = 0;
+
+    /**
+     * @brief Procesa las lecturas escribiendo el resultado en un flujo
+     * @param salida Flujo donde se escribe el resultado del procesamiento
+     * @details Por defecto llama a procesarLectura(), que escribe en std::cout y no en
+     * salida. Los sensores que escriben solo en salida lo redefinen (y procesarLectura()
+     * lo llama con std::cout) junto con procesaEnParalelo(). Una subclase de un sensor que
+     * lo redefine debe redefinir esta versión para cambiar el procesamiento
+     */
+    virtual void procesarLectura(std::ostream& salida);
+
+    /**
+     * @brief Indica si procesarLectura(salida) puede ejecutarse en otro hilo
+     * @return true si escribe solo en salida y modifica solo el propio sensor
+     * @details Por defecto false: los sistemas procesan estos sensores en su turno desde
+     * un solo hilo, escribiendo directamente en std::cout
+     */
+    virtual bool procesaEnParalelo() const;
     
     /**
      * @brief Método virtual puro para imprimir información del sensor
@@ -8,6 +8,12 @@
 
 #include "SensorBase.h"
 #include "ListaSensor.h"
+#include "HistorialCircular.h"
+#include "ColaLecturas.h"
+#include "AlmacenSegmentos.h"
+#include "ResumenTemporal.h"
+#include "BosquejoCuantiles.h"
+#include "MotorReglas.h"
 
 /**
  * @class SensorPresion
@@ -16,14 +22,28 @@
  */
 class SensorPresion : public SensorBase {
 private:
-    ListaSensor<int> historial;  ///< Lista enlazada de lecturas int
+    ListaSensor<int, TAM_BLOQUE_LECTURAS> historial;  ///< Lista enlazada (por bloques) de lecturas int
+    HistorialCircular<int>* historialAcotado;  ///< Historial acotado (nullptr = sin retención)
+    ColaLecturas<int>* pendientes;  ///< Cola de ingesta concurrente (nullptr = solo registrarLectura)
+    AlmacenSegmentos<int>* segmentos;  ///< Lecturas antiguas selladas en disco (nullptr = solo memoria)
+    int limiteMemoria;  ///< Lecturas en memoria a partir de las que se sellan las antiguas
+    ResumenTemporal<int>* resumenes;  ///< Cubetas por ventana de tiempo (nullptr = desactivados)
+    BosquejoCuantiles<int> cuantiles;  ///< Cuantiles de todas las lecturas recibidas
+    EstadoReglas* reglas;  ///< Estado de las reglas de alerta (nullptr = sin reglas)
+
+    /**
+     * @brief Sella en un segmento las lecturas más antiguas del historial en memoria
+     * @details Deja en memoria la mitad del límite, así que cada sellado cubre un lote grande
+     */
+    void volcarAntiguas();
 
 public:
     /**
      * @brief Constructor con identificador del sensor
      * @param id Nombre único del sensor de presión
+     * @param arena Arena compartida para los nodos del historial (nullptr = pool propio)
      */
-    SensorPresion(const char* id);
+    SensorPresion(const char* id, ArenaMemoria* arena = nullptr);
     
     /**
      * @brief Destructor
@@ -36,18 +56,171 @@ public:
      * @param valor Lectura en unidades de presión (int)
      */
     void registrarLectura(int valor);
+
+    /**
+     * @brief Registra una lectura con marca de tiempo explícita
+     * @param valor Lectura
+     * @param marcaMs Marca en milisegundos; con retención por edad debe ser no decreciente y
+     * del reloj milisegundosMonotonos()
+     * @details registrarLectura(valor) usa milisegundosMonotonos() cuando hace falta marca
+     */
+    void registrarLectura(int valor, long long marcaMs);
     
     /**
      * @brief Implementación del procesamiento específico para presión
      * @details Calcula el promedio de todas las lecturas almacenadas
      */
+    void procesarLectura(std::ostream& salida) override;
+
+    /**
+     * @brief Procesa escribiendo en la salida estándar
+     */
     void procesarLectura() override;
+
+    /**
+     * @brief procesarLectura(salida) escribe solo en salida
+     * @return true
+     */
+    bool procesaEnParalelo() const override;
+
+    /**
+     * @brief Procesa un lote de sensores de este tipo exacto sin pasar por la tabla virtual
+     * @param sensores Arreglo de sensores (ninguno puede ser una subclase)
+     * @param n Número de sensores
+     * @param salida Flujo donde se escriben los resultados
+     * @details Definido junto a procesarLectura() para que el compilador pueda expandirla
+     */
+    static void procesarLote(SensorPresion* const* sensores, int n, std::ostream& salida);
     
     /**
      * @brief Implementación de impresión de información del sensor
      * @details Muestra el nombre, tipo y número de lecturas almacenadas
      */
     void imprimirInfo() const override;
+
+    /**
+     * @brief Acota el historial con una política de retención
+     * @param politica Capacidad, edad máxima y submuestreo
+     * @details Las lecturas actuales pasan al búfer circular (las más recientes si no caben);
+     * a partir de aquí la memoria del sensor es constante
+     */
+    void fijarRetencion(const PoliticaRetencion& politica);
+
+    /**
+     * @brief Envía las lecturas antiguas a un archivo de segmentos comprimidos
+     * @param directorio Directorio existente; el archivo es "<directorio>/<nombre>.seg"
+     * @param lecturasEnMemoria Máximo de lecturas que se mantienen en memoria
+     * @return false si el archivo no pudo abrirse o el historial está acotado
+     * @details Si el archivo ya existe, sus segmentos forman parte del historial.
+     * Incompatible con fijarRetencion(): un historial acotado ya tiene memoria constante
+     */
+    bool fijarSegmentos(const char* directorio, int lecturasEnMemoria = 65536);
+
+    /**
+     * @brief Promedio del historial completo (memoria y segmentos)
+     * @return Promedio (0 si no hay lecturas)
+     */
+    int calcularPromedio() const;
+
+    /**
+     * @brief Menor lectura del historial completo (memoria y segmentos)
+     * @return Mínimo (0 si no hay lecturas)
+     */
+    int obtenerMinimo() const;
+
+    /**
+     * @brief Mantiene resúmenes por ventana de tiempo (1 s, 1 min, 1 h) en cada lectura
+     * @param politica Cubetas retenidas por resolución
+     * @details Cubren las lecturas registradas desde ahora (no las cargadas de una
+     * instantánea, que no llevan marca)
+     */
+    void activarResumenes(const PoliticaResumen& politica = PoliticaResumen());
+
+    /**
+     * @brief Agregados de las lecturas con marca en [desdeMs, hastaMs)
+     * @return Resumen vacío si los resúmenes no están activos
+     * @details O(cubetas): no recorre las lecturas
+     */
+    ResumenVentana<int> consultarVentana(long long desdeMs, long long hastaMs) const;
+
+    /**
+     * @brief Agregados de los últimos duracionMs milisegundos
+     * @param duracionMs Longitud de la ventana
+     * @param ahoraMs Fin de la ventana (por defecto, el reloj de registrarLectura(valor))
+     */
+    ResumenVentana<int> consultarUltimos(long long duracionMs, long long ahoraMs = milisegundosMonotonos()) const;
+
+    /**
+     * @brief Cuantil estimado de todas las lecturas recibidas
+     * @param q Fracción en [0, 1] (0,5 = p50, 0,99 = p99)
+     * @return Lectura estimada (0 si no hay lecturas)
+     * @details Cubre el flujo completo (también lecturas ya eliminadas, selladas en disco
+     * o descartadas por la retención); error de rango de ~1,65 % (ver BosquejoCuantiles)
+     */
+    int obtenerCuantil(double q) const;
+
+    /**
+     * @brief Bosquejo de cuantiles del sensor, para combinarlo con los de otros
+     */
+    const BosquejoCuantiles<int>& obtenerCuantiles() const;
+
+    /**
+     * @brief Evalúa las reglas de alerta de presión en cada lectura registrada
+     * @param motor Motor con las reglas ya compiladas (nullptr = desactivar)
+     * @details Las alertas se publican en la cola del motor. Las lecturas cargadas de una
+     * instantánea no se evalúan
+     */
+    void fijarReglas(MotorReglas* motor);
+
+    /**
+     * @brief Número de lecturas almacenadas en el historial
+     * @return Lecturas del historial en memoria (acotado o no; sin las selladas en disco)
+     */
+    int obtenerCantidadLecturas() const;
+
+    /**
+     * @brief Visita las lecturas del historial en memoria en orden de inserción
+     * @param visitar Función llamada con cada valor
+     */
+    template <typename F>
+    void recorrerLecturas(F visitar) const {
+        if (historialAcotado != nullptr) {
+            historialAcotado->recorrer(visitar);
+        } else {
+            historial.recorrer(visitar);
+        }
+    }
+
+    /**
+     * @brief Añade al historial un arreglo de lecturas (p. ej. desde una instantánea)
+     * @param datos Lecturas en orden
+     * @param n Número de lecturas
+     */
+    void cargarLecturas(const int* datos, int n);
+
+    /**
+     * @brief Crea la cola de ingesta concurrente del sensor
+     * @param capacidad Lecturas pendientes como máximo
+     * @details Debe llamarse antes de que otros hilos usen encolarLectura()
+     */
+    void activarCola(std::size_t capacidad = 4096);
+
+    /**
+     * @brief Encola una lectura de presión; seguro desde varios hilos, sin cerrojos
+     * @param valor Lectura
+     * @return false si la cola no está activa o está llena (la lectura se pierde)
+     */
+    bool encolarLectura(int valor);
+
+    /**
+     * @brief Aplica al historial, por lotes, las lecturas encoladas
+     * @return Lecturas aplicadas
+     * @details Consumidor único: procesarLectura() lo llama antes de procesar
+     */
+    int aplicarPendientes();
+
+    SensorPresion(const SensorPresion&) = delete;
+    SensorPresion& operator=(const SensorPresion&) = delete;
 };
 
 #endif // SENSOR_PRESION_H
\ No newline at end of file
@@ -0,0 +1,226 @@
+/**
+ * @file ServidorIngesta.h
+ * @brief Servidor de ingesta dirigido por eventos: muchas conexiones en un bucle epoll
+ * @details Multiplexa en un solo hilo las líneas "TIPO|ID|VALOR" de conexiones TCP locales,
+ * puertos serie, ptys y FIFOs. Cada descriptor es no bloqueante y conserva solo su línea
+ * partida (TAM_LINEA bytes); los datos de todas las conexiones listas en una ronda de
+ * epoll_wait se leen a un búfer de ronda compartido, se analizan en él sin copiarlos y
+ * se despachan a SistemaGestion en un único lote por ronda. Así un núcleo atiende miles
+ * de dispositivos sin un hilo lector bloqueado por cada uno. Con el protocolo binario
+ * activo en la ingesta, cada conexión separa además sus propias tramas del texto.
+ */
+
+#ifndef SERVIDOR_INGESTA_H
+#define SERVIDOR_INGESTA_H
+
+#include "IngestaLecturas.h"
+#include <atomic>
+#include <cstddef>
+
+class SistemaGestion;
+class SistemaFragmentado;
+class PlanificadorSensores;
+
+/**
+ * @brief Contadores de conexiones del servidor
+ */
+struct EstadisticasServidor {
+    long long conexionesAceptadas;  ///< Conexiones TCP aceptadas
+    long long conexionesCerradas;   ///< Conexiones y fuentes cerradas (fin de flujo o error)
+    long long bytes;                ///< Bytes leídos de todas las conexiones
+    long long lineasLargas;         ///< Líneas descartadas por superar TAM_LINEA
+    long long rondas;               ///< Rondas de epoll_wait atendidas
+
+    EstadisticasServidor()
+        : conexionesAceptadas(0), conexionesCerradas(0), bytes(0), lineasLargas(0), rondas(0) {}
+};
+
+/**
+ * @class ServidorIngesta
+ * @brief Bucle epoll sobre las conexiones de los dispositivos
+ * @details Cada servidor es un bucle de un solo hilo con su propia IngestaLecturas. Varios
+ * servidores pueden repartirse las conexiones en hilos distintos si comparten un sistema
+ * con los sensores ya registrados y la ingesta en modo cola (fijarModoCola), porque el
+ * registro de sensores no admite cambios concurrentes.
+ */
+class ServidorIngesta {
+public:
+    static const std::size_t TAM_LINEA = 128;          ///< Línea partida máxima por conexión
+    static const std::size_t TAM_LECTURA = 16 * 1024;  ///< Bytes por read() de una conexión
+    static const std::size_t TAM_RONDA = 256 * 1024;   ///< Búfer compartido de una ronda
+    static const int MAX_EVENTOS = 256;                ///< Eventos por epoll_wait
+
+    /**
+     * @brief Constructor - Crea la instancia epoll y el descriptor de despertar
+     * @param sistema Sistema que recibe las lecturas
+     */
+    explicit ServidorIngesta(SistemaGestion& sistema);
+
+    /**
+     * @brief Constructor - Las lecturas se reparten entre los fragmentos de un sistema
+     * @param fragmentos Sistema fragmentado que recibe las lecturas
+     * @details El bucle solo analiza; registrar las lecturas corre en los hilos de los
+     * fragmentos, así que la ingesta escala con los núcleos
+     */
+    explicit ServidorIngesta(SistemaFragmentado& fragmentos);
+
+    /**
+     * @brief Destructor - Cierra todas las conexiones (sus líneas partidas se pierden)
+     */
+    ~ServidorIngesta();
+
+    ServidorIngesta(const ServidorIngesta&) = delete;
+    ServidorIngesta& operator=(const ServidorIngesta&) = delete;
+
+    /**
+     * @brief Ingesta compartida por todas las conexiones
+     * @details Para configurar segmentos, reglas o el modo cola antes de ejecutar(). Su
+     * fijarProtocoloBinario() se aplica a las conexiones y fuentes registradas después
+     */
+    IngestaLecturas& obtenerIngesta();
+
+    /**
+     * @brief Avanza una rueda de procesamiento desde el bucle
+     * @param planificador Rueda a avanzar (nullptr = ninguna); su tick 0 es el inicio de ejecutar()
+     * @param msPorTick Milisegundos por tick
+     * @details ejecutar() limita la espera de epoll_wait al siguiente tick y, tras cada
+     * ronda, procesa los sensores vencidos en std::cout. Para programar los sensores que
+     * se creen, usar también IngestaLecturas::fijarPlanificador()
+     */
+    void fijarPlanificador(PlanificadorSensores* planificador, int msPorTick);
+
+    /**
+     * @brief Acepta conexiones TCP en 127.0.0.1
+     * @param puerto Puerto local (0 = uno libre, ver obtenerPuerto())
+     * @return false si no se pudo abrir el socket
+     */
+    bool escuchar(int puerto);
+
+    /**
+     * @brief Añade un puerto serie, pty o FIFO al bucle
+     * @param ruta Ruta del dispositivo
+     * @return false si no se pudo abrir o no admite epoll (p. ej. un archivo regular)
+     * @details Un terminal se configura en modo crudo a 115200 baudios
+     */
+    bool agregarFuente(const char* ruta);
+
+    /**
+     * @brief Añade al bucle un descriptor ya abierto (socket, tubería...)
+     * @param descriptor Descriptor legible; se pasa a modo no bloqueante
+     * @param propio true si el servidor debe cerrarlo
+     * @return false si epoll no lo admite
+     */
+    bool agregarDescriptor(int descriptor, bool propio);
+
+    /**
+     * @brief Atiende una ronda de eventos
+     * @param esperaMs Espera máxima (-1 = indefinida, 0 = no esperar)
+     * @return Eventos atendidos, o -1 si epoll_wait falló
+     */
+    int atender(int esperaMs);
+
+    /**
+     * @brief Atiende rondas hasta detener() o, si no se escucha, hasta cerrar todas las fuentes
+     * @return false si el bucle terminó por un error
+     */
+    bool ejecutar();
+
+    /**
+     * @brief Pide a ejecutar() que termine
+     * @details Seguro desde otro hilo o desde un manejador de señales
+     */
+    void detener();
+
+    /**
+     * @brief Puerto TCP en el que se escucha (0 si no se escucha)
+     */
+    int obtenerPuerto() const;
+
+    /**
+     * @brief Conexiones y fuentes abiertas
+     */
+    int obtenerConexionesAbiertas() const;
+
+    /**
+     * @brief Contadores del servidor (los de líneas y lecturas están en obtenerIngesta())
+     */
+    const EstadisticasServidor& obtenerEstadisticas() const;
+
+private:
+    /**
+     * @brief Estado por conexión: la línea partida y, con tramas, la trama en curso
+     */
+    struct Conexion {
+        int descriptor;          ///< Descriptor no bloqueante
+        bool propio;             ///< true si debe cerrarse
+        int posicion;            ///< Índice en conexiones (para quitarla en O(1))
+        std::size_t pendiente;   ///< Bytes de la línea partida
+        bool descartandoLinea;   ///< Se está saltando una línea mayor que TAM_LINEA
+        char linea[TAM_LINEA];   ///< Línea partida
+        TramaEnCurso* trama;     ///< Trama binaria en curso (nullptr = solo texto)
+    };
+
+    struct TextoConexion;
+
+    IngestaLecturas ingesta;       ///< Análisis y despacho por lotes
+    int epoll;                     ///< Instancia epoll
+    int despertador;               ///< eventfd que interrumpe epoll_wait en detener()
+    int escucha;                   ///< Socket de escucha (-1 = ninguno)
+    int puerto;                    ///< Puerto de escucha
+    Conexion** conexiones;         ///< Conexiones abiertas
+    int numConexiones;             ///< Conexiones en uso
+    int capacidad;                 ///< Capacidad del arreglo
+    char* ronda;                   ///< Búfer compartido de la ronda actual
+    std::size_t usado;             ///< Bytes de la ronda aún referenciados por el lote
+    std::atomic<bool> detenido;    ///< Solicitud de parada
+    PlanificadorSensores* planificador;  ///< Rueda avanzada por ejecutar() (nullptr = ninguna)
+    int msPorTick;                 ///< Milisegundos por tick de la rueda
+    EstadisticasServidor estadisticas;  ///< Contadores
+
+    void crecer();
+
+    /**
+     * @brief Registra el descriptor de despertar en la instancia epoll
+     */
+    void iniciarBucle();
+
+    /**
+     * @brief Registra un descriptor no bloqueante en epoll
+     */
+    bool registrar(int descriptor, bool propio);
+
+    /**
+     * @brief Acepta todas las conexiones pendientes
+     */
+    void aceptar();
+
+    /**
+     * @brief Lee una vez de una conexión y acumula sus líneas completas
+     */
+    void leer(Conexion* conexion);
+
+    /**
+     * @brief Lee una vez de una conexión con tramas y separa tramas y texto
+     */
+    void leerMixto(Conexion* conexion);
+
+    /**
+     * @brief Consume un tramo de texto de una conexión con tramas
+     * @details Las líneas completas se analizan en su sitio; si vienen de la trama en
+     * curso o completan la línea partida, el lote se despacha antes de reutilizarlas
+     */
+    void consumirTexto(Conexion* conexion, const char* datos, std::size_t longitud);
+
+    /**
+     * @brief Analiza la línea partida final, quita la conexión de epoll y la libera
+     */
+    void cerrarConexion(Conexion* conexion);
+
+    /**
+     * @brief Reserva espacio en el búfer de ronda (despacha el lote si no queda)
+     * @return Inicio de al menos bytes libres
+     */
+    char* reservarRonda(std::size_t bytes);
+};
+
+#endif // SERVIDOR_INGESTA_H
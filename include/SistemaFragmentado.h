@@ -0,0 +1,240 @@
+/**
+ * @file SistemaFragmentado.h
+ * @brief Gestión de sensores repartida en fragmentos independientes, uno por núcleo
+ * @details Un único SistemaGestion es un punto de serialización: su registro, su arena y
+ * su lista solo admiten un hilo. SistemaFragmentado reparte los sensores por el hash de
+ * su nombre entre N fragmentos que no comparten nada: cada uno tiene su SistemaGestion
+ * (registro, sensores y arena), su IngestaLecturas y un hilo fijado a un núcleo que es el
+ * único que los toca. Lecturas, búsquedas y procesamientos llegan al fragmento dueño como
+ * mensajes por su ColaLecturas, así que el camino caliente no toma cerrojos compartidos.
+ */
+
+#ifndef SISTEMA_FRAGMENTADO_H
+#define SISTEMA_FRAGMENTADO_H
+
+#include "IngestaLecturas.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+class SistemaGestion;
+class SensorBase;
+class MotorReglas;
+
+template <typename T>
+class BosquejoCuantiles;
+
+template <typename T>
+struct ResumenVentana;
+
+/**
+ * @class SistemaFragmentado
+ * @brief Conjunto de SistemaGestion atendidos cada uno por su propio hilo
+ * @details enviarLecturas() es seguro desde varios hilos productores y conserva el orden
+ * de las lecturas de cada productor. Las demás operaciones son síncronas: encolan una
+ * orden detrás de las lecturas ya enviadas y esperan a que el fragmento la ejecute, por lo
+ * que ven todas esas lecturas aplicadas. No deben llamarse desde el hilo de un fragmento.
+ */
+class SistemaFragmentado {
+public:
+    static const int MAX_FRAGMENTOS = 64;                  ///< Fragmentos como máximo
+    static const int TAM_LOTE = IngestaLecturas::TAM_LOTE; ///< Mensajes drenados por vuelta
+
+    /**
+     * @brief Constructor - Crea los fragmentos y arranca sus hilos
+     * @param fragmentos Número de fragmentos (0 = uno por núcleo)
+     * @param fijarNucleos true para fijar el hilo del fragmento i al núcleo i (módulo núcleos)
+     * @param capacidadCola Mensajes en vuelo por fragmento
+     */
+    explicit SistemaFragmentado(int fragmentos = 0, bool fijarNucleos = true, std::size_t capacidadCola = 16384);
+
+    /**
+     * @brief Destructor - Aplica los mensajes pendientes, detiene los hilos y libera los sensores
+     */
+    ~SistemaFragmentado();
+
+    SistemaFragmentado(const SistemaFragmentado&) = delete;
+    SistemaFragmentado& operator=(const SistemaFragmentado&) = delete;
+
+    /**
+     * @brief Número de fragmentos
+     */
+    int obtenerNumFragmentos() const;
+
+    /**
+     * @brief Fragmento dueño de un nombre
+     * @param nombre Identificador (no terminado en '\0')
+     * @param longitud Caracteres del identificador
+     * @return Índice en [0, obtenerNumFragmentos())
+     * @details Usa los bits altos del hash de IndiceSensores: los bajos indexan la tabla de
+     * cada fragmento, que así no recibe solo nombres con los mismos bits bajos
+     */
+    int fragmentoDe(const char* nombre, int longitud) const;
+
+    /**
+     * @brief Fragmento dueño de un nombre terminado en '\0'
+     */
+    int fragmentoDe(const char* nombre) const;
+
+    /**
+     * @brief Registra automáticamente los sensores desconocidos (activo por defecto)
+     * @details Como en IngestaLecturas; debe llamarse antes de enviar lecturas
+     */
+    void fijarCrearDesconocidos(bool crear);
+
+    /**
+     * @brief Envía a segmentos en disco las lecturas antiguas de los sensores que se creen
+     * @param directorio Directorio de los archivos (nullptr = solo memoria); debe seguir
+     * válido mientras vivan los fragmentos
+     * @param lecturasEnMemoria Lecturas que cada sensor mantiene en memoria
+     */
+    void fijarSegmentos(const char* directorio, int lecturasEnMemoria = 65536);
+
+    /**
+     * @brief Evalúa reglas de alerta en los sensores que se creen
+     * @param motor Motor compartido: su cola de alertas admite varios productores
+     */
+    void fijarReglas(MotorReglas* motor);
+
+    /**
+     * @brief Indexa los extremos de los sensores de temperatura que se creen
+     * @see IngestaLecturas::fijarIndiceExtremos()
+     */
+    void fijarIndiceExtremos(bool activo);
+
+    /**
+     * @brief Acota el historial de los sensores que se creen
+     * @see IngestaLecturas::fijarRetencion()
+     */
+    void fijarRetencion(const PoliticaRetencion& politica);
+
+    /**
+     * @brief Mantiene resúmenes temporales en los sensores que se creen
+     * @see IngestaLecturas::fijarResumenes()
+     */
+    void fijarResumenes(bool activo);
+
+    /**
+     * @brief Reparte un lote de lecturas entre los fragmentos dueños
+     * @param lecturas Lecturas analizadas (los identificadores se copian)
+     * @param n Número de lecturas
+     * @details Si la cola de un fragmento está llena, espera a que drene (contrapresión)
+     */
+    void enviarLecturas(const LecturaTexto* lecturas, int n);
+
+    /**
+     * @brief Espera a que se apliquen todas las lecturas enviadas hasta ahora por este hilo
+     */
+    void sincronizar();
+
+    /**
+     * @brief Ejecuta una tarea en el hilo de un fragmento y espera a que termine
+     * @param fragmento Índice del fragmento
+     * @param tarea Función llamada con el SistemaGestion del fragmento
+     */
+    void ejecutarEn(int fragmento, const std::function<void(SistemaGestion&)>& tarea);
+
+    /**
+     * @brief Ejecuta una tarea en todos los fragmentos a la vez y espera a que terminen
+     * @param tarea Función llamada con el índice y el SistemaGestion de cada fragmento;
+     * debe ser segura entre fragmentos distintos
+     */
+    void ejecutarEnTodos(const std::function<void(int, SistemaGestion&)>& tarea);
+
+    /**
+     * @brief Agrega un sensor a su fragmento dueño
+     * @param sensor Sensor asignado con new, sin arena o con la de ese fragmento
+     * @return Igual que SistemaGestion::agregarSensor()
+     */
+    bool agregarSensor(SensorBase* sensor);
+
+    /**
+     * @brief Elimina y destruye un sensor registrado
+     * @return true si existía
+     */
+    bool eliminarSensor(const char* nombre);
+
+    /**
+     * @brief Busca un sensor y lo visita en el hilo de su fragmento
+     * @param nombre Identificador del sensor
+     * @param visitar Función llamada con el sensor si existe
+     * @return true si el sensor existe
+     * @details El sensor solo puede usarse dentro de visitar: fuera, su fragmento puede
+     * estar aplicándole lecturas
+     */
+    bool consultarSensor(const char* nombre, const std::function<void(SensorBase*)>& visitar);
+
+    /**
+     * @brief Número de sensores registrados en todos los fragmentos
+     */
+    int obtenerCantidad();
+
+    /**
+     * @brief Contadores de despacho de todos los fragmentos
+     * @return lecturas, descartadas y sensoresCreados sumados (el resto de campos lo
+     * cuenta la IngestaLecturas que analiza el flujo)
+     */
+    EstadisticasIngesta obtenerEstadisticas();
+
+    /**
+     * @brief Combina los cuantiles de todos los sensores, por tipo de lectura
+     */
+    void combinarCuantiles(BosquejoCuantiles<float>& temperatura, BosquejoCuantiles<int>& presion);
+
+    /**
+     * @brief Combina los resúmenes temporales de los últimos duracionMs de todos los sensores
+     * @see SistemaGestion::combinarUltimos()
+     */
+    void combinarUltimos(long long duracionMs, long long ahoraMs, ResumenVentana<float>& temperatura,
+                         ResumenVentana<int>& presion);
+
+    /**
+     * @brief Procesa todos los sensores, en paralelo entre fragmentos
+     * @details Cada fragmento escribe en su propio búfer, en orden de registro; los búferes
+     * se emiten en orden de fragmento. Los sensores sin procesaEnParalelo() se procesan al
+     * emitir su fragmento, de uno en uno, en su turno dentro del búfer
+     */
+    void procesarTodosSensores();
+
+    /**
+     * @brief Muestra la información de los sensores, fragmento a fragmento
+     */
+    void mostrarTodosSensores();
+
+private:
+    struct Fragmento;
+    struct Espera;
+    struct Mensaje;
+
+    Fragmento** fragmentos;                 ///< Fragmentos (cada uno con su hilo)
+    int numFragmentos;                      ///< Fragmentos creados
+    std::atomic<long long> idsDescartados;  ///< Lecturas con identificador demasiado largo
+
+    /**
+     * @brief Bucle del hilo de un fragmento
+     */
+    static void atender(Fragmento& fragmento);
+
+    /**
+     * @brief Bloquea el hilo de un fragmento hasta que llegue un mensaje
+     * @return false si debe terminar (detenido y sin mensajes)
+     */
+    static bool dormir(Fragmento& fragmento);
+
+    /**
+     * @brief Despierta el hilo de un fragmento si está dormido
+     */
+    static void avisar(Fragmento& fragmento);
+
+    /**
+     * @brief Encola un mensaje, esperando si la cola está llena
+     */
+    static void encolar(Fragmento& fragmento, const Mensaje& mensaje);
+
+    /**
+     * @brief Ejecuta una orden en un fragmento (o en todos, con -1) y espera
+     */
+    void ordenar(int fragmento, const std::function<void(Fragmento&)>& tarea);
+};
+
+#endif // SISTEMA_FRAGMENTADO_H
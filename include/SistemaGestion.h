@@ -8,36 +8,101 @@
 #define SISTEMA_GESTION_H
 
 #include "SensorBase.h"
+#include "ArenaMemoria.h"
+#include "IndiceSensores.h"
+#include "ParticionSensores.h"
+#include <iosfwd>
+
+class PoolHilos;
+class SensorTemperatura;
+class SensorPresion;
+
+template <typename T>
+class BosquejoCuantiles;
+
+template <typename T>
+struct ResumenVentana;
+
+/**
+ * @brief Partición de SistemaGestion a la que pertenece un sensor
+ * @details Solo el tipo exacto cuenta: una subclase de SensorTemperatura definida por el
+ * usuario va a SENSOR_OTRO y se procesa por la tabla virtual
+ */
+enum TipoSensor {
+    SENSOR_OTRO,         ///< Cualquier otra subclase de SensorBase
+    SENSOR_TEMPERATURA,  ///< Exactamente SensorTemperatura
+    SENSOR_PRESION       ///< Exactamente SensorPresion
+};
 
 /**
  * @brief Nodo para la lista de gestión polimórfica (no genérica)
- * @details Almacena punteros a la clase base SensorBase*
+ * @details Almacena punteros a la clase base SensorBase*. El enlace al anterior solo
+ * sirve para desenlazar en O(1) el nodo que localiza el índice hash.
  */
 struct NodoGestion {
     SensorBase* sensor;      ///< Puntero polimórfico al sensor
     NodoGestion* siguiente;  ///< Puntero al siguiente nodo
+    NodoGestion* anterior;   ///< Puntero al nodo previo (eliminación en O(1))
+    TipoSensor tipo;         ///< Partición del sensor
+    int posicion;            ///< Índice del sensor en su partición
     
     /**
      * @brief Constructor del nodo de gestión
      * @param s Puntero al sensor (subclase de SensorBase)
      */
-    NodoGestion(SensorBase* s) : sensor(s), siguiente(nullptr) {}
+    NodoGestion(SensorBase* s)
+        : sensor(s), siguiente(nullptr), anterior(nullptr), tipo(SENSOR_OTRO), posicion(0) {}
 };
 
 /**
  * @class SistemaGestion
  * @brief Gestor principal del sistema IoT de sensores
- * @details Lista enlazada no genérica para gestión polimórfica de sensores heterogéneos
+ * @details Lista enlazada no genérica para gestión polimórfica de sensores heterogéneos.
+ * La lista fija el orden de registro (recorridos deterministas) y un IndiceSensores
+ * resuelve las búsquedas por nombre en O(1). Además cada sensor está en la partición de
+ * su tipo exacto, para los recorridos por lotes sin llamadas virtuales.
  */
 class SistemaGestion {
 private:
     NodoGestion* cabeza;  ///< Primer nodo de la lista de sensores
+    NodoGestion* cola;    ///< Último nodo (agregarSensor en O(1))
+    ArenaMemoria arena;   ///< Arena compartida por los historiales de los sensores
+    PoolNodos<NodoGestion> nodos;  ///< Pool propio de los nodos de gestión
+    IndiceSensores indice;  ///< Índice hash nombre -> nodo
+    PoolHilos* pool;        ///< Hilos de procesamiento (nullptr = secuencial)
+    ParticionSensores<SensorTemperatura, NodoGestion> temperaturas;  ///< Sensores de temperatura
+    ParticionSensores<SensorPresion, NodoGestion> presiones;         ///< Sensores de presión
+    ParticionSensores<SensorBase, NodoGestion> otros;                ///< Tipos definidos por el usuario
+    bool anunciar;          ///< Mostrar los mensajes de inicio y cierre
+
+    /**
+     * @brief Añade el sensor de un nodo a la partición de su tipo exacto
+     */
+    void particionar(NodoGestion* nodo);
+
+    /**
+     * @brief Quita el sensor de un nodo de su partición
+     */
+    void desparticionar(NodoGestion* nodo);
+
+    /**
+     * @brief Procesa los sensores con el pool y emite las salidas en orden de registro
+     * @details Los sensores sin procesaEnParalelo() se procesan en este hilo al llegar su turno
+     */
+    void procesarEnParalelo();
+
+    /**
+     * @brief Actualiza el indicador de lecturas en memoria (si hay métricas compiladas)
+     */
+    void publicarLecturasEnMemoria() const;
 
 public:
     /**
      * @brief Constructor del sistema de gestión
+     * @param anunciar false para no mostrar los mensajes de inicio y cierre (los fragmentos
+     * de SistemaFragmentado, que los muestra una sola vez)
      */
-    SistemaGestion();
+    explicit SistemaGestion(bool anunciar = true);
     
     /**
      * @brief Destructor - Libera en cascada todos los sensores y nodos
@@ -47,8 +112,23 @@ public:
     /**
      * @brief Agrega un sensor al sistema de gestión
      * @param sensor Puntero al sensor (debe ser asignado con new)
+     * @return true si se agregó (el sistema toma su propiedad); false si es nulo o su
+     * nombre ya está registrado (la propiedad sigue siendo del llamador)
+     */
+    bool agregarSensor(SensorBase* sensor);
+
+    /**
+     * @brief Elimina y destruye un sensor registrado
+     * @param nombre Identificador del sensor
+     * @return true si existía
      */
-    void agregarSensor(SensorBase* sensor);
+    bool eliminarSensor(const char* nombre);
+
+    /**
+     * @brief Número de sensores registrados
+     * @return Cantidad de sensores
+     */
+    int obtenerCantidad() const;
     
     /**
      * @brief Busca un sensor por su nombre
@@ -56,18 +136,123 @@ public:
      * @return Puntero al sensor encontrado o nullptr si no existe
      */
     SensorBase* buscarSensor(const char* nombre);
+
+    /**
+     * @brief Busca un sensor por un nombre no terminado en '\0'
+     * @param nombre Primer carácter del identificador
+     * @param longitud Número de caracteres
+     * @return Puntero al sensor encontrado o nullptr si no existe
+     * @details Permite resolver identificadores directamente dentro de un búfer de entrada
+     */
+    SensorBase* buscarSensor(const char* nombre, int longitud);
     
     /**
      * @brief Ejecuta el procesamiento polimórfico de todos los sensores
-     * @details Llama a procesarLectura() de cada sensor mediante polimorfismo
+     * @details Llama a procesarLectura() de cada sensor en orden de registro; los de tipo
+     * exacto SensorTemperatura o SensorPresion con una llamada calificada según su
+     * partición y los demás mediante polimorfismo. En modo paralelo cada sensor con
+     * procesaEnParalelo() escribe en su propio búfer, los demás se procesan en el hilo
+     * llamante y todo se emite en orden de registro, por lo que la salida es idéntica a
+     * la del modo secuencial
      */
     void procesarTodosSensores();
+
+    /**
+     * @brief Procesa los sensores agrupados por tipo, sin llamadas virtuales
+     * @param salida Flujo donde se escriben los resultados
+     * @details Primero todos los SensorTemperatura, luego todos los SensorPresion (cada
+     * grupo en un bucle con despacho estático) y por último los demás tipos mediante
+     * polimorfismo (los que no redefinen procesarLectura(salida) escriben en std::cout).
+     * Dentro de cada grupo el orden no es el de registro, así que el programa no lo usa:
+     * es la variante por lotes que mide el banco de pruebas. Para una salida en orden de
+     * registro usar procesarTodosSensores()
+     */
+    void procesarPorTipo(std::ostream& salida);
+
+    /**
+     * @brief Configura los hilos usados por procesarTodosSensores()
+     * @param hilos 1 = secuencial; 0 = un hilo por núcleo; n > 1 = n hilos
+     * @details No debe llamarse durante un procesamiento
+     */
+    void fijarHilosProcesamiento(int hilos);
+
+    /**
+     * @brief Hilos usados por procesarTodosSensores()
+     * @return 1 en modo secuencial
+     */
+    int obtenerHilosProcesamiento() const;
     
+    /**
+     * @brief Visita los sensores en orden de registro
+     * @param visitar Función llamada con cada SensorBase*
+     */
+    template <typename F>
+    void recorrerSensores(F visitar) const {
+        for (NodoGestion* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            visitar(actual->sensor);
+        }
+    }
+
+    /**
+     * @brief Visita los SensorTemperatura, sin llamadas virtuales
+     * @param visitar Función llamada con cada SensorTemperatura*
+     */
+    template <typename F>
+    void recorrerTemperaturas(F visitar) const {
+        temperaturas.paraCada(visitar);
+    }
+
+    /**
+     * @brief Visita los SensorPresion, sin llamadas virtuales
+     * @param visitar Función llamada con cada SensorPresion*
+     */
+    template <typename F>
+    void recorrerPresiones(F visitar) const {
+        presiones.paraCada(visitar);
+    }
+
+    /**
+     * @brief Visita los sensores de tipos definidos por el usuario
+     * @param visitar Función llamada con cada SensorBase*
+     */
+    template <typename F>
+    void recorrerOtros(F visitar) const {
+        otros.paraCada(visitar);
+    }
+
+    /**
+     * @brief Combina los cuantiles de todos los sensores, por tipo de lectura
+     * @param temperatura Recibe los bosquejos de los SensorTemperatura
+     * @param presion Recibe los bosquejos de los SensorPresion
+     * @details Cuantiles de toda la flota con la misma cota de error que los de un sensor
+     */
+    void combinarCuantiles(BosquejoCuantiles<float>& temperatura, BosquejoCuantiles<int>& presion) const;
+
+    /**
+     * @brief Combina los resúmenes temporales de los últimos duracionMs de todos los sensores
+     * @param duracionMs Longitud de la ventana
+     * @param ahoraMs Fin de la ventana (reloj milisegundosMonotonos())
+     * @param temperatura Recibe los agregados de los SensorTemperatura
+     * @param presion Recibe los agregados de los SensorPresion
+     * @details Los sensores sin activarResumenes() no aportan nada
+     */
+    void combinarUltimos(long long duracionMs, long long ahoraMs, ResumenVentana<float>& temperatura,
+                         ResumenVentana<int>& presion) const;
+
     /**
      * @brief Muestra información de todos los sensores registrados
      */
     void mostrarTodosSensores() const;
     
+    /**
+     * @brief Arena compartida para los historiales de los sensores de este sistema
+     * @return Puntero a la arena (válida mientras viva el sistema)
+     * @details Pasarla al construir un sensor (p. ej. new SensorTemperatura("T-001",
+     * sistema.obtenerArena())) y agregarlo a este sistema; la arena se devuelve en bloque
+     * al liberar el sistema, después de destruir los sensores
+     */
+    ArenaMemoria* obtenerArena();
+
     /**
      * @brief Libera toda la memoria del sistema (llamado por el destructor)
      */
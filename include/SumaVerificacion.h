@@ -0,0 +1,23 @@
+/**
+ * @file SumaVerificacion.h
+ * @brief CRC-32C (Castagnoli) para detectar corrupción en datos persistidos o transmitidos
+ * @details Usa la instrucción crc32 de SSE4.2 si la CPU la tiene (elegido en tiempo de
+ * ejecución) y una tabla de 256 entradas en otro caso; ambos dan el mismo resultado.
+ */
+
+#ifndef SUMA_VERIFICACION_H
+#define SUMA_VERIFICACION_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Calcula o continúa un CRC-32C
+ * @param datos Bytes a verificar
+ * @param longitud Número de bytes
+ * @param previo CRC de los bytes anteriores (0 para empezar)
+ * @return CRC acumulado; calcularCrc32c(b, m, calcularCrc32c(a, n)) equivale al CRC de a·b
+ */
+uint32_t calcularCrc32c(const void* datos, std::size_t longitud, uint32_t previo = 0);
+
+#endif // SUMA_VERIFICACION_H
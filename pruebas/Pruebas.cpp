@@ -0,0 +1,59 @@
+/**
+ * @file Pruebas.cpp
+ * @brief Punto de entrada de sistema_iot_pruebas: ejecuta un grupo de pruebas por nombre
+ */
+
+#include "Pruebas.h"
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Grupo de pruebas registrado
+ */
+struct Grupo {
+    const char* nombre;  ///< Nombre con el que lo invoca ctest
+    int (*ejecutar)();   ///< Devuelve el número de fallos
+};
+
+const Grupo GRUPOS[] = {
+    { "compresion", pruebasCompresion },
+    { "tramas", pruebasTramas },
+    { "demultiplexado", pruebasDemultiplexado },
+    { "cola_lecturas", pruebasColaLecturas },
+    { "indice_sensores", pruebasIndiceSensores },
+    { "historial", pruebasHistorial },
+    { "procesamiento", pruebasProcesamiento },
+    { "reglas", pruebasReglas },
+    { "segmentos", pruebasSegmentos },
+    { "ingesta", pruebasIngesta },
+    { "lista_sensor", pruebasListaSensor },
+    { "indice_extremos", pruebasIndiceExtremos },
+    { "agregados", pruebasAgregados },
+    { "instantanea", pruebasInstantanea },
+    { "cuantiles", pruebasCuantiles },
+    { "planificador", pruebasPlanificador },
+};
+
+}  // namespace
+
+/**
+ * @brief Ejecuta el grupo indicado (o todos sin argumentos)
+ * @return 0 si no hubo fallos
+ */
+int main(int argc, char* argv[]) {
+    int fallos = 0;
+    bool encontrado = false;
+    for (std::size_t i = 0; i < sizeof(GRUPOS) / sizeof(GRUPOS[0]); i++) {
+        if (argc > 1 && std::strcmp(argv[1], GRUPOS[i].nombre) != 0) continue;
+        encontrado = true;
+        int f = GRUPOS[i].ejecutar();
+        std::cout << "[Pruebas] " << GRUPOS[i].nombre << ": " << (f == 0 ? "correcto" : "FALLOS") << "\n";
+        fallos += f;
+    }
+    if (!encontrado) {
+        std::cerr << "[Pruebas] Grupo desconocido: " << argv[1] << "\n";
+        return 2;
+    }
+    return fallos == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file Pruebas.h
+ * @brief Utilidades mínimas de las pruebas unitarias del núcleo (ctest)
+ * @details Cada grupo de pruebas es una función que devuelve el número de fallos;
+ * sistema_iot_pruebas ejecuta el grupo cuyo nombre recibe como argumento.
+ */
+
+#ifndef PRUEBAS_H
+#define PRUEBAS_H
+
+#include <iostream>
+
+/**
+ * @brief Comprueba una condición; si falla, informa y cuenta el fallo en fallos
+ * @details Requiere una variable int fallos en el ámbito de la llamada
+ */
+#define COMPROBAR(condicion)                                                              \
+    do {                                                                                  \
+        if (!(condicion)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": falla " #condicion "\n";       \
+            fallos++;                                                                     \
+        }                                                                                 \
+    } while (0)
+
+/**
+ * @brief Generador pseudoaleatorio reproducible (xorshift64*) para las pruebas
+ */
+class Aleatorio {
+private:
+    unsigned long long estado;  ///< Estado interno (nunca 0)
+
+public:
+    explicit Aleatorio(unsigned long long semilla) : estado(semilla * 2685821657736338717ULL + 1) {}
+
+    /**
+     * @brief Siguientes 32 bits
+     */
+    unsigned int siguiente() {
+        estado ^= estado >> 12;
+        estado ^= estado << 25;
+        estado ^= estado >> 27;
+        return static_cast<unsigned int>((estado * 2685821657736338717ULL) >> 32);
+    }
+
+    /**
+     * @brief Entero en [0, n)
+     */
+    int hasta(int n) { return static_cast<int>(siguiente() % static_cast<unsigned int>(n)); }
+};
+
+/// CompresionSegmento: ida y vuelta, cota del peor caso y bloques truncados
+int pruebasCompresion();
+
+/// ProtocoloBinario: ida y vuelta, prefijos incompletos, bytes alterados y nombres
+int pruebasTramas();
+
+/// Tramas intercaladas con texto en IngestaLecturas y por conexión en ServidorIngesta
+int pruebasDemultiplexado();
+
+/// ColaLecturas: FIFO con vueltas al búfer y varios productores concurrentes
+int pruebasColaLecturas();
+
+/// IndiceSensores: búsquedas tras inserciones y borrados por desplazamiento hacia atrás
+int pruebasIndiceSensores();
+
+/// HistorialCircular: diezmado ponderado por las lecturas que resume cada posición
+int pruebasHistorial();
+
+/// Procesamiento paralelo con sensores que escriben en std::cout (salidas sin mezclar) y
+/// mensajes de inicio y cierre de SistemaFragmentado una sola vez
+int pruebasProcesamiento();
+
+/// MotorReglas: operadores en límites decimales, ventanas y cambios de estado
+int pruebasReglas();
+
+/// AlmacenSegmentos: reapertura, agregados y conteos de más de 2^31 lecturas
+int pruebasSegmentos();
+
+/// IngestaLecturas: retención y resúmenes de los sensores creados (también con fragmentos)
+/// y modo cola con colas llenas y sensores desconocidos
+int pruebasIngesta();
+
+/// ListaSensor: copia y movimiento (con índice), empalme entre arenas y fusión estable
+int pruebasListaSensor();
+
+/// IndiceExtremos: extracción frente a un multiset, empates y compactación de la lista
+int pruebasIndiceExtremos();
+
+/// EstadisticasLectura y ListaSensor: agregados O(1) frente a recorridos, suma ancha de
+/// enteros, suma compensada de flotantes, quitar y combinar
+int pruebasAgregados();
+
+/// Instantanea: ida y vuelta, anexado a sensores existentes y rechazo de bytes alterados
+/// y archivos truncados
+int pruebasInstantanea();
+
+/// BosquejoCuantiles: error de rango bajo la cota documentada, memoria acotada y combinación
+int pruebasCuantiles();
+
+/// PlanificadorSensores: vencimientos y orden tras las cascadas, periodos más allá del
+/// horizonte, cancelación y reprogramación
+int pruebasPlanificador();
+
+#endif // PRUEBAS_H
@@ -0,0 +1,166 @@
+/**
+ * @file PruebasAgregados.cpp
+ * @brief Pruebas de EstadisticasLectura y de los agregados que mantiene ListaSensor
+ */
+
+#include "Pruebas.h"
+#include "EstadisticasLectura.h"
+#include "ListaSensor.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Agregados calculados recorriendo la lista entera, como referencia
+ */
+struct Recorrido {
+    long long cantidad;
+    long double suma;
+    long double sumaCuadrados;
+    double minimo;
+    double maximo;
+};
+
+template <typename T, int N>
+Recorrido recorrer(const ListaSensor<T, N>& lista) {
+    Recorrido r = { 0, 0.0L, 0.0L, 0.0, 0.0 };
+    lista.recorrer([&r](T v) {
+        double x = static_cast<double>(v);
+        if (r.cantidad == 0 || x < r.minimo) r.minimo = x;
+        if (r.cantidad == 0 || x > r.maximo) r.maximo = x;
+        r.cantidad++;
+        r.suma += x;
+        r.sumaCuadrados += static_cast<long double>(x) * x;
+    });
+    return r;
+}
+
+/**
+ * @brief Compara los agregados O(1) de la lista con un recorrido completo
+ */
+template <typename T, int N>
+bool coinciden(const ListaSensor<T, N>& lista) {
+    Recorrido r = recorrer(lista);
+    if (lista.obtenerTamanio() != r.cantidad) return false;
+    if (lista.obtenerEstadisticas().obtenerCantidad() != r.cantidad) return false;
+    if (r.cantidad == 0) return lista.calcularPromedio() == T();
+    double media = static_cast<double>(r.suma / r.cantidad);
+    double varianza = static_cast<double>(r.sumaCuadrados / r.cantidad) - media * media;
+    double tolerancia = 1e-6 * (1.0 + std::fabs(media));
+    // El promedio de enteros se trunca
+    double toleranciaPromedio = std::numeric_limits<T>::is_integer ? 1.0 : 1e-3;
+    return std::fabs(static_cast<double>(lista.obtenerEstadisticas().obtenerSuma()) - static_cast<double>(r.suma)) <=
+               tolerancia * r.cantidad &&
+           std::fabs(static_cast<double>(lista.calcularPromedio()) - media) <= toleranciaPromedio &&
+           std::fabs(lista.calcularVarianza() - varianza) <= 1e-6 * (1.0 + varianza) + 1e-6 &&
+           static_cast<double>(lista.obtenerMinimo()) == r.minimo &&
+           static_cast<double>(lista.obtenerMaximo()) == r.maximo;
+}
+
+/**
+ * @brief Secuencia aleatoria de inserciones, bloques y extracciones comprobando los agregados
+ */
+template <typename T>
+bool secuencia(Aleatorio& aleatorio, bool conIndice, T escala) {
+    ListaSensor<T, 8> lista;
+    if (conIndice) lista.activarIndice();
+    for (int paso = 0; paso < 3000; paso++) {
+        unsigned operacion = aleatorio.hasta(20);
+        T valor = static_cast<T>(static_cast<int>(aleatorio.hasta(2001)) - 1000) / escala;
+        if (operacion < 10 || lista.estaVacia()) {
+            lista.insertar(valor);
+        } else if (operacion < 12) {
+            T bloque[13];
+            for (int i = 0; i < 13; i++) bloque[i] = valor + static_cast<T>(i);
+            lista.insertarBloque(bloque, 13);
+        } else if (operacion < 15) {
+            lista.eliminarMenor();
+        } else if (operacion < 18) {
+            lista.eliminarMayor();
+        } else if (operacion < 19) {
+            lista.descartarPrimeros(static_cast<int>(aleatorio.hasta(5)));
+        } else {
+            lista.recalcularEstadisticas();
+        }
+        if (paso % 25 == 0 && !coinciden(lista)) return false;
+    }
+    return coinciden(lista);
+}
+
+}
+
+int pruebasAgregados() {
+    int fallos = 0;
+    Aleatorio aleatorio(3);
+
+    // Agregados incrementales frente a un recorrido completo, con y sin índice de extremos
+    for (int conIndice = 0; conIndice < 2; conIndice++) {
+        COMPROBAR(secuencia<float>(aleatorio, conIndice != 0, 8.0f));
+        COMPROBAR(secuencia<int>(aleatorio, conIndice != 0, 1));
+    }
+
+    // La suma de presiones va en un acumulador de 64 bits: no desborda con 2^31 de total
+    {
+        EstadisticasLectura<int> presion;
+        const int lecturas = 3000000;
+        for (int i = 0; i < lecturas; i++) presion.agregar(1000000);
+        COMPROBAR(presion.obtenerSuma() == 3000000000000LL);
+        COMPROBAR(presion.promedio() == 1000000);
+        COMPROBAR(presion.varianza() == 0.0);
+    }
+
+    // Suma compensada: un millón de 0.1f no deriva como lo haría una suma en float
+    {
+        EstadisticasLectura<float> temperatura;
+        long double exacta = 0.0L;
+        for (int i = 0; i < 1000000; i++) {
+            temperatura.agregar(0.1f);
+            exacta += 0.1f;
+        }
+        COMPROBAR(std::fabs(static_cast<long double>(temperatura.obtenerSuma()) - exacta) < 1e-6L);
+        COMPROBAR(std::fabs(temperatura.promedio() - 0.1f) < 1e-7f);
+    }
+
+    // Quitar y combinar: mismo resultado que agregar directamente las lecturas que quedan
+    {
+        std::vector<int> valores;
+        for (int i = 0; i < 500; i++) valores.push_back(static_cast<int>(aleatorio.hasta(200)) + 900);
+        EstadisticasLectura<int> izquierda;
+        EstadisticasLectura<int> derecha;
+        EstadisticasLectura<int> todas;
+        for (std::size_t i = 0; i < valores.size(); i++) {
+            (i < 200 ? izquierda : derecha).agregar(valores[i]);
+            todas.agregar(valores[i]);
+        }
+        izquierda.combinar(derecha);
+        COMPROBAR(izquierda.obtenerCantidad() == 500);
+        COMPROBAR(izquierda.obtenerSuma() == todas.obtenerSuma());
+        COMPROBAR(std::fabs(izquierda.varianza() - todas.varianza()) < 1e-6 * todas.varianza());
+        COMPROBAR(izquierda.obtenerMinimo() == todas.obtenerMinimo());
+        COMPROBAR(izquierda.obtenerMaximo() == todas.obtenerMaximo());
+
+        EstadisticasLectura<int> restantes;
+        for (std::size_t i = 100; i < valores.size(); i++) restantes.agregar(valores[i]);
+        for (std::size_t i = 0; i < 100; i++) todas.quitar(valores[i]);
+        COMPROBAR(todas.obtenerCantidad() == 400);
+        COMPROBAR(todas.obtenerSuma() == restantes.obtenerSuma());
+        COMPROBAR(std::fabs(todas.varianza() - restantes.varianza()) < 1e-6 * restantes.varianza());
+
+        // Quitar un extremo deja los extremos pendientes de recalcular
+        EstadisticasLectura<int> extremos;
+        extremos.agregar(1);
+        extremos.agregar(5);
+        extremos.agregar(9);
+        extremos.quitar(5);
+        COMPROBAR(extremos.extremosAlDia());
+        extremos.quitar(9);
+        COMPROBAR(!extremos.extremosAlDia());
+        extremos.fijarExtremos(1, 1);
+        COMPROBAR(extremos.extremosAlDia() && extremos.obtenerMaximo() == 1);
+        extremos.quitar(1);
+        COMPROBAR(extremos.obtenerCantidad() == 0 && extremos.promedio() == 0);
+    }
+    return fallos;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file PruebasColaLecturas.cpp
+ * @brief Pruebas de ColaLecturas (MPSC sin cerrojos)
+ */
+
+#include "Pruebas.h"
+#include "ColaLecturas.h"
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int PRODUCTORES = 4;           ///< Hilos que encolan a la vez
+const unsigned long long POR_PRODUCTOR = 100000;  ///< Lecturas de cada productor
+
+/// Lectura de prueba: productor en los bits altos, número de secuencia en los bajos
+unsigned long long etiqueta(int productor, unsigned long long secuencia) {
+    return (static_cast<unsigned long long>(productor) << 40) | secuencia;
+}
+
+}  // namespace
+
+int pruebasColaLecturas() {
+    int fallos = 0;
+
+    // Un hilo: capacidad, cola llena, orden FIFO y muchas vueltas al búfer
+    ColaLecturas<int> pequena(5);
+    COMPROBAR(pequena.obtenerCapacidad() == 8);
+    COMPROBAR(pequena.estaVacia());
+    int siguiente = 0;
+    int esperado = 0;
+    bool ordenado = true;
+    for (int vuelta = 0; vuelta < 1000; vuelta++) {
+        while (pequena.encolar(siguiente)) siguiente++;
+        COMPROBAR(siguiente - esperado == 8);
+        int lote[3];
+        int n = pequena.drenar(lote, 3);
+        for (int i = 0; i < n; i++) {
+            if (lote[i] != esperado++) ordenado = false;
+        }
+        if (vuelta % 2 == 1) {
+            int resto[8];
+            n = pequena.drenar(resto, 8);
+            for (int i = 0; i < n; i++) {
+                if (resto[i] != esperado++) ordenado = false;
+            }
+            COMPROBAR(pequena.estaVacia());
+        }
+    }
+    COMPROBAR(ordenado);
+    COMPROBAR(ColaLecturas<int>(1).obtenerCapacidad() == 2);
+
+    // Varios productores y un consumidor concurrentes sobre una cola pequeña: cada
+    // lectura llega exactamente una vez y en el orden de su productor
+    ColaLecturas<unsigned long long> cola(64);
+    std::vector<std::thread> productores;
+    for (int p = 0; p < PRODUCTORES; p++) {
+        productores.push_back(std::thread([&cola, p]() {
+            for (unsigned long long s = 0; s < POR_PRODUCTOR; s++) {
+                while (!cola.encolar(etiqueta(p, s))) std::this_thread::yield();
+            }
+        }));
+    }
+
+    std::vector<unsigned long long> siguientes(PRODUCTORES, 0);
+    unsigned long long recibidas = 0;
+    bool enOrden = true;
+    unsigned long long lote[32];
+    while (recibidas < PRODUCTORES * POR_PRODUCTOR) {
+        int n = cola.drenar(lote, 32);
+        if (n == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            int p = static_cast<int>(lote[i] >> 40);
+            unsigned long long s = lote[i] & ((1ULL << 40) - 1);
+            if (p >= PRODUCTORES || s != siguientes[p]) {
+                enOrden = false;
+            } else {
+                siguientes[p]++;
+            }
+        }
+        recibidas += static_cast<unsigned long long>(n);
+    }
+    for (std::size_t i = 0; i < productores.size(); i++) {
+        productores[i].join();
+    }
+    COMPROBAR(enOrden);
+    COMPROBAR(recibidas == PRODUCTORES * POR_PRODUCTOR);
+    COMPROBAR(cola.estaVacia());
+    return fallos;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file PruebasCompresion.cpp
+ * @brief Pruebas de CompresionSegmento
+ */
+
+#include "Pruebas.h"
+#include "CompresionSegmento.h"
+#include <climits>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const unsigned char CENTINELA = 0xCD;  ///< Relleno tras la cota para detectar desbordes
+
+/**
+ * @brief Comprime, comprueba la cota y el relleno, descomprime y compara bit a bit
+ * @details También comprueba que todo prefijo estrictamente más corto se rechaza
+ */
+template <typename T>
+int idaYVuelta(const std::vector<T>& datos) {
+    int fallos = 0;
+    int n = static_cast<int>(datos.size());
+    std::size_t cota = CompresionSegmento::cotaComprimida(n);
+    std::vector<unsigned char> comprimido(cota + 64, CENTINELA);
+
+    std::size_t bytes = CompresionSegmento::comprimir(datos.data(), n, comprimido.data());
+    COMPROBAR(bytes <= cota);
+    bool intacto = true;
+    for (std::size_t i = cota; i < comprimido.size(); i++) {
+        if (comprimido[i] != CENTINELA) intacto = false;
+    }
+    COMPROBAR(intacto);
+
+    std::vector<T> salida(datos.size() + 1);
+    COMPROBAR(CompresionSegmento::descomprimir(comprimido.data(), bytes, salida.data(), n));
+    COMPROBAR(n == 0 || std::memcmp(salida.data(), datos.data(), datos.size() * sizeof(T)) == 0);
+
+    if (n > 0) {
+        bool rechazados = true;
+        std::size_t desde = bytes > 16 ? bytes - 16 : 0;
+        for (std::size_t corto = desde; corto < bytes; corto++) {
+            if (CompresionSegmento::descomprimir(comprimido.data(), corto, salida.data(), n)) rechazados = false;
+        }
+        COMPROBAR(rechazados);
+    }
+    return fallos;
+}
+
+float desdeBits(unsigned int bits) {
+    float valor;
+    std::memcpy(&valor, &bits, sizeof(valor));
+    return valor;
+}
+
+}  // namespace
+
+int pruebasCompresion() {
+    int fallos = 0;
+    Aleatorio aleatorio(15);
+
+    // Casos degenerados
+    fallos += idaYVuelta(std::vector<float>());
+    fallos += idaYVuelta(std::vector<int>());
+    fallos += idaYVuelta(std::vector<float>(1, 21.5f));
+    fallos += idaYVuelta(std::vector<int>(1, INT_MIN));
+    fallos += idaYVuelta(std::vector<float>(1000, 0.0f));
+    fallos += idaYVuelta(std::vector<int>(1000, 85));
+
+    // Series típicas del simulador
+    std::vector<float> temperaturas;
+    std::vector<int> presiones;
+    for (int i = 0; i < 4096; i++) {
+        temperaturas.push_back(20.0f + aleatorio.hasta(3000) / 100.0f);
+        presiones.push_back(70 + aleatorio.hasta(31));
+    }
+    fallos += idaYVuelta(temperaturas);
+    fallos += idaYVuelta(presiones);
+
+    // Peor caso float: patrones de bits arbitrarios (NaN, infinitos, subnormales, -0)
+    // y XOR que alternan todos los bits significativos
+    for (int ronda = 0; ronda < 50; ronda++) {
+        std::vector<float> ruido;
+        int n = 1 + aleatorio.hasta(2000);
+        for (int i = 0; i < n; i++) ruido.push_back(desdeBits(aleatorio.siguiente()));
+        fallos += idaYVuelta(ruido);
+    }
+    std::vector<float> alternos;
+    for (int i = 0; i < 2048; i++) {
+        alternos.push_back(desdeBits(i % 2 == 0 ? 0x00000001u : 0xFFFFFFFFu));
+    }
+    fallos += idaYVuelta(alternos);
+    alternos.clear();
+    for (int i = 0; i < 2048; i++) {
+        alternos.push_back(desdeBits(i % 2 == 0 ? 0x80000000u : 0x00000001u));
+    }
+    fallos += idaYVuelta(alternos);
+
+    // Peor caso int: delta de delta que desborda 32 bits entre extremos
+    for (int ronda = 0; ronda < 50; ronda++) {
+        std::vector<int> ruido;
+        int n = 1 + aleatorio.hasta(2000);
+        for (int i = 0; i < n; i++) ruido.push_back(static_cast<int>(aleatorio.siguiente()));
+        fallos += idaYVuelta(ruido);
+    }
+    std::vector<int> extremos;
+    for (int i = 0; i < 2048; i++) {
+        extremos.push_back(i % 3 == 0 ? INT_MIN : (i % 3 == 1 ? INT_MAX : 0));
+    }
+    fallos += idaYVuelta(extremos);
+    return fallos;
+}
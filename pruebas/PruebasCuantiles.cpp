@@ -0,0 +1,105 @@
+/**
+ * @file PruebasCuantiles.cpp
+ * @brief Pruebas de BosquejoCuantiles: cota del error de rango, memoria acotada y combinación
+ */
+
+#include "Pruebas.h"
+#include "BosquejoCuantiles.h"
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// Cota documentada del error de rango para k = 200
+const double ERROR_RANGO = 0.0165;
+
+const double FRACCIONES[] = { 0.01, 0.05, 0.10, 0.25, 0.50, 0.75, 0.90, 0.95, 0.99 };
+const int NUM_FRACCIONES = 9;
+
+/**
+ * @brief Mayor error de rango relativo sobre FRACCIONES
+ * @details Las lecturas son 0..n-1, así que el rango de una lectura es su valor
+ */
+double errorRango(const BosquejoCuantiles<int>& bosquejo, long long n) {
+    int resultado[NUM_FRACCIONES];
+    bosquejo.cuantiles(FRACCIONES, resultado, NUM_FRACCIONES);
+    double peor = 0.0;
+    for (int j = 0; j < NUM_FRACCIONES; j++) {
+        double error = std::fabs(static_cast<double>(resultado[j]) / static_cast<double>(n) - FRACCIONES[j]);
+        if (error > peor) peor = error;
+    }
+    return peor;
+}
+
+/**
+ * @brief Permutación de 0..n-1 (Fisher-Yates)
+ */
+std::vector<int> permutacion(Aleatorio& aleatorio, int n) {
+    std::vector<int> valores(static_cast<std::size_t>(n));
+    for (int i = 0; i < n; i++) valores[static_cast<std::size_t>(i)] = i;
+    for (int i = n - 1; i > 0; i--) {
+        int j = aleatorio.hasta(i + 1);
+        std::swap(valores[static_cast<std::size_t>(i)], valores[static_cast<std::size_t>(j)]);
+    }
+    return valores;
+}
+
+}
+
+int pruebasCuantiles() {
+    int fallos = 0;
+    Aleatorio aleatorio(17);
+
+    // Con pocas lecturas no se compacta nada: los cuantiles son exactos
+    {
+        BosquejoCuantiles<int> bosquejo;
+        std::vector<int> valores = permutacion(aleatorio, 100);
+        for (std::size_t i = 0; i < valores.size(); i++) bosquejo.agregar(valores[i]);
+        COMPROBAR(bosquejo.cuantil(0.0) == 0 && bosquejo.cuantil(1.0) == 99);
+        COMPROBAR(bosquejo.cuantil(0.50) == 49);
+        COMPROBAR(bosquejo.cuantil(0.95) == 94);
+        COMPROBAR(bosquejo.obtenerRetenidos() == 100);
+        BosquejoCuantiles<int> vacio;
+        COMPROBAR(vacio.cuantil(0.5) == 0 && vacio.obtenerCantidad() == 0);
+    }
+
+    // Orden creciente, decreciente y aleatorio: error de rango bajo la cota y memoria ~3k
+    const int N = 200000;
+    std::vector<int> aleatorias = permutacion(aleatorio, N);
+    for (int orden = 0; orden < 3; orden++) {
+        BosquejoCuantiles<int> bosquejo;
+        for (int i = 0; i < N; i++) {
+            bosquejo.agregar(orden == 0 ? i : orden == 1 ? N - 1 - i : aleatorias[static_cast<std::size_t>(i)]);
+        }
+        COMPROBAR(bosquejo.obtenerCantidad() == N);
+        COMPROBAR(errorRango(bosquejo, N) < ERROR_RANGO);
+        COMPROBAR(bosquejo.obtenerRetenidos() <= 3 * BosquejoCuantiles<int>::K_DEFECTO + 64);
+        COMPROBAR(bosquejo.cuantil(0.0) == 0 && bosquejo.cuantil(1.0) == N - 1);
+    }
+
+    // Flota: diez sensores con rangos disjuntos (ninguno representa a la flota), combinados
+    {
+        const int SENSORES = 10;
+        BosquejoCuantiles<int> sensores[SENSORES];
+        for (int i = 0; i < N; i++) {
+            int valor = aleatorias[static_cast<std::size_t>(i)];
+            sensores[valor / (N / SENSORES)].agregar(valor);
+        }
+        BosquejoCuantiles<int> flota;
+        for (int s = 0; s < SENSORES; s++) flota.combinar(sensores[s]);
+        COMPROBAR(flota.obtenerCantidad() == N);
+        COMPROBAR(errorRango(flota, N) < ERROR_RANGO);
+        COMPROBAR(flota.obtenerRetenidos() <= 3 * BosquejoCuantiles<int>::K_DEFECTO + 64);
+        COMPROBAR(flota.cuantil(0.0) == 0 && flota.cuantil(1.0) == N - 1);
+    }
+
+    // Menor k, más error: la cota escala como 1/k
+    {
+        BosquejoCuantiles<int> bosquejo(50);
+        for (int i = 0; i < N; i++) bosquejo.agregar(aleatorias[static_cast<std::size_t>(i)]);
+        COMPROBAR(errorRango(bosquejo, N) < ERROR_RANGO * 200 / 50);
+        COMPROBAR(bosquejo.obtenerRetenidos() <= 3 * 50 + 64);
+    }
+    return fallos;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file PruebasHistorial.cpp
+ * @brief Pruebas del diezmado de HistorialCircular
+ */
+
+#include "Pruebas.h"
+#include "HistorialCircular.h"
+#include <cmath>
+
+int pruebasHistorial() {
+    int fallos = 0;
+
+    // Un promedio anterior pesa tantas lecturas como resume: (6 + 0) / 2 = 3 con dos
+    // muestras y luego (3 * 2 + 0) / 3 = 2, no (3 + 0) / 2
+    HistorialCircular<float> pequeno(PoliticaRetencion(4, 0, 2));
+    long long marca = 0;
+    pequeno.insertar(6.0f, ++marca);
+    for (int i = 0; i < 4; i++) pequeno.insertar(0.0f, ++marca);
+    COMPROBAR(pequeno.obtenerTamanio() == 4);
+    COMPROBAR(pequeno.obtener(0) == 3.0f);
+    COMPROBAR(pequeno.obtenerMuestras(0) == 2);
+    COMPROBAR(pequeno.obtenerMarca(0) == 2);
+    pequeno.insertar(0.0f, ++marca);
+    COMPROBAR(pequeno.obtener(0) == 2.0f);
+    COMPROBAR(pequeno.obtenerMuestras(0) == 3);
+    COMPROBAR(pequeno.obtenerMuestras(3) == 1);
+
+    // Con diezmado nada se descarta: las muestras suman las lecturas insertadas y la suma
+    // ponderada conserva la de los valores
+    Aleatorio aleatorio(9);
+    HistorialCircular<float> historial(PoliticaRetencion(64, 0, 4));
+    double esperado = 0.0;
+    for (int n = 1; n <= 20000; n++) {
+        float valor = static_cast<float>(aleatorio.hasta(1000)) / 10.0f;
+        historial.insertar(valor, n);
+        esperado += valor;
+    }
+    long long muestras = 0;
+    double suma = 0.0;
+    bool marcasOrdenadas = true;
+    for (int i = 0; i < historial.obtenerTamanio(); i++) {
+        muestras += historial.obtenerMuestras(i);
+        suma += static_cast<double>(historial.obtener(i)) * historial.obtenerMuestras(i);
+        if (i > 0 && historial.obtenerMarca(i) <= historial.obtenerMarca(i - 1)) marcasOrdenadas = false;
+    }
+    COMPROBAR(muestras == 20000);
+    COMPROBAR(std::fabs(suma - esperado) < esperado * 1e-4);
+    COMPROBAR(marcasOrdenadas);
+    COMPROBAR(historial.obtenerMuestras(historial.obtenerTamanio() - 1) == 1);
+
+    // La copia conserva las muestras de cada posición
+    HistorialCircular<float> copia(historial);
+    bool iguales = copia.obtenerTamanio() == historial.obtenerTamanio();
+    for (int i = 0; iguales && i < copia.obtenerTamanio(); i++) {
+        iguales = copia.obtener(i) == historial.obtener(i) && copia.obtenerMuestras(i) == historial.obtenerMuestras(i);
+    }
+    COMPROBAR(iguales);
+
+    // Sin diezmado se descarta la más antigua
+    HistorialCircular<int> sinDiezmar(PoliticaRetencion(3));
+    for (int v = 1; v <= 5; v++) sinDiezmar.insertar(v, v);
+    COMPROBAR(sinDiezmar.obtenerTamanio() == 3);
+    COMPROBAR(sinDiezmar.obtener(0) == 3);
+    COMPROBAR(sinDiezmar.obtenerMuestras(0) == 1);
+
+    return fallos;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file PruebasIndiceExtremos.cpp
+ * @brief Pruebas de IndiceExtremos: orden de extracción, empates y compactación de la lista
+ */
+
+#include "Pruebas.h"
+#include "IndiceExtremos.h"
+#include "ListaSensor.h"
+#include <set>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Lectura con un identificador que no interviene en el orden
+ * @details Permite ver cuál de dos lecturas iguales sale primero
+ */
+struct LecturaMarcada {
+    int valor;  ///< Clave de orden
+    int id;     ///< Orden de inserción
+    bool operator<(const LecturaMarcada& otra) const { return valor < otra.valor; }
+};
+
+std::vector<int> contenido(const ListaSensor<int, 4>& lista) {
+    std::vector<int> valores;
+    lista.recorrer([&valores](int v) { valores.push_back(v); });
+    return valores;
+}
+
+}
+
+int pruebasIndiceExtremos() {
+    int fallos = 0;
+    Aleatorio aleatorio(4);
+
+    // Extracciones alternas de mínimo y máximo frente a un multiset, con registro suelto y
+    // por bloques (este último reconstruye los montículos)
+    for (int porBloques = 0; porBloques < 2; porBloques++) {
+        IndiceExtremos<int> indice;
+        std::multiset<int> referencia;
+        std::vector<int> bloque;
+        for (int i = 0; i < 300; i++) {
+            int valor = static_cast<int>(aleatorio.hasta(100));
+            referencia.insert(valor);
+            bloque.push_back(valor);
+            if (!porBloques) indice.registrar(valor);
+        }
+        if (porBloques) {
+            indice.registrar(bloque[0]);
+            indice.registrarBloque(&bloque[1], static_cast<int>(bloque.size()) - 1);
+        }
+
+        bool iguales = true;
+        for (int i = 0; !referencia.empty(); i++) {
+            int valor = 0;
+            int consultado = 0;
+            if (i % 3 == 2) {
+                iguales = iguales && indice.consultarMayor(consultado) && indice.extraerMayor(valor);
+                std::multiset<int>::iterator mayor = referencia.end();
+                --mayor;
+                iguales = iguales && valor == *mayor && consultado == valor;
+                referencia.erase(mayor);
+            } else {
+                iguales = iguales && indice.consultarMenor(consultado) && indice.extraerMenor(valor);
+                iguales = iguales && valor == *referencia.begin() && consultado == valor;
+                referencia.erase(referencia.begin());
+            }
+        }
+        COMPROBAR(iguales);
+        int valor = 0;
+        COMPROBAR(!indice.extraerMenor(valor) && !indice.extraerMayor(valor));
+        COMPROBAR(indice.obtenerExtraidas() == 300);
+    }
+
+    // En empate sale primero la lectura más antigua, por ambos extremos
+    {
+        IndiceExtremos<LecturaMarcada> indice;
+        const int valores[] = { 5, 1, 5, 9, 1, 9, 5 };
+        for (int i = 0; i < 7; i++) {
+            LecturaMarcada lectura = { valores[i], i };
+            indice.registrar(lectura);
+        }
+        LecturaMarcada lectura;
+        COMPROBAR(indice.extraerMenor(lectura) && lectura.valor == 1 && lectura.id == 1);
+        COMPROBAR(indice.extraerMenor(lectura) && lectura.valor == 1 && lectura.id == 4);
+        COMPROBAR(indice.extraerMayor(lectura) && lectura.valor == 9 && lectura.id == 3);
+        COMPROBAR(indice.extraerMayor(lectura) && lectura.valor == 9 && lectura.id == 5);
+        COMPROBAR(indice.extraerMayor(lectura) && lectura.valor == 5 && lectura.id == 0);
+        COMPROBAR(indice.extraerMenor(lectura) && lectura.valor == 5 && lectura.id == 2);
+        COMPROBAR(!indice.vivo(0) && indice.vivo(6));
+    }
+
+    // Lista con y sin índice ante la misma secuencia de operaciones: mismos extremos y el
+    // mismo orden de lecturas tras cada compactación
+    {
+        ListaSensor<int, 4> indexada;
+        ListaSensor<int, 4> lineal;
+        indexada.activarIndice();
+        bool iguales = true;
+        for (int paso = 0; paso < 2000 && iguales; paso++) {
+            unsigned operacion = aleatorio.hasta(10);
+            if (operacion < 5 || lineal.estaVacia()) {
+                int valor = static_cast<int>(aleatorio.hasta(50));
+                indexada.insertar(valor);
+                lineal.insertar(valor);
+            } else if (operacion < 8) {
+                iguales = indexada.eliminarMenor() == lineal.eliminarMenor();
+            } else {
+                iguales = indexada.eliminarMayor() == lineal.eliminarMayor();
+            }
+            iguales = iguales && indexada.obtenerTamanio() == lineal.obtenerTamanio();
+            if (paso % 50 == 0) iguales = iguales && contenido(indexada) == contenido(lineal);
+        }
+        COMPROBAR(iguales);
+        COMPROBAR(contenido(indexada) == contenido(lineal));
+        COMPROBAR(indexada.obtenerMinimo() == lineal.obtenerMinimo());
+        COMPROBAR(indexada.obtenerMaximo() == lineal.obtenerMaximo());
+
+        // Vaciar por extracción compacta hasta no dejar nodos; la lista sigue utilizable
+        while (!indexada.estaVacia()) indexada.eliminarMayor();
+        COMPROBAR(indexada.obtenerTamanio() == 0);
+        indexada.insertar(8);
+        indexada.insertar(3);
+        COMPROBAR(indexada.eliminarMenor() == 3);
+        COMPROBAR(contenido(indexada) == std::vector<int>{ 8 });
+    }
+    return fallos;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file PruebasIndiceSensores.cpp
+ * @brief Pruebas de IndiceSensores (sondeo lineal con borrado por desplazamiento)
+ */
+
+#include "Pruebas.h"
+#include "IndiceSensores.h"
+#include "SistemaGestion.h"
+#include "SensorPresion.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Comprueba que están exactamente los sensores marcados como presentes
+ */
+bool coincide(const IndiceSensores& indice, const std::vector<NodoGestion*>& nodos,
+              const std::vector<bool>& presentes) {
+    int cantidad = 0;
+    for (std::size_t i = 0; i < nodos.size(); i++) {
+        const char* nombre = nodos[i]->sensor->obtenerNombre();
+        NodoGestion* encontrado = indice.buscar(nombre);
+        if (encontrado != (presentes[i] ? nodos[i] : nullptr)) return false;
+        // Búsqueda sobre un búfer sin '\0' (como la de la ingesta)
+        char bufer[64];
+        int longitud = static_cast<int>(std::strlen(nombre));
+        std::memcpy(bufer, nombre, longitud);
+        bufer[longitud] = '|';
+        if (indice.buscar(bufer, longitud) != encontrado) return false;
+        if (presentes[i]) cantidad++;
+    }
+    return indice.obtenerCantidad() == cantidad;
+}
+
+}  // namespace
+
+int pruebasIndiceSensores() {
+    int fallos = 0;
+    Aleatorio aleatorio(6);
+
+    // Muchas tablas pequeñas: los grupos de colisiones dan la vuelta al final de la
+    // tabla y cada borrado debe recolocar las entradas que siguen al hueco
+    bool correcto = true;
+    for (int ronda = 0; ronda < 300 && correcto; ronda++) {
+        int n = 1 + aleatorio.hasta(40);
+        std::vector<SensorPresion*> sensores;
+        std::vector<NodoGestion*> nodos;
+        for (int i = 0; i < n; i++) {
+            char nombre[32];
+            std::snprintf(nombre, sizeof(nombre), "P-%d-%d", ronda, i);
+            sensores.push_back(new SensorPresion(nombre));
+            nodos.push_back(new NodoGestion(sensores.back()));
+        }
+
+        IndiceSensores indice;
+        std::vector<bool> presentes(n, false);
+        for (int i = 0; i < n; i++) {
+            if (!indice.insertar(nodos[i])) correcto = false;
+            presentes[i] = true;
+        }
+        if (indice.insertar(nodos[0])) correcto = false;  // Nombre repetido
+        if (!coincide(indice, nodos, presentes)) correcto = false;
+
+        // Borrar en orden aleatorio, comprobando todo tras cada borrado
+        for (int k = 0; k < n && correcto; k++) {
+            int i = aleatorio.hasta(n);
+            NodoGestion* quitado = indice.eliminar(nodos[i]->sensor->obtenerNombre());
+            if (quitado != (presentes[i] ? nodos[i] : nullptr)) correcto = false;
+            presentes[i] = false;
+            if (!coincide(indice, nodos, presentes)) correcto = false;
+
+            // A veces reinsertar uno ya borrado
+            int j = aleatorio.hasta(n);
+            if (!presentes[j] && aleatorio.hasta(3) == 0) {
+                if (!indice.insertar(nodos[j])) correcto = false;
+                presentes[j] = true;
+                if (!coincide(indice, nodos, presentes)) correcto = false;
+            }
+        }
+
+        indice.vaciar();
+        COMPROBAR(indice.obtenerCantidad() == 0);
+        COMPROBAR(indice.buscar(nodos[0]->sensor->obtenerNombre()) == nullptr);
+        for (int i = 0; i < n; i++) {
+            delete nodos[i];
+            delete sensores[i];
+        }
+        if (!correcto) std::cerr << "  en la ronda " << ronda << "\n";
+    }
+    COMPROBAR(correcto);
+
+    IndiceSensores vacio;
+    COMPROBAR(vacio.eliminar("P-1") == nullptr);
+    COMPROBAR(vacio.buscar("P-1") == nullptr);
+    COMPROBAR(IndiceSensores::hashNombre("T-001") == IndiceSensores::hashNombre("T-001|45.3", 5));
+    return fallos;
+}
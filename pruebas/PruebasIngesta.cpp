@@ -0,0 +1,119 @@
+/**
+ * @file PruebasIngesta.cpp
+ * @brief Pruebas de las opciones de IngestaLecturas: retención, resúmenes y modo cola
+ */
+
+#include "Pruebas.h"
+#include "IngestaLecturas.h"
+#include "ResumenTemporal.h"
+#include "SistemaGestion.h"
+#include "SistemaFragmentado.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include <string>
+
+namespace {
+
+/**
+ * @brief Flujo de texto con n lecturas de T-1 (0, 1, ..., n-1 °C) y n de P-1 (900, 901, ...)
+ */
+std::string flujoLecturas(int n) {
+    std::string flujo;
+    for (int i = 0; i < n; i++) {
+        flujo += "TEMP|T-1|" + std::to_string(i) + ".00\n";
+        flujo += "PRES|P-1|" + std::to_string(900 + i) + "\n";
+    }
+    return flujo;
+}
+
+}
+
+int pruebasIngesta() {
+    int fallos = 0;
+    const int N = 50;
+    std::string flujo = flujoLecturas(N);
+
+    // Retención: los sensores creados por la ingesta quedan acotados
+    {
+        SistemaGestion sistema;
+        IngestaLecturas ingesta(sistema);
+        ingesta.fijarRetencion(PoliticaRetencion(8));
+        ingesta.consumir(flujo.data(), flujo.size());
+        ingesta.finalizar();
+        COMPROBAR(ingesta.obtenerEstadisticas().lecturas == 2 * N);
+        SensorTemperatura* t = dynamic_cast<SensorTemperatura*>(sistema.buscarSensor("T-1"));
+        SensorPresion* p = dynamic_cast<SensorPresion*>(sistema.buscarSensor("P-1"));
+        COMPROBAR(t != nullptr && p != nullptr);
+        if (t != nullptr && p != nullptr) {
+            COMPROBAR(t->obtenerCantidadLecturas() == 8);
+            COMPROBAR(p->obtenerCantidadLecturas() == 8);
+            COMPROBAR(t->calcularPromedio() == (N - 8 + N - 1) / 2.0f);
+        }
+    }
+
+    // Sin resúmenes los sensores no aportan a combinarUltimos(); con ellos, todas las lecturas
+    for (int activo = 0; activo < 2; activo++) {
+        SistemaGestion sistema;
+        IngestaLecturas ingesta(sistema);
+        ingesta.fijarResumenes(activo != 0);
+        ingesta.consumir(flujo.data(), flujo.size());
+        ingesta.finalizar();
+        ResumenVentana<float> t;
+        ResumenVentana<int> p;
+        sistema.combinarUltimos(60000, milisegundosMonotonos(), t, p);
+        if (activo == 0) {
+            COMPROBAR(t.cantidad == 0 && p.cantidad == 0);
+        } else {
+            COMPROBAR(t.cantidad == N && p.cantidad == N);
+            COMPROBAR(t.minimo == 0.0f && t.maximo == N - 1);
+            COMPROBAR(p.minimo == 900 && p.maximo == 900 + N - 1);
+            COMPROBAR(p.suma == 900LL * N + N * (N - 1) / 2);
+        }
+    }
+
+    // Con fragmentos, retención y resúmenes llegan a los sensores de cada fragmento
+    {
+        SistemaFragmentado sistema(2);
+        IngestaLecturas ingesta(sistema);
+        ingesta.fijarRetencion(PoliticaRetencion(8));
+        ingesta.fijarResumenes(true);
+        ingesta.consumir(flujo.data(), flujo.size());
+        ingesta.finalizar();
+        sistema.sincronizar();
+        ResumenVentana<float> t;
+        ResumenVentana<int> p;
+        sistema.combinarUltimos(60000, milisegundosMonotonos(), t, p);
+        COMPROBAR(t.cantidad == N && p.cantidad == N);
+        COMPROBAR(t.maximo == N - 1 && p.minimo == 900);
+    }
+
+    // Modo cola: las lecturas esperan en la cola hasta aplicarPendientes(); una cola llena y
+    // un sensor desconocido cuentan como descartadas
+    {
+        SistemaGestion sistema;
+        SensorTemperatura* t = new SensorTemperatura("T-1");
+        SensorPresion* p = new SensorPresion("P-1");
+        const int capacidadPresion = 16;  // Potencia de dos: ColaLecturas no la redondea
+        t->activarCola(64);
+        p->activarCola(capacidadPresion);
+        sistema.agregarSensor(t);
+        sistema.agregarSensor(p);
+        IngestaLecturas ingesta(sistema);
+        ingesta.fijarModoCola(true);
+        std::string conDesconocido = flujo + "TEMP|T-2|1.00\n";
+        ingesta.consumir(conDesconocido.data(), conDesconocido.size());
+        ingesta.finalizar();
+
+        const EstadisticasIngesta& e = ingesta.obtenerEstadisticas();
+        COMPROBAR(sistema.buscarSensor("T-2") == nullptr);
+        COMPROBAR(e.lecturas == N + capacidadPresion);
+        COMPROBAR(e.descartadas == N - capacidadPresion + 1);
+        COMPROBAR(t->obtenerCantidadLecturas() == 0);
+        COMPROBAR(t->aplicarPendientes() == N);
+        COMPROBAR(p->aplicarPendientes() == capacidadPresion);
+        COMPROBAR(t->obtenerCantidadLecturas() == N);
+        COMPROBAR(p->obtenerCantidadLecturas() == capacidadPresion);
+        COMPROBAR(t->aplicarPendientes() == 0);
+    }
+    return fallos;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file PruebasInstantanea.cpp
+ * @brief Pruebas de Instantanea: ida y vuelta y rechazo de archivos dañados o truncados
+ */
+
+#include "Pruebas.h"
+#include "Instantanea.h"
+#include "SistemaGestion.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const int SENSORES = 6;
+
+std::string nombreSensor(int i) {
+    // Longitudes variadas: el relleno hasta 8 bytes cambia de un sensor a otro
+    std::string nombre = (i % 2 == 0 ? "T-" : "P-") + std::to_string(i);
+    return nombre + std::string(static_cast<std::size_t>(i), 'x');
+}
+
+/**
+ * @brief Sensores alternos de temperatura y presión; el último, sin lecturas
+ */
+void poblar(SistemaGestion& sistema, Aleatorio& aleatorio) {
+    for (int i = 0; i < SENSORES; i++) {
+        int lecturas = i == SENSORES - 1 ? 0 : 50 + static_cast<int>(aleatorio.hasta(300));
+        if (i % 2 == 0) {
+            SensorTemperatura* t = new SensorTemperatura(nombreSensor(i).c_str());
+            for (int k = 0; k < lecturas; k++) {
+                t->registrarLectura(static_cast<float>(static_cast<int>(aleatorio.hasta(5000)) - 1000) / 100.0f);
+            }
+            sistema.agregarSensor(t);
+        } else {
+            SensorPresion* p = new SensorPresion(nombreSensor(i).c_str());
+            for (int k = 0; k < lecturas; k++) p->registrarLectura(900 + static_cast<int>(aleatorio.hasta(200)));
+            sistema.agregarSensor(p);
+        }
+    }
+}
+
+/**
+ * @brief Lecturas de un sensor en orden (vacío si no existe o es de otro tipo)
+ */
+std::vector<double> lecturas(SistemaGestion& sistema, int i) {
+    std::vector<double> valores;
+    SensorBase* sensor = sistema.buscarSensor(nombreSensor(i).c_str());
+    if (SensorTemperatura* t = dynamic_cast<SensorTemperatura*>(sensor)) {
+        t->recorrerLecturas([&valores](float v) { valores.push_back(v); });
+    } else if (SensorPresion* p = dynamic_cast<SensorPresion*>(sensor)) {
+        p->recorrerLecturas([&valores](int v) { valores.push_back(v); });
+    }
+    return valores;
+}
+
+std::string leerArchivo(const char* ruta) {
+    std::string contenido;
+    FILE* archivo = fopen(ruta, "rb");
+    if (archivo == nullptr) return contenido;
+    char bufer[4096];
+    std::size_t n;
+    while ((n = fread(bufer, 1, sizeof(bufer), archivo)) > 0) contenido.append(bufer, n);
+    fclose(archivo);
+    return contenido;
+}
+
+bool escribirArchivo(const char* ruta, const std::string& contenido) {
+    FILE* archivo = fopen(ruta, "wb");
+    if (archivo == nullptr) return false;
+    bool escrito = fwrite(contenido.data(), 1, contenido.size(), archivo) == contenido.size();
+    return fclose(archivo) == 0 && escrito;
+}
+
+}
+
+int pruebasInstantanea() {
+    int fallos = 0;
+    Aleatorio aleatorio(14);
+
+    char ruta[] = "/tmp/sistema_iot_instantanea_XXXXXX";
+    int descriptor = mkstemp(ruta);
+    COMPROBAR(descriptor >= 0);
+    if (descriptor < 0) return fallos;
+    close(descriptor);
+
+    SistemaGestion original(false);
+    poblar(original, aleatorio);
+    COMPROBAR(Instantanea::guardar(original, ruta));
+
+    // Ida y vuelta: mismos sensores, tipos y lecturas en el mismo orden
+    {
+        SistemaGestion restaurado(false);
+        COMPROBAR(Instantanea::restaurar(restaurado, ruta));
+        COMPROBAR(restaurado.obtenerCantidad() == SENSORES);
+        for (int i = 0; i < SENSORES; i++) {
+            SensorBase* sensor = restaurado.buscarSensor(nombreSensor(i).c_str());
+            COMPROBAR(sensor != nullptr);
+            COMPROBAR((dynamic_cast<SensorTemperatura*>(sensor) != nullptr) == (i % 2 == 0));
+            COMPROBAR(lecturas(restaurado, i) == lecturas(original, i));
+        }
+
+        // Un sensor ya registrado recibe las lecturas al final de su historial
+        SensorTemperatura* t = dynamic_cast<SensorTemperatura*>(restaurado.buscarSensor(nombreSensor(0).c_str()));
+        int antes = t != nullptr ? t->obtenerCantidadLecturas() : 0;
+        COMPROBAR(Instantanea::restaurar(restaurado, ruta));
+        COMPROBAR(restaurado.obtenerCantidad() == SENSORES);
+        COMPROBAR(t != nullptr && t->obtenerCantidadLecturas() == 2 * antes);
+    }
+
+    // Cualquier byte alterado o un archivo truncado se rechaza sin tocar el sistema
+    std::string bueno = leerArchivo(ruta);
+    COMPROBAR(bueno.size() > 64);
+    int aceptados = 0;
+    for (std::size_t i = 0; i < bueno.size(); i++) {
+        std::string danado = bueno;
+        danado[i] = static_cast<char>(danado[i] ^ (1 << (i % 8)));
+        if (!escribirArchivo(ruta, danado)) break;
+        SistemaGestion sistema(false);
+        if (Instantanea::restaurar(sistema, ruta) || sistema.obtenerCantidad() != 0) {
+            aceptados++;
+            std::cerr << "  byte " << i << " alterado aceptado\n";
+        }
+    }
+    COMPROBAR(aceptados == 0);
+    const std::size_t cortes[] = { 0, 7, bueno.size() / 2, bueno.size() - 1 };
+    for (int k = 0; k < 4; k++) {
+        COMPROBAR(escribirArchivo(ruta, bueno.substr(0, cortes[k])));
+        SistemaGestion sistema(false);
+        COMPROBAR(!Instantanea::restaurar(sistema, ruta));
+        COMPROBAR(sistema.obtenerCantidad() == 0);
+    }
+
+    unlink(ruta);
+    SistemaGestion sistema(false);
+    COMPROBAR(!Instantanea::restaurar(sistema, ruta));
+    return fallos;
+}
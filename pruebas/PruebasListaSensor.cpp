@@ -0,0 +1,174 @@
+/**
+ * @file PruebasListaSensor.cpp
+ * @brief Pruebas de ListaSensor: copia y movimiento, empalme y fusión de listas ordenadas
+ */
+
+#include "Pruebas.h"
+#include "ArenaMemoria.h"
+#include "ListaSensor.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// Bloques pequeños: las pruebas cruzan muchos límites de nodo
+typedef ListaSensor<int, 4> Lista;
+
+std::vector<int> contenido(const Lista& lista) {
+    std::vector<int> valores;
+    lista.recorrer([&valores](int v) { valores.push_back(v); });
+    return valores;
+}
+
+void llenar(Lista& lista, const std::vector<int>& valores) {
+    for (std::size_t i = 0; i < valores.size(); i++) lista.insertar(valores[i]);
+}
+
+std::vector<int> aleatorios(Aleatorio& aleatorio, int n) {
+    std::vector<int> valores;
+    for (int i = 0; i < n; i++) valores.push_back(static_cast<int>(aleatorio.hasta(1000)));
+    return valores;
+}
+
+/// Orden por decenas: valores distintos empatan y se ve la estabilidad
+struct MenorDecena {
+    bool operator()(int a, int b) const { return a / 10 < b / 10; }
+};
+
+}
+
+int pruebasListaSensor() {
+    int fallos = 0;
+    Aleatorio aleatorio(13);
+
+    // Copia: mismo contenido y agregados, sin compartir nodos
+    {
+        std::vector<int> valores = aleatorios(aleatorio, 37);
+        Lista original;
+        llenar(original, valores);
+        Lista copia(original);
+        COMPROBAR(contenido(copia) == valores);
+        COMPROBAR(copia.obtenerTamanio() == 37);
+        COMPROBAR(copia.obtenerMinimo() == *std::min_element(valores.begin(), valores.end()));
+        COMPROBAR(copia.obtenerMaximo() == *std::max_element(valores.begin(), valores.end()));
+        original.insertar(5000);
+        original.eliminarMenor();
+        COMPROBAR(contenido(copia) == valores);
+
+        Lista asignada;
+        asignada.insertar(1);
+        asignada = copia;
+        COMPROBAR(contenido(asignada) == valores);
+        Lista& misma = asignada;
+        asignada = misma;
+        COMPROBAR(contenido(asignada) == valores);
+    }
+
+    // Copia con índice: las lecturas ya extraídas no pasan a la copia
+    {
+        Lista original;
+        original.activarIndice();
+        llenar(original, std::vector<int>{ 50, 10, 40, 20, 30, 60 });
+        COMPROBAR(original.eliminarMenor() == 10);
+        COMPROBAR(original.eliminarMayor() == 60);
+        Lista copia(original);
+        COMPROBAR(copia.indiceActivo());
+        COMPROBAR(contenido(copia) == (std::vector<int>{ 50, 40, 20, 30 }));
+        COMPROBAR(copia.eliminarMenor() == 20);
+        COMPROBAR(contenido(original) == (std::vector<int>{ 50, 40, 20, 30 }));
+    }
+
+    // Movimiento: el destino se queda con nodos e índice; el origen, vacío y sin índice
+    {
+        std::vector<int> valores = aleatorios(aleatorio, 21);
+        Lista origen;
+        origen.activarIndice();
+        llenar(origen, valores);
+        Lista movida(std::move(origen));
+        COMPROBAR(origen.estaVacia() && !origen.indiceActivo());
+        COMPROBAR(movida.indiceActivo());
+        COMPROBAR(contenido(movida) == valores);
+        COMPROBAR(movida.eliminarMenor() == *std::min_element(valores.begin(), valores.end()));
+
+        Lista asignada;
+        llenar(asignada, aleatorios(aleatorio, 9));
+        asignada = std::move(movida);
+        COMPROBAR(movida.estaVacia());
+        COMPROBAR(asignada.obtenerTamanio() == 20);
+        origen.insertar(7);
+        COMPROBAR(contenido(origen) == std::vector<int>{ 7 });
+    }
+
+    // Empalme: destino vacío, misma arena (reenlaza) y arenas distintas (copia)
+    ArenaMemoria compartida;
+    for (int caso = 0; caso < 3; caso++) {
+        std::vector<int> primeros = caso == 0 ? std::vector<int>() : aleatorios(aleatorio, 11);
+        std::vector<int> segundos = aleatorios(aleatorio, 14);
+        Lista destino(caso == 2 ? nullptr : &compartida);
+        Lista otra(&compartida);
+        llenar(destino, primeros);
+        llenar(otra, segundos);
+        destino.activarIndice();
+        destino.empalmar(otra);
+
+        std::vector<int> esperado = primeros;
+        esperado.insert(esperado.end(), segundos.begin(), segundos.end());
+        COMPROBAR(otra.estaVacia());
+        COMPROBAR(contenido(destino) == esperado);
+        COMPROBAR(destino.obtenerTamanio() == static_cast<int>(esperado.size()));
+        COMPROBAR(destino.obtenerMaximo() == *std::max_element(esperado.begin(), esperado.end()));
+        // Las lecturas recibidas entran en el índice
+        COMPROBAR(destino.eliminarMenor() == *std::min_element(esperado.begin(), esperado.end()));
+        otra.insertar(3);
+        COMPROBAR(contenido(otra) == std::vector<int>{ 3 });
+    }
+
+    // Empalme de una lista con lecturas ya extraídas por el índice
+    {
+        Lista destino;
+        Lista otra;
+        destino.insertar(100);
+        otra.activarIndice();
+        llenar(otra, std::vector<int>{ 5, 1, 9, 3 });
+        COMPROBAR(otra.eliminarMenor() == 1);
+        destino.empalmar(otra);
+        COMPROBAR(contenido(destino) == (std::vector<int>{ 100, 5, 9, 3 }));
+        COMPROBAR(destino.obtenerMinimo() == 3);
+    }
+
+    // Fusión: resultado ordenado y estable frente a std::merge
+    for (int caso = 0; caso < 4; caso++) {
+        std::vector<int> a = aleatorios(aleatorio, caso * 9);
+        std::vector<int> b = aleatorios(aleatorio, 23 - caso * 5);
+        std::stable_sort(a.begin(), a.end(), MenorDecena());
+        std::stable_sort(b.begin(), b.end(), MenorDecena());
+        Lista izquierda;
+        Lista derecha;
+        llenar(izquierda, a);
+        llenar(derecha, b);
+        izquierda.fusionar(derecha, MenorDecena());
+
+        std::vector<int> esperado;
+        std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(esperado), MenorDecena());
+        COMPROBAR(derecha.estaVacia());
+        COMPROBAR(contenido(izquierda) == esperado);
+        COMPROBAR(izquierda.obtenerTamanio() == static_cast<int>(esperado.size()));
+    }
+
+    // Fusión con el orden natural y una lista con extraídas
+    {
+        Lista izquierda;
+        Lista derecha;
+        izquierda.activarIndice();
+        llenar(izquierda, std::vector<int>{ 1, 4, 6, 8 });
+        llenar(derecha, std::vector<int>{ 2, 3, 7 });
+        COMPROBAR(izquierda.eliminarMayor() == 8);
+        izquierda.fusionar(derecha);
+        COMPROBAR(contenido(izquierda) == (std::vector<int>{ 1, 2, 3, 4, 6, 7 }));
+        COMPROBAR(izquierda.eliminarMayor() == 7);
+        COMPROBAR(izquierda.eliminarMenor() == 1);
+    }
+    return fallos;
+}
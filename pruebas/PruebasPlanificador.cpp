@@ -0,0 +1,187 @@
+/**
+ * @file PruebasPlanificador.cpp
+ * @brief Pruebas de PlanificadorSensores: vencimientos tras las cascadas, más allá del
+ * horizonte de la rueda, orden dentro de un tick, cancelación y reprogramación
+ */
+
+#include "Pruebas.h"
+#include "PlanificadorSensores.h"
+#include "SensorBase.h"
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Procesamiento registrado: tick y orden de programación del sensor
+ */
+struct Disparo {
+    uint64_t tick;
+    int sensor;
+    bool operator<(const Disparo& otro) const {
+        return tick != otro.tick ? tick < otro.tick : sensor < otro.sensor;
+    }
+    bool operator==(const Disparo& otro) const { return tick == otro.tick && sensor == otro.sensor; }
+};
+
+/**
+ * @brief Sensor que anota en qué tick lo procesa el planificador
+ */
+class SensorSonda : public SensorBase {
+public:
+    int indice;                             ///< Orden en que se programó
+    const PlanificadorSensores* reloj;      ///< Planificador que lo procesa
+    std::vector<Disparo>* disparos;         ///< Registro compartido
+
+    SensorSonda(int indice, const PlanificadorSensores* reloj, std::vector<Disparo>* disparos)
+        : SensorBase("sonda"), indice(indice), reloj(reloj), disparos(disparos) {}
+
+    void procesarLectura() override {
+        Disparo d = { reloj->obtenerTick(), indice };
+        disparos->push_back(d);
+    }
+
+    void imprimirInfo() const override {}
+};
+
+/**
+ * @brief Vencimientos de una tarea en (desde, hasta], empezando en primero
+ */
+void vencimientos(std::vector<Disparo>& esperado, int sensor, uint64_t primero, unsigned periodo, uint64_t hasta) {
+    for (uint64_t tick = primero; tick <= hasta; tick += periodo) {
+        Disparo d = { tick, sensor };
+        esperado.push_back(d);
+    }
+}
+
+}
+
+int pruebasPlanificador() {
+    int fallos = 0;
+    Aleatorio aleatorio(25);
+    std::ostringstream salida;
+
+    // Periodos mezclados que cruzan los límites de las ruedas (64, 4096, 262144) y avances
+    // irregulares: cada sensor se procesa en cada uno de sus vencimientos y en ningún otro tick
+    {
+        const uint64_t FIN = 300000;
+        PlanificadorSensores planificador(5);
+        std::vector<Disparo> disparos;
+        std::vector<Disparo> esperado;
+        std::vector<SensorSonda*> sondas;
+        const unsigned periodos[] = { 1, 3, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 262145 };
+        for (int i = 0; i < 200; i++) {
+            unsigned periodo = i < 11 ? periodos[i] : 7 + static_cast<unsigned>(aleatorio.hasta(9000));
+            unsigned primero = i % 3 == 0 ? 0 : 1 + static_cast<unsigned>(aleatorio.hasta(static_cast<int>(periodo)));
+            sondas.push_back(new SensorSonda(i, &planificador, &disparos));
+            planificador.programar(sondas.back(), periodo, primero);
+            vencimientos(esperado, i, 5 + (primero > 0 ? primero : periodo), periodo, FIN);
+        }
+        COMPROBAR(planificador.obtenerCantidad() == 200);
+        while (planificador.obtenerTick() < FIN) {
+            uint64_t paso = aleatorio.hasta(4) == 0 ? 1 + aleatorio.hasta(20000) : 1 + aleatorio.hasta(70);
+            planificador.avanzarHasta(std::min(planificador.obtenerTick() + paso, FIN), salida);
+        }
+        // Los disparos salen en orden de tick; dentro de un tick el orden depende de la ranura
+        bool enOrden = true;
+        for (std::size_t i = 1; i < disparos.size(); i++) enOrden = enOrden && disparos[i - 1].tick <= disparos[i].tick;
+        COMPROBAR(enOrden);
+        std::sort(disparos.begin(), disparos.end());
+        std::sort(esperado.begin(), esperado.end());
+        COMPROBAR(disparos == esperado);
+        COMPROBAR(planificador.avanzarHasta(FIN, salida) == 0);
+        for (std::size_t i = 0; i < sondas.size(); i++) delete sondas[i];
+    }
+
+    // Más allá del horizonte (64^4 ticks): la última rueda recoloca la tarea en cada vuelta
+    {
+        const uint64_t HORIZONTE = static_cast<uint64_t>(1) << (PlanificadorSensores::BITS_RANURA *
+                                                                 PlanificadorSensores::NIVELES);
+        const uint64_t FIN = 3 * HORIZONTE + 12345;
+        PlanificadorSensores planificador;
+        std::vector<Disparo> disparos;
+        std::vector<Disparo> esperado;
+        std::vector<SensorSonda*> sondas;
+        const unsigned periodos[] = { static_cast<unsigned>(HORIZONTE - 1), static_cast<unsigned>(HORIZONTE),
+                                      static_cast<unsigned>(HORIZONTE + 1), static_cast<unsigned>(HORIZONTE + 777),
+                                      static_cast<unsigned>(2 * HORIZONTE + 3), 1000000 };
+        for (int i = 0; i < 6; i++) {
+            unsigned primero = i == 3 ? static_cast<unsigned>(HORIZONTE + 5) : 0;
+            sondas.push_back(new SensorSonda(i, &planificador, &disparos));
+            planificador.programar(sondas.back(), periodos[i], primero);
+            vencimientos(esperado, i, primero > 0 ? primero : periodos[i], periodos[i], FIN);
+        }
+        // Un solo avance largo y luego pasos grandes
+        planificador.avanzarHasta(HORIZONTE + 2, salida);
+        while (planificador.obtenerTick() < FIN) {
+            uint64_t paso = 1 + static_cast<uint64_t>(aleatorio.hasta(3000000));
+            planificador.avanzarHasta(std::min(planificador.obtenerTick() + paso, FIN), salida);
+        }
+        std::sort(esperado.begin(), esperado.end());
+        COMPROBAR(disparos == esperado);
+        for (std::size_t i = 0; i < sondas.size(); i++) delete sondas[i];
+    }
+
+    // Primer vencimiento común, también bajando en cascada desde la rueda 2: orden de
+    // programación. Después, la tarea de periodo 1 vuelve a la ranura detrás de las demás
+    {
+        PlanificadorSensores planificador(10);
+        std::vector<Disparo> disparos;
+        SensorSonda a(0, &planificador, &disparos);
+        SensorSonda b(1, &planificador, &disparos);
+        SensorSonda c(2, &planificador, &disparos);
+        planificador.programar(&a, 1, 5000);
+        planificador.programar(&b, 5000);
+        planificador.programar(&c, 2500, 5000);
+        COMPROBAR(planificador.avanzarHasta(5010, salida) == 3);
+        COMPROBAR(disparos.size() == 3 && disparos[0].sensor == 0 && disparos[1].sensor == 1 &&
+                  disparos[2].sensor == 2 && disparos[2].tick == 5010);
+        disparos.clear();
+        COMPROBAR(planificador.avanzarHasta(7510, salida) == 2500 + 1);
+        COMPROBAR(disparos.size() == 2501 && disparos[2499].tick == 7510 && disparos[2499].sensor == 2 &&
+                  disparos[2500].tick == 7510 && disparos[2500].sensor == 0);
+    }
+
+    // Cancelar y reprogramar a mitad de camino, también tareas en ruedas superiores
+    {
+        PlanificadorSensores planificador;
+        std::vector<Disparo> disparos;
+        SensorSonda corta(0, &planificador, &disparos);
+        SensorSonda larga(1, &planificador, &disparos);
+        SensorSonda cancelada(2, &planificador, &disparos);
+        SensorSonda lejana(3, &planificador, &disparos);
+        TareaPlanificada* tareaCorta = planificador.programar(&corta, 10);
+        TareaPlanificada* tareaLarga = planificador.programar(&larga, 5000);
+        TareaPlanificada* tareaCancelada = planificador.programar(&cancelada, 7);
+        TareaPlanificada* tareaLejana = planificador.programar(&lejana, 300000);
+        COMPROBAR(planificador.avanzar(100, salida) == 10 + 14);
+
+        planificador.cancelar(tareaCancelada);
+        planificador.cancelar(tareaLejana);
+        planificador.reprogramar(tareaLarga, 3);
+        planificador.reprogramar(tareaCorta, 70000);
+        COMPROBAR(planificador.obtenerCantidad() == 2);
+        disparos.clear();
+        planificador.avanzarHasta(400000, salida);
+        int cortas = 0;
+        int largas = 0;
+        bool enSuTick = true;
+        for (std::size_t i = 0; i < disparos.size(); i++) {
+            const Disparo& d = disparos[i];
+            if (d.sensor == 0) {
+                cortas++;
+                enSuTick = enSuTick && (d.tick - 100) % 70000 == 0;
+            } else if (d.sensor == 1) {
+                largas++;
+                enSuTick = enSuTick && (d.tick - 100) % 3 == 0;
+            } else {
+                enSuTick = false;
+            }
+        }
+        COMPROBAR(enSuTick);
+        COMPROBAR(cortas == (400000 - 100) / 70000);
+        COMPROBAR(largas == (400000 - 100) / 3);
+    }
+    return fallos;
+}
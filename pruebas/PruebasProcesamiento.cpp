@@ -0,0 +1,137 @@
+/**
+ * @file PruebasProcesamiento.cpp
+ * @brief Pruebas del procesamiento paralelo con sensores que escriben en std::cout y de los
+ * mensajes de SistemaFragmentado
+ */
+
+#include "Pruebas.h"
+#include "SistemaGestion.h"
+#include "SistemaFragmentado.h"
+#include "SensorTemperatura.h"
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+const int SENSORES = 24;  ///< Sensores de cada tipo
+const int LINEAS = 8;     ///< Líneas que escribe cada sensor de eco
+
+/**
+ * @brief Sensor de otro tipo que no redefine procesarLectura(salida): escribe en std::cout
+ */
+class SensorEco : public SensorBase {
+public:
+    std::streambuf* esperado;  ///< Búfer de std::cout durante la pasada
+    bool redirigido;           ///< std::cout apuntaba a otro búfer al procesar
+
+    SensorEco(const char* id, std::streambuf* esperado) : SensorBase(id), esperado(esperado), redirigido(false) {}
+
+    void procesarLectura() override {
+        if (std::cout.rdbuf() != esperado) redirigido = true;
+        for (int k = 0; k < LINEAS; k++) {
+            std::cout << "[" << nombre << "] linea " << k << "\n";
+            std::this_thread::yield();
+        }
+    }
+
+    void imprimirInfo() const override {}
+};
+
+/**
+ * @brief Registra SENSORES sensores de temperatura y de eco intercalados
+ */
+template <typename Sistema>
+void poblar(Sistema& sistema, std::streambuf* esperado, SensorEco** ecos) {
+    for (int i = 0; i < SENSORES; i++) {
+        char nombre[32];
+        snprintf(nombre, sizeof(nombre), "T-%03d", i);
+        SensorTemperatura* temperatura = new SensorTemperatura(nombre);
+        for (int k = 0; k < 4; k++) temperatura->registrarLectura(static_cast<float>(i * 10 + k));
+        sistema.agregarSensor(temperatura);
+        snprintf(nombre, sizeof(nombre), "E-%03d", i);
+        ecos[i] = new SensorEco(nombre, esperado);
+        sistema.agregarSensor(ecos[i]);
+    }
+}
+
+/**
+ * @brief Comprueba que las líneas de cada sensor de eco salen juntas y en orden
+ * @return Fallos encontrados
+ */
+int comprobarBloques(const std::string& texto) {
+    int fallos = 0;
+    for (int i = 0; i < SENSORES; i++) {
+        char bloque[256];
+        int escrito = 0;
+        for (int k = 0; k < LINEAS; k++) {
+            escrito += snprintf(bloque + escrito, sizeof(bloque) - static_cast<std::size_t>(escrito),
+                                "[E-%03d] linea %d\n", i, k);
+        }
+        COMPROBAR(texto.find(bloque) != std::string::npos);
+    }
+    return fallos;
+}
+
+}  // namespace
+
+int pruebasProcesamiento() {
+    int fallos = 0;
+    std::streambuf* original = std::cout.rdbuf();
+
+    // Secuencial y con 4 hilos: misma salida, en orden de registro
+    std::string salidas[2];
+    SensorEco* ecos[2][SENSORES];
+    for (int modo = 0; modo < 2; modo++) {
+        SistemaGestion sistema;
+        sistema.fijarHilosProcesamiento(modo == 0 ? 1 : 4);
+        std::ostringstream captura;
+        poblar(sistema, captura.rdbuf(), ecos[modo]);
+        std::cout.rdbuf(captura.rdbuf());
+        sistema.procesarTodosSensores();
+        std::cout.rdbuf(original);
+        salidas[modo] = captura.str();
+        for (int i = 0; i < SENSORES; i++) COMPROBAR(!ecos[modo][i]->redirigido);
+    }
+    COMPROBAR(salidas[0] == salidas[1]);
+    COMPROBAR(salidas[1].find("[T-007] (Temperatura): Lectura más baja (70°C)") != std::string::npos);
+    fallos += comprobarBloques(salidas[1]);
+
+    // Con fragmentos, cada sensor de eco se procesa en su turno dentro de su fragmento
+    {
+        SistemaFragmentado sistema(4, false);
+        SensorEco* ecosFragmentos[SENSORES];
+        std::ostringstream captura;
+        poblar(sistema, captura.rdbuf(), ecosFragmentos);
+        std::cout.rdbuf(captura.rdbuf());
+        sistema.procesarTodosSensores();
+        std::cout.rdbuf(original);
+        for (int i = 0; i < SENSORES; i++) COMPROBAR(!ecosFragmentos[i]->redirigido);
+        std::string texto = captura.str();
+        fallos += comprobarBloques(texto);
+        // El bloque de cada sensor de temperatura tampoco se interrumpe
+        for (int i = 0; i < SENSORES; i++) {
+            char bloque[128];
+            snprintf(bloque, sizeof(bloque),
+                     "-> Procesando Sensor T-%03d (Temperatura)...\n[T-%03d] (Temperatura): Lectura más baja (%d°C)",
+                     i, i, i * 10);
+            COMPROBAR(texto.find(bloque) != std::string::npos);
+        }
+    }
+
+    // Los fragmentos no repiten los mensajes de inicio y cierre
+    {
+        std::ostringstream captura;
+        std::cout.rdbuf(captura.rdbuf());
+        { SistemaFragmentado sistema(4, false); }
+        std::cout.rdbuf(original);
+        std::string texto = captura.str();
+        COMPROBAR(texto.find("Iniciado") != std::string::npos);
+        COMPROBAR(texto.find("Iniciado") == texto.rfind("Iniciado"));
+        COMPROBAR(texto.find("Sistema cerrado") != std::string::npos);
+        COMPROBAR(texto.find("Sistema cerrado") == texto.rfind("Sistema cerrado"));
+    }
+
+    return fallos;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file PruebasProtocolo.cpp
+ * @brief Pruebas del protocolo binario: tramas, y su separación del texto en la ingesta
+ */
+
+#include "Pruebas.h"
+#include "ProtocoloBinario.h"
+#include "IngestaLecturas.h"
+#include "ServidorIngesta.h"
+#include "SistemaGestion.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+std::string trama(TipoLectura tipo, unsigned id, const int16_t* valores, int n) {
+    uint8_t bytes[TAM_MAX_TRAMA];
+    std::size_t longitud = codificarTrama(tipo, id, valores, n, bytes);
+    return std::string(reinterpret_cast<const char*>(bytes), longitud);
+}
+
+/**
+ * @brief Flujo mixto: texto, tramas válidas, una trama corrupta, ruido y una línea final sin '\n'
+ * @details Deja 6 lecturas en T-001 (suma 116.0) y 2 en P-105 (80 y 81) con 2 tramas válidas
+ */
+std::string flujoMixto() {
+    const int16_t primera[] = { 2200, 2300, -150 };
+    const int16_t corrupta[] = { 90, 91 };
+    const int16_t segunda[] = { 2500, 2600 };
+
+    std::string flujo = "ESP32 - Simulador\nTEMP|T-001|21.50\n";
+    flujo += trama(LECTURA_TEMPERATURA, 1, primera, 3);
+    flujo += "PRES|P-105|80\n";
+    std::string mala = trama(LECTURA_PRESION, 105, corrupta, 2);
+    mala[CABECERA_TRAMA] ^= 0x01;  // El CRC ya no cuadra
+    flujo += mala;
+    flujo += trama(LECTURA_TEMPERATURA, 1, segunda, 2);
+    flujo += "\xA5\n";
+    flujo += "PRES|P-105|81";
+    return flujo;
+}
+
+/**
+ * @brief Comprueba los sensores que deja flujoMixto() repetido veces veces
+ */
+int comprobarSensores(SistemaGestion& sistema, int veces) {
+    int fallos = 0;
+    SensorTemperatura* t = dynamic_cast<SensorTemperatura*>(sistema.buscarSensor("T-001"));
+    SensorPresion* p = dynamic_cast<SensorPresion*>(sistema.buscarSensor("P-105"));
+    COMPROBAR(t != nullptr);
+    COMPROBAR(p != nullptr);
+    if (t == nullptr || p == nullptr) return fallos;
+    COMPROBAR(t->obtenerCantidadLecturas() == 6 * veces);
+    COMPROBAR(std::fabs(t->calcularPromedio() - 116.0f / 6) < 1e-3f);
+    COMPROBAR(p->obtenerCantidadLecturas() == 2 * veces);
+    COMPROBAR(p->obtenerMinimo() == 80);
+    return fallos;
+}
+
+}  // namespace
+
+int pruebasTramas() {
+    int fallos = 0;
+
+    // Ida y vuelta en los extremos de tamaño y de valor
+    int16_t valores[MAX_VALORES_TRAMA];
+    for (int i = 0; i < MAX_VALORES_TRAMA; i++) {
+        valores[i] = static_cast<int16_t>(i % 2 == 0 ? -32768 + i : 32767 - i);
+    }
+    for (int n = 1; n <= MAX_VALORES_TRAMA; n += MAX_VALORES_TRAMA - 1) {
+        uint8_t bytes[TAM_MAX_TRAMA];
+        std::size_t longitud = codificarTrama(LECTURA_PRESION, 65535, valores, n, bytes);
+        COMPROBAR(longitud == CABECERA_TRAMA + 2 * static_cast<std::size_t>(n) + 4);
+
+        TramaBinaria t;
+        std::size_t consumidos = 0;
+        COMPROBAR(analizarTrama(bytes, longitud, t, consumidos) == TRAMA_VALIDA);
+        COMPROBAR(consumidos == longitud);
+        COMPROBAR(t.tipo == LECTURA_PRESION && t.id == 65535 && t.cantidad == n);
+        COMPROBAR(std::memcmp(t.valores, valores, n * sizeof(int16_t)) == 0);
+
+        // Todo prefijo está incompleto; ningún byte alterado da una trama válida
+        bool incompletos = true;
+        for (std::size_t corto = 0; corto < longitud; corto++) {
+            if (analizarTrama(bytes, corto, t, consumidos) != TRAMA_INCOMPLETA) incompletos = false;
+        }
+        COMPROBAR(incompletos);
+        bool rechazadas = true;
+        for (std::size_t i = 0; i < longitud; i++) {
+            for (int bit = 0; bit < 8; bit++) {
+                bytes[i] ^= static_cast<uint8_t>(1u << bit);
+                if (analizarTrama(bytes, longitud, t, consumidos) == TRAMA_VALIDA) rechazadas = false;
+                bytes[i] ^= static_cast<uint8_t>(1u << bit);
+            }
+        }
+        COMPROBAR(rechazadas);
+    }
+
+    uint8_t bytes[TAM_MAX_TRAMA];
+    COMPROBAR(codificarTrama(LECTURA_TEMPERATURA, 1, valores, 0, bytes) == 0);
+    COMPROBAR(codificarTrama(LECTURA_TEMPERATURA, 1, valores, MAX_VALORES_TRAMA + 1, bytes) == 0);
+    COMPROBAR(codificarTrama(LECTURA_TEMPERATURA, 65536, valores, 1, bytes) == 0);
+
+    char nombre[8];
+    COMPROBAR(formatearIdSensor(LECTURA_TEMPERATURA, 1, nombre) == 5 && std::strcmp(nombre, "T-001") == 0);
+    COMPROBAR(formatearIdSensor(LECTURA_PRESION, 105, nombre) == 5 && std::strcmp(nombre, "P-105") == 0);
+    COMPROBAR(formatearIdSensor(LECTURA_TEMPERATURA, 1234, nombre) == 6 && std::strcmp(nombre, "T-1234") == 0);
+    return fallos;
+}
+
+int pruebasDemultiplexado() {
+    int fallos = 0;
+    std::string flujo = flujoMixto();
+
+    // Con cualquier partición en bloques, el resultado es el mismo
+    for (std::size_t bloque = 1; bloque <= flujo.size(); bloque++) {
+        SistemaGestion sistema;
+        IngestaLecturas ingesta(sistema);
+        ingesta.fijarProtocoloBinario(true);
+        for (std::size_t desde = 0; desde < flujo.size(); desde += bloque) {
+            std::size_t n = flujo.size() - desde < bloque ? flujo.size() - desde : bloque;
+            ingesta.consumir(flujo.data() + desde, n);
+        }
+        ingesta.finalizar();
+
+        const EstadisticasIngesta& e = ingesta.obtenerEstadisticas();
+        int antes = fallos;
+        COMPROBAR(e.lecturas == 8);
+        COMPROBAR(e.tramas == 2);
+        COMPROBAR(e.tramasInvalidas >= 1);
+        COMPROBAR(e.sensoresCreados == 2);
+        fallos += comprobarSensores(sistema, 1);
+        if (fallos != antes) {
+            std::cerr << "  con bloques de " << bloque << " bytes\n";
+            break;
+        }
+    }
+
+    // Servidor: dos conexiones intercaladas byte a byte, cada una con su trama en curso
+    SistemaGestion sistema;
+    ServidorIngesta servidor(sistema);
+    servidor.obtenerIngesta().fijarProtocoloBinario(true);
+    int escritura[2];
+    for (int k = 0; k < 2; k++) {
+        int tuberia[2];
+        COMPROBAR(pipe(tuberia) == 0);
+        COMPROBAR(servidor.agregarDescriptor(tuberia[0], true));
+        escritura[k] = tuberia[1];
+    }
+    for (std::size_t i = 0; i < flujo.size(); i++) {
+        for (int k = 0; k < 2; k++) {
+            COMPROBAR(write(escritura[k], flujo.data() + i, 1) == 1);
+        }
+        servidor.atender(0);
+    }
+    close(escritura[0]);
+    close(escritura[1]);
+    while (servidor.obtenerConexionesAbiertas() > 0) {
+        if (servidor.atender(100) < 0) break;
+    }
+
+    const EstadisticasIngesta& e = servidor.obtenerIngesta().obtenerEstadisticas();
+    COMPROBAR(e.lecturas == 16);
+    COMPROBAR(e.tramas == 4);
+    COMPROBAR(e.tramasInvalidas >= 2);
+    fallos += comprobarSensores(sistema, 2);
+    return fallos;
+}
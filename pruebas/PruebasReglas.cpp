@@ -0,0 +1,173 @@
+/**
+ * @file PruebasReglas.cpp
+ * @brief Pruebas de MotorReglas: operadores en límites decimales, ventanas y cambios de estado
+ */
+
+#include "Pruebas.h"
+#include "MotorReglas.h"
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Evalúa lecturas con un estado nuevo y sigue el estado de cada regla por sus eventos
+ * @param activas Estado final de cada regla (al menos obtenerNumReglas())
+ * @return Eventos recibidos
+ */
+int evaluar(MotorReglas& motor, TipoReglas tipo, const double* lecturas, int n, bool* activas) {
+    for (int r = 0; r < motor.obtenerNumReglas(); r++) activas[r] = false;
+    EstadoReglas estado(motor, tipo, "S-1");
+    int eventos = 0;
+    EventoAlerta alertas[64];
+    for (int i = 0; i < n; i++) {
+        estado.evaluar(lecturas[i]);
+        int m;
+        while ((m = motor.drenarAlertas(alertas, 64)) > 0) {
+            for (int k = 0; k < m; k++) activas[alertas[k].regla] = alertas[k].activa;
+            eventos += m;
+        }
+    }
+    return eventos;
+}
+
+/**
+ * @brief Indica si una única regla se cumple tras una lectura
+ */
+bool seCumple(const std::string& condicion, TipoReglas tipo, double lectura) {
+    MotorReglas motor;
+    std::string texto = std::string("R ") + (tipo == REGLAS_TEMPERATURA ? "temperatura " : "presion ") + condicion;
+    if (!motor.compilar(texto.c_str())) return false;
+    bool activas[1];
+    evaluar(motor, tipo, &lectura, 1, activas);
+    return activas[0];
+}
+
+}  // namespace
+
+int pruebasReglas() {
+    int fallos = 0;
+
+    // Temperatura: el límite decimal es el float de la lectura. En la lectura exacta se
+    // cumplen >= y <=, justo por encima > y >=, justo por debajo < y <=
+    const char* limites[] = { "45.2", "45.3", "0.1", "-0.1", "100.7", "0.001", "-273.15" };
+    for (std::size_t i = 0; i < sizeof(limites) / sizeof(limites[0]); i++) {
+        std::string l(limites[i]);
+        float exacta = strtof(limites[i], nullptr);
+        float encima = std::nextafter(exacta, HUGE_VALF);
+        float debajo = std::nextafter(exacta, -HUGE_VALF);
+        COMPROBAR(!seCumple("valor > " + l, REGLAS_TEMPERATURA, exacta));
+        COMPROBAR(seCumple("valor >= " + l, REGLAS_TEMPERATURA, exacta));
+        COMPROBAR(!seCumple("valor < " + l, REGLAS_TEMPERATURA, exacta));
+        COMPROBAR(seCumple("valor <= " + l, REGLAS_TEMPERATURA, exacta));
+        COMPROBAR(seCumple("valor > " + l, REGLAS_TEMPERATURA, encima));
+        COMPROBAR(seCumple("valor >= " + l, REGLAS_TEMPERATURA, encima));
+        COMPROBAR(!seCumple("valor < " + l, REGLAS_TEMPERATURA, encima));
+        COMPROBAR(!seCumple("valor <= " + l, REGLAS_TEMPERATURA, encima));
+        COMPROBAR(!seCumple("valor > " + l, REGLAS_TEMPERATURA, debajo));
+        COMPROBAR(!seCumple("valor >= " + l, REGLAS_TEMPERATURA, debajo));
+        COMPROBAR(seCumple("valor < " + l, REGLAS_TEMPERATURA, debajo));
+        COMPROBAR(seCumple("valor <= " + l, REGLAS_TEMPERATURA, debajo));
+        // "durante N" compara el mínimo, que también es una lectura float
+        COMPROBAR(seCumple("valor >= " + l + " durante 1", REGLAS_TEMPERATURA, exacta));
+    }
+
+    // Presión: lecturas enteras frente a límites enteros y decimales
+    COMPROBAR(!seCumple("valor > 90", REGLAS_PRESION, 90));
+    COMPROBAR(seCumple("valor >= 90", REGLAS_PRESION, 90));
+    COMPROBAR(!seCumple("valor < 90", REGLAS_PRESION, 90));
+    COMPROBAR(seCumple("valor <= 90", REGLAS_PRESION, 90));
+    COMPROBAR(!seCumple("valor >= 90.5", REGLAS_PRESION, 90));
+    COMPROBAR(seCumple("valor >= 90.5", REGLAS_PRESION, 91));
+    COMPROBAR(seCumple("valor <= 90.5", REGLAS_PRESION, 90));
+    COMPROBAR(!seCumple("valor <= 90.5", REGLAS_PRESION, 91));
+
+    // No hay operador de igualdad: la línea se rechaza y las reglas no cambian
+    {
+        MotorReglas motor;
+        COMPROBAR(motor.compilar("A temperatura valor > 45"));
+        COMPROBAR(!motor.compilar("B temperatura valor == 45.2"));
+        COMPROBAR(!motor.compilar("B temperatura valor = 45.2"));
+        COMPROBAR(motor.obtenerNumReglas() == 1);
+        COMPROBAR(std::string(motor.obtenerNombreRegla(0)) == "A");
+        COMPROBAR(!motor.compilar("C humedad valor > 1"));
+        COMPROBAR(!motor.compilar("C temperatura valor > 4x"));
+        COMPROBAR(!motor.compilar("C temperatura valor > 45 durante 0"));
+        COMPROBAR(!motor.compilar("A temperatura valor > 1\nA presion valor > 2"));
+        COMPROBAR(motor.obtenerNumReglas() == 1);
+    }
+
+    // El promedio de lecturas float se compara como float: cuatro lecturas de 45.3
+    {
+        MotorReglas motor;
+        COMPROBAR(motor.compilar("GE temperatura promedio 4 >= 45.3\n"
+                                 "GT temperatura promedio 4 > 45.3\n"
+                                 "LE temperatura promedio 4 <= 45.3\n"));
+        double lecturas[] = { 45.3f, 45.3f, 45.3f, 45.3f };
+        bool activas[3];
+        evaluar(motor, REGLAS_TEMPERATURA, lecturas, 3, activas);
+        COMPROBAR(!activas[0] && !activas[1] && !activas[2]);  // Aún no hay 4 lecturas
+        evaluar(motor, REGLAS_TEMPERATURA, lecturas, 4, activas);
+        COMPROBAR(activas[0]);
+        COMPROBAR(!activas[1]);
+        COMPROBAR(activas[2]);
+    }
+
+    // "durante N": solo N lecturas seguidas por encima activan; un evento por cambio de estado
+    {
+        MotorReglas motor;
+        COMPROBAR(motor.compilar("SOSTENIDA temperatura valor > 45 durante 3"));
+        double lecturas[] = { 46, 46, 44, 46, 46 };
+        bool activas[1];
+        COMPROBAR(evaluar(motor, REGLAS_TEMPERATURA, lecturas, 5, activas) == 0);
+        COMPROBAR(!activas[0]);
+        double sostenidas[] = { 46, 46, 46, 47, 50 };
+        COMPROBAR(evaluar(motor, REGLAS_TEMPERATURA, sostenidas, 5, activas) == 1);
+        COMPROBAR(activas[0]);
+        double resueltas[] = { 46, 46, 46, 47, 45, 46, 46 };
+        COMPROBAR(evaluar(motor, REGLAS_TEMPERATURA, resueltas, 7, activas) == 2);
+        COMPROBAR(!activas[0]);
+    }
+
+    // Con "<" la ventana es la del mínimo de la lectura negada
+    {
+        MotorReglas motor;
+        COMPROBAR(motor.compilar("BAJA presion valor < 10 durante 2"));
+        double lecturas[] = { 9, 11, 9, 9 };
+        bool activas[1];
+        evaluar(motor, REGLAS_PRESION, lecturas, 3, activas);
+        COMPROBAR(!activas[0]);
+        COMPROBAR(evaluar(motor, REGLAS_PRESION, lecturas, 4, activas) == 1);
+        COMPROBAR(activas[0]);
+    }
+
+    // Promedio deslizante: se mantiene mientras la media de la ventana siga por encima
+    {
+        MotorReglas motor;
+        COMPROBAR(motor.compilar("MEDIA presion promedio 2 > 50"));
+        double lecturas[] = { 40, 70, 40, 30 };
+        bool activas[1];
+        COMPROBAR(evaluar(motor, REGLAS_PRESION, lecturas, 3, activas) == 1);
+        COMPROBAR(activas[0]);
+        COMPROBAR(evaluar(motor, REGLAS_PRESION, lecturas, 4, activas) == 2);
+        COMPROBAR(!activas[0]);
+    }
+
+    // Reglas sobre la misma señal comparten ventana y se activan como prefijo de umbrales
+    {
+        MotorReglas motor;
+        COMPROBAR(motor.compilar("A temperatura valor > 40\nB temperatura valor > 50\nC temperatura valor >= 45\n"
+                                 "D temperatura valor < 0"));
+        COMPROBAR(motor.obtenerReglas(REGLAS_TEMPERATURA).obtenerNumSenales() == 2);
+        bool activas[4];
+        double lecturas[] = { 47 };
+        COMPROBAR(evaluar(motor, REGLAS_TEMPERATURA, lecturas, 1, activas) == 2);
+        COMPROBAR(activas[0] && !activas[1] && activas[2] && !activas[3]);
+        double subida[] = { 47, 55, 30, -1 };
+        COMPROBAR(evaluar(motor, REGLAS_TEMPERATURA, subida, 4, activas) == 7);
+        COMPROBAR(!activas[0] && !activas[1] && !activas[2] && activas[3]);
+    }
+
+    return fallos;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file PruebasSegmentos.cpp
+ * @brief Pruebas de AlmacenSegmentos: reapertura, agregados y conteos de más de 2^31 lecturas
+ */
+
+#include "Pruebas.h"
+#include "AlmacenSegmentos.h"
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+
+int pruebasSegmentos() {
+    int fallos = 0;
+
+    // Los agregados combinados de varios segmentos no caben en un int
+    const long long porSegmento = 3000000000LL;
+    EstadisticasLectura<int> total;
+    for (int s = 0; s < 3; s++) {
+        EstadisticasLectura<int> segmento;
+        segmento.reconstruir(porSegmento, porSegmento * (40 + 10 * s),
+                             static_cast<double>(porSegmento) * (40 + 10 * s) * (40 + 10 * s), 40 + 10 * s,
+                             40 + 10 * s);
+        total.combinar(segmento);
+    }
+    COMPROBAR(total.obtenerCantidad() == 3 * porSegmento);
+    COMPROBAR(total.promedio() == 50);
+    COMPROBAR(total.obtenerMinimo() == 40 && total.obtenerMaximo() == 60);
+
+    // Sellar, reabrir y ver memoria más segmentos como un solo historial
+    char ruta[] = "/tmp/sistema_iot_segmentos_XXXXXX";
+    int descriptor = mkstemp(ruta);
+    COMPROBAR(descriptor >= 0);
+    if (descriptor < 0) return fallos;
+    close(descriptor);
+
+    std::vector<int> lecturas;
+    Aleatorio aleatorio(15);
+    {
+        AlmacenSegmentos<int> almacen(ruta);
+        COMPROBAR(almacen.estaAbierto());
+        for (int s = 0; s < 3; s++) {
+            std::vector<int> bloque;
+            for (int i = 0; i < 1000 + s; i++) bloque.push_back(80 + aleatorio.hasta(21));
+            COMPROBAR(almacen.sellar(&bloque[0], static_cast<int>(bloque.size())));
+            lecturas.insert(lecturas.end(), bloque.begin(), bloque.end());
+        }
+    }
+    AlmacenSegmentos<int> reabierto(ruta);
+    COMPROBAR(reabierto.obtenerNumSegmentos() == 3);
+    COMPROBAR(reabierto.obtenerCantidad() == static_cast<long long>(lecturas.size()));
+    long long suma = 0;
+    for (std::size_t i = 0; i < lecturas.size(); i++) suma += lecturas[i];
+    COMPROBAR(reabierto.obtenerEstadisticas().obtenerSuma() == suma);
+    std::size_t leidas = 0;
+    bool iguales = true;
+    COMPROBAR(reabierto.recorrer([&lecturas, &leidas, &iguales](int v) {
+        if (leidas >= lecturas.size() || lecturas[leidas] != v) iguales = false;
+        leidas++;
+    }));
+    COMPROBAR(iguales && leidas == lecturas.size());
+
+    ListaSensor<int, TAM_BLOQUE_LECTURAS> memoria;
+    memoria.insertar(100);
+    memoria.insertar(70);
+    VistaSegmentada<int, TAM_BLOQUE_LECTURAS> vista(memoria, reabierto);
+    COMPROBAR(vista.obtenerTamanio() == static_cast<long long>(lecturas.size()) + 2);
+    COMPROBAR(vista.obtenerMaximo() == 100);
+    COMPROBAR(vista.obtenerMinimo() == 70);
+    COMPROBAR(vista.eliminarMenor() == 70);
+    COMPROBAR(vista.obtenerTamanio() == static_cast<long long>(lecturas.size()) + 1);
+
+    unlink(ruta);
+    return fallos;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file AlmacenSegmentos.cpp
+ * @brief Implementación de la E/S del archivo de segmentos
+ */
+
+#include "AlmacenSegmentos.h"
+#include "SumaVerificacion.h"
+#include "Registro.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief pread completo (reintenta lecturas parciales)
+ */
+bool leerEn(int descriptor, void* destino, std::size_t bytes, uint64_t posicion) {
+    char* p = static_cast<char*>(destino);
+    while (bytes > 0) {
+        ssize_t leidos = pread(descriptor, p, bytes, static_cast<off_t>(posicion));
+        if (leidos < 0 && errno == EINTR) continue;
+        if (leidos <= 0) return false;
+        p += leidos;
+        bytes -= static_cast<std::size_t>(leidos);
+        posicion += static_cast<uint64_t>(leidos);
+    }
+    return true;
+}
+
+}  // namespace
+
+ArchivoSegmentos::ArchivoSegmentos()
+    : cabeceras(nullptr), desplazamientos(nullptr), numSegmentos(0), capacidad(0), tamanio(0) {}
+
+ArchivoSegmentos::~ArchivoSegmentos() {
+    delete[] cabeceras;
+    delete[] desplazamientos;
+}
+
+void ArchivoSegmentos::crecer() {
+    int nuevaCapacidad = capacidad == 0 ? 16 : capacidad * 2;
+
+    CabeceraSegmento* nuevasCabeceras = new CabeceraSegmento[nuevaCapacidad];
+    uint64_t* nuevosDesplazamientos = new uint64_t[nuevaCapacidad];
+    for (int i = 0; i < numSegmentos; i++) {
+        nuevasCabeceras[i] = cabeceras[i];
+        nuevosDesplazamientos[i] = desplazamientos[i];
+    }
+
+    delete[] cabeceras;
+    delete[] desplazamientos;
+    cabeceras = nuevasCabeceras;
+    desplazamientos = nuevosDesplazamientos;
+    capacidad = nuevaCapacidad;
+}
+
+bool ArchivoSegmentos::abrir(const char* archivo, uint32_t tipo) {
+    ruta = archivo;
+    int descriptor = open(archivo, O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        if (errno == ENOENT) return true;  // Se creará con el primer segmento
+        REGISTRO_ERROR("[Error] No se pudo abrir el archivo de segmentos '" << archivo << "': "
+                       << strerror(errno) << "\n");
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        REGISTRO_ERROR("[Error] No se pudo consultar '" << archivo << "': " << strerror(errno) << "\n");
+        close(descriptor);
+        return false;
+    }
+    uint64_t tamanioArchivo = static_cast<uint64_t>(info.st_size);
+
+    // Solo se leen las cabeceras: los datos se verifican al descomprimirlos
+    uint64_t posicion = 0;
+    bool correcto = true;
+    while (tamanioArchivo - posicion >= sizeof(CabeceraSegmento)) {
+        CabeceraSegmento cabecera;
+        if (!leerEn(descriptor, &cabecera, sizeof(cabecera), posicion) ||
+            std::memcmp(cabecera.magia, "SEG1", 4) != 0 ||
+            cabecera.crcCabecera != calcularCrc32c(&cabecera, sizeof(cabecera) - 4) ||
+            cabecera.bytesDatos > tamanioArchivo - posicion - sizeof(cabecera)) {
+            break;
+        }
+        if (cabecera.tipo != tipo) {
+            REGISTRO_ERROR("[Error] '" << archivo << "' contiene segmentos de otro tipo de lectura.\n");
+            correcto = false;
+            break;
+        }
+
+        if (numSegmentos == capacidad) {
+            crecer();
+        }
+        cabeceras[numSegmentos] = cabecera;
+        desplazamientos[numSegmentos] = posicion + sizeof(cabecera);
+        numSegmentos++;
+        posicion += sizeof(cabecera) + cabecera.bytesDatos;
+    }
+    close(descriptor);
+    if (!correcto) return false;
+
+    if (posicion < tamanioArchivo) {
+        REGISTRO_AVISO("[Segmentos] '" << archivo << "': " << static_cast<long long>(tamanioArchivo - posicion)
+                       << " byte(s) finales incompletos recortados.\n");
+        if (truncate(archivo, static_cast<off_t>(posicion)) != 0) {
+            REGISTRO_ERROR("[Error] No se pudo recortar '" << archivo << "': " << strerror(errno) << "\n");
+            return false;
+        }
+    }
+    tamanio = posicion;
+    return true;
+}
+
+bool ArchivoSegmentos::anexar(CabeceraSegmento cabecera, const unsigned char* datos) {
+    int descriptor = open(ruta.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (descriptor < 0) {
+        REGISTRO_ERROR("[Error] No se pudo abrir '" << ruta.c_str() << "': " << strerror(errno) << "\n");
+        return false;
+    }
+
+    cabecera.crcDatos = calcularCrc32c(datos, cabecera.bytesDatos);
+    cabecera.crcCabecera = calcularCrc32c(&cabecera, sizeof(cabecera) - 4);
+
+    struct iovec partes[2];
+    partes[0].iov_base = &cabecera;
+    partes[0].iov_len = sizeof(cabecera);
+    partes[1].iov_base = const_cast<unsigned char*>(datos);
+    partes[1].iov_len = cabecera.bytesDatos;
+    std::size_t total = sizeof(cabecera) + cabecera.bytesDatos;
+
+    ssize_t escritos;
+    do {
+        escritos = writev(descriptor, partes, 2);
+    } while (escritos < 0 && errno == EINTR);
+
+    if (escritos != static_cast<ssize_t>(total) || fdatasync(descriptor) != 0) {
+        REGISTRO_ERROR("[Error] No se pudo sellar el segmento en '" << ruta.c_str() << "': "
+                       << strerror(errno) << "\n");
+        // Un segmento a medias se descarta para no dejar basura antes del siguiente
+        if (ftruncate(descriptor, static_cast<off_t>(tamanio)) != 0) {
+            REGISTRO_ERROR("[Error] No se pudo recortar el segmento incompleto.\n");
+        }
+        close(descriptor);
+        return false;
+    }
+    close(descriptor);
+
+    if (numSegmentos == capacidad) {
+        crecer();
+    }
+    cabeceras[numSegmentos] = cabecera;
+    desplazamientos[numSegmentos] = tamanio + sizeof(cabecera);
+    numSegmentos++;
+    tamanio += total;
+    return true;
+}
+
+bool ArchivoSegmentos::leerDatos(int i, unsigned char* destino) const {
+    const CabeceraSegmento& cabecera = cabeceras[i];
+    int descriptor = open(ruta.c_str(), O_RDONLY | O_CLOEXEC);
+    bool leido = descriptor >= 0 && leerEn(descriptor, destino, cabecera.bytesDatos, desplazamientos[i]);
+    if (!leido) {
+        REGISTRO_ERROR("[Error] No se pudo leer el segmento " << i << " de '" << ruta.c_str() << "': "
+                       << strerror(errno) << "\n");
+    }
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+    if (!leido) return false;
+    if (calcularCrc32c(destino, cabecera.bytesDatos) != cabecera.crcDatos) {
+        REGISTRO_ERROR("[Error] Segmento " << i << " de '" << ruta.c_str() << "' corrupto (CRC).\n");
+        return false;
+    }
+    return true;
+}
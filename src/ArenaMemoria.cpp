@@ -0,0 +1,181 @@
+/**
+ * @file ArenaMemoria.cpp
+ * @brief Implementación de la arena de memoria por bloques
+ */
+
+#include "ArenaMemoria.h"
+#include "Metricas.h"
+
+const std::size_t ArenaMemoria::TAM_BLOQUE;
+const std::size_t ArenaMemoria::ALINEACION;
+const std::size_t ArenaMemoria::TAM_MAX_CLASE;
+const std::size_t ArenaMemoria::TAM_PRIMER_BLOQUE;
+const std::size_t ArenaMemoria::CABECERA_GRANDE;
+
+ArenaMemoria::ArenaMemoria()
+    : bloques(nullptr), grandes(nullptr), libre(nullptr), fin(nullptr), numBloques(0), tamSiguiente(TAM_PRIMER_BLOQUE),
+      bytesReservados(0), concurrente(false), desmontando(false), diferidos(nullptr) {
+    static_assert(sizeof(Diferido) <= ALINEACION, "Un hueco mínimo debe admitir una liberación diferida");
+    for (std::size_t i = 0; i < NUM_CLASES; i++) {
+        huecos[i] = nullptr;
+    }
+}
+
+ArenaMemoria::~ArenaMemoria() {
+    reiniciar();
+}
+
+void* ArenaMemoria::reservar(std::size_t bytes) {
+    if (concurrente) {
+        std::lock_guard<std::mutex> bloqueo(cerrojo);
+        return reservarLocal(bytes);
+    }
+    return reservarLocal(bytes);
+}
+
+void ArenaMemoria::liberar(void* p, std::size_t bytes) {
+    if (desmontando || p == nullptr) return;
+    if (concurrente) {
+        // Solo se apila: sin pops concurrentes no hay ABA
+        Diferido* diferido = static_cast<Diferido*>(p);
+        diferido->bytes = bytes;
+        diferido->siguiente = diferidos.load(std::memory_order_relaxed);
+        while (!diferidos.compare_exchange_weak(diferido->siguiente, diferido, std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+        }
+        return;
+    }
+    liberarLocal(p, bytes);
+}
+
+void ArenaMemoria::fijarConcurrente(bool valor) {
+    concurrente = valor;
+    if (!valor) aplicarDiferidos();
+}
+
+void ArenaMemoria::aplicarDiferidos() {
+    Diferido* diferido = diferidos.exchange(nullptr, std::memory_order_acquire);
+    while (diferido != nullptr) {
+        Diferido* siguiente = diferido->siguiente;
+        liberarLocal(diferido, diferido->bytes);
+        diferido = siguiente;
+    }
+}
+
+void ArenaMemoria::fijarDesmontaje(bool valor) {
+    desmontando = valor;
+}
+
+bool ArenaMemoria::enDesmontaje() const {
+    return desmontando;
+}
+
+void* ArenaMemoria::reservarLocal(std::size_t bytes) {
+    if (bytes > TAM_MAX_CLASE) {
+        Grande* grande = static_cast<Grande*>(::operator new(CABECERA_GRANDE + bytes));
+        grande->bytes = CABECERA_GRANDE + bytes;
+        grande->anterior = nullptr;
+        grande->siguiente = grandes;
+        if (grandes != nullptr) grandes->anterior = grande;
+        grandes = grande;
+        bytesReservados += grande->bytes;
+        METRICA_AJUSTAR(INDICADOR_BYTES_ARENA, static_cast<long long>(grande->bytes));
+        return reinterpret_cast<char*>(grande) + CABECERA_GRANDE;
+    }
+
+    std::size_t tam = (bytes + ALINEACION - 1) / ALINEACION * ALINEACION;
+    if (tam == 0) tam = ALINEACION;
+    std::size_t clase = tam / ALINEACION - 1;
+
+    // Reutilizar un hueco liberado de la misma clase
+    if (huecos[clase] != nullptr) {
+        Hueco* hueco = huecos[clase];
+        huecos[clase] = hueco->siguiente;
+        return hueco;
+    }
+
+    // Avance lineal dentro del bloque actual
+    if (libre == nullptr || static_cast<std::size_t>(fin - libre) < tam) {
+        nuevoBloque(tam);
+    }
+    void* p = libre;
+    libre += tam;
+    return p;
+}
+
+void ArenaMemoria::liberarLocal(void* p, std::size_t bytes) {
+    if (p == nullptr) return;
+
+    if (bytes > TAM_MAX_CLASE) {
+        Grande* grande = reinterpret_cast<Grande*>(static_cast<char*>(p) - CABECERA_GRANDE);
+        if (grande->anterior != nullptr) {
+            grande->anterior->siguiente = grande->siguiente;
+        } else {
+            grandes = grande->siguiente;
+        }
+        if (grande->siguiente != nullptr) grande->siguiente->anterior = grande->anterior;
+        bytesReservados -= grande->bytes;
+        METRICA_AJUSTAR(INDICADOR_BYTES_ARENA, -static_cast<long long>(grande->bytes));
+        ::operator delete(grande);
+        return;
+    }
+
+    std::size_t tam = (bytes + ALINEACION - 1) / ALINEACION * ALINEACION;
+    if (tam == 0) tam = ALINEACION;
+    std::size_t clase = tam / ALINEACION - 1;
+
+    Hueco* hueco = static_cast<Hueco*>(p);
+    hueco->siguiente = huecos[clase];
+    huecos[clase] = hueco;
+}
+
+void ArenaMemoria::reiniciar() {
+    // Los huecos diferidos están dentro de los bloques que se devuelven
+    diferidos.store(nullptr, std::memory_order_relaxed);
+    Bloque* actual = bloques;
+    while (actual != nullptr) {
+        Bloque* siguiente = actual->siguiente;
+        ::operator delete(actual);
+        actual = siguiente;
+    }
+    Grande* grande = grandes;
+    while (grande != nullptr) {
+        Grande* siguiente = grande->siguiente;
+        ::operator delete(grande);
+        grande = siguiente;
+    }
+    bloques = nullptr;
+    grandes = nullptr;
+    libre = nullptr;
+    fin = nullptr;
+    METRICA_AJUSTAR(INDICADOR_BYTES_ARENA, -static_cast<long long>(bytesReservados));
+    bytesReservados = 0;
+    numBloques = 0;
+    tamSiguiente = TAM_PRIMER_BLOQUE;
+    for (std::size_t i = 0; i < NUM_CLASES; i++) {
+        huecos[i] = nullptr;
+    }
+}
+
+std::size_t ArenaMemoria::obtenerBloques() const {
+    return numBloques;
+}
+
+void ArenaMemoria::nuevoBloque(std::size_t minimo) {
+    // Bloques crecientes: una arena con pocos objetos no retiene TAM_BLOQUE bytes
+    std::size_t tam = tamSiguiente;
+    while (tam < minimo + ALINEACION) tam *= 2;
+    if (tamSiguiente < TAM_BLOQUE) tamSiguiente *= 2;
+    char* memoria = static_cast<char*>(::operator new(tam));
+
+    Bloque* bloque = reinterpret_cast<Bloque*>(memoria);
+    bloque->siguiente = bloques;
+    bloques = bloque;
+    numBloques++;
+    bytesReservados += tam;
+    METRICA_AJUSTAR(INDICADOR_BYTES_ARENA, static_cast<long long>(tam));
+
+    // La cabecera ocupa la primera ranura para conservar la alineación
+    libre = memoria + ALINEACION;
+    fin = memoria + tam;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file CompresionSegmento.cpp
+ * @brief Implementación de los codificadores XOR (float) y delta de delta (int)
+ */
+
+#include "CompresionSegmento.h"
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Escritura de campos de bits, del más significativo al menos significativo
+ */
+class EscritorBits {
+private:
+    unsigned char* destino;
+    std::size_t bytes;
+    uint64_t acumulado;
+    int pendientes;  ///< Bits en acumulado aún no volcados (< 8 entre llamadas)
+
+public:
+    explicit EscritorBits(unsigned char* destino) : destino(destino), bytes(0), acumulado(0), pendientes(0) {}
+
+    void escribir(uint32_t valor, int bits) {
+        uint64_t mascara = (static_cast<uint64_t>(1) << bits) - 1;
+        acumulado = (acumulado << bits) | (valor & mascara);
+        pendientes += bits;
+        while (pendientes >= 8) {
+            pendientes -= 8;
+            destino[bytes++] = static_cast<unsigned char>(acumulado >> pendientes);
+        }
+    }
+
+    /**
+     * @brief Completa el último byte con ceros
+     * @return Bytes escritos en total
+     */
+    std::size_t terminar() {
+        if (pendientes > 0) {
+            destino[bytes++] = static_cast<unsigned char>(acumulado << (8 - pendientes));
+            pendientes = 0;
+        }
+        return bytes;
+    }
+};
+
+/**
+ * @brief Lectura de campos de bits escritos por EscritorBits
+ */
+class LectorBits {
+private:
+    const unsigned char* origen;
+    std::size_t bytes;
+    std::size_t posicion;
+    uint64_t acumulado;
+    int disponibles;
+    bool agotado;
+
+public:
+    LectorBits(const unsigned char* origen, std::size_t bytes)
+        : origen(origen), bytes(bytes), posicion(0), acumulado(0), disponibles(0), agotado(false) {}
+
+    uint32_t leer(int bits) {
+        while (disponibles < bits) {
+            if (posicion == bytes) {
+                agotado = true;
+                return 0;
+            }
+            acumulado = (acumulado << 8) | origen[posicion++];
+            disponibles += 8;
+        }
+        disponibles -= bits;
+        uint64_t mascara = (static_cast<uint64_t>(1) << bits) - 1;
+        return static_cast<uint32_t>((acumulado >> disponibles) & mascara);
+    }
+
+    bool estaAgotado() const { return agotado; }
+};
+
+int cerosIzquierda(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clz(x);
+#else
+    int n = 0;
+    while (!(x & 0x80000000u)) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+int cerosDerecha(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    int n = 0;
+    while (!(x & 1u)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+uint32_t bitsDe(float valor) {
+    uint32_t bits;
+    std::memcpy(&bits, &valor, sizeof(bits));
+    return bits;
+}
+
+float deBits(uint32_t bits) {
+    float valor;
+    std::memcpy(&valor, &bits, sizeof(valor));
+    return valor;
+}
+
+uint64_t zigzag(int64_t valor) {
+    return (static_cast<uint64_t>(valor) << 1) ^ static_cast<uint64_t>(valor >> 63);
+}
+
+int64_t deZigzag(uint64_t valor) {
+    return static_cast<int64_t>(valor >> 1) ^ -static_cast<int64_t>(valor & 1u);
+}
+
+std::size_t escribirVarint(uint64_t valor, unsigned char* destino) {
+    std::size_t n = 0;
+    while (valor >= 0x80u) {
+        destino[n++] = static_cast<unsigned char>(valor | 0x80u);
+        valor >>= 7;
+    }
+    destino[n++] = static_cast<unsigned char>(valor);
+    return n;
+}
+
+bool leerVarint(const unsigned char* origen, std::size_t bytes, std::size_t& posicion, uint64_t& valor) {
+    valor = 0;
+    for (int desplazamiento = 0; desplazamiento < 64; desplazamiento += 7) {
+        if (posicion == bytes) return false;
+        unsigned char byte = origen[posicion++];
+        valor |= static_cast<uint64_t>(byte & 0x7Fu) << desplazamiento;
+        if (!(byte & 0x80u)) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+std::size_t CompresionSegmento::cotaComprimida(int n) {
+    // XOR: 2 + 5 + 5 + 32 bits por lectura como máximo; varint: 5 bytes
+    return static_cast<std::size_t>(n > 0 ? n : 0) * 6 + 8;
+}
+
+std::size_t CompresionSegmento::comprimir(const float* datos, int n, unsigned char* destino) {
+    if (n <= 0) return 0;
+
+    EscritorBits escritor(destino);
+    uint32_t previo = bitsDe(datos[0]);
+    escritor.escribir(previo, 32);
+
+    // Ventana de bits significativos del último XOR escrito con cabecera completa
+    int ventanaIzquierda = -1;
+    int ventanaDerecha = 0;
+    for (int i = 1; i < n; i++) {
+        uint32_t actual = bitsDe(datos[i]);
+        uint32_t diferencia = actual ^ previo;
+        previo = actual;
+
+        if (diferencia == 0) {
+            escritor.escribir(0, 1);
+            continue;
+        }
+
+        int izquierda = cerosIzquierda(diferencia);
+        int derecha = cerosDerecha(diferencia);
+        if (ventanaIzquierda >= 0 && izquierda >= ventanaIzquierda && derecha >= ventanaDerecha) {
+            // Cabe en la ventana anterior: solo los bits de la ventana
+            escritor.escribir(2, 2);
+            escritor.escribir(diferencia >> ventanaDerecha, 32 - ventanaIzquierda - ventanaDerecha);
+        } else {
+            int significativos = 32 - izquierda - derecha;
+            escritor.escribir(3, 2);
+            escritor.escribir(static_cast<uint32_t>(izquierda), 5);
+            escritor.escribir(static_cast<uint32_t>(significativos - 1), 5);
+            escritor.escribir(diferencia >> derecha, significativos);
+            ventanaIzquierda = izquierda;
+            ventanaDerecha = derecha;
+        }
+    }
+    return escritor.terminar();
+}
+
+bool CompresionSegmento::descomprimir(const unsigned char* origen, std::size_t bytes, float* destino, int n) {
+    if (n <= 0) return true;
+
+    LectorBits lector(origen, bytes);
+    uint32_t previo = lector.leer(32);
+    destino[0] = deBits(previo);
+
+    int ventanaIzquierda = -1;
+    int ventanaDerecha = 0;
+    for (int i = 1; i < n; i++) {
+        if (lector.leer(1) != 0) {
+            uint32_t diferencia;
+            if (lector.leer(1) == 0) {
+                if (ventanaIzquierda < 0) return false;
+                diferencia = lector.leer(32 - ventanaIzquierda - ventanaDerecha) << ventanaDerecha;
+            } else {
+                int izquierda = static_cast<int>(lector.leer(5));
+                int significativos = static_cast<int>(lector.leer(5)) + 1;
+                int derecha = 32 - izquierda - significativos;
+                if (derecha < 0) return false;
+                diferencia = lector.leer(significativos) << derecha;
+                ventanaIzquierda = izquierda;
+                ventanaDerecha = derecha;
+            }
+            previo ^= diferencia;
+        }
+        destino[i] = deBits(previo);
+    }
+    return !lector.estaAgotado();
+}
+
+std::size_t CompresionSegmento::comprimir(const int* datos, int n, unsigned char* destino) {
+    if (n <= 0) return 0;
+
+    std::size_t bytes = escribirVarint(zigzag(datos[0]), destino);
+    int64_t deltaPrevio = 0;
+    for (int i = 1; i < n; i++) {
+        int64_t delta = static_cast<int64_t>(datos[i]) - datos[i - 1];
+        bytes += escribirVarint(zigzag(delta - deltaPrevio), destino + bytes);
+        deltaPrevio = delta;
+    }
+    return bytes;
+}
+
+bool CompresionSegmento::descomprimir(const unsigned char* origen, std::size_t bytes, int* destino, int n) {
+    if (n <= 0) return true;
+
+    std::size_t posicion = 0;
+    uint64_t codificado;
+    if (!leerVarint(origen, bytes, posicion, codificado)) return false;
+    int64_t valor = deZigzag(codificado);
+    int64_t delta = 0;
+    for (int i = 0; i < n; i++) {
+        if (i > 0) {
+            if (!leerVarint(origen, bytes, posicion, codificado)) return false;
+            delta += deZigzag(codificado);
+            valor += delta;
+        }
+        if (valor < INT_MIN || valor > INT_MAX) return false;
+        destino[i] = static_cast<int>(valor);
+    }
+    return true;
+}
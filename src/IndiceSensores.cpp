@@ -0,0 +1,145 @@
+/**
+ * @file IndiceSensores.cpp
+ * @brief Implementación del índice hash del registro de sensores
+ */
+
+#include "IndiceSensores.h"
+#include "SistemaGestion.h"
+#include <cstring>
+
+namespace {
+const int CAPACIDAD_INICIAL = 16;  ///< Ranuras de la primera tabla (potencia de 2)
+}
+
+IndiceSensores::IndiceSensores() : ranuras(nullptr), capacidad(0), cantidad(0) {}
+
+IndiceSensores::~IndiceSensores() {
+    delete[] ranuras;
+}
+
+unsigned int IndiceSensores::hashNombre(const char* nombre) {
+    return hashNombre(nombre, static_cast<int>(strlen(nombre)));
+}
+
+unsigned int IndiceSensores::hashNombre(const char* nombre, int longitud) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < longitud; i++) {
+        hash ^= static_cast<unsigned char>(nombre[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool IndiceSensores::insertar(NodoGestion* nodo) {
+    const char* nombre = nodo->sensor->obtenerNombre();
+    int longitud = static_cast<int>(strlen(nombre));
+    unsigned int hash = hashNombre(nombre, longitud);
+
+    if (capacidad > 0 && localizar(nombre, longitud, hash) >= 0) {
+        return false;
+    }
+    if ((cantidad + 1) * 2 > capacidad) {
+        crecer();
+    }
+
+    int mascara = capacidad - 1;
+    int i = static_cast<int>(hash & static_cast<unsigned int>(mascara));
+    while (ranuras[i].nodo != nullptr) {
+        i = (i + 1) & mascara;
+    }
+    ranuras[i].hash = hash;
+    ranuras[i].nodo = nodo;
+    cantidad++;
+    return true;
+}
+
+NodoGestion* IndiceSensores::buscar(const char* nombre) const {
+    return buscar(nombre, static_cast<int>(strlen(nombre)));
+}
+
+NodoGestion* IndiceSensores::buscar(const char* nombre, int longitud) const {
+    if (capacidad == 0) return nullptr;
+
+    int i = localizar(nombre, longitud, hashNombre(nombre, longitud));
+    return i >= 0 ? ranuras[i].nodo : nullptr;
+}
+
+NodoGestion* IndiceSensores::eliminar(const char* nombre) {
+    if (capacidad == 0) return nullptr;
+
+    int longitud = static_cast<int>(strlen(nombre));
+    int i = localizar(nombre, longitud, hashNombre(nombre, longitud));
+    if (i < 0) return nullptr;
+
+    NodoGestion* nodo = ranuras[i].nodo;
+    ranuras[i].nodo = nullptr;
+    cantidad--;
+
+    // Desplazamiento hacia atrás: recolocar el resto del grupo para no dejar huecos
+    int mascara = capacidad - 1;
+    int hueco = i;
+    int j = (i + 1) & mascara;
+    while (ranuras[j].nodo != nullptr) {
+        int ideal = static_cast<int>(ranuras[j].hash & static_cast<unsigned int>(mascara));
+        // ¿La ranura ideal de j queda fuera del tramo (hueco, j]? Entonces puede subir
+        bool mover = (hueco <= j) ? (ideal <= hueco || ideal > j)
+                                  : (ideal <= hueco && ideal > j);
+        if (mover) {
+            ranuras[hueco] = ranuras[j];
+            ranuras[j].nodo = nullptr;
+            hueco = j;
+        }
+        j = (j + 1) & mascara;
+    }
+
+    return nodo;
+}
+
+void IndiceSensores::vaciar() {
+    for (int i = 0; i < capacidad; i++) {
+        ranuras[i].nodo = nullptr;
+    }
+    cantidad = 0;
+}
+
+int IndiceSensores::obtenerCantidad() const {
+    return cantidad;
+}
+
+int IndiceSensores::localizar(const char* nombre, int longitud, unsigned int hash) const {
+    int mascara = capacidad - 1;
+    int i = static_cast<int>(hash & static_cast<unsigned int>(mascara));
+    while (ranuras[i].nodo != nullptr) {
+        if (ranuras[i].hash == hash) {
+            const char* candidato = ranuras[i].nodo->sensor->obtenerNombre();
+            if (strncmp(candidato, nombre, longitud) == 0 && candidato[longitud] == '\0') {
+                return i;
+            }
+        }
+        i = (i + 1) & mascara;
+    }
+    return -1;
+}
+
+void IndiceSensores::crecer() {
+    Ranura* anteriores = ranuras;
+    int capacidadAnterior = capacidad;
+
+    capacidad = capacidad == 0 ? CAPACIDAD_INICIAL : capacidad * 2;
+    ranuras = new Ranura[capacidad];
+    for (int i = 0; i < capacidad; i++) {
+        ranuras[i].nodo = nullptr;
+    }
+
+    int mascara = capacidad - 1;
+    for (int k = 0; k < capacidadAnterior; k++) {
+        if (anteriores[k].nodo == nullptr) continue;
+        int i = static_cast<int>(anteriores[k].hash & static_cast<unsigned int>(mascara));
+        while (ranuras[i].nodo != nullptr) {
+            i = (i + 1) & mascara;
+        }
+        ranuras[i] = anteriores[k];
+    }
+
+    delete[] anteriores;
+}
@@ -0,0 +1,433 @@
+/**
+ * @file IngestaLecturas.cpp
+ * @brief Implementación de la tubería de ingesta de lecturas
+ */
+
+#include "IngestaLecturas.h"
+#include "SistemaGestion.h"
+#include "SistemaFragmentado.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "PlanificadorSensores.h"
+#include "Registro.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+const int IngestaLecturas::TAM_LOTE;
+const std::size_t IngestaLecturas::TAM_BUFER;
+
+IngestaLecturas::IngestaLecturas(SistemaGestion& sistema)
+    : sistema(&sistema), fragmentos(nullptr), descriptor(-1), propio(false), crearDesconocidos(true), modoCola(false),
+      dirSegmentos(nullptr), lecturasEnMemoria(0), reglas(nullptr), indiceExtremos(false), retencion(0),
+      resumenes(false), planificador(nullptr),
+      periodoTemperatura(0), periodoPresion(0), bufer(new char[TAM_BUFER]), pendiente(0), descartandoLinea(false),
+      entrada(nullptr), enLote(0) {}
+
+IngestaLecturas::IngestaLecturas(SistemaFragmentado& fragmentos)
+    : sistema(nullptr), fragmentos(&fragmentos), descriptor(-1), propio(false), crearDesconocidos(true), modoCola(false),
+      dirSegmentos(nullptr), lecturasEnMemoria(0), reglas(nullptr), indiceExtremos(false), retencion(0),
+      resumenes(false), planificador(nullptr),
+      periodoTemperatura(0), periodoPresion(0), bufer(new char[TAM_BUFER]), pendiente(0), descartandoLinea(false),
+      entrada(nullptr), enLote(0) {}
+
+IngestaLecturas::~IngestaLecturas() {
+    cerrar();
+    delete[] bufer;
+    delete[] entrada;
+}
+
+void IngestaLecturas::fijarCrearDesconocidos(bool crear) {
+    crearDesconocidos = crear;
+    if (fragmentos != nullptr) fragmentos->fijarCrearDesconocidos(crear);
+}
+
+void IngestaLecturas::fijarModoCola(bool cola) {
+    modoCola = cola;
+}
+
+void IngestaLecturas::fijarSegmentos(const char* directorio, int lecturasEnMemoria) {
+    dirSegmentos = directorio;
+    this->lecturasEnMemoria = lecturasEnMemoria;
+    if (fragmentos != nullptr) fragmentos->fijarSegmentos(directorio, lecturasEnMemoria);
+}
+
+void IngestaLecturas::fijarReglas(MotorReglas* motor) {
+    reglas = motor;
+    if (fragmentos != nullptr) fragmentos->fijarReglas(motor);
+}
+
+void IngestaLecturas::fijarIndiceExtremos(bool activo) {
+    indiceExtremos = activo;
+    if (fragmentos != nullptr) fragmentos->fijarIndiceExtremos(activo);
+}
+
+void IngestaLecturas::fijarRetencion(const PoliticaRetencion& politica) {
+    retencion = politica;
+    if (fragmentos != nullptr) fragmentos->fijarRetencion(politica);
+}
+
+void IngestaLecturas::fijarResumenes(bool activo) {
+    resumenes = activo;
+    if (fragmentos != nullptr) fragmentos->fijarResumenes(activo);
+}
+
+void IngestaLecturas::fijarPlanificador(PlanificadorSensores* planificador, unsigned periodoTemperatura,
+                                        unsigned periodoPresion) {
+    this->planificador = planificador;
+    this->periodoTemperatura = periodoTemperatura;
+    this->periodoPresion = periodoPresion;
+}
+
+void IngestaLecturas::fijarProtocoloBinario(bool activo) {
+    if (activo && entrada == nullptr) {
+        entrada = new char[TAM_BUFER];
+    } else if (!activo) {
+        delete[] entrada;
+        entrada = nullptr;
+        trama.cantidad = 0;
+    }
+}
+
+bool IngestaLecturas::protocoloBinario() const {
+    return entrada != nullptr;
+}
+
+bool IngestaLecturas::abrir(const char* ruta) {
+    cerrar();
+
+    if (strcmp(ruta, "-") == 0) {
+        descriptor = STDIN_FILENO;
+        propio = false;
+        return true;
+    }
+
+    descriptor = open(ruta, O_RDONLY | O_NOCTTY);
+    if (descriptor < 0) {
+        REGISTRO_ERROR("[Error] No se pudo abrir '" << ruta << "': " << strerror(errno) << "\n");
+        return false;
+    }
+    propio = true;
+
+    if (isatty(descriptor) && !configurarSerial(descriptor)) {
+        REGISTRO_AVISO("[Ingesta] No se pudo configurar '" << ruta << "' a 115200 baudios.\n");
+    }
+    REGISTRO_INFO("[Ingesta] Fuente abierta: " << ruta << "\n");
+    return true;
+}
+
+void IngestaLecturas::cerrar() {
+    if (descriptor >= 0 && propio) {
+        close(descriptor);
+    }
+    descriptor = -1;
+    propio = false;
+}
+
+bool IngestaLecturas::procesarFuente() {
+    if (descriptor < 0) return false;
+
+    // Con tramas binarias se lee a un búfer aparte: el principal guarda la línea partida
+    while (entrada != nullptr) {
+        ssize_t leidos = read(descriptor, entrada, TAM_BUFER);
+        if (leidos < 0) {
+            if (errno == EINTR) continue;
+            REGISTRO_ERROR("[Error] Lectura de la fuente fallida: " << strerror(errno) << "\n");
+            finalizar();
+            return false;
+        }
+        if (leidos == 0) {
+            finalizar();
+            return true;
+        }
+        demultiplexar(trama, entrada, static_cast<std::size_t>(leidos), *this);
+    }
+
+    while (true) {
+        ssize_t leidos = read(descriptor, bufer + pendiente, TAM_BUFER - pendiente);
+        if (leidos < 0) {
+            if (errno == EINTR) continue;
+            REGISTRO_ERROR("[Error] Lectura de la fuente fallida: " << strerror(errno) << "\n");
+            finalizar();
+            return false;
+        }
+        if (leidos == 0) {
+            finalizar();
+            return true;
+        }
+
+        // Analizar en el propio búfer, despachar y conservar solo la línea partida
+        std::size_t total = pendiente + static_cast<std::size_t>(leidos);
+        std::size_t consumidos = analizarLineas(bufer, total);
+        despacharLote();
+
+        pendiente = total - consumidos;
+        if (pendiente == TAM_BUFER) {
+            estadisticas.invalidas++;
+            descartandoLinea = true;
+            pendiente = 0;
+        } else if (pendiente > 0 && consumidos > 0) {
+            memmove(bufer, bufer + consumidos, pendiente);
+        }
+    }
+}
+
+void IngestaLecturas::consumir(const char* datos, std::size_t longitud) {
+    if (entrada != nullptr) {
+        demultiplexar(trama, datos, longitud, *this);
+    } else {
+        consumirTexto(datos, longitud);
+    }
+}
+
+void IngestaLecturas::consumirTexto(const char* datos, std::size_t longitud) {
+    const char* fin = datos + longitud;
+
+    // Completar la línea partida del bloque anterior
+    if (pendiente > 0 || descartandoLinea) {
+        const char* salto = static_cast<const char*>(memchr(datos, '\n', longitud));
+        std::size_t hasta = salto != nullptr ? static_cast<std::size_t>(salto - datos) : longitud;
+
+        if (!descartandoLinea && pendiente + hasta > TAM_BUFER) {
+            estadisticas.invalidas++;
+            descartandoLinea = true;
+            pendiente = 0;
+        }
+        if (!descartandoLinea) {
+            memcpy(bufer + pendiente, datos, hasta);
+            pendiente += hasta;
+        }
+        if (salto == nullptr) return;
+
+        if (descartandoLinea) {
+            descartandoLinea = false;
+        } else {
+            estadisticas.lineas++;
+            analizarUna(bufer, bufer + pendiente);
+        }
+        datos = salto + 1;
+        pendiente = 0;
+    }
+
+    std::size_t consumidos = analizarLineas(datos, static_cast<std::size_t>(fin - datos));
+    despacharLote();
+
+    std::size_t resto = static_cast<std::size_t>(fin - datos) - consumidos;
+    if (resto > TAM_BUFER) {
+        estadisticas.invalidas++;
+        descartandoLinea = true;
+    } else if (resto > 0) {
+        memcpy(bufer, datos + consumidos, resto);
+        pendiente = resto;
+    }
+}
+
+bool IngestaLecturas::descartarLineaPartida() {
+    bool habia = pendiente > 0 || descartandoLinea;
+    pendiente = 0;
+    descartandoLinea = false;
+    return habia;
+}
+
+void IngestaLecturas::descartarTrama(TramaEnCurso& enCurso) {
+    if (enCurso.cantidad > 0) {
+        estadisticas.tramasInvalidas++;
+        enCurso.cantidad = 0;
+    }
+}
+
+void IngestaLecturas::entregarTrama(const TramaBinaria& t) {
+    char nombre[8];
+    int longitudId = formatearIdSensor(t.tipo, t.id, nombre);
+
+    // La trama entra entera en el lote y se despacha antes de que nombre deje de existir
+    if (enLote + t.cantidad > TAM_LOTE) despacharLote();
+    for (int i = 0; i < t.cantidad; i++) {
+        LecturaTexto& lectura = lote[enLote++];
+        lectura.tipo = t.tipo;
+        lectura.id = nombre;
+        lectura.longitudId = longitudId;
+        if (t.tipo == LECTURA_TEMPERATURA) {
+            // Misma conversión que el texto "45.30": centésimas en double y después float
+            lectura.valorFloat = static_cast<float>(static_cast<double>(t.valores[i]) / 100.0);
+        } else {
+            lectura.valorInt = t.valores[i];
+        }
+    }
+    despacharLote();
+}
+
+void IngestaLecturas::finalizar() {
+    // Trama cortada por el fin de la fuente
+    descartarTrama(trama);
+    if (pendiente > 0 && !descartandoLinea) {
+        estadisticas.lineas++;
+        analizarUna(bufer, bufer + pendiente);
+    }
+    despacharLote();
+    pendiente = 0;
+    descartandoLinea = false;
+}
+
+bool IngestaLecturas::configurarSerial(int descriptor) {
+    termios opciones;
+    if (tcgetattr(descriptor, &opciones) != 0) return false;
+
+    cfmakeraw(&opciones);
+    cfsetispeed(&opciones, B115200);
+    cfsetospeed(&opciones, B115200);
+    opciones.c_cflag |= CLOCAL | CREAD;
+    opciones.c_cc[VMIN] = 1;
+    opciones.c_cc[VTIME] = 0;
+    return tcsetattr(descriptor, TCSANOW, &opciones) == 0;
+}
+
+void IngestaLecturas::acumularLineas(const char* datos, std::size_t longitud) {
+    analizarLineas(datos, longitud);
+}
+
+const EstadisticasIngesta& IngestaLecturas::obtenerEstadisticas() const {
+    return estadisticas;
+}
+
+std::size_t IngestaLecturas::analizarLineas(const char* datos, std::size_t longitud) {
+    const char* inicio = datos;
+    const char* fin = datos + longitud;
+
+    while (inicio < fin) {
+        const char* salto = static_cast<const char*>(memchr(inicio, '\n', static_cast<std::size_t>(fin - inicio)));
+        if (salto == nullptr) break;
+
+        if (descartandoLinea) {
+            // Cola de una línea que no cupo en el búfer
+            descartandoLinea = false;
+        } else {
+            estadisticas.lineas++;
+            analizarUna(inicio, salto);
+        }
+        inicio = salto + 1;
+    }
+
+    return static_cast<std::size_t>(inicio - datos);
+}
+
+void IngestaLecturas::analizarUna(const char* inicio, const char* fin) {
+    switch (analizarLinea(inicio, fin, lote[enLote])) {
+    case LINEA_LECTURA:
+        if (++enLote == TAM_LOTE) {
+            despacharLote();
+        }
+        break;
+    case LINEA_IGNORADA:
+        estadisticas.ignoradas++;
+        break;
+    case LINEA_INVALIDA:
+        estadisticas.invalidas++;
+        break;
+    }
+}
+
+void IngestaLecturas::despacharLote() {
+    if (fragmentos != nullptr) {
+        // Los identificadores se copian a los mensajes: el lote puede reutilizarse ya
+        fragmentos->enviarLecturas(lote, enLote);
+    } else {
+        despachar(lote, enLote);
+    }
+    enLote = 0;
+}
+
+void IngestaLecturas::entregarLecturas(const LecturaTexto* lecturas, int n) {
+    despacharLote();
+    if (fragmentos != nullptr) {
+        fragmentos->enviarLecturas(lecturas, n);
+    } else {
+        despachar(lecturas, n);
+    }
+}
+
+void IngestaLecturas::despachar(const LecturaTexto* lecturas, int n) {
+    // Caché del último destino: el simulador repite los mismos ID en ráfagas
+    const char* ultimoId = nullptr;
+    int ultimaLongitud = 0;
+    SensorTemperatura* temperatura = nullptr;
+    SensorPresion* presion = nullptr;
+
+    for (int i = 0; i < n; i++) {
+        const LecturaTexto& lectura = lecturas[i];
+
+        bool mismoId = ultimoId != nullptr && ultimaLongitud == lectura.longitudId &&
+                       memcmp(ultimoId, lectura.id, static_cast<std::size_t>(lectura.longitudId)) == 0;
+        if (!mismoId) {
+            SensorBase* sensor = resolverSensor(lectura);
+            temperatura = dynamic_cast<SensorTemperatura*>(sensor);
+            presion = dynamic_cast<SensorPresion*>(sensor);
+            ultimoId = lectura.id;
+            ultimaLongitud = lectura.longitudId;
+        }
+
+        bool entregada = false;
+        if (lectura.tipo == LECTURA_TEMPERATURA && temperatura != nullptr) {
+            if (modoCola) {
+                entregada = temperatura->encolarLectura(lectura.valorFloat);
+            } else {
+                temperatura->registrarLectura(lectura.valorFloat);
+                entregada = true;
+            }
+        } else if (lectura.tipo == LECTURA_PRESION && presion != nullptr) {
+            if (modoCola) {
+                entregada = presion->encolarLectura(lectura.valorInt);
+            } else {
+                presion->registrarLectura(lectura.valorInt);
+                entregada = true;
+            }
+        }
+
+        if (entregada) {
+            estadisticas.lecturas++;
+        } else {
+            estadisticas.descartadas++;
+        }
+    }
+}
+
+SensorBase* IngestaLecturas::resolverSensor(const LecturaTexto& lectura) {
+    SensorBase* sensor = sistema->buscarSensor(lectura.id, lectura.longitudId);
+    if (sensor != nullptr || !crearDesconocidos || modoCola) {
+        return sensor;
+    }
+
+    char nombre[50];
+    memcpy(nombre, lectura.id, static_cast<std::size_t>(lectura.longitudId));
+    nombre[lectura.longitudId] = '\0';
+
+    if (lectura.tipo == LECTURA_TEMPERATURA) {
+        SensorTemperatura* temperatura = new SensorTemperatura(nombre, sistema->obtenerArena());
+        if (retencion.capacidad > 0) temperatura->fijarRetencion(retencion);
+        if (dirSegmentos != nullptr) temperatura->fijarSegmentos(dirSegmentos, lecturasEnMemoria);
+        if (reglas != nullptr) temperatura->fijarReglas(reglas);
+        if (indiceExtremos) temperatura->activarIndiceExtremos();
+        if (resumenes) temperatura->activarResumenes();
+        sensor = temperatura;
+    } else {
+        SensorPresion* presion = new SensorPresion(nombre, sistema->obtenerArena());
+        if (retencion.capacidad > 0) presion->fijarRetencion(retencion);
+        if (dirSegmentos != nullptr) presion->fijarSegmentos(dirSegmentos, lecturasEnMemoria);
+        if (reglas != nullptr) presion->fijarReglas(reglas);
+        if (resumenes) presion->activarResumenes();
+        sensor = presion;
+    }
+    if (!sistema->agregarSensor(sensor)) {
+        // Nombre rechazado por el registro: no debe quedar un sensor huérfano recibiendo lecturas
+        delete sensor;
+        return nullptr;
+    }
+    unsigned periodo = lectura.tipo == LECTURA_TEMPERATURA ? periodoTemperatura : periodoPresion;
+    if (planificador != nullptr && periodo > 0) {
+        planificador->programar(sensor, periodo, 1 + static_cast<unsigned>(estadisticas.sensoresCreados % periodo));
+    }
+    estadisticas.sensoresCreados++;
+    return sensor;
+}
@@ -0,0 +1,354 @@
+/**
+ * @file Instantanea.cpp
+ * @brief Implementación de la instantánea binaria (escritura secuencial, lectura con mmap)
+ */
+
+#include "Instantanea.h"
+#include "SistemaGestion.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "SumaVerificacion.h"
+#include "Registro.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const unsigned Instantanea::VERSION;
+
+namespace {
+
+const char MAGIA_INICIO[8] = {'I', 'O', 'T', 'S', 'N', 'A', 'P', '1'};
+const char MAGIA_FIN[8] = {'I', 'O', 'T', 'S', 'N', 'E', 'N', 'D'};
+
+const uint32_t TIPO_TEMPERATURA = 1;
+const uint32_t TIPO_PRESION = 2;
+
+struct CabeceraArchivo {
+    char magia[8];
+    uint32_t version;
+    uint32_t numSensores;
+    uint32_t crcCabecera;  ///< CRC de los 16 bytes anteriores
+    uint32_t relleno;
+};
+
+struct CabeceraSensor {
+    uint32_t tipo;
+    uint32_t longitudNombre;
+    uint64_t numLecturas;
+    uint32_t crcCabecera;  ///< CRC de los 16 bytes anteriores
+    uint32_t relleno;
+};
+
+struct PieSensor {
+    uint32_t crcDatos;  ///< CRC del nombre (con relleno) y de las lecturas (con relleno)
+    uint32_t relleno;
+};
+
+struct PieArchivo {
+    char magia[8];
+    uint64_t tamanioTotal;  ///< Bytes del archivo completo
+};
+
+static_assert(sizeof(CabeceraArchivo) == 24, "Formato de instantánea");
+static_assert(sizeof(CabeceraSensor) == 24, "Formato de instantánea");
+static_assert(sizeof(PieSensor) == 8, "Formato de instantánea");
+static_assert(sizeof(PieArchivo) == 16, "Formato de instantánea");
+static_assert(sizeof(float) == 4 && sizeof(int) == 4, "Lecturas de 4 bytes");
+
+uint64_t alinear8(uint64_t n) {
+    return (n + 7u) & ~static_cast<uint64_t>(7u);
+}
+
+/**
+ * @brief Escritura secuencial con búfer propio y CRC acumulado de cada sección
+ */
+class Escritor {
+private:
+    FILE* archivo;
+    uint64_t escritos;
+    uint32_t crc;
+    bool correcto;
+
+public:
+    explicit Escritor(FILE* archivo) : archivo(archivo), escritos(0), crc(0), correcto(true) {}
+
+    void escribir(const void* datos, std::size_t n) {
+        if (!correcto || n == 0) return;
+        crc = calcularCrc32c(datos, n, crc);
+        if (fwrite(datos, 1, n, archivo) != n) {
+            correcto = false;
+        }
+        escritos += n;
+    }
+
+    void rellenar() {
+        static const char ceros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        escribir(ceros, static_cast<std::size_t>(alinear8(escritos) - escritos));
+    }
+
+    /**
+     * @brief Devuelve el CRC de lo escrito desde la llamada anterior y lo reinicia
+     */
+    uint32_t cerrarSeccion() {
+        uint32_t valor = crc;
+        crc = 0;
+        return valor;
+    }
+
+    uint64_t obtenerEscritos() const { return escritos; }
+    bool esCorrecto() const { return correcto; }
+};
+
+/**
+ * @brief Escribe el registro de un sensor: cabecera, nombre, lecturas y pie
+ */
+template <typename TSensor, typename T>
+void escribirSensor(Escritor& escritor, const TSensor* sensor, uint32_t tipo) {
+    const char* nombre = sensor->obtenerNombre();
+
+    CabeceraSensor cabecera;
+    std::memset(&cabecera, 0, sizeof(cabecera));
+    cabecera.tipo = tipo;
+    cabecera.longitudNombre = static_cast<uint32_t>(std::strlen(nombre));
+    cabecera.numLecturas = static_cast<uint64_t>(sensor->obtenerCantidadLecturas());
+    cabecera.crcCabecera = calcularCrc32c(&cabecera, 16);
+    escritor.escribir(&cabecera, sizeof(cabecera));
+    escritor.cerrarSeccion();
+
+    escritor.escribir(nombre, cabecera.longitudNombre);
+    escritor.rellenar();
+
+    // Lecturas en tandas de 4096 para escribir con pocas llamadas
+    T tanda[4096];
+    std::size_t enTanda = 0;
+    sensor->recorrerLecturas([&escritor, &tanda, &enTanda](T valor) {
+        tanda[enTanda++] = valor;
+        if (enTanda == 4096) {
+            escritor.escribir(tanda, sizeof(tanda));
+            enTanda = 0;
+        }
+    });
+    escritor.escribir(tanda, enTanda * sizeof(T));
+    escritor.rellenar();
+
+    PieSensor pie;
+    pie.crcDatos = escritor.cerrarSeccion();
+    pie.relleno = 0;
+    escritor.escribir(&pie, sizeof(pie));
+    escritor.cerrarSeccion();
+}
+
+/**
+ * @brief Vista de un registro de sensor dentro del archivo mapeado
+ */
+struct RegistroSensor {
+    const CabeceraSensor* cabecera;
+    const char* nombre;
+    const void* lecturas;
+};
+
+/**
+ * @brief Recorre (y verifica) los registros de un archivo mapeado
+ * @param verificar false para omitir los CRC de los datos (ya verificados)
+ * @param visitar Llamada con cada registro
+ * @return false ante cualquier inconsistencia
+ */
+template <typename F>
+bool recorrerRegistros(const char* base, uint64_t tamanio, bool verificar, F visitar) {
+    if (tamanio < sizeof(CabeceraArchivo) + sizeof(PieArchivo)) return false;
+    // Todas las secciones ocupan múltiplos de 8: otro tamaño es un archivo truncado, y
+    // descartarlo aquí mantiene alineadas las estructuras leídas desde el mapeo
+    if (tamanio % 8 != 0) return false;
+
+    const CabeceraArchivo* cabecera = reinterpret_cast<const CabeceraArchivo*>(base);
+    if (std::memcmp(cabecera->magia, MAGIA_INICIO, 8) != 0 || cabecera->version != Instantanea::VERSION ||
+        cabecera->crcCabecera != calcularCrc32c(cabecera, 16) || cabecera->relleno != 0) {
+        return false;
+    }
+
+    const PieArchivo* pieArchivo = reinterpret_cast<const PieArchivo*>(base + tamanio - sizeof(PieArchivo));
+    if (std::memcmp(pieArchivo->magia, MAGIA_FIN, 8) != 0 || pieArchivo->tamanioTotal != tamanio) {
+        return false;
+    }
+
+    uint64_t posicion = sizeof(CabeceraArchivo);
+    uint64_t limite = tamanio - sizeof(PieArchivo);
+    for (uint32_t s = 0; s < cabecera->numSensores; s++) {
+        if (limite - posicion < sizeof(CabeceraSensor)) return false;
+        const CabeceraSensor* cs = reinterpret_cast<const CabeceraSensor*>(base + posicion);
+        if (cs->crcCabecera != calcularCrc32c(cs, 16) || cs->relleno != 0 ||
+            cs->longitudNombre == 0 || cs->longitudNombre >= 50 ||
+            (cs->tipo != TIPO_TEMPERATURA && cs->tipo != TIPO_PRESION)) {
+            return false;
+        }
+        posicion += sizeof(CabeceraSensor);
+
+        uint64_t bytesNombre = alinear8(cs->longitudNombre);
+        if (cs->numLecturas > (limite - posicion) / 4) return false;
+        uint64_t bytesLecturas = alinear8(cs->numLecturas * 4);
+        if (limite - posicion < bytesNombre + bytesLecturas + sizeof(PieSensor)) return false;
+
+        const char* inicio = base + posicion;
+        const PieSensor* pie = reinterpret_cast<const PieSensor*>(inicio + bytesNombre + bytesLecturas);
+        // Los campos de relleno no entran en ningún CRC: se exige que sean cero
+        if (pie->relleno != 0 ||
+            (verificar &&
+             pie->crcDatos != calcularCrc32c(inicio, static_cast<std::size_t>(bytesNombre + bytesLecturas)))) {
+            return false;
+        }
+
+        RegistroSensor registro;
+        registro.cabecera = cs;
+        registro.nombre = inicio;
+        registro.lecturas = inicio + bytesNombre;
+        visitar(registro);
+
+        posicion += bytesNombre + bytesLecturas + sizeof(PieSensor);
+    }
+    return posicion == limite;
+}
+
+/**
+ * @brief Carga las lecturas de un registro en un sensor (en tramos que caben en int)
+ */
+template <typename TSensor, typename T>
+void cargarEn(TSensor* sensor, const RegistroSensor& registro) {
+    const T* lecturas = static_cast<const T*>(registro.lecturas);
+    uint64_t restantes = registro.cabecera->numLecturas;
+    const uint64_t TRAMO = 1u << 30;
+    while (restantes > 0) {
+        uint64_t n = restantes < TRAMO ? restantes : TRAMO;
+        sensor->cargarLecturas(lecturas, static_cast<int>(n));
+        lecturas += n;
+        restantes -= n;
+    }
+}
+
+}  // namespace
+
+bool Instantanea::guardar(const SistemaGestion& sistema, const char* ruta) {
+    std::string temporal = std::string(ruta) + ".tmp";
+    FILE* archivo = fopen(temporal.c_str(), "wb");
+    if (archivo == nullptr) {
+        REGISTRO_ERROR("[Error] No se pudo crear '" << temporal.c_str() << "': " << strerror(errno) << "\n");
+        return false;
+    }
+    setvbuf(archivo, nullptr, _IOFBF, 1 << 20);
+
+    Escritor escritor(archivo);
+
+    CabeceraArchivo cabecera;
+    std::memset(&cabecera, 0, sizeof(cabecera));
+    std::memcpy(cabecera.magia, MAGIA_INICIO, 8);
+    cabecera.version = VERSION;
+    sistema.recorrerSensores([&cabecera](const SensorBase* sensor) {
+        if (dynamic_cast<const SensorTemperatura*>(sensor) != nullptr ||
+            dynamic_cast<const SensorPresion*>(sensor) != nullptr) {
+            cabecera.numSensores++;
+        }
+    });
+    cabecera.crcCabecera = calcularCrc32c(&cabecera, 16);
+    escritor.escribir(&cabecera, sizeof(cabecera));
+    escritor.cerrarSeccion();
+
+    sistema.recorrerSensores([&escritor](const SensorBase* sensor) {
+        if (const SensorTemperatura* t = dynamic_cast<const SensorTemperatura*>(sensor)) {
+            escribirSensor<SensorTemperatura, float>(escritor, t, TIPO_TEMPERATURA);
+        } else if (const SensorPresion* p = dynamic_cast<const SensorPresion*>(sensor)) {
+            escribirSensor<SensorPresion, int>(escritor, p, TIPO_PRESION);
+        }
+    });
+
+    PieArchivo pie;
+    std::memcpy(pie.magia, MAGIA_FIN, 8);
+    pie.tamanioTotal = escritor.obtenerEscritos() + sizeof(PieArchivo);
+    escritor.escribir(&pie, sizeof(pie));
+
+    bool correcto = escritor.esCorrecto() && fflush(archivo) == 0 && fsync(fileno(archivo)) == 0;
+    correcto = fclose(archivo) == 0 && correcto;
+    if (!correcto || rename(temporal.c_str(), ruta) != 0) {
+        REGISTRO_ERROR("[Error] No se pudo escribir la instantánea '" << ruta << "': " << strerror(errno) << "\n");
+        remove(temporal.c_str());
+        return false;
+    }
+
+    REGISTRO_INFO("[Instantanea] " << cabecera.numSensores << " sensor(es) guardados en '" << ruta << "' ("
+                  << static_cast<long long>(pie.tamanioTotal) << " bytes).\n");
+    return true;
+}
+
+bool Instantanea::restaurar(SistemaGestion& sistema, const char* ruta) {
+    int descriptor = open(ruta, O_RDONLY);
+    if (descriptor < 0) {
+        REGISTRO_ERROR("[Error] No se pudo abrir la instantánea '" << ruta << "': " << strerror(errno) << "\n");
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size <= 0) {
+        close(descriptor);
+        REGISTRO_ERROR("[Error] Instantánea '" << ruta << "' vacía o ilegible.\n");
+        return false;
+    }
+    uint64_t tamanio = static_cast<uint64_t>(info.st_size);
+
+    void* mapa = mmap(nullptr, static_cast<std::size_t>(tamanio), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapa == MAP_FAILED) {
+        REGISTRO_ERROR("[Error] mmap de '" << ruta << "' fallido: " << strerror(errno) << "\n");
+        return false;
+    }
+    madvise(mapa, static_cast<std::size_t>(tamanio), MADV_SEQUENTIAL | MADV_WILLNEED);
+    const char* base = static_cast<const char*>(mapa);
+
+    // Primera pasada: solo verificar; el sistema no se toca si algo no cuadra
+    bool valida = recorrerRegistros(base, tamanio, true, [](const RegistroSensor&) {});
+    if (!valida) {
+        munmap(mapa, static_cast<std::size_t>(tamanio));
+        REGISTRO_ERROR("[Error] Instantánea '" << ruta << "' corrupta o truncada.\n");
+        return false;
+    }
+
+    int restaurados = 0;
+    int omitidos = 0;
+    recorrerRegistros(base, tamanio, false, [&sistema, &restaurados, &omitidos](const RegistroSensor& registro) {
+        char nombre[50];
+        std::memcpy(nombre, registro.nombre, registro.cabecera->longitudNombre);
+        nombre[registro.cabecera->longitudNombre] = '\0';
+
+        SensorBase* existente = sistema.buscarSensor(nombre);
+        if (registro.cabecera->tipo == TIPO_TEMPERATURA) {
+            SensorTemperatura* sensor = existente != nullptr ? dynamic_cast<SensorTemperatura*>(existente)
+                                                             : new SensorTemperatura(nombre, sistema.obtenerArena());
+            if (sensor == nullptr) {
+                omitidos++;
+                return;
+            }
+            cargarEn<SensorTemperatura, float>(sensor, registro);
+            if (existente == nullptr) sistema.agregarSensor(sensor);
+        } else {
+            SensorPresion* sensor = existente != nullptr ? dynamic_cast<SensorPresion*>(existente)
+                                                         : new SensorPresion(nombre, sistema.obtenerArena());
+            if (sensor == nullptr) {
+                omitidos++;
+                return;
+            }
+            cargarEn<SensorPresion, int>(sensor, registro);
+            if (existente == nullptr) sistema.agregarSensor(sensor);
+        }
+        restaurados++;
+    });
+
+    munmap(mapa, static_cast<std::size_t>(tamanio));
+    if (omitidos > 0) {
+        REGISTRO_AVISO("[Instantanea] " << omitidos << " sensor(es) omitidos: ya existen con otro tipo.\n");
+    }
+    REGISTRO_INFO("[Instantanea] " << restaurados << " sensor(es) restaurados desde '" << ruta << "'.\n");
+    return true;
+}
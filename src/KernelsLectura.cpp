@@ -0,0 +1,413 @@
+/**
+ * @file KernelsLectura.cpp
+ * @brief Kernels SSE2/AVX2 para bloques de lecturas float e int
+ */
+
+#include "KernelsLectura.h"
+
+#if defined(SISTEMA_IOT_SIMD) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// ======================== Versiones escalares ========================
+
+template <typename T, typename A>
+A sumarEscalar(const T* datos, int n) {
+    A suma = A();
+    for (int i = 0; i < n; i++) suma += static_cast<A>(datos[i]);
+    return suma;
+}
+
+template <typename T>
+double sumarCuadradosEscalar(const T* datos, int n) {
+    double suma = 0.0;
+    for (int i = 0; i < n; i++) {
+        double x = static_cast<double>(datos[i]);
+        suma += x * x;
+    }
+    return suma;
+}
+
+template <typename T>
+int buscarEscalar(const T* datos, int n, T valor) {
+    for (int i = 0; i < n; i++) {
+        if (datos[i] == valor) return i;
+    }
+    return -1;
+}
+
+template <typename T>
+T menorEscalar(const T* datos, int desde, int n, T menor) {
+    for (int i = desde; i < n; i++) {
+        if (datos[i] < menor) menor = datos[i];
+    }
+    return menor;
+}
+
+template <typename T>
+T mayorEscalar(const T* datos, int desde, int n, T mayor) {
+    for (int i = desde; i < n; i++) {
+        if (mayor < datos[i]) mayor = datos[i];
+    }
+    return mayor;
+}
+
+#ifdef KERNELS_X86
+
+// ======================== SSE2 (base en x86-64) ========================
+
+double sumarSse2(const float* datos, int n) {
+    __m128d a = _mm_setzero_pd();
+    __m128d b = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(datos + i);
+        a = _mm_add_pd(a, _mm_cvtps_pd(v));
+        b = _mm_add_pd(b, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    double parcial[2];
+    _mm_storeu_pd(parcial, _mm_add_pd(a, b));
+    return parcial[0] + parcial[1] + sumarEscalar<float, double>(datos + i, n - i);
+}
+
+long long sumarSse2(const int* datos, int n) {
+    __m128i a = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + i));
+        __m128i signo = _mm_srai_epi32(v, 31);
+        a = _mm_add_epi64(a, _mm_unpacklo_epi32(v, signo));
+        a = _mm_add_epi64(a, _mm_unpackhi_epi32(v, signo));
+    }
+    long long parcial[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(parcial), a);
+    return parcial[0] + parcial[1] + sumarEscalar<int, long long>(datos + i, n - i);
+}
+
+double sumarCuadradosSse2(const float* datos, int n) {
+    __m128d a = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(datos + i);
+        __m128d bajo = _mm_cvtps_pd(v);
+        __m128d alto = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+        a = _mm_add_pd(a, _mm_add_pd(_mm_mul_pd(bajo, bajo), _mm_mul_pd(alto, alto)));
+    }
+    double parcial[2];
+    _mm_storeu_pd(parcial, a);
+    return parcial[0] + parcial[1] + sumarCuadradosEscalar(datos + i, n - i);
+}
+
+double sumarCuadradosSse2(const int* datos, int n) {
+    __m128d a = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + i));
+        __m128d bajo = _mm_cvtepi32_pd(v);
+        __m128d alto = _mm_cvtepi32_pd(_mm_unpackhi_epi64(v, v));
+        a = _mm_add_pd(a, _mm_add_pd(_mm_mul_pd(bajo, bajo), _mm_mul_pd(alto, alto)));
+    }
+    double parcial[2];
+    _mm_storeu_pd(parcial, a);
+    return parcial[0] + parcial[1] + sumarCuadradosEscalar(datos + i, n - i);
+}
+
+int buscarSse2(const float* datos, int n, float valor) {
+    __m128 objetivo = _mm_set1_ps(valor);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int mascara = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(datos + i), objetivo));
+        if (mascara != 0) return i + __builtin_ctz(static_cast<unsigned int>(mascara));
+    }
+    int resto = buscarEscalar(datos + i, n - i, valor);
+    return resto < 0 ? -1 : i + resto;
+}
+
+int buscarSse2(const int* datos, int n, int valor) {
+    __m128i objetivo = _mm_set1_epi32(valor);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + i));
+        int mascara = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, objetivo)));
+        if (mascara != 0) return i + __builtin_ctz(static_cast<unsigned int>(mascara));
+    }
+    int resto = buscarEscalar(datos + i, n - i, valor);
+    return resto < 0 ? -1 : i + resto;
+}
+
+/**
+ * @brief Extremo de un bloque float con SSE2
+ * @param menor true para el mínimo, false para el máximo
+ */
+float extremoSse2(const float* datos, int n, bool menor) {
+    if (n < 8) {
+        return menor ? menorEscalar(datos, 1, n, datos[0]) : mayorEscalar(datos, 1, n, datos[0]);
+    }
+    __m128 m = _mm_loadu_ps(datos);
+    int i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(datos + i);
+        m = menor ? _mm_min_ps(m, v) : _mm_max_ps(m, v);
+    }
+    float carriles[4];
+    _mm_storeu_ps(carriles, m);
+    float extremo = menor ? menorEscalar(carriles, 1, 4, carriles[0])
+                          : mayorEscalar(carriles, 1, 4, carriles[0]);
+    return menor ? menorEscalar(datos, i, n, extremo) : mayorEscalar(datos, i, n, extremo);
+}
+
+/**
+ * @brief Extremo de un bloque int con SSE2 (min/max de 32 bits emulados con comparación)
+ */
+int extremoSse2(const int* datos, int n, bool menor) {
+    if (n < 8) {
+        return menor ? menorEscalar(datos, 1, n, datos[0]) : mayorEscalar(datos, 1, n, datos[0]);
+    }
+    __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos));
+    int i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + i));
+        __m128i elegir = menor ? _mm_cmplt_epi32(v, m) : _mm_cmpgt_epi32(v, m);
+        m = _mm_or_si128(_mm_and_si128(elegir, v), _mm_andnot_si128(elegir, m));
+    }
+    int carriles[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(carriles), m);
+    int extremo = menor ? menorEscalar(carriles, 1, 4, carriles[0])
+                        : mayorEscalar(carriles, 1, 4, carriles[0]);
+    return menor ? menorEscalar(datos, i, n, extremo) : mayorEscalar(datos, i, n, extremo);
+}
+
+// ======================== AVX2 (elegido en tiempo de ejecución) ========================
+
+__attribute__((target("avx2"))) double sumarAvx2(const float* datos, int n) {
+    __m256d a = _mm256_setzero_pd();
+    __m256d b = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a = _mm256_add_pd(a, _mm256_cvtps_pd(_mm_loadu_ps(datos + i)));
+        b = _mm256_add_pd(b, _mm256_cvtps_pd(_mm_loadu_ps(datos + i + 4)));
+    }
+    double parcial[4];
+    _mm256_storeu_pd(parcial, _mm256_add_pd(a, b));
+    return (parcial[0] + parcial[1]) + (parcial[2] + parcial[3]) +
+           sumarEscalar<float, double>(datos + i, n - i);
+}
+
+__attribute__((target("avx2"))) long long sumarAvx2(const int* datos, int n) {
+    __m256i a = _mm256_setzero_si256();
+    __m256i b = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a = _mm256_add_epi64(a, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + i))));
+        b = _mm256_add_epi64(b, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + i + 4))));
+    }
+    long long parcial[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(parcial), _mm256_add_epi64(a, b));
+    return parcial[0] + parcial[1] + parcial[2] + parcial[3] +
+           sumarEscalar<int, long long>(datos + i, n - i);
+}
+
+__attribute__((target("avx2"))) double sumarCuadradosAvx2(const float* datos, int n) {
+    __m256d a = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_cvtps_pd(_mm_loadu_ps(datos + i));
+        a = _mm256_add_pd(a, _mm256_mul_pd(v, v));
+    }
+    double parcial[4];
+    _mm256_storeu_pd(parcial, a);
+    return (parcial[0] + parcial[1]) + (parcial[2] + parcial[3]) +
+           sumarCuadradosEscalar(datos + i, n - i);
+}
+
+__attribute__((target("avx2"))) double sumarCuadradosAvx2(const int* datos, int n) {
+    __m256d a = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(datos + i)));
+        a = _mm256_add_pd(a, _mm256_mul_pd(v, v));
+    }
+    double parcial[4];
+    _mm256_storeu_pd(parcial, a);
+    return (parcial[0] + parcial[1]) + (parcial[2] + parcial[3]) +
+           sumarCuadradosEscalar(datos + i, n - i);
+}
+
+__attribute__((target("avx2"))) int buscarAvx2(const float* datos, int n, float valor) {
+    __m256 objetivo = _mm256_set1_ps(valor);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int mascara = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(datos + i), objetivo, _CMP_EQ_OQ));
+        if (mascara != 0) return i + __builtin_ctz(static_cast<unsigned int>(mascara));
+    }
+    int resto = buscarEscalar(datos + i, n - i, valor);
+    return resto < 0 ? -1 : i + resto;
+}
+
+__attribute__((target("avx2"))) int buscarAvx2(const int* datos, int n, int valor) {
+    __m256i objetivo = _mm256_set1_epi32(valor);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i));
+        int mascara = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, objetivo)));
+        if (mascara != 0) return i + __builtin_ctz(static_cast<unsigned int>(mascara));
+    }
+    int resto = buscarEscalar(datos + i, n - i, valor);
+    return resto < 0 ? -1 : i + resto;
+}
+
+__attribute__((target("avx2"))) float extremoAvx2(const float* datos, int n, bool menor) {
+    if (n < 16) return extremoSse2(datos, n, menor);
+    __m256 m = _mm256_loadu_ps(datos);
+    int i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(datos + i);
+        m = menor ? _mm256_min_ps(m, v) : _mm256_max_ps(m, v);
+    }
+    float carriles[8];
+    _mm256_storeu_ps(carriles, m);
+    float extremo = menor ? menorEscalar(carriles, 1, 8, carriles[0])
+                          : mayorEscalar(carriles, 1, 8, carriles[0]);
+    return menor ? menorEscalar(datos, i, n, extremo) : mayorEscalar(datos, i, n, extremo);
+}
+
+__attribute__((target("avx2"))) int extremoAvx2(const int* datos, int n, bool menor) {
+    if (n < 16) return extremoSse2(datos, n, menor);
+    __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos));
+    int i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i));
+        m = menor ? _mm256_min_epi32(m, v) : _mm256_max_epi32(m, v);
+    }
+    int carriles[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(carriles), m);
+    int extremo = menor ? menorEscalar(carriles, 1, 8, carriles[0])
+                        : mayorEscalar(carriles, 1, 8, carriles[0]);
+    return menor ? menorEscalar(datos, i, n, extremo) : mayorEscalar(datos, i, n, extremo);
+}
+
+/**
+ * @brief true si la CPU soporta AVX2 (se consulta una sola vez)
+ */
+bool usarAvx2() {
+    static const bool disponible = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+    return disponible;
+}
+
+#endif // KERNELS_X86
+
+/**
+ * @brief Primera posición de un extremo ya calculado
+ * @details Si el extremo no se encuentra por igualdad (NaN), se recurre al recorrido escalar
+ */
+template <typename T>
+int posicionDe(const T* datos, int n, T extremo, bool menor) {
+    int posicion = KernelsSimd::buscar(datos, n, extremo);
+    if (posicion >= 0) return posicion;
+
+    posicion = 0;
+    for (int i = 1; i < n; i++) {
+        if (menor ? datos[i] < datos[posicion] : datos[posicion] < datos[i]) posicion = i;
+    }
+    return posicion;
+}
+
+}  // namespace
+
+// ======================== Selección de implementación ========================
+
+#ifdef KERNELS_X86
+#define KERNEL_DESPACHAR(nombre, ...) \
+    (usarAvx2() ? nombre##Avx2(__VA_ARGS__) : nombre##Sse2(__VA_ARGS__))
+#endif
+
+double KernelsSimd::sumar(const float* datos, int n) {
+#ifdef KERNELS_X86
+    return KERNEL_DESPACHAR(sumar, datos, n);
+#else
+    return sumarEscalar<float, double>(datos, n);
+#endif
+}
+
+long long KernelsSimd::sumar(const int* datos, int n) {
+#ifdef KERNELS_X86
+    return KERNEL_DESPACHAR(sumar, datos, n);
+#else
+    return sumarEscalar<int, long long>(datos, n);
+#endif
+}
+
+double KernelsSimd::sumarCuadrados(const float* datos, int n) {
+#ifdef KERNELS_X86
+    return KERNEL_DESPACHAR(sumarCuadrados, datos, n);
+#else
+    return sumarCuadradosEscalar(datos, n);
+#endif
+}
+
+double KernelsSimd::sumarCuadrados(const int* datos, int n) {
+#ifdef KERNELS_X86
+    return KERNEL_DESPACHAR(sumarCuadrados, datos, n);
+#else
+    return sumarCuadradosEscalar(datos, n);
+#endif
+}
+
+int KernelsSimd::buscar(const float* datos, int n, float valor) {
+#ifdef KERNELS_X86
+    return KERNEL_DESPACHAR(buscar, datos, n, valor);
+#else
+    return buscarEscalar(datos, n, valor);
+#endif
+}
+
+int KernelsSimd::buscar(const int* datos, int n, int valor) {
+#ifdef KERNELS_X86
+    return KERNEL_DESPACHAR(buscar, datos, n, valor);
+#else
+    return buscarEscalar(datos, n, valor);
+#endif
+}
+
+int KernelsSimd::posicionMinimo(const float* datos, int n) {
+#ifdef KERNELS_X86
+    return posicionDe(datos, n, KERNEL_DESPACHAR(extremo, datos, n, true), true);
+#else
+    return posicionDe(datos, n, menorEscalar(datos, 1, n, datos[0]), true);
+#endif
+}
+
+int KernelsSimd::posicionMinimo(const int* datos, int n) {
+#ifdef KERNELS_X86
+    return posicionDe(datos, n, KERNEL_DESPACHAR(extremo, datos, n, true), true);
+#else
+    return posicionDe(datos, n, menorEscalar(datos, 1, n, datos[0]), true);
+#endif
+}
+
+int KernelsSimd::posicionMaximo(const float* datos, int n) {
+#ifdef KERNELS_X86
+    return posicionDe(datos, n, KERNEL_DESPACHAR(extremo, datos, n, false), false);
+#else
+    return posicionDe(datos, n, mayorEscalar(datos, 1, n, datos[0]), false);
+#endif
+}
+
+int KernelsSimd::posicionMaximo(const int* datos, int n) {
+#ifdef KERNELS_X86
+    return posicionDe(datos, n, KERNEL_DESPACHAR(extremo, datos, n, false), false);
+#else
+    return posicionDe(datos, n, mayorEscalar(datos, 1, n, datos[0]), false);
+#endif
+}
+
+const char* KernelsSimd::implementacion() {
+#ifdef KERNELS_X86
+    return usarAvx2() ? "avx2" : "sse2";
+#else
+    return "escalar";
+#endif
+}
@@ -0,0 +1,281 @@
+/**
+ * @file Metricas.cpp
+ * @brief Agregación de los fragmentos por hilo y exportación en formato Prometheus
+ */
+
+#include "Metricas.h"
+#include "Registro.h"
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Descripción de una métrica para la exportación
+ */
+struct DescripcionMetrica {
+    const char* nombre;
+    const char* ayuda;
+};
+
+/// Contador de llamadas de cada punto instrumentado
+const DescripcionMetrica CONTADORES[NUM_HISTOGRAMAS] = {
+    {"sistema_iot_lecturas_registradas_total", "Lecturas registradas en los sensores"},
+    {"sistema_iot_sensores_procesados_total", "Llamadas a procesarLectura"},
+    {"sistema_iot_busquedas_total", "Llamadas a buscarSensor"},
+    {"sistema_iot_ciclos_procesamiento_total", "Ciclos completos de procesamiento"},
+};
+
+/// Histograma de cada punto instrumentado (periodos de muestreo de METRICA_CRONOMETRAR)
+const DescripcionMetrica HISTOGRAMAS[NUM_HISTOGRAMAS] = {
+    {"sistema_iot_registrar_lectura_segundos", "Latencia de registrarLectura (1 de cada 1024 llamadas)"},
+    {"sistema_iot_procesar_lectura_segundos", "Latencia de procesarLectura (1 de cada 64 llamadas)"},
+    {"sistema_iot_buscar_sensor_segundos", "Latencia de buscarSensor (1 de cada 1024 llamadas)"},
+    {"sistema_iot_ciclo_procesamiento_segundos", "Duración de un ciclo completo de procesamiento"},
+};
+
+const DescripcionMetrica INDICADORES[NUM_INDICADORES] = {
+    {"sistema_iot_sensores", "Sensores registrados"},
+    {"sistema_iot_lecturas_en_memoria", "Lecturas en memoria al terminar el último ciclo"},
+    {"sistema_iot_arena_bytes", "Bytes reservados por las arenas de memoria"},
+};
+
+/// Límites exportados: potencias de dos de 2^6 ns (64 ns) a 2^36 ns (~69 s)
+const int PRIMERA_POTENCIA = 6;
+const int ULTIMA_POTENCIA = 36;
+
+/**
+ * @brief Estado global: lista de fragmentos, indicadores y exportador periódico
+ * @details Su destructor detiene el exportador (última escritura incluida)
+ */
+struct EstadoMetricas {
+    std::mutex cerrojo;                              ///< Protege la lista y el exportador
+    Metricas::Fragmento* fragmentos;                 ///< Fragmentos de todos los hilos
+    std::atomic<long long> indicadores[NUM_INDICADORES];
+    std::condition_variable despertar;               ///< Detiene la espera del exportador
+    std::thread exportador;                          ///< Hilo de exportación periódica
+    std::string ruta;                                ///< Archivo de exportación periódica
+    int intervaloMs;                                 ///< Periodo de exportación
+    bool detener;                                    ///< Solicitud de parada al exportador
+
+    EstadoMetricas() : fragmentos(nullptr), intervaloMs(1000), detener(false) {
+        for (int i = 0; i < NUM_INDICADORES; i++) {
+            indicadores[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ~EstadoMetricas() {
+        Metricas::detenerExportacion();
+        // Los fragmentos no se liberan: hilos aún vivos podrían seguir escribiendo
+    }
+};
+
+EstadoMetricas& estado() {
+    static EstadoMetricas instancia;
+    return instancia;
+}
+
+void escribirCabecera(std::ostream& salida, const DescripcionMetrica& d, const char* tipo) {
+    salida << "# HELP " << d.nombre << " " << d.ayuda << "\n";
+    salida << "# TYPE " << d.nombre << " " << tipo << "\n";
+}
+
+void bucleExportador() {
+    EstadoMetricas& e = estado();
+    std::unique_lock<std::mutex> bloqueo(e.cerrojo);
+    while (!e.detener) {
+        e.despertar.wait_for(bloqueo, std::chrono::milliseconds(e.intervaloMs));
+        std::string ruta = e.ruta;
+        // exportarArchivo toma el cerrojo al sumar los fragmentos
+        bloqueo.unlock();
+        Metricas::exportarArchivo(ruta.c_str());
+        bloqueo.lock();
+    }
+}
+
+}  // namespace
+
+const int Metricas::SUBCUBETAS;
+const int Metricas::NUM_CUBETAS;
+
+bool Metricas::habilitadas() {
+#ifdef SISTEMA_IOT_METRICAS
+    return true;
+#else
+    return false;
+#endif
+}
+
+Metricas::Fragmento* Metricas::crearFragmento() {
+    Fragmento* f = new Fragmento;
+    for (int h = 0; h < NUM_HISTOGRAMAS; h++) {
+        f->llamadas[h].store(0, std::memory_order_relaxed);
+        for (int i = 0; i < NUM_CUBETAS; i++) {
+            f->cubetas[h][i].store(0, std::memory_order_relaxed);
+        }
+        f->sumasNs[h].store(0, std::memory_order_relaxed);
+    }
+
+    EstadoMetricas& e = estado();
+    std::lock_guard<std::mutex> bloqueo(e.cerrojo);
+    f->siguiente = e.fragmentos;
+    e.fragmentos = f;
+    return f;
+}
+
+void Metricas::ajustarIndicador(IndicadorMetrica indicador, long long delta) {
+    estado().indicadores[indicador].fetch_add(delta, std::memory_order_relaxed);
+}
+
+void Metricas::fijarIndicador(IndicadorMetrica indicador, long long valor) {
+    estado().indicadores[indicador].store(valor, std::memory_order_relaxed);
+}
+
+uint64_t Metricas::limiteCubeta(int indice) {
+    if (indice < SUBCUBETAS) return static_cast<uint64_t>(indice);
+    int exponente = indice / SUBCUBETAS + 2;
+    uint64_t subcubeta = static_cast<uint64_t>(indice % SUBCUBETAS);
+    return ((SUBCUBETAS + 1 + subcubeta) << (exponente - 3)) - 1;
+}
+
+uint64_t Metricas::percentil(HistogramaMetrica histograma, double q) {
+    uint64_t cubetas[NUM_CUBETAS] = {};
+    uint64_t total = 0;
+    {
+        EstadoMetricas& e = estado();
+        std::lock_guard<std::mutex> bloqueo(e.cerrojo);
+        for (Fragmento* f = e.fragmentos; f != nullptr; f = f->siguiente) {
+            for (int i = 0; i < NUM_CUBETAS; i++) {
+                uint64_t n = f->cubetas[histograma][i].load(std::memory_order_relaxed);
+                cubetas[i] += n;
+                total += n;
+            }
+        }
+    }
+    if (total == 0) return 0;
+
+    double objetivo = q * static_cast<double>(total);
+    uint64_t acumulado = 0;
+    for (int i = 0; i < NUM_CUBETAS; i++) {
+        acumulado += cubetas[i];
+        if (cubetas[i] > 0 && static_cast<double>(acumulado) >= objetivo) {
+            return limiteCubeta(i);
+        }
+    }
+    return limiteCubeta(NUM_CUBETAS - 1);
+}
+
+uint64_t Metricas::totalLlamadas(HistogramaMetrica histograma) {
+    EstadoMetricas& e = estado();
+    std::lock_guard<std::mutex> bloqueo(e.cerrojo);
+    uint64_t total = 0;
+    for (Fragmento* f = e.fragmentos; f != nullptr; f = f->siguiente) {
+        total += f->llamadas[histograma].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Metricas::exportarPrometheus(std::ostream& salida) {
+    EstadoMetricas& e = estado();
+
+    // Copia de los totales bajo el cerrojo; el formateo va después
+    uint64_t llamadas[NUM_HISTOGRAMAS] = {};
+    uint64_t cubetas[NUM_HISTOGRAMAS][NUM_CUBETAS] = {};
+    uint64_t sumasNs[NUM_HISTOGRAMAS] = {};
+    {
+        std::lock_guard<std::mutex> bloqueo(e.cerrojo);
+        for (Fragmento* f = e.fragmentos; f != nullptr; f = f->siguiente) {
+            for (int h = 0; h < NUM_HISTOGRAMAS; h++) {
+                llamadas[h] += f->llamadas[h].load(std::memory_order_relaxed);
+                for (int i = 0; i < NUM_CUBETAS; i++) {
+                    cubetas[h][i] += f->cubetas[h][i].load(std::memory_order_relaxed);
+                }
+                sumasNs[h] += f->sumasNs[h].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (int h = 0; h < NUM_HISTOGRAMAS; h++) {
+        escribirCabecera(salida, CONTADORES[h], "counter");
+        salida << CONTADORES[h].nombre << " " << llamadas[h] << "\n";
+    }
+
+    char limite[32];
+    for (int h = 0; h < NUM_HISTOGRAMAS; h++) {
+        escribirCabecera(salida, HISTOGRAMAS[h], "histogram");
+        // Las cubetas finas se alinean con las potencias de dos: la cubeta (k - 2) · 8
+        // es la primera con latencias >= 2^k ns
+        uint64_t acumulado = 0;
+        int i = 0;
+        for (int k = PRIMERA_POTENCIA; k <= ULTIMA_POTENCIA; k++) {
+            for (; i < (k - 2) * SUBCUBETAS; i++) {
+                acumulado += cubetas[h][i];
+            }
+            snprintf(limite, sizeof(limite), "%.9g", static_cast<double>(1ULL << k) * 1e-9);
+            salida << HISTOGRAMAS[h].nombre << "_bucket{le=\"" << limite << "\"} " << acumulado << "\n";
+        }
+        for (; i < NUM_CUBETAS; i++) {
+            acumulado += cubetas[h][i];
+        }
+        salida << HISTOGRAMAS[h].nombre << "_bucket{le=\"+Inf\"} " << acumulado << "\n";
+        snprintf(limite, sizeof(limite), "%.9f", static_cast<double>(sumasNs[h]) * 1e-9);
+        salida << HISTOGRAMAS[h].nombre << "_sum " << limite << "\n";
+        salida << HISTOGRAMAS[h].nombre << "_count " << acumulado << "\n";
+    }
+
+    for (int g = 0; g < NUM_INDICADORES; g++) {
+        escribirCabecera(salida, INDICADORES[g], "gauge");
+        salida << INDICADORES[g].nombre << " " << e.indicadores[g].load(std::memory_order_relaxed) << "\n";
+    }
+}
+
+bool Metricas::exportarArchivo(const char* ruta) {
+    std::string temporal = std::string(ruta) + ".tmp";
+    {
+        std::ofstream archivo(temporal.c_str());
+        if (!archivo) {
+            REGISTRO_ERROR("[Error] No se pudo escribir '" << temporal.c_str() << "': " << strerror(errno) << "\n");
+            return false;
+        }
+        exportarPrometheus(archivo);
+        if (!archivo.flush()) {
+            REGISTRO_ERROR("[Error] No se pudo escribir '" << temporal.c_str() << "'.\n");
+            return false;
+        }
+    }
+    // rename es atómico: el lector nunca ve un archivo a medias
+    if (std::rename(temporal.c_str(), ruta) != 0) {
+        REGISTRO_ERROR("[Error] No se pudo reemplazar '" << ruta << "': " << strerror(errno) << "\n");
+        std::remove(temporal.c_str());
+        return false;
+    }
+    return true;
+}
+
+void Metricas::iniciarExportacion(const char* ruta, int intervaloMs) {
+    detenerExportacion();
+    EstadoMetricas& e = estado();
+    std::lock_guard<std::mutex> bloqueo(e.cerrojo);
+    e.ruta = ruta;
+    e.intervaloMs = intervaloMs > 0 ? intervaloMs : 1000;
+    e.detener = false;
+    e.exportador = std::thread(bucleExportador);
+}
+
+void Metricas::detenerExportacion() {
+    EstadoMetricas& e = estado();
+    {
+        std::lock_guard<std::mutex> bloqueo(e.cerrojo);
+        if (!e.exportador.joinable()) return;
+        e.detener = true;
+    }
+    e.despertar.notify_one();
+    e.exportador.join();
+}
@@ -0,0 +1,400 @@
+/**
+ * @file MotorReglas.cpp
+ * @brief Compilación de las reglas de alerta y su evaluación incremental
+ */
+
+#include "MotorReglas.h"
+#include "Registro.h"
+#include <algorithm>
+#include <cerrno>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Regla analizada, antes de agruparla por señal
+ */
+struct ReglaAnalizada {
+    std::string nombre;
+    std::string condicion;
+    TipoReglas tipo;
+    SenalReglas::Tipo senal;
+    int ventana;
+    bool negada;
+    double umbral;
+};
+
+bool leerEntero(const std::string& texto, int& valor) {
+    char* fin = nullptr;
+    errno = 0;
+    long n = strtol(texto.c_str(), &fin, 10);
+    if (texto.empty() || *fin != '\0' || errno != 0 || n < 1 || n > 1000000) return false;
+    valor = static_cast<int>(n);
+    return true;
+}
+
+bool leerReal(const std::string& texto, double& valor) {
+    char* fin = nullptr;
+    errno = 0;
+    valor = strtod(texto.c_str(), &fin);
+    return !texto.empty() && *fin == '\0' && errno == 0 && std::isfinite(valor);
+}
+
+/**
+ * @brief Reduce "señal op límite" a "señal' > umbral"
+ * @details < y <= niegan la señal; >= y <= usan el double inmediatamente inferior al
+ * límite, que equivale a comparar con >= cualquier señal double. Las lecturas de
+ * temperatura son float: el límite se redondea a float para que "45.2" sea el mismo
+ * valor que la lectura 45.2f (en double, 45.2f > 45.2 y 45.3f < 45.3)
+ */
+bool normalizarOperador(const std::string& op, TipoReglas tipo, double limite, bool& negada, double& umbral) {
+    if (tipo == REGLAS_TEMPERATURA && std::fabs(limite) <= FLT_MAX) {
+        limite = static_cast<float>(limite);
+    }
+    if (op == ">") {
+        negada = false;
+        umbral = limite;
+    } else if (op == ">=") {
+        negada = false;
+        umbral = std::nextafter(limite, -HUGE_VAL);
+    } else if (op == "<") {
+        negada = true;
+        umbral = -limite;
+    } else if (op == "<=") {
+        negada = true;
+        umbral = std::nextafter(-limite, -HUGE_VAL);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Analiza una línea "nombre tipo condición"
+ * @return Mensaje de error (nullptr si la línea es válida)
+ */
+const char* analizarRegla(const std::string& linea, ReglaAnalizada& regla) {
+    std::istringstream flujo(linea);
+    std::vector<std::string> t;
+    std::string token;
+    while (flujo >> token) {
+        t.push_back(token);
+    }
+    if (t.size() < 5) return "faltan campos (nombre tipo condición)";
+
+    regla.nombre = t[0];
+    if (t[1] == "temperatura") {
+        regla.tipo = REGLAS_TEMPERATURA;
+    } else if (t[1] == "presion") {
+        regla.tipo = REGLAS_PRESION;
+    } else {
+        return "tipo desconocido (temperatura o presion)";
+    }
+
+    double limite;
+    std::string op;
+    if (t[2] == "valor") {
+        // valor <op> L [durante N]
+        if (t.size() != 5 && t.size() != 7) return "se esperaba 'valor <op> límite [durante N]'";
+        op = t[3];
+        if (!leerReal(t[4], limite)) return "límite inválido";
+        regla.ventana = 1;
+        if (t.size() == 7 && (t[5] != "durante" || !leerEntero(t[6], regla.ventana))) {
+            return "se esperaba 'durante N' con N >= 1";
+        }
+        // N lecturas seguidas por encima del límite: el mínimo de las N está por encima
+        regla.senal = regla.ventana == 1 ? SenalReglas::VALOR : SenalReglas::MINIMO;
+    } else if (t[2] == "promedio") {
+        // promedio N <op> L
+        if (t.size() != 6) return "se esperaba 'promedio N <op> límite'";
+        if (!leerEntero(t[3], regla.ventana)) return "ventana inválida (N >= 1)";
+        op = t[4];
+        if (!leerReal(t[5], limite)) return "límite inválido";
+        regla.senal = regla.ventana == 1 ? SenalReglas::VALOR : SenalReglas::PROMEDIO;
+    } else {
+        return "condición desconocida (valor o promedio)";
+    }
+    if (regla.senal == SenalReglas::VALOR) regla.ventana = 1;
+
+    if (!normalizarOperador(op, regla.tipo, limite, regla.negada, regla.umbral)) {
+        return "operador desconocido (>, >=, <, <=)";
+    }
+
+    regla.condicion = t[2];
+    for (std::size_t i = 3; i < t.size(); i++) {
+        regla.condicion += " " + t[i];
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+ReglasCompiladas::ReglasCompiladas() : senales(nullptr), numSenales(0), capacidad(0) {}
+
+ReglasCompiladas::~ReglasCompiladas() {
+    vaciar();
+}
+
+void ReglasCompiladas::crecer() {
+    int nueva = capacidad == 0 ? 4 : capacidad * 2;
+    SenalReglas* arreglo = new SenalReglas[nueva];
+    for (int i = 0; i < numSenales; i++) {
+        arreglo[i] = senales[i];
+    }
+    delete[] senales;
+    senales = arreglo;
+    capacidad = nueva;
+}
+
+void ReglasCompiladas::agregar(SenalReglas::Tipo tipo, int ventana, bool negada, double umbral, int regla) {
+    int s = 0;
+    while (s < numSenales && !(senales[s].tipo == tipo && senales[s].ventana == ventana &&
+                               senales[s].negada == negada)) {
+        s++;
+    }
+    if (s == numSenales) {
+        if (numSenales == capacidad) crecer();
+        SenalReglas& nueva = senales[numSenales++];
+        nueva.tipo = tipo;
+        nueva.ventana = ventana;
+        nueva.negada = negada;
+        nueva.umbrales = nullptr;
+        nueva.reglas = nullptr;
+        nueva.numUmbrales = 0;
+    }
+
+    // Inserción ordenada: solo al compilar
+    SenalReglas& senal = senales[s];
+    double* umbrales = new double[senal.numUmbrales + 1];
+    int* reglas = new int[senal.numUmbrales + 1];
+    int k = 0;
+    for (; k < senal.numUmbrales && senal.umbrales[k] <= umbral; k++) {
+        umbrales[k] = senal.umbrales[k];
+        reglas[k] = senal.reglas[k];
+    }
+    umbrales[k] = umbral;
+    reglas[k] = regla;
+    for (; k < senal.numUmbrales; k++) {
+        umbrales[k + 1] = senal.umbrales[k];
+        reglas[k + 1] = senal.reglas[k];
+    }
+    delete[] senal.umbrales;
+    delete[] senal.reglas;
+    senal.umbrales = umbrales;
+    senal.reglas = reglas;
+    senal.numUmbrales++;
+}
+
+void ReglasCompiladas::vaciar() {
+    for (int i = 0; i < numSenales; i++) {
+        delete[] senales[i].umbrales;
+        delete[] senales[i].reglas;
+    }
+    delete[] senales;
+    senales = nullptr;
+    numSenales = 0;
+    capacidad = 0;
+}
+
+void ReglasCompiladas::intercambiar(ReglasCompiladas& otro) {
+    std::swap(senales, otro.senales);
+    std::swap(numSenales, otro.numSenales);
+    std::swap(capacidad, otro.capacidad);
+}
+
+EstadoReglas::EstadoReglas(MotorReglas& motor, TipoReglas tipo, const char* sensor)
+    : compiladas(motor.obtenerReglas(tipo)), motor(motor), sensor(sensor), tipo(tipo), ventanas(nullptr),
+      numVentanas(compiladas.obtenerNumSenales()), lecturas(0) {
+    if (numVentanas == 0) return;
+    ventanas = new Ventana[numVentanas];
+    for (int s = 0; s < numVentanas; s++) {
+        const SenalReglas& senal = compiladas.obtenerSenal(s);
+        Ventana& v = ventanas[s];
+        v.valores = senal.tipo == SenalReglas::VALOR ? nullptr : new double[senal.ventana];
+        v.posiciones = senal.tipo == SenalReglas::MINIMO ? new long long[senal.ventana] : nullptr;
+        v.inicio = 0;
+        v.cantidad = 0;
+        v.suma = 0.0;
+        v.hastaRecalculo = senal.ventana;
+        v.cumplidas = 0;
+    }
+}
+
+EstadoReglas::~EstadoReglas() {
+    for (int s = 0; s < numVentanas; s++) {
+        delete[] ventanas[s].valores;
+        delete[] ventanas[s].posiciones;
+    }
+    delete[] ventanas;
+}
+
+bool EstadoReglas::actualizar(const SenalReglas& senal, Ventana& v, double x, double& valor) {
+    int n = senal.ventana;
+    switch (senal.tipo) {
+    case SenalReglas::VALOR:
+        valor = x;
+        return true;
+
+    case SenalReglas::MINIMO: {
+        // Cola monótona creciente: el frente es el mínimo de la ventana
+        if (v.cantidad > 0 && v.posiciones[v.inicio] <= lecturas - n) {
+            v.inicio = v.inicio + 1 == n ? 0 : v.inicio + 1;
+            v.cantidad--;
+        }
+        while (v.cantidad > 0) {
+            int ultimo = (v.inicio + v.cantidad - 1) % n;
+            if (v.valores[ultimo] < x) break;
+            v.cantidad--;
+        }
+        int nuevo = (v.inicio + v.cantidad) % n;
+        v.valores[nuevo] = x;
+        v.posiciones[nuevo] = lecturas;
+        v.cantidad++;
+        valor = v.valores[v.inicio];
+        return lecturas + 1 >= n;
+    }
+
+    case SenalReglas::PROMEDIO:
+        if (v.cantidad < n) {
+            v.valores[v.cantidad++] = x;
+            v.suma += x;
+        } else {
+            v.suma += x - v.valores[v.inicio];
+            v.valores[v.inicio] = x;
+            v.inicio = v.inicio + 1 == n ? 0 : v.inicio + 1;
+            // La suma deslizante acumula error de redondeo: se rehace cada N lecturas
+            if (--v.hastaRecalculo == 0) {
+                double suma = 0.0;
+                for (int i = 0; i < n; i++) {
+                    suma += v.valores[i];
+                }
+                v.suma = suma;
+                v.hastaRecalculo = n;
+            }
+        }
+        valor = v.suma / n;
+        return v.cantidad == n;
+    }
+    return false;
+}
+
+void EstadoReglas::evaluar(double lectura) {
+    for (int s = 0; s < numVentanas; s++) {
+        const SenalReglas& senal = compiladas.obtenerSenal(s);
+        Ventana& v = ventanas[s];
+
+        double valor = 0.0;
+        int cumplidas = 0;
+        if (actualizar(senal, v, senal.negada ? -lectura : lectura, valor)) {
+            // El promedio de lecturas float se compara como float, igual que los límites
+            if (tipo == REGLAS_TEMPERATURA && senal.tipo == SenalReglas::PROMEDIO) {
+                valor = static_cast<float>(valor);
+            }
+            // Umbrales estrictamente menores que la señal: las reglas que se cumplen
+            cumplidas = static_cast<int>(std::lower_bound(senal.umbrales, senal.umbrales + senal.numUmbrales, valor) -
+                                         senal.umbrales);
+        }
+        if (cumplidas == v.cumplidas) continue;
+
+        EventoAlerta evento;
+        strncpy(evento.sensor, sensor, sizeof(evento.sensor) - 1);
+        evento.sensor[sizeof(evento.sensor) - 1] = '\0';
+        evento.valor = senal.negada ? -valor : valor;
+        evento.activa = cumplidas > v.cumplidas;
+        int desde = evento.activa ? v.cumplidas : cumplidas;
+        int hasta = evento.activa ? cumplidas : v.cumplidas;
+        for (int k = desde; k < hasta; k++) {
+            evento.regla = senal.reglas[k];
+            motor.publicar(evento);
+        }
+        v.cumplidas = cumplidas;
+    }
+    lecturas++;
+}
+
+MotorReglas::MotorReglas(std::size_t capacidadAlertas)
+    : nombres(nullptr), condiciones(nullptr), numReglas(0), alertas(capacidadAlertas), perdidas(0) {}
+
+MotorReglas::~MotorReglas() {
+    delete[] nombres;
+    delete[] condiciones;
+}
+
+bool MotorReglas::cargar(const char* archivo) {
+    std::ifstream entrada(archivo);
+    if (!entrada) {
+        REGISTRO_ERROR("[Error] No se pudo abrir '" << archivo << "': " << strerror(errno) << "\n");
+        return false;
+    }
+    std::ostringstream texto;
+    texto << entrada.rdbuf();
+    return compilar(texto.str().c_str(), archivo);
+}
+
+bool MotorReglas::compilar(const char* texto, const char* origen) {
+    std::string nombreOrigen(origen);
+    std::vector<ReglaAnalizada> reglas;
+    std::istringstream flujo(texto);
+    std::string linea;
+    int numero = 0;
+    bool valido = true;
+    while (std::getline(flujo, linea)) {
+        numero++;
+        std::size_t comentario = linea.find('#');
+        if (comentario != std::string::npos) linea.erase(comentario);
+        if (linea.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        ReglaAnalizada regla;
+        const char* error = analizarRegla(linea, regla);
+        for (std::size_t i = 0; error == nullptr && i < reglas.size(); i++) {
+            if (reglas[i].nombre == regla.nombre) error = "nombre de regla repetido";
+        }
+        if (error != nullptr) {
+            REGISTRO_ERROR("[Error] " << nombreOrigen << ":" << numero << ": " << error << "\n");
+            valido = false;
+            continue;
+        }
+        reglas.push_back(regla);
+    }
+    if (!valido) return false;
+
+    // Se compila aparte y se intercambia: un archivo inválido deja las reglas anteriores
+    ReglasCompiladas nuevas[NUM_TIPOS_REGLAS];
+    std::string* nuevosNombres = new std::string[reglas.size()];
+    std::string* nuevasCondiciones = new std::string[reglas.size()];
+    for (std::size_t i = 0; i < reglas.size(); i++) {
+        const ReglaAnalizada& r = reglas[i];
+        nuevas[r.tipo].agregar(r.senal, r.ventana, r.negada, r.umbral, static_cast<int>(i));
+        nuevosNombres[i] = r.nombre;
+        nuevasCondiciones[i] = r.condicion;
+    }
+    for (int t = 0; t < NUM_TIPOS_REGLAS; t++) {
+        compiladas[t].intercambiar(nuevas[t]);
+    }
+    delete[] nombres;
+    delete[] condiciones;
+    nombres = nuevosNombres;
+    condiciones = nuevasCondiciones;
+    numReglas = static_cast<int>(reglas.size());
+
+    REGISTRO_INFO("[Reglas] " << numReglas << " regla(s) compiladas de '" << nombreOrigen << "' ("
+                  << compiladas[REGLAS_TEMPERATURA].obtenerNumSenales() << " señal(es) de temperatura, "
+                  << compiladas[REGLAS_PRESION].obtenerNumSenales() << " de presión).\n");
+    return true;
+}
+
+void MotorReglas::publicar(const EventoAlerta& evento) {
+    if (!alertas.encolar(evento)) {
+        perdidas.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int MotorReglas::drenarAlertas(EventoAlerta* destino, int maximo) {
+    return alertas.drenar(destino, maximo);
+}
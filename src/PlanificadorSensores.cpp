@@ -0,0 +1,187 @@
+/**
+ * @file PlanificadorSensores.cpp
+ * @brief Implementación de la rueda temporal jerárquica de procesamiento
+ */
+
+#include "PlanificadorSensores.h"
+#include "SensorBase.h"
+#include <cstring>
+#include <ostream>
+
+const int PlanificadorSensores::BITS_RANURA;
+const int PlanificadorSensores::RANURAS;
+const int PlanificadorSensores::NIVELES;
+const uint64_t PlanificadorSensores::MASCARA_RANURA;
+
+namespace {
+
+int cerosDerecha(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1u)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+}  // namespace
+
+PlanificadorSensores::PlanificadorSensores(uint64_t inicio) : actual(inicio), cantidad(0) {
+    memset(cabezas, 0, sizeof(cabezas));
+    memset(colas, 0, sizeof(colas));
+    memset(ocupadas, 0, sizeof(ocupadas));
+}
+
+TareaPlanificada* PlanificadorSensores::programar(SensorBase* sensor, unsigned periodo, unsigned primero) {
+    TareaPlanificada* tarea = tareas.crear(sensor);
+    tarea->periodo = periodo > 0 ? periodo : 1;
+    tarea->vencimiento = actual + (primero > 0 ? primero : tarea->periodo);
+    insertar(tarea);
+    cantidad++;
+    return tarea;
+}
+
+void PlanificadorSensores::cancelar(TareaPlanificada* tarea) {
+    desenlazar(tarea);
+    tareas.destruir(tarea);
+    cantidad--;
+}
+
+void PlanificadorSensores::reprogramar(TareaPlanificada* tarea, unsigned periodo) {
+    desenlazar(tarea);
+    tarea->periodo = periodo > 0 ? periodo : 1;
+    tarea->vencimiento = actual + tarea->periodo;
+    insertar(tarea);
+}
+
+void PlanificadorSensores::insertar(TareaPlanificada* tarea) {
+    // Nivel más bajo en el que el vencimiento y el tick actual comparten los bits superiores;
+    // más allá del horizonte, la última rueda la vuelve a colocar en cada vuelta
+    uint64_t diferencia = tarea->vencimiento ^ actual;
+    int nivel = 0;
+    while (nivel < NIVELES - 1 && (diferencia >> (BITS_RANURA * (nivel + 1))) != 0) {
+        nivel++;
+    }
+    int ranura = static_cast<int>((tarea->vencimiento >> (BITS_RANURA * nivel)) & MASCARA_RANURA);
+
+    tarea->nivel = nivel;
+    tarea->ranura = ranura;
+    tarea->siguiente = nullptr;
+    tarea->anterior = colas[nivel][ranura];
+    if (tarea->anterior != nullptr) {
+        tarea->anterior->siguiente = tarea;
+    } else {
+        cabezas[nivel][ranura] = tarea;
+        ocupadas[nivel] |= static_cast<uint64_t>(1) << ranura;
+    }
+    colas[nivel][ranura] = tarea;
+}
+
+void PlanificadorSensores::desenlazar(TareaPlanificada* tarea) {
+    int nivel = tarea->nivel;
+    int ranura = tarea->ranura;
+    if (tarea->anterior != nullptr) {
+        tarea->anterior->siguiente = tarea->siguiente;
+    } else {
+        cabezas[nivel][ranura] = tarea->siguiente;
+    }
+    if (tarea->siguiente != nullptr) {
+        tarea->siguiente->anterior = tarea->anterior;
+    } else {
+        colas[nivel][ranura] = tarea->anterior;
+    }
+    if (cabezas[nivel][ranura] == nullptr) {
+        ocupadas[nivel] &= ~(static_cast<uint64_t>(1) << ranura);
+    }
+    tarea->nivel = -1;
+}
+
+TareaPlanificada* PlanificadorSensores::vaciarRanura(int nivel, int ranura) {
+    TareaPlanificada* lista = cabezas[nivel][ranura];
+    cabezas[nivel][ranura] = nullptr;
+    colas[nivel][ranura] = nullptr;
+    ocupadas[nivel] &= ~(static_cast<uint64_t>(1) << ranura);
+    return lista;
+}
+
+void PlanificadorSensores::cascada() {
+    // El tick actual abre una ranura en el nivel 1 y, si además completa vueltas, en los siguientes
+    int alto = 1;
+    while (alto < NIVELES - 1 && ((actual >> (BITS_RANURA * alto)) & MASCARA_RANURA) == 0) {
+        alto++;
+    }
+    for (int nivel = alto; nivel >= 1; nivel--) {
+        int ranura = static_cast<int>((actual >> (BITS_RANURA * nivel)) & MASCARA_RANURA);
+        if ((ocupadas[nivel] & (static_cast<uint64_t>(1) << ranura)) == 0) continue;
+        TareaPlanificada* tarea = vaciarRanura(nivel, ranura);
+        while (tarea != nullptr) {
+            TareaPlanificada* siguiente = tarea->siguiente;
+            insertar(tarea);
+            tarea = siguiente;
+        }
+    }
+}
+
+int PlanificadorSensores::disparar(std::ostream& salida) {
+    int ranura = static_cast<int>(actual & MASCARA_RANURA);
+    if ((ocupadas[0] & (static_cast<uint64_t>(1) << ranura)) == 0) return 0;
+
+    // La lista se extrae antes de procesar: las tareas vuelven a otra ranura (periodo >= 1)
+    int procesados = 0;
+    TareaPlanificada* tarea = vaciarRanura(0, ranura);
+    while (tarea != nullptr) {
+        TareaPlanificada* siguiente = tarea->siguiente;
+        tarea->sensor->procesarLectura(salida);
+        tarea->vencimiento += tarea->periodo;
+        insertar(tarea);
+        procesados++;
+        tarea = siguiente;
+    }
+    return procesados;
+}
+
+int PlanificadorSensores::avanzarHasta(uint64_t destino, std::ostream& salida) {
+    int procesados = 0;
+    while (actual < destino) {
+        int posicion = static_cast<int>(actual & MASCARA_RANURA);
+        if (posicion == RANURAS - 1) {
+            // Vuelta completa del nivel 0: bajar lo que vence en la siguiente
+            actual++;
+            cascada();
+            procesados += disparar(salida);
+            continue;
+        }
+
+        // Siguiente ranura ocupada del nivel 0 antes del final de la vuelta o del destino
+        uint64_t limite = actual | MASCARA_RANURA;
+        if (limite > destino) limite = destino;
+        int hasta = static_cast<int>(limite & MASCARA_RANURA);
+        uint64_t pendientes = ocupadas[0] & (~static_cast<uint64_t>(0) << (posicion + 1));
+        if (hasta < RANURAS - 1) {
+            pendientes &= (static_cast<uint64_t>(2) << hasta) - 1;
+        }
+        if (pendientes == 0) {
+            actual = limite;
+            continue;
+        }
+        actual = (actual & ~MASCARA_RANURA) | static_cast<uint64_t>(cerosDerecha(pendientes));
+        procesados += disparar(salida);
+    }
+    return procesados;
+}
+
+int PlanificadorSensores::avanzar(uint64_t ticks, std::ostream& salida) {
+    return avanzarHasta(actual + ticks, salida);
+}
+
+uint64_t PlanificadorSensores::obtenerTick() const {
+    return actual;
+}
+
+int PlanificadorSensores::obtenerCantidad() const {
+    return cantidad;
+}
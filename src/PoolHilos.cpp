@@ -0,0 +1,121 @@
+/**
+ * @file PoolHilos.cpp
+ * @brief Implementación del pool de hilos con robo de trabajo
+ */
+
+#include "PoolHilos.h"
+
+PoolHilos::PoolHilos(int hilos) : numHilos(0), generacion(0), detener(false), restantes(0) {
+    if (hilos <= 0) {
+        hilos = static_cast<int>(std::thread::hardware_concurrency());
+        if (hilos <= 0) hilos = 1;
+    }
+
+    numHilos = hilos;
+    for (int i = 0; i < hilos; i++) {
+        colas.push_back(new ColaTrabajo());
+    }
+    for (int i = 0; i < hilos; i++) {
+        trabajadores.push_back(std::thread(&PoolHilos::trabajar, this, i));
+    }
+}
+
+PoolHilos::~PoolHilos() {
+    {
+        std::lock_guard<std::mutex> bloqueo(cerrojoEspera);
+        detener = true;
+    }
+    hayTrabajo.notify_all();
+    for (std::size_t i = 0; i < trabajadores.size(); i++) {
+        trabajadores[i].join();
+    }
+    for (std::size_t i = 0; i < colas.size(); i++) {
+        delete colas[i];
+    }
+}
+
+int PoolHilos::obtenerHilos() const {
+    return numHilos;
+}
+
+void PoolHilos::paraCada(int n, const std::function<void(int)>& tarea, int grano) {
+    if (n <= 0) return;
+    std::lock_guard<std::mutex> llamada(cerrojoLlamada);
+
+    int hilos = obtenerHilos();
+    if (grano <= 0) {
+        // Unos 8 rangos por hilo: suficiente margen para equilibrar robando
+        grano = n / (hilos * 8);
+        if (grano < 1) grano = 1;
+    }
+
+    int numRangos = (n + grano - 1) / grano;
+    restantes.store(numRangos, std::memory_order_relaxed);
+
+    // Reparto inicial por bloques consecutivos: cada hilo empieza con índices contiguos
+    int porHilo = (numRangos + hilos - 1) / hilos;
+    for (int r = 0; r < numRangos; r++) {
+        Rango rango;
+        rango.inicio = r * grano;
+        rango.fin = rango.inicio + grano < n ? rango.inicio + grano : n;
+        rango.tarea = &tarea;
+
+        ColaTrabajo* cola = colas[r / porHilo];
+        std::lock_guard<std::mutex> bloqueo(cola->cerrojo);
+        cola->rangos.push_back(rango);
+    }
+
+    std::unique_lock<std::mutex> bloqueo(cerrojoEspera);
+    generacion++;
+    hayTrabajo.notify_all();
+    terminado.wait(bloqueo, [this] { return restantes.load(std::memory_order_acquire) == 0; });
+}
+
+void PoolHilos::trabajar(int id) {
+    unsigned long vista = 0;
+
+    while (true) {
+        Rango rango;
+        if (tomar(id, rango)) {
+            for (int i = rango.inicio; i < rango.fin; i++) {
+                (*rango.tarea)(i);
+            }
+            if (restantes.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> bloqueo(cerrojoEspera);
+                terminado.notify_one();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> bloqueo(cerrojoEspera);
+        hayTrabajo.wait(bloqueo, [this, vista] { return detener || generacion != vista; });
+        if (detener) return;
+        vista = generacion;
+    }
+}
+
+bool PoolHilos::tomar(int id, Rango& rango) {
+    // Cola propia: el rango añadido más recientemente (el más caliente en caché)
+    {
+        ColaTrabajo* propia = colas[id];
+        std::lock_guard<std::mutex> bloqueo(propia->cerrojo);
+        if (!propia->rangos.empty()) {
+            rango = propia->rangos.back();
+            propia->rangos.pop_back();
+            return true;
+        }
+    }
+
+    // Robo: el rango más antiguo de la siguiente cola con trabajo
+    int hilos = obtenerHilos();
+    for (int k = 1; k < hilos; k++) {
+        ColaTrabajo* victima = colas[(id + k) % hilos];
+        std::lock_guard<std::mutex> bloqueo(victima->cerrojo);
+        if (!victima->rangos.empty()) {
+            rango = victima->rangos.front();
+            victima->rangos.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file ProtocoloBinario.cpp
+ * @brief Codificación y análisis de las tramas binarias del simulador ESP32
+ */
+
+#include "ProtocoloBinario.h"
+#include "SumaVerificacion.h"
+
+namespace {
+
+inline unsigned leerU16(const uint8_t* p) {
+    return static_cast<unsigned>(p[0]) | (static_cast<unsigned>(p[1]) << 8);
+}
+
+inline uint32_t leerU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void escribirU16(uint8_t* p, unsigned v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+}  // namespace
+
+ResultadoTrama analizarTrama(const uint8_t* datos, std::size_t longitud, TramaBinaria& trama, std::size_t& bytes) {
+    // Cada campo de la cabecera se valida en cuanto llega: el ruido se descarta pronto
+    if (longitud < 1) return TRAMA_INCOMPLETA;
+    if (datos[0] != SINCRONIA_TRAMA_0) return TRAMA_INVALIDA;
+    if (longitud < 2) return TRAMA_INCOMPLETA;
+    if (datos[1] != SINCRONIA_TRAMA_1) return TRAMA_INVALIDA;
+    if (longitud < 3) return TRAMA_INCOMPLETA;
+    if (datos[2] != VERSION_TRAMA) return TRAMA_INVALIDA;
+    if (longitud < 4) return TRAMA_INCOMPLETA;
+    if (datos[3] > 1) return TRAMA_INVALIDA;
+    if (longitud < CABECERA_TRAMA) return TRAMA_INCOMPLETA;
+    int n = datos[6];
+    if (n < 1 || n > MAX_VALORES_TRAMA) return TRAMA_INVALIDA;
+
+    std::size_t carga = CABECERA_TRAMA + 2 * static_cast<std::size_t>(n);
+    if (longitud < carga + 4) return TRAMA_INCOMPLETA;
+    if (calcularCrc32c(datos + 2, carga - 2) != leerU32(datos + carga)) return TRAMA_INVALIDA;
+
+    trama.tipo = datos[3] == 0 ? LECTURA_TEMPERATURA : LECTURA_PRESION;
+    trama.id = leerU16(datos + 4);
+    trama.cantidad = n;
+    for (int i = 0; i < n; i++) {
+        trama.valores[i] = static_cast<int16_t>(leerU16(datos + CABECERA_TRAMA + 2 * i));
+    }
+    bytes = carga + 4;
+    return TRAMA_VALIDA;
+}
+
+std::size_t codificarTrama(TipoLectura tipo, unsigned id, const int16_t* valores, int n, uint8_t* destino) {
+    if (n < 1 || n > MAX_VALORES_TRAMA || id > 0xFFFF) return 0;
+
+    destino[0] = SINCRONIA_TRAMA_0;
+    destino[1] = SINCRONIA_TRAMA_1;
+    destino[2] = VERSION_TRAMA;
+    destino[3] = tipo == LECTURA_TEMPERATURA ? 0 : 1;
+    escribirU16(destino + 4, id);
+    destino[6] = static_cast<uint8_t>(n);
+    for (int i = 0; i < n; i++) {
+        escribirU16(destino + CABECERA_TRAMA + 2 * i, static_cast<uint16_t>(valores[i]));
+    }
+
+    std::size_t carga = CABECERA_TRAMA + 2 * static_cast<std::size_t>(n);
+    uint32_t crc = calcularCrc32c(destino + 2, carga - 2);
+    escribirU16(destino + carga, crc & 0xFFFFu);
+    escribirU16(destino + carga + 2, crc >> 16);
+    return carga + 4;
+}
+
+int formatearIdSensor(TipoLectura tipo, unsigned id, char* destino) {
+    char digitos[5];
+    int n = 0;
+    do {
+        digitos[n++] = static_cast<char>('0' + id % 10);
+        id /= 10;
+    } while (id > 0 && n < 5);
+    // Al menos tres dígitos, como los nombres del simulador
+    while (n < 3) {
+        digitos[n++] = '0';
+    }
+
+    int longitud = 0;
+    destino[longitud++] = tipo == LECTURA_TEMPERATURA ? 'T' : 'P';
+    destino[longitud++] = '-';
+    while (n > 0) {
+        destino[longitud++] = digitos[--n];
+    }
+    destino[longitud] = '\0';
+    return longitud;
+}
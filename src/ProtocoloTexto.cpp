@@ -0,0 +1,115 @@
+/**
+ * @file ProtocoloTexto.cpp
+ * @brief Implementación del parser del protocolo "TIPO|ID|VALOR"
+ */
+
+#include "ProtocoloTexto.h"
+
+namespace {
+
+const int MAX_LONGITUD_ID = 49;  ///< Igual que SensorBase::nombre (50 con el '\0')
+
+const double POTENCIAS_10[] = {
+    1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+
+inline bool esDigito(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/// Caracteres admitidos en un identificador: [A-Za-z0-9_-]
+inline bool caracterIdValido(char c) {
+    return esDigito(c) || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_' || c == '-';
+}
+
+/**
+ * @brief Convierte [p, fin) a entero con signo opcional
+ * @return false si hay caracteres no numéricos o no hay dígitos
+ */
+bool analizarEntero(const char* p, const char* fin, int& valor) {
+    bool negativo = false;
+    if (p < fin && (*p == '-' || *p == '+')) {
+        negativo = *p == '-';
+        p++;
+    }
+    if (p == fin || fin - p > 9) return false;
+
+    int resultado = 0;
+    for (; p < fin; p++) {
+        if (!esDigito(*p)) return false;
+        resultado = resultado * 10 + (*p - '0');
+    }
+    valor = negativo ? -resultado : resultado;
+    return true;
+}
+
+/**
+ * @brief Convierte [p, fin) en notación decimal simple ("45.30", "-3", "7.")
+ * @return false si el formato no es válido o excede 9 dígitos significativos
+ */
+bool analizarDecimal(const char* p, const char* fin, float& valor) {
+    bool negativo = false;
+    if (p < fin && (*p == '-' || *p == '+')) {
+        negativo = *p == '-';
+        p++;
+    }
+
+    long long mantisa = 0;
+    int digitos = 0;
+    int decimales = 0;
+    bool punto = false;
+    for (; p < fin; p++) {
+        if (esDigito(*p)) {
+            if (++digitos > 9) return false;
+            mantisa = mantisa * 10 + (*p - '0');
+            if (punto) decimales++;
+        } else if (*p == '.' && !punto) {
+            punto = true;
+        } else {
+            return false;
+        }
+    }
+    if (digitos == 0) return false;
+
+    double resultado = static_cast<double>(mantisa) / POTENCIAS_10[decimales];
+    valor = static_cast<float>(negativo ? -resultado : resultado);
+    return true;
+}
+
+}  // namespace
+
+ResultadoLinea analizarLinea(const char* inicio, const char* fin, LecturaTexto& lectura) {
+    if (fin > inicio && fin[-1] == '\r') fin--;
+
+    // Prefijo "TEMP|" o "PRES|"
+    if (fin - inicio < 5 || inicio[4] != '|') return LINEA_IGNORADA;
+    if (inicio[0] == 'T' && inicio[1] == 'E' && inicio[2] == 'M' && inicio[3] == 'P') {
+        lectura.tipo = LECTURA_TEMPERATURA;
+    } else if (inicio[0] == 'P' && inicio[1] == 'R' && inicio[2] == 'E' && inicio[3] == 'S') {
+        lectura.tipo = LECTURA_PRESION;
+    } else {
+        return LINEA_IGNORADA;
+    }
+
+    // Identificador hasta el segundo '|', solo [A-Za-z0-9_-]: el nombre acaba en rutas
+    // de archivo (segmentos) y un '\0' lo truncaría al registrarlo
+    const char* id = inicio + 5;
+    const char* p = id;
+    while (p < fin && *p != '|') {
+        if (!caracterIdValido(*p)) return LINEA_INVALIDA;
+        p++;
+    }
+    int longitudId = static_cast<int>(p - id);
+    if (p == fin || longitudId == 0 || longitudId > MAX_LONGITUD_ID) return LINEA_INVALIDA;
+
+    lectura.id = id;
+    lectura.longitudId = longitudId;
+
+    const char* valor = p + 1;
+    if (lectura.tipo == LECTURA_TEMPERATURA) {
+        lectura.valorInt = 0;
+        return analizarDecimal(valor, fin, lectura.valorFloat) ? LINEA_LECTURA : LINEA_INVALIDA;
+    }
+    lectura.valorFloat = 0.0f;
+    return analizarEntero(valor, fin, lectura.valorInt) ? LINEA_LECTURA : LINEA_INVALIDA;
+}
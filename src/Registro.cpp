@@ -0,0 +1,187 @@
+/**
+ * @file Registro.cpp
+ * @brief Implementación del subsistema de registro y su destino asíncrono
+ */
+
+#include "Registro.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const std::size_t CAPACIDAD_MINIMA = 4096;  ///< Búfer asíncrono mínimo (muy por encima de un mensaje)
+
+/**
+ * @brief Estado compartido del destino de registro
+ * @details Su destructor (al terminar el programa) vuelca y detiene el hilo escritor
+ */
+struct EstadoRegistro {
+    std::atomic<int> nivel;          ///< Nivel mínimo en tiempo de ejecución
+    std::atomic<bool> asincrono;     ///< true si hay hilo escritor activo
+    std::mutex cerrojo;              ///< Protege búferes y banderas
+    std::condition_variable hayDatos;    ///< Despierta al escritor
+    std::condition_variable hayEspacio;  ///< Despierta a productores bloqueados
+    char* activo;                    ///< Búfer en el que escriben los productores
+    char* respaldo;                  ///< Búfer que vuelca el escritor
+    std::size_t usado;               ///< Bytes ocupados en activo
+    std::size_t capacidad;           ///< Capacidad de cada búfer
+    bool detener;                    ///< Solicitud de parada al escritor
+    std::thread escritor;            ///< Hilo que vuelca los búferes
+
+    EstadoRegistro()
+        : nivel(NIVEL_LOG_TRAZA), asincrono(false), activo(nullptr), respaldo(nullptr),
+          usado(0), capacidad(0), detener(false) {}
+
+    ~EstadoRegistro() {
+        Registro::detenerAsincrono();
+    }
+};
+
+EstadoRegistro& estado() {
+    static EstadoRegistro instancia;
+    return instancia;
+}
+
+void bucleEscritor() {
+    EstadoRegistro& e = estado();
+    std::unique_lock<std::mutex> bloqueo(e.cerrojo);
+
+    while (true) {
+        e.hayDatos.wait_for(bloqueo, std::chrono::milliseconds(50),
+                            [&e] { return e.detener || e.usado >= e.capacidad / 2; });
+
+        if (e.usado > 0) {
+            // Intercambiar búferes y volcar sin retener el cerrojo
+            char* lleno = e.activo;
+            std::size_t bytes = e.usado;
+            e.activo = e.respaldo;
+            e.respaldo = lleno;
+            e.usado = 0;
+            e.hayEspacio.notify_all();
+
+            bloqueo.unlock();
+            std::fwrite(lleno, 1, bytes, stdout);
+            std::fflush(stdout);
+            bloqueo.lock();
+        }
+
+        if (e.detener && e.usado == 0) break;
+    }
+}
+
+}  // namespace
+
+void Registro::fijarNivel(int nivel) {
+    estado().nivel.store(nivel, std::memory_order_relaxed);
+}
+
+bool Registro::habilitado(int nivel) {
+    return nivel >= estado().nivel.load(std::memory_order_relaxed);
+}
+
+void Registro::iniciarAsincrono(std::size_t capacidad) {
+    EstadoRegistro& e = estado();
+    if (e.asincrono.load()) return;
+
+    std::cout.flush();
+    e.capacidad = capacidad < CAPACIDAD_MINIMA ? CAPACIDAD_MINIMA : capacidad;
+    e.activo = new char[e.capacidad];
+    e.respaldo = new char[e.capacidad];
+    e.usado = 0;
+    e.detener = false;
+    e.escritor = std::thread(bucleEscritor);
+    e.asincrono.store(true);
+}
+
+void Registro::detenerAsincrono() {
+    EstadoRegistro& e = estado();
+    if (!e.asincrono.load()) return;
+
+    {
+        std::lock_guard<std::mutex> bloqueo(e.cerrojo);
+        e.detener = true;
+    }
+    e.hayDatos.notify_one();
+    e.escritor.join();
+    e.asincrono.store(false);
+
+    std::lock_guard<std::mutex> bloqueo(e.cerrojo);
+    delete[] e.activo;
+    delete[] e.respaldo;
+    e.activo = nullptr;
+    e.respaldo = nullptr;
+}
+
+void Registro::escribir(const char* texto, std::size_t longitud) {
+    EstadoRegistro& e = estado();
+
+    if (!e.asincrono.load(std::memory_order_acquire)) {
+        std::cout.write(texto, static_cast<std::streamsize>(longitud));
+        return;
+    }
+
+    std::unique_lock<std::mutex> bloqueo(e.cerrojo);
+    if (e.activo == nullptr) {
+        // El destino asíncrono se detuvo mientras esperábamos el cerrojo
+        bloqueo.unlock();
+        std::cout.write(texto, static_cast<std::streamsize>(longitud));
+        return;
+    }
+    if (e.usado + longitud > e.capacidad) {
+        // Contrapresión: esperar a que el escritor libere el búfer
+        e.hayDatos.notify_one();
+        e.hayEspacio.wait(bloqueo, [&e, longitud] { return e.usado + longitud <= e.capacidad; });
+    }
+    std::memcpy(e.activo + e.usado, texto, longitud);
+    e.usado += longitud;
+    if (e.usado >= e.capacidad / 2) {
+        e.hayDatos.notify_one();
+    }
+}
+
+// ======================== Registro::Linea ========================
+
+Registro::Linea& Registro::Linea::operator<<(const char* valor) {
+    while (*valor != '\0' && longitud < CAPACIDAD) {
+        texto[longitud++] = *valor++;
+    }
+    return *this;
+}
+
+Registro::Linea& Registro::Linea::operator<<(char valor) {
+    if (longitud < CAPACIDAD) {
+        texto[longitud++] = valor;
+    }
+    return *this;
+}
+
+/**
+ * @brief Añade texto formateado con snprintf, truncando si no cabe
+ */
+#define LINEA_FORMATEAR(formato, valor)                                          \
+    do {                                                                         \
+        std::size_t disponible = CAPACIDAD - longitud;                           \
+        if (disponible == 0) return *this;                                       \
+        int escritos = std::snprintf(texto + longitud, disponible, formato, valor); \
+        if (escritos > 0) {                                                      \
+            std::size_t bytes = static_cast<std::size_t>(escritos);              \
+            longitud += bytes < disponible ? bytes : disponible - 1;             \
+        }                                                                        \
+        return *this;                                                            \
+    } while (0)
+
+Registro::Linea& Registro::Linea::operator<<(int valor) { LINEA_FORMATEAR("%d", valor); }
+Registro::Linea& Registro::Linea::operator<<(long valor) { LINEA_FORMATEAR("%ld", valor); }
+Registro::Linea& Registro::Linea::operator<<(long long valor) { LINEA_FORMATEAR("%lld", valor); }
+Registro::Linea& Registro::Linea::operator<<(unsigned int valor) { LINEA_FORMATEAR("%u", valor); }
+Registro::Linea& Registro::Linea::operator<<(unsigned long valor) { LINEA_FORMATEAR("%lu", valor); }
+Registro::Linea& Registro::Linea::operator<<(unsigned long long valor) { LINEA_FORMATEAR("%llu", valor); }
+Registro::Linea& Registro::Linea::operator<<(float valor) { LINEA_FORMATEAR("%g", static_cast<double>(valor)); }
+Registro::Linea& Registro::Linea::operator<<(double valor) { LINEA_FORMATEAR("%g", valor); }
+
+#undef LINEA_FORMATEAR
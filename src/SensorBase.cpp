@@ -6,18 +6,32 @@
 #include "SensorBase.h"
 #include <cstring>
 #include <iostream>
+#include "Registro.h"
 
 SensorBase::SensorBase(const char* id) {
     // Copiar el nombre de forma segura
     strncpy(nombre, id, 49);
     nombre[49] = '\0';  // Asegurar terminación
-    std::cout << "[Log] SensorBase '" << nombre << "' construido.\n";
+    REGISTRO_DEPURACION("[Log] SensorBase '" << nombre << "' construido.\n");
 }
 
 SensorBase::~SensorBase() {
-    std::cout << "[Destructor SensorBase] Sensor '" << nombre << "' destruido.\n";
+    REGISTRO_DEPURACION("[Destructor SensorBase] Sensor '" << nombre << "' destruido.\n");
+}
+
+void SensorBase::procesarLectura(std::ostream&) {
+    // Redirigir std::cout a salida cambiaría el flujo de todos los hilos a la vez
+    procesarLectura();
+}
+
+bool SensorBase::procesaEnParalelo() const {
+    return false;
 }
 
 const char* SensorBase::obtenerNombre() const {
     return nombre;
-}
\ No newline at end of file
+}
+
+bool SensorBase::nombreValidoComoArchivo() const {
+    return nombre[0] != '\0' && nombre[0] != '.' && std::strchr(nombre, '/') == nullptr;
+}
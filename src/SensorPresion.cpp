@@ -4,44 +4,291 @@
  */
 
 #include "SensorPresion.h"
+#include "Registro.h"
+#include "Metricas.h"
 #include <iostream>
+#include <string>
 
-SensorPresion::SensorPresion(const char* id) : SensorBase(id) {
-    std::cout << "[Log] SensorPresion '" << nombre << "' creado.\n";
+namespace {
+
+/**
+ * @brief Promedia todas las lecturas del historial
+ * @tparam H ListaSensor o HistorialCircular
+ */
+template <typename H>
+void procesarHistorial(const H& historial, std::ostream& salida) {
+    if (historial.estaVacia()) {
+        salida << "[Sensor Presion] No hay lecturas para procesar.\n";
+        return;
+    }
+    
+    long long tamanio = historial.obtenerTamanio();
+    int promedio = historial.calcularPromedio();
+    
+    salida << "[Sensor Presion] Promedio calculado sobre " << tamanio 
+           << " lectura(s): " << promedio << " kPa.\n";
+}
+
+template <typename H>
+void imprimirHistorial(const H& historial) {
+    std::cout << "Lecturas almacenadas: " << historial.obtenerTamanio() << "\n";
+    if (!historial.estaVacia()) {
+        std::cout << "Promedio actual: " << historial.calcularPromedio() << " kPa\n";
+    }
+}
+
+}  // namespace
+
+SensorPresion::SensorPresion(const char* id, ArenaMemoria* arena)
+    : SensorBase(id), historial(arena), historialAcotado(nullptr),
+      pendientes(nullptr), segmentos(nullptr), limiteMemoria(0),
+      resumenes(nullptr), reglas(nullptr) {
+    REGISTRO_DEPURACION("[Log] SensorPresion '" << nombre << "' creado.\n");
 }
 
 SensorPresion::~SensorPresion() {
-    std::cout << "[Destructor SensorPresion] Sensor '" << nombre << "' liberando recursos...\n";
+    REGISTRO_DEPURACION("[Destructor SensorPresion] Sensor '" << nombre << "' liberando recursos...\n");
     // ListaSensor se destruye automáticamente (RAII)
+    delete historialAcotado;
+    delete pendientes;
+    delete segmentos;
+    delete resumenes;
+    delete reglas;
 }
 
 void SensorPresion::registrarLectura(int valor) {
-    std::cout << "[" << nombre << "] Registrando lectura de presión: " << valor << " kPa\n";
+    // El reloj solo se consulta si algo usa la marca
+    if (historialAcotado != nullptr || resumenes != nullptr) {
+        registrarLectura(valor, milisegundosMonotonos());
+        return;
+    }
+    METRICA_CRONOMETRAR(HISTOGRAMA_REGISTRAR, 1024);
+    REGISTRO_TRAZA("[" << nombre << "] Registrando lectura de presión: " << valor << " kPa\n");
     historial.insertar(valor);
+    cuantiles.agregar(valor);
+    if (reglas != nullptr) {
+        reglas->evaluar(valor);
+    }
+    if (segmentos != nullptr && historial.obtenerTamanio() > limiteMemoria) {
+        volcarAntiguas();
+    }
 }
 
-void SensorPresion::procesarLectura() {
-    std::cout << "\n-> Procesando Sensor " << nombre << " (Presión)...\n";
-    
-    if (historial.estaVacia()) {
-        std::cout << "[Sensor Presion] No hay lecturas para procesar.\n";
-        return;
+void SensorPresion::registrarLectura(int valor, long long marcaMs) {
+    METRICA_CRONOMETRAR(HISTOGRAMA_REGISTRAR, 1024);
+    REGISTRO_TRAZA("[" << nombre << "] Registrando lectura de presión: " << valor << " kPa\n");
+    if (historialAcotado != nullptr) {
+        historialAcotado->insertar(valor, marcaMs);
+    } else {
+        historial.insertar(valor);
+        if (segmentos != nullptr && historial.obtenerTamanio() > limiteMemoria) {
+            volcarAntiguas();
+        }
     }
+    cuantiles.agregar(valor);
+    if (reglas != nullptr) {
+        reglas->evaluar(valor);
+    }
+    if (resumenes != nullptr) {
+        resumenes->agregar(valor, marcaMs);
+    }
+}
+
+void SensorPresion::procesarLectura(std::ostream& salida) {
+    METRICA_CRONOMETRAR(HISTOGRAMA_PROCESAR, 64);
+    aplicarPendientes();
+    salida << "\n-> Procesando Sensor " << nombre << " (Presión)...\n";
     
-    int tamanio = historial.obtenerTamanio();
-    int promedio = historial.calcularPromedio();
-    
-    std::cout << "[Sensor Presion] Promedio calculado sobre " << tamanio 
-              << " lectura(s): " << promedio << " kPa.\n";
+    if (historialAcotado != nullptr) {
+        procesarHistorial(*historialAcotado, salida);
+    } else if (segmentos != nullptr) {
+        procesarHistorial(VistaSegmentada<int, TAM_BLOQUE_LECTURAS>(historial, *segmentos), salida);
+    } else {
+        procesarHistorial(historial, salida);
+    }
+}
+
+void SensorPresion::procesarLectura() {
+    procesarLectura(std::cout);
+}
+
+bool SensorPresion::procesaEnParalelo() const {
+    return true;
+}
+
+void SensorPresion::procesarLote(SensorPresion* const* sensores, int n, std::ostream& salida) {
+    for (int i = 0; i < n; i++) {
+        // Llamada calificada: despacho estático
+        sensores[i]->SensorPresion::procesarLectura(salida);
+    }
 }
 
 void SensorPresion::imprimirInfo() const {
     std::cout << "\n=== Sensor de Presión ===\n";
     std::cout << "ID: " << nombre << "\n";
     std::cout << "Tipo: Presión (int)\n";
-    std::cout << "Lecturas almacenadas: " << historial.obtenerTamanio() << "\n";
-    if (!historial.estaVacia()) {
-        std::cout << "Promedio actual: " << historial.calcularPromedio() << " kPa\n";
+    if (historialAcotado != nullptr) {
+        imprimirHistorial(*historialAcotado);
+    } else if (segmentos != nullptr) {
+        imprimirHistorial(VistaSegmentada<int, TAM_BLOQUE_LECTURAS>(historial, *segmentos));
+        std::cout << "Segmentos en disco: " << segmentos->obtenerNumSegmentos() << " ("
+                  << segmentos->obtenerCantidad() << " lecturas, "
+                  << static_cast<long long>(segmentos->obtenerBytes()) << " bytes)\n";
+    } else {
+        imprimirHistorial(historial);
+    }
+    if (resumenes != nullptr) {
+        ResumenVentana<int> minuto = consultarUltimos(60 * 1000);
+        std::cout << "Último minuto: " << minuto.cantidad << " lectura(s)";
+        if (minuto.cantidad > 0) {
+            std::cout << ", promedio " << minuto.promedio() << " kPa (mín " << minuto.minimo
+                      << ", máx " << minuto.maximo << ")";
+        }
+        std::cout << "\n";
     }
     std::cout << "========================\n";
-}
\ No newline at end of file
+}
+
+void SensorPresion::fijarRetencion(const PoliticaRetencion& politica) {
+    HistorialCircular<int>* nuevo = new HistorialCircular<int>(politica);
+    if (historialAcotado != nullptr) {
+        historialAcotado->recorrer([nuevo](int valor) { nuevo->insertar(valor); });
+        delete historialAcotado;
+    } else {
+        historial.recorrer([nuevo](int valor) { nuevo->insertar(valor); });
+        historial.vaciar();
+    }
+    historialAcotado = nuevo;
+    if (segmentos != nullptr) {
+        REGISTRO_AVISO("[Aviso] " << nombre << ": con retención, los segmentos en disco dejan de consultarse.\n");
+        delete segmentos;
+        segmentos = nullptr;
+    }
+    REGISTRO_DEPURACION("[Log] SensorPresion '" << nombre << "' acotado a "
+                        << politica.capacidad << " lectura(s).\n");
+}
+
+void SensorPresion::activarCola(std::size_t capacidad) {
+    if (pendientes == nullptr) {
+        pendientes = new ColaLecturas<int>(capacidad);
+    }
+}
+
+bool SensorPresion::encolarLectura(int valor) {
+    return pendientes != nullptr && pendientes->encolar(valor);
+}
+
+int SensorPresion::aplicarPendientes() {
+    if (pendientes == nullptr) return 0;
+
+    int lote[256];
+    int total = 0;
+    int n;
+    // Acotado a una vuelta del búfer: productores continuos no retienen al consumidor
+    int limite = static_cast<int>(pendientes->obtenerCapacidad());
+    while (total < limite && (n = pendientes->drenar(lote, 256)) > 0) {
+        for (int i = 0; i < n; i++) {
+            registrarLectura(lote[i]);
+        }
+        total += n;
+    }
+    return total;
+}
+
+int SensorPresion::obtenerCantidadLecturas() const {
+    return historialAcotado != nullptr ? historialAcotado->obtenerTamanio() : historial.obtenerTamanio();
+}
+
+void SensorPresion::cargarLecturas(const int* datos, int n) {
+    for (int i = 0; i < n; i++) {
+        cuantiles.agregar(datos[i]);
+    }
+    if (historialAcotado != nullptr) {
+        for (int i = 0; i < n; i++) {
+            historialAcotado->insertar(datos[i]);
+        }
+    } else {
+        historial.insertarBloque(datos, n);
+        if (segmentos != nullptr && historial.obtenerTamanio() > limiteMemoria) {
+            volcarAntiguas();
+        }
+    }
+}
+
+bool SensorPresion::fijarSegmentos(const char* directorio, int lecturasEnMemoria) {
+    if (historialAcotado != nullptr) {
+        REGISTRO_AVISO("[Aviso] " << nombre << ": historial acotado, no se usan segmentos.\n");
+        return false;
+    }
+    if (!nombreValidoComoArchivo()) {
+        REGISTRO_ERROR("[Error] " << nombre << ": nombre no utilizable como archivo de segmentos.\n");
+        return false;
+    }
+
+    std::string ruta = std::string(directorio) + "/" + nombre + ".seg";
+    AlmacenSegmentos<int>* almacen = new AlmacenSegmentos<int>(ruta.c_str());
+    if (!almacen->estaAbierto()) {
+        delete almacen;
+        return false;
+    }
+
+    delete segmentos;
+    segmentos = almacen;
+    limiteMemoria = lecturasEnMemoria > 1 ? lecturasEnMemoria : 2;
+    if (historial.obtenerTamanio() > limiteMemoria) {
+        volcarAntiguas();
+    }
+    REGISTRO_DEPURACION("[Log] SensorPresion '" << nombre << "': " << segmentos->obtenerNumSegmentos()
+                        << " segmento(s) en '" << ruta.c_str() << "'.\n");
+    return true;
+}
+
+void SensorPresion::volcarAntiguas() {
+    int n = historial.obtenerTamanio() - limiteMemoria / 2;
+    int* antiguas = new int[n];
+    historial.copiarPrimeros(antiguas, n);
+    // Solo se descartan de memoria si el segmento quedó en disco
+    if (segmentos->sellar(antiguas, n)) {
+        historial.descartarPrimeros(n);
+    }
+    delete[] antiguas;
+}
+
+int SensorPresion::calcularPromedio() const {
+    if (historialAcotado != nullptr) return historialAcotado->calcularPromedio();
+    if (segmentos != nullptr) return estadisticasCompletas(historial, *segmentos).promedio();
+    return historial.calcularPromedio();
+}
+
+int SensorPresion::obtenerMinimo() const {
+    if (historialAcotado != nullptr) return historialAcotado->obtenerMinimo();
+    if (segmentos != nullptr) return estadisticasCompletas(historial, *segmentos).obtenerMinimo();
+    return historial.obtenerMinimo();
+}
+
+void SensorPresion::activarResumenes(const PoliticaResumen& politica) {
+    delete resumenes;
+    resumenes = new ResumenTemporal<int>(politica);
+}
+
+ResumenVentana<int> SensorPresion::consultarVentana(long long desdeMs, long long hastaMs) const {
+    if (resumenes == nullptr) return ResumenVentana<int>();
+    return resumenes->consultar(desdeMs, hastaMs);
+}
+
+ResumenVentana<int> SensorPresion::consultarUltimos(long long duracionMs, long long ahoraMs) const {
+    return consultarVentana(ahoraMs - duracionMs, ahoraMs);
+}
+
+int SensorPresion::obtenerCuantil(double q) const {
+    return cuantiles.cuantil(q);
+}
+
+const BosquejoCuantiles<int>& SensorPresion::obtenerCuantiles() const {
+    return cuantiles;
+}
+
+void SensorPresion::fijarReglas(MotorReglas* motor) {
+    delete reglas;
+    reglas = motor != nullptr ? new EstadoReglas(*motor, REGLAS_PRESION, nombre) : nullptr;
+}
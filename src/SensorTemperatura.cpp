@@ -4,35 +4,29 @@
  */
 
 #include "SensorTemperatura.h"
+#include "Registro.h"
+#include "Metricas.h"
 #include <iostream>
+#include <string>
 
-SensorTemperatura::SensorTemperatura(const char* id) : SensorBase(id) {
-    std::cout << "[Log] SensorTemperatura '" << nombre << "' creado.\n";
-}
+namespace {
 
-SensorTemperatura::~SensorTemperatura() {
-    std::cout << "[Destructor SensorTemperatura] Sensor '" << nombre << "' liberando recursos...\n";
-    // ListaSensor se destruye automáticamente (RAII)
-}
-
-void SensorTemperatura::registrarLectura(float valor) {
-    std::cout << "[" << nombre << "] Registrando lectura de temperatura: " << valor << "°C\n";
-    historial.insertar(valor);
-}
-
-void SensorTemperatura::procesarLectura() {
-    std::cout << "\n-> Procesando Sensor " << nombre << " (Temperatura)...\n";
-    
+/**
+ * @brief Elimina la lectura más baja y promedia el resto
+ * @tparam H ListaSensor o HistorialCircular
+ */
+template <typename H>
+void procesarHistorial(H& historial, const char* nombre, std::ostream& salida) {
     if (historial.estaVacia()) {
-        std::cout << "[Sensor Temp] No hay lecturas para procesar.\n";
+        salida << "[Sensor Temp] No hay lecturas para procesar.\n";
         return;
     }
     
-    int tamanioInicial = historial.obtenerTamanio();
+    long long tamanioInicial = historial.obtenerTamanio();
     
     if (tamanioInicial == 1) {
         float promedio = historial.calcularPromedio();
-        std::cout << "[Sensor Temp] Una sola lectura. Promedio: " << promedio << "°C\n";
+        salida << "[Sensor Temp] Una sola lectura. Promedio: " << promedio << "°C\n";
         return;
     }
     
@@ -42,17 +36,275 @@ void SensorTemperatura::procesarLectura() {
     // Calcular promedio de las lecturas restantes
     float promedioRestante = historial.calcularPromedio();
     
-    std::cout << "[" << nombre << "] (Temperatura): Lectura más baja (" << menorEliminado 
-              << "°C) eliminada. Promedio restante: " << promedioRestante << "°C.\n";
+    salida << "[" << nombre << "] (Temperatura): Lectura más baja (" << menorEliminado 
+           << "°C) eliminada. Promedio restante: " << promedioRestante << "°C.\n";
+}
+
+template <typename H>
+void imprimirHistorial(const H& historial) {
+    std::cout << "Lecturas almacenadas: " << historial.obtenerTamanio() << "\n";
+    if (!historial.estaVacia()) {
+        std::cout << "Promedio actual: " << historial.calcularPromedio() << "°C\n";
+    }
+}
+
+}  // namespace
+
+SensorTemperatura::SensorTemperatura(const char* id, ArenaMemoria* arena)
+    : SensorBase(id), historial(arena), historialAcotado(nullptr),
+      pendientes(nullptr), segmentos(nullptr), limiteMemoria(0),
+      resumenes(nullptr), reglas(nullptr) {
+    REGISTRO_DEPURACION("[Log] SensorTemperatura '" << nombre << "' creado.\n");
+}
+
+SensorTemperatura::~SensorTemperatura() {
+    REGISTRO_DEPURACION("[Destructor SensorTemperatura] Sensor '" << nombre << "' liberando recursos...\n");
+    // ListaSensor se destruye automáticamente (RAII)
+    delete historialAcotado;
+    delete pendientes;
+    delete segmentos;
+    delete resumenes;
+    delete reglas;
+}
+
+void SensorTemperatura::activarIndiceExtremos() {
+    historial.activarIndice();
+}
+
+void SensorTemperatura::registrarLectura(float valor) {
+    // El reloj solo se consulta si algo usa la marca
+    if (historialAcotado != nullptr || resumenes != nullptr) {
+        registrarLectura(valor, milisegundosMonotonos());
+        return;
+    }
+    METRICA_CRONOMETRAR(HISTOGRAMA_REGISTRAR, 1024);
+    REGISTRO_TRAZA("[" << nombre << "] Registrando lectura de temperatura: " << valor << "°C\n");
+    historial.insertar(valor);
+    cuantiles.agregar(valor);
+    if (reglas != nullptr) {
+        reglas->evaluar(valor);
+    }
+    if (segmentos != nullptr && historial.obtenerTamanio() > limiteMemoria) {
+        volcarAntiguas();
+    }
+}
+
+void SensorTemperatura::registrarLectura(float valor, long long marcaMs) {
+    METRICA_CRONOMETRAR(HISTOGRAMA_REGISTRAR, 1024);
+    REGISTRO_TRAZA("[" << nombre << "] Registrando lectura de temperatura: " << valor << "°C\n");
+    if (historialAcotado != nullptr) {
+        historialAcotado->insertar(valor, marcaMs);
+    } else {
+        historial.insertar(valor);
+        if (segmentos != nullptr && historial.obtenerTamanio() > limiteMemoria) {
+            volcarAntiguas();
+        }
+    }
+    cuantiles.agregar(valor);
+    if (reglas != nullptr) {
+        reglas->evaluar(valor);
+    }
+    if (resumenes != nullptr) {
+        resumenes->agregar(valor, marcaMs);
+    }
+}
+
+void SensorTemperatura::procesarLectura(std::ostream& salida) {
+    METRICA_CRONOMETRAR(HISTOGRAMA_PROCESAR, 64);
+    aplicarPendientes();
+    salida << "\n-> Procesando Sensor " << nombre << " (Temperatura)...\n";
+    
+    if (historialAcotado != nullptr) {
+        procesarHistorial(*historialAcotado, nombre, salida);
+    } else if (segmentos != nullptr) {
+        VistaSegmentada<float, TAM_BLOQUE_LECTURAS> vista(historial, *segmentos);
+        procesarHistorial(vista, nombre, salida);
+    } else {
+        procesarHistorial(historial, nombre, salida);
+    }
+}
+
+void SensorTemperatura::procesarLectura() {
+    procesarLectura(std::cout);
+}
+
+bool SensorTemperatura::procesaEnParalelo() const {
+    return true;
+}
+
+void SensorTemperatura::procesarLote(SensorTemperatura* const* sensores, int n, std::ostream& salida) {
+    for (int i = 0; i < n; i++) {
+        // Llamada calificada: despacho estático
+        sensores[i]->SensorTemperatura::procesarLectura(salida);
+    }
 }
 
 void SensorTemperatura::imprimirInfo() const {
     std::cout << "\n=== Sensor de Temperatura ===\n";
     std::cout << "ID: " << nombre << "\n";
     std::cout << "Tipo: Temperatura (float)\n";
-    std::cout << "Lecturas almacenadas: " << historial.obtenerTamanio() << "\n";
-    if (!historial.estaVacia()) {
-        std::cout << "Promedio actual: " << historial.calcularPromedio() << "°C\n";
+    if (historialAcotado != nullptr) {
+        imprimirHistorial(*historialAcotado);
+    } else if (segmentos != nullptr) {
+        imprimirHistorial(VistaSegmentada<float, TAM_BLOQUE_LECTURAS>(historial, *segmentos));
+        std::cout << "Segmentos en disco: " << segmentos->obtenerNumSegmentos() << " ("
+                  << segmentos->obtenerCantidad() << " lecturas, "
+                  << static_cast<long long>(segmentos->obtenerBytes()) << " bytes)\n";
+    } else {
+        imprimirHistorial(historial);
+    }
+    if (resumenes != nullptr) {
+        ResumenVentana<float> minuto = consultarUltimos(60 * 1000);
+        std::cout << "Último minuto: " << minuto.cantidad << " lectura(s)";
+        if (minuto.cantidad > 0) {
+            std::cout << ", promedio " << minuto.promedio() << "°C (mín " << minuto.minimo
+                      << ", máx " << minuto.maximo << ")";
+        }
+        std::cout << "\n";
     }
     std::cout << "============================\n";
-}
\ No newline at end of file
+}
+
+void SensorTemperatura::fijarRetencion(const PoliticaRetencion& politica) {
+    HistorialCircular<float>* nuevo = new HistorialCircular<float>(politica);
+    if (historialAcotado != nullptr) {
+        historialAcotado->recorrer([nuevo](float valor) { nuevo->insertar(valor); });
+        delete historialAcotado;
+    } else {
+        historial.recorrer([nuevo](float valor) { nuevo->insertar(valor); });
+        historial.vaciar();
+    }
+    historialAcotado = nuevo;
+    if (segmentos != nullptr) {
+        REGISTRO_AVISO("[Aviso] " << nombre << ": con retención, los segmentos en disco dejan de consultarse.\n");
+        delete segmentos;
+        segmentos = nullptr;
+    }
+    REGISTRO_DEPURACION("[Log] SensorTemperatura '" << nombre << "' acotado a "
+                        << politica.capacidad << " lectura(s).\n");
+}
+
+void SensorTemperatura::activarCola(std::size_t capacidad) {
+    if (pendientes == nullptr) {
+        pendientes = new ColaLecturas<float>(capacidad);
+    }
+}
+
+bool SensorTemperatura::encolarLectura(float valor) {
+    return pendientes != nullptr && pendientes->encolar(valor);
+}
+
+int SensorTemperatura::aplicarPendientes() {
+    if (pendientes == nullptr) return 0;
+
+    float lote[256];
+    int total = 0;
+    int n;
+    // Acotado a una vuelta del búfer: productores continuos no retienen al consumidor
+    int limite = static_cast<int>(pendientes->obtenerCapacidad());
+    while (total < limite && (n = pendientes->drenar(lote, 256)) > 0) {
+        for (int i = 0; i < n; i++) {
+            registrarLectura(lote[i]);
+        }
+        total += n;
+    }
+    return total;
+}
+
+int SensorTemperatura::obtenerCantidadLecturas() const {
+    return historialAcotado != nullptr ? historialAcotado->obtenerTamanio() : historial.obtenerTamanio();
+}
+
+void SensorTemperatura::cargarLecturas(const float* datos, int n) {
+    for (int i = 0; i < n; i++) {
+        cuantiles.agregar(datos[i]);
+    }
+    if (historialAcotado != nullptr) {
+        for (int i = 0; i < n; i++) {
+            historialAcotado->insertar(datos[i]);
+        }
+    } else {
+        historial.insertarBloque(datos, n);
+        if (segmentos != nullptr && historial.obtenerTamanio() > limiteMemoria) {
+            volcarAntiguas();
+        }
+    }
+}
+
+bool SensorTemperatura::fijarSegmentos(const char* directorio, int lecturasEnMemoria) {
+    if (historialAcotado != nullptr) {
+        REGISTRO_AVISO("[Aviso] " << nombre << ": historial acotado, no se usan segmentos.\n");
+        return false;
+    }
+    if (!nombreValidoComoArchivo()) {
+        REGISTRO_ERROR("[Error] " << nombre << ": nombre no utilizable como archivo de segmentos.\n");
+        return false;
+    }
+
+    std::string ruta = std::string(directorio) + "/" + nombre + ".seg";
+    AlmacenSegmentos<float>* almacen = new AlmacenSegmentos<float>(ruta.c_str());
+    if (!almacen->estaAbierto()) {
+        delete almacen;
+        return false;
+    }
+
+    delete segmentos;
+    segmentos = almacen;
+    limiteMemoria = lecturasEnMemoria > 1 ? lecturasEnMemoria : 2;
+    if (historial.obtenerTamanio() > limiteMemoria) {
+        volcarAntiguas();
+    }
+    REGISTRO_DEPURACION("[Log] SensorTemperatura '" << nombre << "': " << segmentos->obtenerNumSegmentos()
+                        << " segmento(s) en '" << ruta.c_str() << "'.\n");
+    return true;
+}
+
+void SensorTemperatura::volcarAntiguas() {
+    int n = historial.obtenerTamanio() - limiteMemoria / 2;
+    float* antiguas = new float[n];
+    historial.copiarPrimeros(antiguas, n);
+    // Solo se descartan de memoria si el segmento quedó en disco
+    if (segmentos->sellar(antiguas, n)) {
+        historial.descartarPrimeros(n);
+    }
+    delete[] antiguas;
+}
+
+float SensorTemperatura::calcularPromedio() const {
+    if (historialAcotado != nullptr) return historialAcotado->calcularPromedio();
+    if (segmentos != nullptr) return estadisticasCompletas(historial, *segmentos).promedio();
+    return historial.calcularPromedio();
+}
+
+float SensorTemperatura::obtenerMinimo() const {
+    if (historialAcotado != nullptr) return historialAcotado->obtenerMinimo();
+    if (segmentos != nullptr) return estadisticasCompletas(historial, *segmentos).obtenerMinimo();
+    return historial.obtenerMinimo();
+}
+
+void SensorTemperatura::activarResumenes(const PoliticaResumen& politica) {
+    delete resumenes;
+    resumenes = new ResumenTemporal<float>(politica);
+}
+
+ResumenVentana<float> SensorTemperatura::consultarVentana(long long desdeMs, long long hastaMs) const {
+    if (resumenes == nullptr) return ResumenVentana<float>();
+    return resumenes->consultar(desdeMs, hastaMs);
+}
+
+ResumenVentana<float> SensorTemperatura::consultarUltimos(long long duracionMs, long long ahoraMs) const {
+    return consultarVentana(ahoraMs - duracionMs, ahoraMs);
+}
+
+float SensorTemperatura::obtenerCuantil(double q) const {
+    return cuantiles.cuantil(q);
+}
+
+const BosquejoCuantiles<float>& SensorTemperatura::obtenerCuantiles() const {
+    return cuantiles;
+}
+
+void SensorTemperatura::fijarReglas(MotorReglas* motor) {
+    delete reglas;
+    reglas = motor != nullptr ? new EstadoReglas(*motor, REGLAS_TEMPERATURA, nombre) : nullptr;
+}
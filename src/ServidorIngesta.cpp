@@ -0,0 +1,462 @@
+/**
+ * @file ServidorIngesta.cpp
+ * @brief Implementación del bucle epoll de ingesta
+ */
+
+#include "ServidorIngesta.h"
+#include "PlanificadorSensores.h"
+#include "Registro.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+const std::size_t ServidorIngesta::TAM_LINEA;
+const std::size_t ServidorIngesta::TAM_LECTURA;
+const std::size_t ServidorIngesta::TAM_RONDA;
+const int ServidorIngesta::MAX_EVENTOS;
+
+namespace {
+
+bool fijarNoBloqueante(int descriptor) {
+    int banderas = fcntl(descriptor, F_GETFL);
+    return banderas >= 0 && fcntl(descriptor, F_SETFL, banderas | O_NONBLOCK) == 0;
+}
+
+/**
+ * @brief Último '\n' de un bloque
+ * @return Puntero al salto o nullptr
+ */
+const char* ultimoSalto(const char* datos, std::size_t longitud) {
+    while (longitud > 0) {
+        if (datos[--longitud] == '\n') return datos + longitud;
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+/**
+ * @brief Destino del texto de una conexión para IngestaLecturas::demultiplexar()
+ */
+struct ServidorIngesta::TextoConexion {
+    ServidorIngesta& servidor;  ///< Servidor dueño de la conexión
+    Conexion* conexion;         ///< Conexión cuyo texto se consume
+
+    void consumirTexto(const char* datos, std::size_t longitud) {
+        servidor.consumirTexto(conexion, datos, longitud);
+    }
+
+    bool descartarLineaPartida() {
+        bool habia = conexion->pendiente > 0 || conexion->descartandoLinea;
+        conexion->pendiente = 0;
+        conexion->descartandoLinea = false;
+        return habia;
+    }
+};
+
+ServidorIngesta::ServidorIngesta(SistemaGestion& sistema)
+    : ingesta(sistema), epoll(epoll_create1(EPOLL_CLOEXEC)), despertador(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      escucha(-1), puerto(0), conexiones(nullptr), numConexiones(0), capacidad(0),
+      ronda(new char[TAM_RONDA]), usado(0), detenido(false), planificador(nullptr), msPorTick(1) {
+    iniciarBucle();
+}
+
+ServidorIngesta::ServidorIngesta(SistemaFragmentado& fragmentos)
+    : ingesta(fragmentos), epoll(epoll_create1(EPOLL_CLOEXEC)), despertador(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      escucha(-1), puerto(0), conexiones(nullptr), numConexiones(0), capacidad(0),
+      ronda(new char[TAM_RONDA]), usado(0), detenido(false), planificador(nullptr), msPorTick(1) {
+    iniciarBucle();
+}
+
+void ServidorIngesta::iniciarBucle() {
+    if (epoll < 0 || despertador < 0) {
+        REGISTRO_ERROR("[Error] No se pudo crear el bucle de eventos: " << strerror(errno) << "\n");
+        return;
+    }
+    epoll_event evento;
+    evento.events = EPOLLIN;
+    evento.data.ptr = &despertador;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, despertador, &evento);
+}
+
+ServidorIngesta::~ServidorIngesta() {
+    for (int i = 0; i < numConexiones; i++) {
+        if (conexiones[i]->propio) close(conexiones[i]->descriptor);
+        delete conexiones[i]->trama;
+        delete conexiones[i];
+    }
+    delete[] conexiones;
+    if (escucha >= 0) close(escucha);
+    if (despertador >= 0) close(despertador);
+    if (epoll >= 0) close(epoll);
+    delete[] ronda;
+}
+
+IngestaLecturas& ServidorIngesta::obtenerIngesta() {
+    return ingesta;
+}
+
+bool ServidorIngesta::escuchar(int puerto) {
+    if (escucha >= 0) {
+        REGISTRO_AVISO("[Servidor] Ya se escucha en el puerto " << this->puerto << ".\n");
+        return false;
+    }
+
+    int s = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (s < 0) {
+        REGISTRO_ERROR("[Error] No se pudo crear el socket: " << strerror(errno) << "\n");
+        return false;
+    }
+    int reutilizar = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &reutilizar, sizeof(reutilizar));
+
+    sockaddr_in direccion;
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.sin_family = AF_INET;
+    direccion.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    direccion.sin_port = htons(static_cast<uint16_t>(puerto));
+    socklen_t longitud = sizeof(direccion);
+    if (bind(s, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) != 0 ||
+        listen(s, SOMAXCONN) != 0 ||
+        getsockname(s, reinterpret_cast<sockaddr*>(&direccion), &longitud) != 0) {
+        REGISTRO_ERROR("[Error] No se pudo escuchar en 127.0.0.1:" << puerto << ": " << strerror(errno) << "\n");
+        close(s);
+        return false;
+    }
+
+    epoll_event evento;
+    evento.events = EPOLLIN;
+    evento.data.ptr = &escucha;
+    if (epoll_ctl(epoll, EPOLL_CTL_ADD, s, &evento) != 0) {
+        REGISTRO_ERROR("[Error] epoll_ctl del socket de escucha: " << strerror(errno) << "\n");
+        close(s);
+        return false;
+    }
+    escucha = s;
+    this->puerto = ntohs(direccion.sin_port);
+    REGISTRO_INFO("[Servidor] Escuchando en 127.0.0.1:" << this->puerto << "\n");
+    return true;
+}
+
+bool ServidorIngesta::agregarFuente(const char* ruta) {
+    int descriptor = open(ruta, O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (descriptor < 0) {
+        REGISTRO_ERROR("[Error] No se pudo abrir '" << ruta << "': " << strerror(errno) << "\n");
+        return false;
+    }
+    if (isatty(descriptor) && !IngestaLecturas::configurarSerial(descriptor)) {
+        REGISTRO_AVISO("[Servidor] No se pudo configurar '" << ruta << "' a 115200 baudios.\n");
+    }
+    if (!registrar(descriptor, true)) {
+        REGISTRO_ERROR("[Error] '" << ruta << "' no admite epoll (para archivos, usar --ingesta).\n");
+        return false;
+    }
+    REGISTRO_INFO("[Servidor] Fuente abierta: " << ruta << "\n");
+    return true;
+}
+
+bool ServidorIngesta::agregarDescriptor(int descriptor, bool propio) {
+    if (!fijarNoBloqueante(descriptor)) {
+        REGISTRO_ERROR("[Error] No se pudo pasar el descriptor " << descriptor << " a modo no bloqueante: "
+                       << strerror(errno) << "\n");
+        return false;
+    }
+    return registrar(descriptor, propio);
+}
+
+void ServidorIngesta::crecer() {
+    int nueva = capacidad == 0 ? 64 : capacidad * 2;
+    Conexion** arreglo = new Conexion*[nueva];
+    for (int i = 0; i < numConexiones; i++) {
+        arreglo[i] = conexiones[i];
+    }
+    delete[] conexiones;
+    conexiones = arreglo;
+    capacidad = nueva;
+}
+
+bool ServidorIngesta::registrar(int descriptor, bool propio) {
+    Conexion* conexion = new Conexion;
+    conexion->descriptor = descriptor;
+    conexion->propio = propio;
+    conexion->pendiente = 0;
+    conexion->descartandoLinea = false;
+    conexion->trama = ingesta.protocoloBinario() ? new TramaEnCurso : nullptr;
+
+    // Disparo por nivel: una lectura por conexión y ronda reparte el bucle entre todas
+    epoll_event evento;
+    evento.events = EPOLLIN;
+    evento.data.ptr = conexion;
+    if (epoll_ctl(epoll, EPOLL_CTL_ADD, descriptor, &evento) != 0) {
+        if (propio) close(descriptor);
+        delete conexion->trama;
+        delete conexion;
+        return false;
+    }
+
+    if (numConexiones == capacidad) crecer();
+    conexion->posicion = numConexiones;
+    conexiones[numConexiones++] = conexion;
+    return true;
+}
+
+void ServidorIngesta::fijarPlanificador(PlanificadorSensores* planificador, int msPorTick) {
+    this->planificador = planificador;
+    this->msPorTick = msPorTick > 0 ? msPorTick : 1;
+}
+
+int ServidorIngesta::atender(int esperaMs) {
+    epoll_event eventos[MAX_EVENTOS];
+    int n = epoll_wait(epoll, eventos, MAX_EVENTOS, esperaMs);
+    if (n < 0) {
+        if (errno == EINTR) return 0;
+        REGISTRO_ERROR("[Error] epoll_wait: " << strerror(errno) << "\n");
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        void* origen = eventos[i].data.ptr;
+        if (origen == &escucha) {
+            aceptar();
+        } else if (origen == &despertador) {
+            uint64_t valor;
+            while (read(despertador, &valor, sizeof(valor)) > 0) {}
+        } else {
+            leer(static_cast<Conexion*>(origen));
+        }
+    }
+
+    // Un solo despacho para todas las conexiones de la ronda
+    ingesta.despacharLote();
+    usado = 0;
+    estadisticas.rondas++;
+    return n;
+}
+
+bool ServidorIngesta::ejecutar() {
+    if (epoll < 0) return false;
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    while (!detenido.load(std::memory_order_acquire) && (escucha >= 0 || numConexiones > 0)) {
+        if (planificador == nullptr) {
+            if (atender(-1) < 0) return false;
+            continue;
+        }
+
+        // Despertar a tiempo para el siguiente tick aunque no lleguen datos
+        long long transcurrido = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - inicio).count();
+        int espera = msPorTick - static_cast<int>(transcurrido % msPorTick);
+        if (atender(espera) < 0) return false;
+        transcurrido = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - inicio).count();
+        planificador->avanzarHasta(static_cast<uint64_t>(transcurrido / msPorTick), std::cout);
+    }
+    return true;
+}
+
+void ServidorIngesta::detener() {
+    detenido.store(true, std::memory_order_release);
+    uint64_t uno = 1;
+    if (write(despertador, &uno, sizeof(uno)) < 0) {
+        // El contador ya está activo: epoll_wait despertará igualmente
+    }
+}
+
+void ServidorIngesta::aceptar() {
+    while (true) {
+        int descriptor = accept4(escucha, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (descriptor < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                REGISTRO_AVISO("[Servidor] accept: " << strerror(errno) << "\n");
+            }
+            return;
+        }
+        if (registrar(descriptor, true)) {
+            estadisticas.conexionesAceptadas++;
+        } else {
+            REGISTRO_AVISO("[Servidor] epoll_ctl de una conexión: " << strerror(errno) << "\n");
+        }
+    }
+}
+
+char* ServidorIngesta::reservarRonda(std::size_t bytes) {
+    if (usado + bytes > TAM_RONDA) {
+        // El lote apunta a la ronda: se entrega antes de reutilizarla
+        ingesta.despacharLote();
+        usado = 0;
+    }
+    return ronda + usado;
+}
+
+void ServidorIngesta::leer(Conexion* conexion) {
+    if (conexion->trama != nullptr) {
+        leerMixto(conexion);
+        return;
+    }
+
+    // La línea partida va delante de los bytes nuevos: el análisis ve líneas contiguas
+    char* inicio = reservarRonda(TAM_LINEA + TAM_LECTURA);
+    memcpy(inicio, conexion->linea, conexion->pendiente);
+
+    ssize_t leidos = read(conexion->descriptor, inicio + conexion->pendiente, TAM_LECTURA);
+    if (leidos < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return;
+        // EIO: el otro extremo de una pty se cerró
+        if (errno != EIO) {
+            REGISTRO_AVISO("[Servidor] Lectura fallida en el descriptor " << conexion->descriptor << ": "
+                           << strerror(errno) << "\n");
+        }
+        cerrarConexion(conexion);
+        return;
+    }
+    if (leidos == 0) {
+        cerrarConexion(conexion);
+        return;
+    }
+    estadisticas.bytes += leidos;
+
+    std::size_t total = conexion->pendiente + static_cast<std::size_t>(leidos);
+    const char* salto = ultimoSalto(inicio, total);
+    std::size_t completas = salto != nullptr ? static_cast<std::size_t>(salto - inicio) + 1 : 0;
+    if (completas > 0) {
+        std::size_t desde = 0;
+        if (conexion->descartandoLinea) {
+            // Cola de una línea demasiado larga
+            desde = static_cast<std::size_t>(static_cast<const char*>(memchr(inicio, '\n', total)) - inicio) + 1;
+            conexion->descartandoLinea = false;
+        }
+        ingesta.acumularLineas(inicio + desde, completas - desde);
+        usado += completas;
+    }
+
+    std::size_t resto = total - completas;
+    if (conexion->descartandoLinea || resto > TAM_LINEA) {
+        if (!conexion->descartandoLinea) estadisticas.lineasLargas++;
+        conexion->descartandoLinea = true;
+        conexion->pendiente = 0;
+    } else {
+        memcpy(conexion->linea, inicio + completas, resto);
+        conexion->pendiente = resto;
+    }
+}
+
+void ServidorIngesta::leerMixto(Conexion* conexion) {
+    // Los bytes quedan en la ronda: las líneas completas se analizan sin copiarlas
+    char* inicio = reservarRonda(TAM_LECTURA);
+    ssize_t leidos = read(conexion->descriptor, inicio, TAM_LECTURA);
+    if (leidos < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return;
+        if (errno != EIO) {
+            REGISTRO_AVISO("[Servidor] Lectura fallida en el descriptor " << conexion->descriptor << ": "
+                           << strerror(errno) << "\n");
+        }
+        cerrarConexion(conexion);
+        return;
+    }
+    if (leidos == 0) {
+        cerrarConexion(conexion);
+        return;
+    }
+    estadisticas.bytes += leidos;
+    usado += static_cast<std::size_t>(leidos);
+
+    TextoConexion texto = { *this, conexion };
+    ingesta.demultiplexar(*conexion->trama, inicio, static_cast<std::size_t>(leidos), texto);
+}
+
+void ServidorIngesta::consumirTexto(Conexion* conexion, const char* datos, std::size_t longitud) {
+    const char* fin = datos + longitud;
+
+    // Completar la línea partida; se analiza en conexion->linea y se despacha ya
+    if (conexion->pendiente > 0 || conexion->descartandoLinea) {
+        const char* salto = static_cast<const char*>(memchr(datos, '\n', longitud));
+        std::size_t hasta = salto != nullptr ? static_cast<std::size_t>(salto - datos) : longitud;
+        if (!conexion->descartandoLinea && conexion->pendiente + hasta >= TAM_LINEA) {
+            estadisticas.lineasLargas++;
+            conexion->descartandoLinea = true;
+            conexion->pendiente = 0;
+        }
+        if (!conexion->descartandoLinea) {
+            memcpy(conexion->linea + conexion->pendiente, datos, hasta);
+            conexion->pendiente += hasta;
+        }
+        if (salto == nullptr) return;
+
+        if (conexion->descartandoLinea) {
+            conexion->descartandoLinea = false;
+        } else {
+            conexion->linea[conexion->pendiente] = '\n';
+            ingesta.acumularLineas(conexion->linea, conexion->pendiente + 1);
+            ingesta.despacharLote();
+        }
+        conexion->pendiente = 0;
+        datos = salto + 1;
+    }
+
+    std::size_t resto = static_cast<std::size_t>(fin - datos);
+    const char* salto = ultimoSalto(datos, resto);
+    std::size_t completas = salto != nullptr ? static_cast<std::size_t>(salto - datos) + 1 : 0;
+    if (completas > 0) {
+        ingesta.acumularLineas(datos, completas);
+        // El texto reexaminado de una trama corrupta se sobrescribe al volver
+        const char* trama = reinterpret_cast<const char*>(conexion->trama->bytes);
+        if (datos >= trama && datos < trama + TAM_MAX_TRAMA) ingesta.despacharLote();
+    }
+
+    resto -= completas;
+    if (resto >= TAM_LINEA) {
+        estadisticas.lineasLargas++;
+        conexion->descartandoLinea = true;
+    } else {
+        memcpy(conexion->linea, datos + completas, resto);
+        conexion->pendiente = resto;
+    }
+}
+
+void ServidorIngesta::cerrarConexion(Conexion* conexion) {
+    if (conexion->trama != nullptr) {
+        // Trama cortada por el cierre
+        ingesta.descartarTrama(*conexion->trama);
+    }
+    if (conexion->pendiente > 0 && !conexion->descartandoLinea) {
+        // Última línea sin '\n'
+        char* inicio = reservarRonda(conexion->pendiente + 1);
+        memcpy(inicio, conexion->linea, conexion->pendiente);
+        inicio[conexion->pendiente] = '\n';
+        ingesta.acumularLineas(inicio, conexion->pendiente + 1);
+        usado += conexion->pendiente + 1;
+    }
+
+    epoll_ctl(epoll, EPOLL_CTL_DEL, conexion->descriptor, nullptr);
+    if (conexion->propio) close(conexion->descriptor);
+
+    // Quitar por intercambio con la última
+    Conexion* ultima = conexiones[--numConexiones];
+    conexiones[conexion->posicion] = ultima;
+    ultima->posicion = conexion->posicion;
+    delete conexion->trama;
+    delete conexion;
+    estadisticas.conexionesCerradas++;
+}
+
+int ServidorIngesta::obtenerPuerto() const {
+    return puerto;
+}
+
+int ServidorIngesta::obtenerConexionesAbiertas() const {
+    return numConexiones;
+}
+
+const EstadisticasServidor& ServidorIngesta::obtenerEstadisticas() const {
+    return estadisticas;
+}
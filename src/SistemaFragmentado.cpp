@@ -0,0 +1,437 @@
+/**
+ * @file SistemaFragmentado.cpp
+ * @brief Implementación de los fragmentos de gestión con hilo propio
+ */
+
+#include "SistemaFragmentado.h"
+#include "SistemaGestion.h"
+#include "ColaLecturas.h"
+#include "IndiceSensores.h"
+#include "BosquejoCuantiles.h"
+#include "SensorBase.h"
+#include "Registro.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int SistemaFragmentado::MAX_FRAGMENTOS;
+const int SistemaFragmentado::TAM_LOTE;
+
+namespace {
+
+const int MAX_LONGITUD_ID = 49;  ///< Igual que SensorBase::nombre (50 con el '\0')
+const int VUELTAS_ANTES_DE_DORMIR = 64;  ///< Colas vacías seguidas antes de bloquear el hilo
+
+}  // namespace
+
+/**
+ * @brief Lectura o, si tarea no es nula, orden para un fragmento
+ */
+struct SistemaFragmentado::Mensaje {
+    const std::function<void(Fragmento&)>* tarea;  ///< Orden (nullptr = lectura)
+    Espera* espera;                                ///< Aviso de orden terminada
+    float valorFloat;                              ///< Valor si tipo == LECTURA_TEMPERATURA
+    int valorInt;                                  ///< Valor si tipo == LECTURA_PRESION
+    TipoLectura tipo;                              ///< Tipo de sensor
+    unsigned char longitudId;                      ///< Caracteres de id
+    char id[MAX_LONGITUD_ID];                      ///< Identificador copiado (sin '\0')
+};
+
+/**
+ * @brief Órdenes pendientes de una llamada síncrona
+ */
+struct SistemaFragmentado::Espera {
+    std::mutex cerrojo;               ///< Protege pendientes
+    std::condition_variable listo;    ///< Avisa al llamador
+    int pendientes;                   ///< Fragmentos que aún no ejecutaron la orden
+};
+
+/**
+ * @brief Estado de un fragmento; solo su hilo toca sistema e ingesta
+ */
+struct SistemaFragmentado::Fragmento {
+    int indice;                       ///< Posición en el sistema
+    SistemaGestion sistema;           ///< Registro, sensores y arena del fragmento
+    IngestaLecturas ingesta;          ///< Resuelve, crea y alimenta los sensores
+    ColaLecturas<Mensaje> cola;       ///< Mensajes de los productores
+    std::thread hilo;                 ///< Único hilo que consume la cola
+    std::atomic<bool> dormido;        ///< El hilo está (o va a estar) bloqueado en aviso
+    std::mutex cerrojo;               ///< Protege avisado y detenido
+    std::condition_variable aviso;    ///< Despierta al hilo
+    bool avisado;                     ///< Llegó un mensaje mientras dormía
+    bool detenido;                    ///< El sistema se está destruyendo
+
+    Fragmento(int indice, std::size_t capacidad)
+        : indice(indice), sistema(false), ingesta(sistema), cola(capacidad), dormido(false), avisado(false), detenido(false) {}
+};
+
+SistemaFragmentado::SistemaFragmentado(int fragmentos, bool fijarNucleos, std::size_t capacidadCola)
+    : fragmentos(nullptr), numFragmentos(0), idsDescartados(0) {
+    std::cout << "\n=== Sistema IoT de Monitoreo Polimórfico Iniciado ===\n\n";
+    int nucleos = static_cast<int>(std::thread::hardware_concurrency());
+    if (nucleos < 1) nucleos = 1;
+    if (fragmentos <= 0) fragmentos = nucleos;
+    if (fragmentos > MAX_FRAGMENTOS) fragmentos = MAX_FRAGMENTOS;
+
+    this->fragmentos = new Fragmento*[fragmentos];
+    for (int i = 0; i < fragmentos; i++) {
+        this->fragmentos[i] = new Fragmento(i, capacidadCola);
+    }
+    numFragmentos = fragmentos;
+
+    int fijados = 0;
+    for (int i = 0; i < fragmentos; i++) {
+        Fragmento& f = *this->fragmentos[i];
+        f.hilo = std::thread(&SistemaFragmentado::atender, std::ref(f));
+        if (fijarNucleos) {
+            cpu_set_t nucleo;
+            CPU_ZERO(&nucleo);
+            CPU_SET(i % nucleos, &nucleo);
+            if (pthread_setaffinity_np(f.hilo.native_handle(), sizeof(nucleo), &nucleo) == 0) fijados++;
+        }
+    }
+    if (fijarNucleos && fijados < fragmentos) {
+        REGISTRO_AVISO("[Fragmentos] Solo " << fijados << " de " << fragmentos << " hilos fijados a un núcleo.\n");
+    }
+    REGISTRO_INFO("[Fragmentos] " << fragmentos << " fragmento(s) en " << nucleos << " núcleo(s).\n");
+}
+
+SistemaFragmentado::~SistemaFragmentado() {
+    std::cout << "\n--- Liberación de Memoria en Cascada ---\n";
+    for (int i = 0; i < numFragmentos; i++) {
+        Fragmento& f = *fragmentos[i];
+        {
+            std::lock_guard<std::mutex> bloqueo(f.cerrojo);
+            f.detenido = true;
+        }
+        f.aviso.notify_one();
+        f.hilo.join();
+    }
+    // Los sensores de cada fragmento se liberan con su SistemaGestion
+    for (int i = 0; i < numFragmentos; i++) {
+        delete fragmentos[i];
+    }
+    delete[] fragmentos;
+    std::cout << "Sistema cerrado. Memoria limpia.\n";
+}
+
+int SistemaFragmentado::obtenerNumFragmentos() const {
+    return numFragmentos;
+}
+
+int SistemaFragmentado::fragmentoDe(const char* nombre, int longitud) const {
+    uint64_t hash = IndiceSensores::hashNombre(nombre, longitud);
+    return static_cast<int>((hash * static_cast<uint64_t>(numFragmentos)) >> 32);
+}
+
+int SistemaFragmentado::fragmentoDe(const char* nombre) const {
+    return fragmentoDe(nombre, static_cast<int>(strlen(nombre)));
+}
+
+void SistemaFragmentado::atender(Fragmento& f) {
+    std::vector<Mensaje> mensajes(TAM_LOTE);
+    LecturaTexto lecturas[TAM_LOTE];
+    int vacias = 0;
+
+    while (true) {
+        int n = f.cola.drenar(mensajes.data(), TAM_LOTE);
+        if (n == 0) {
+            // Girar un poco antes de bloquear: en plena ingesta la cola se rellena enseguida
+            if (++vacias < VUELTAS_ANTES_DE_DORMIR) {
+                std::this_thread::yield();
+                continue;
+            }
+            vacias = 0;
+            if (!dormir(f)) return;
+            continue;
+        }
+        vacias = 0;
+
+        // Las lecturas consecutivas se despachan juntas; las órdenes, en su sitio
+        int enLote = 0;
+        for (int i = 0; i < n; i++) {
+            const Mensaje& m = mensajes[static_cast<std::size_t>(i)];
+            if (m.tarea == nullptr) {
+                LecturaTexto& lectura = lecturas[enLote++];
+                lectura.tipo = m.tipo;
+                lectura.id = m.id;
+                lectura.longitudId = m.longitudId;
+                lectura.valorFloat = m.valorFloat;
+                lectura.valorInt = m.valorInt;
+                continue;
+            }
+            if (enLote > 0) {
+                f.ingesta.entregarLecturas(lecturas, enLote);
+                enLote = 0;
+            }
+            (*m.tarea)(f);
+            // Avisar con el cerrojo tomado: la Espera vive en la pila del llamador
+            std::lock_guard<std::mutex> bloqueo(m.espera->cerrojo);
+            if (--m.espera->pendientes == 0) m.espera->listo.notify_all();
+        }
+        if (enLote > 0) {
+            f.ingesta.entregarLecturas(lecturas, enLote);
+        }
+    }
+}
+
+bool SistemaFragmentado::dormir(Fragmento& f) {
+    std::unique_lock<std::mutex> bloqueo(f.cerrojo);
+    f.dormido.store(true, std::memory_order_relaxed);
+    // Pareja de la barrera de avisar(): o el productor ve dormido o aquí se ve su mensaje
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (f.cola.estaVacia()) {
+        if (f.detenido) {
+            f.dormido.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        f.aviso.wait(bloqueo, [&f]() { return f.avisado || f.detenido; });
+    }
+    f.avisado = false;
+    f.dormido.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void SistemaFragmentado::avisar(Fragmento& f) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!f.dormido.load(std::memory_order_relaxed)) return;
+    {
+        std::lock_guard<std::mutex> bloqueo(f.cerrojo);
+        f.avisado = true;
+    }
+    f.aviso.notify_one();
+}
+
+void SistemaFragmentado::encolar(Fragmento& f, const Mensaje& mensaje) {
+    while (!f.cola.encolar(mensaje)) {
+        avisar(f);
+        std::this_thread::yield();
+    }
+}
+
+void SistemaFragmentado::enviarLecturas(const LecturaTexto* lecturas, int n) {
+    bool destinos[MAX_FRAGMENTOS] = {false};
+    Mensaje m;
+    m.tarea = nullptr;
+    m.espera = nullptr;
+
+    for (int i = 0; i < n; i++) {
+        const LecturaTexto& lectura = lecturas[i];
+        if (lectura.longitudId > MAX_LONGITUD_ID) {
+            idsDescartados.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        int destino = fragmentoDe(lectura.id, lectura.longitudId);
+        m.tipo = lectura.tipo;
+        m.valorFloat = lectura.valorFloat;
+        m.valorInt = lectura.valorInt;
+        m.longitudId = static_cast<unsigned char>(lectura.longitudId);
+        memcpy(m.id, lectura.id, static_cast<std::size_t>(lectura.longitudId));
+        encolar(*fragmentos[destino], m);
+        destinos[destino] = true;
+    }
+
+    // Un aviso por fragmento y lote, no por lectura
+    for (int i = 0; i < numFragmentos; i++) {
+        if (destinos[i]) avisar(*fragmentos[i]);
+    }
+}
+
+void SistemaFragmentado::ordenar(int fragmento, const std::function<void(Fragmento&)>& tarea) {
+    Espera espera;
+    espera.pendientes = fragmento < 0 ? numFragmentos : 1;
+    Mensaje m;
+    m.tarea = &tarea;
+    m.espera = &espera;
+
+    for (int i = 0; i < numFragmentos; i++) {
+        if (fragmento >= 0 && i != fragmento) continue;
+        encolar(*fragmentos[i], m);
+        avisar(*fragmentos[i]);
+    }
+
+    std::unique_lock<std::mutex> bloqueo(espera.cerrojo);
+    espera.listo.wait(bloqueo, [&espera]() { return espera.pendientes == 0; });
+}
+
+void SistemaFragmentado::sincronizar() {
+    ordenar(-1, [](Fragmento&) {});
+}
+
+void SistemaFragmentado::fijarCrearDesconocidos(bool crear) {
+    ordenar(-1, [crear](Fragmento& f) { f.ingesta.fijarCrearDesconocidos(crear); });
+}
+
+void SistemaFragmentado::fijarSegmentos(const char* directorio, int lecturasEnMemoria) {
+    ordenar(-1, [directorio, lecturasEnMemoria](Fragmento& f) {
+        f.ingesta.fijarSegmentos(directorio, lecturasEnMemoria);
+    });
+}
+
+void SistemaFragmentado::fijarReglas(MotorReglas* motor) {
+    ordenar(-1, [motor](Fragmento& f) { f.ingesta.fijarReglas(motor); });
+}
+
+void SistemaFragmentado::fijarIndiceExtremos(bool activo) {
+    ordenar(-1, [activo](Fragmento& f) { f.ingesta.fijarIndiceExtremos(activo); });
+}
+
+void SistemaFragmentado::fijarRetencion(const PoliticaRetencion& politica) {
+    ordenar(-1, [&politica](Fragmento& f) { f.ingesta.fijarRetencion(politica); });
+}
+
+void SistemaFragmentado::fijarResumenes(bool activo) {
+    ordenar(-1, [activo](Fragmento& f) { f.ingesta.fijarResumenes(activo); });
+}
+
+void SistemaFragmentado::ejecutarEn(int fragmento, const std::function<void(SistemaGestion&)>& tarea) {
+    if (fragmento < 0 || fragmento >= numFragmentos) return;
+    ordenar(fragmento, [&tarea](Fragmento& f) { tarea(f.sistema); });
+}
+
+void SistemaFragmentado::ejecutarEnTodos(const std::function<void(int, SistemaGestion&)>& tarea) {
+    ordenar(-1, [&tarea](Fragmento& f) { tarea(f.indice, f.sistema); });
+}
+
+bool SistemaFragmentado::agregarSensor(SensorBase* sensor) {
+    if (sensor == nullptr) {
+        REGISTRO_ERROR("[Error] No se puede agregar un sensor nulo.\n");
+        return false;
+    }
+    bool agregado = false;
+    ejecutarEn(fragmentoDe(sensor->obtenerNombre()), [sensor, &agregado](SistemaGestion& s) {
+        agregado = s.agregarSensor(sensor);
+    });
+    return agregado;
+}
+
+bool SistemaFragmentado::eliminarSensor(const char* nombre) {
+    bool eliminado = false;
+    ejecutarEn(fragmentoDe(nombre), [nombre, &eliminado](SistemaGestion& s) {
+        eliminado = s.eliminarSensor(nombre);
+    });
+    return eliminado;
+}
+
+bool SistemaFragmentado::consultarSensor(const char* nombre, const std::function<void(SensorBase*)>& visitar) {
+    bool encontrado = false;
+    ejecutarEn(fragmentoDe(nombre), [nombre, &visitar, &encontrado](SistemaGestion& s) {
+        SensorBase* sensor = s.buscarSensor(nombre);
+        if (sensor != nullptr) {
+            encontrado = true;
+            visitar(sensor);
+        }
+    });
+    return encontrado;
+}
+
+int SistemaFragmentado::obtenerCantidad() {
+    std::vector<int> cantidades(static_cast<std::size_t>(numFragmentos));
+    ejecutarEnTodos([&cantidades](int i, SistemaGestion& s) {
+        cantidades[static_cast<std::size_t>(i)] = s.obtenerCantidad();
+    });
+    int total = 0;
+    for (std::size_t i = 0; i < cantidades.size(); i++) {
+        total += cantidades[i];
+    }
+    return total;
+}
+
+EstadisticasIngesta SistemaFragmentado::obtenerEstadisticas() {
+    std::vector<EstadisticasIngesta> parciales(static_cast<std::size_t>(numFragmentos));
+    ordenar(-1, [&parciales](Fragmento& f) {
+        parciales[static_cast<std::size_t>(f.indice)] = f.ingesta.obtenerEstadisticas();
+    });
+
+    EstadisticasIngesta total;
+    total.descartadas = idsDescartados.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < parciales.size(); i++) {
+        total.lecturas += parciales[i].lecturas;
+        total.descartadas += parciales[i].descartadas;
+        total.sensoresCreados += parciales[i].sensoresCreados;
+    }
+    return total;
+}
+
+void SistemaFragmentado::combinarCuantiles(BosquejoCuantiles<float>& temperatura, BosquejoCuantiles<int>& presion) {
+    // Un fragmento tras otro: los bosquejos destino no admiten escrituras concurrentes
+    for (int i = 0; i < numFragmentos; i++) {
+        ejecutarEn(i, [&temperatura, &presion](SistemaGestion& s) { s.combinarCuantiles(temperatura, presion); });
+    }
+}
+
+void SistemaFragmentado::combinarUltimos(long long duracionMs, long long ahoraMs, ResumenVentana<float>& temperatura,
+                                         ResumenVentana<int>& presion) {
+    for (int i = 0; i < numFragmentos; i++) {
+        ejecutarEn(i, [duracionMs, ahoraMs, &temperatura, &presion](SistemaGestion& s) {
+            s.combinarUltimos(duracionMs, ahoraMs, temperatura, presion);
+        });
+    }
+}
+
+void SistemaFragmentado::procesarTodosSensores() {
+    std::cout << "\n========== Ejecutando Procesamiento Polimórfico ==========\n";
+
+    // Los sensores sin procesaEnParalelo() escriben en std::cout: en la pasada paralela solo
+    // se anota dónde caen en la salida de su fragmento
+    std::vector<std::string> salidas(static_cast<std::size_t>(numFragmentos));
+    std::vector<std::vector<std::size_t> > cortes(static_cast<std::size_t>(numFragmentos));
+    std::vector<int> cantidades(static_cast<std::size_t>(numFragmentos));
+    ejecutarEnTodos([&salidas, &cortes, &cantidades](int i, SistemaGestion& s) {
+        std::ostringstream salida;
+        std::vector<std::size_t>& corte = cortes[static_cast<std::size_t>(i)];
+        s.recorrerSensores([&salida, &corte](SensorBase* sensor) {
+            if (sensor->procesaEnParalelo()) {
+                sensor->procesarLectura(salida);
+            } else {
+                corte.push_back(static_cast<std::size_t>(salida.tellp()));
+            }
+        });
+        salidas[static_cast<std::size_t>(i)] = salida.str();
+        cantidades[static_cast<std::size_t>(i)] = s.obtenerCantidad();
+    });
+
+    int total = 0;
+    for (std::size_t i = 0; i < salidas.size(); i++) {
+        total += cantidades[i];
+        if (cortes[i].empty()) {
+            std::cout << salidas[i];
+            continue;
+        }
+        // Un fragmento cada vez, en su hilo: solo uno escribe en std::cout
+        const std::string& salida = salidas[i];
+        const std::vector<std::size_t>& corte = cortes[i];
+        ejecutarEn(static_cast<int>(i), [&salida, &corte](SistemaGestion& s) {
+            std::size_t emitido = 0;
+            std::size_t siguiente = 0;
+            s.recorrerSensores([&salida, &corte, &emitido, &siguiente](SensorBase* sensor) {
+                if (sensor->procesaEnParalelo() || siguiente == corte.size()) return;
+                std::cout.write(salida.data() + emitido, static_cast<std::streamsize>(corte[siguiente] - emitido));
+                emitido = corte[siguiente++];
+                sensor->procesarLectura();
+            });
+            std::cout.write(salida.data() + emitido, static_cast<std::streamsize>(salida.size() - emitido));
+        });
+    }
+    if (total == 0) {
+        std::cout << "[Sistema] No hay sensores registrados para procesar.\n";
+        return;
+    }
+
+    std::cout << "========== Procesamiento Completado ==========\n\n";
+}
+
+void SistemaFragmentado::mostrarTodosSensores() {
+    for (int i = 0; i < numFragmentos; i++) {
+        std::cout << "\n[Fragmentos] Fragmento " << i << ":";
+        ejecutarEn(i, [](SistemaGestion& s) { s.mostrarTodosSensores(); });
+    }
+}
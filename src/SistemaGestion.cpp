@@ -4,52 +4,125 @@
  */
 
 #include "SistemaGestion.h"
+#include "PoolHilos.h"
+#include "SensorTemperatura.h"
+#include "SensorPresion.h"
+#include "Registro.h"
+#include "Metricas.h"
 #include <iostream>
-#include <cstring>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
 
-SistemaGestion::SistemaGestion() : cabeza(nullptr) {
-    std::cout << "\n=== Sistema IoT de Monitoreo Polimórfico Iniciado ===\n\n";
+SistemaGestion::SistemaGestion(bool anunciar) : cabeza(nullptr), cola(nullptr), pool(nullptr), anunciar(anunciar) {
+    if (anunciar) std::cout << "\n=== Sistema IoT de Monitoreo Polimórfico Iniciado ===\n\n";
 }
 
 SistemaGestion::~SistemaGestion() {
-    std::cout << "\n--- Liberación de Memoria en Cascada ---\n";
+    if (anunciar) std::cout << "\n--- Liberación de Memoria en Cascada ---\n";
     liberarSistema();
-    std::cout << "Sistema cerrado. Memoria limpia.\n";
+    delete pool;
+    if (anunciar) std::cout << "Sistema cerrado. Memoria limpia.\n";
 }
 
-void SistemaGestion::agregarSensor(SensorBase* sensor) {
+bool SistemaGestion::agregarSensor(SensorBase* sensor) {
     if (sensor == nullptr) {
-        std::cout << "[Error] No se puede agregar un sensor nulo.\n";
-        return;
+        REGISTRO_ERROR("[Error] No se puede agregar un sensor nulo.\n");
+        return false;
     }
     
-    NodoGestion* nuevo = new NodoGestion(sensor);
+    NodoGestion* nuevo = nodos.crear(sensor);
+    if (!indice.insertar(nuevo)) {
+        REGISTRO_ERROR("[Error] Ya existe un sensor '" << sensor->obtenerNombre() << "'.\n");
+        nodos.destruir(nuevo);
+        return false;
+    }
     
     if (cabeza == nullptr) {
         cabeza = nuevo;
     } else {
-        NodoGestion* actual = cabeza;
-        while (actual->siguiente != nullptr) {
-            actual = actual->siguiente;
-        }
-        actual->siguiente = nuevo;
+        cola->siguiente = nuevo;
+        nuevo->anterior = cola;
     }
+    cola = nuevo;
+    particionar(nuevo);
+    METRICA_AJUSTAR(INDICADOR_SENSORES, 1);
     
-    std::cout << "[Sistema] Sensor '" << sensor->obtenerNombre() 
-              << "' agregado a la lista de gestión.\n";
+    REGISTRO_INFO("[Sistema] Sensor '" << sensor->obtenerNombre() 
+                  << "' agregado a la lista de gestión.\n");
+    return true;
 }
 
-SensorBase* SistemaGestion::buscarSensor(const char* nombre) {
-    NodoGestion* actual = cabeza;
+bool SistemaGestion::eliminarSensor(const char* nombre) {
+    NodoGestion* nodo = indice.eliminar(nombre);
+    if (nodo == nullptr) {
+        return false;
+    }
     
-    while (actual != nullptr) {
-        if (strcmp(actual->sensor->obtenerNombre(), nombre) == 0) {
-            return actual->sensor;
-        }
-        actual = actual->siguiente;
+    if (nodo->anterior == nullptr) {
+        cabeza = nodo->siguiente;
+    } else {
+        nodo->anterior->siguiente = nodo->siguiente;
+    }
+    if (nodo->siguiente == nullptr) {
+        cola = nodo->anterior;
+    } else {
+        nodo->siguiente->anterior = nodo->anterior;
     }
     
-    return nullptr;
+    desparticionar(nodo);
+    METRICA_AJUSTAR(INDICADOR_SENSORES, -1);
+    
+    REGISTRO_INFO("[Sistema] Sensor '" << nombre << "' eliminado de la lista de gestión.\n");
+    delete nodo->sensor;
+    nodos.destruir(nodo);
+    return true;
+}
+
+void SistemaGestion::particionar(NodoGestion* nodo) {
+    // typeid y no dynamic_cast: una subclase puede redefinir procesarLectura()
+    const std::type_info& tipo = typeid(*nodo->sensor);
+    if (tipo == typeid(SensorTemperatura)) {
+        nodo->tipo = SENSOR_TEMPERATURA;
+        temperaturas.agregar(static_cast<SensorTemperatura*>(nodo->sensor), nodo);
+    } else if (tipo == typeid(SensorPresion)) {
+        nodo->tipo = SENSOR_PRESION;
+        presiones.agregar(static_cast<SensorPresion*>(nodo->sensor), nodo);
+    } else {
+        nodo->tipo = SENSOR_OTRO;
+        otros.agregar(nodo->sensor, nodo);
+    }
+}
+
+void SistemaGestion::desparticionar(NodoGestion* nodo) {
+    switch (nodo->tipo) {
+    case SENSOR_TEMPERATURA:
+        temperaturas.quitar(nodo);
+        break;
+    case SENSOR_PRESION:
+        presiones.quitar(nodo);
+        break;
+    case SENSOR_OTRO:
+        otros.quitar(nodo);
+        break;
+    }
+}
+
+int SistemaGestion::obtenerCantidad() const {
+    return indice.obtenerCantidad();
+}
+
+SensorBase* SistemaGestion::buscarSensor(const char* nombre) {
+    METRICA_CRONOMETRAR(HISTOGRAMA_BUSCAR, 1024);
+    NodoGestion* nodo = indice.buscar(nombre);
+    return nodo != nullptr ? nodo->sensor : nullptr;
+}
+
+SensorBase* SistemaGestion::buscarSensor(const char* nombre, int longitud) {
+    METRICA_CRONOMETRAR(HISTOGRAMA_BUSCAR, 1024);
+    NodoGestion* nodo = indice.buscar(nombre, longitud);
+    return nodo != nullptr ? nodo->sensor : nullptr;
 }
 
 void SistemaGestion::procesarTodosSensores() {
@@ -60,17 +133,137 @@ void SistemaGestion::procesarTodosSensores() {
         return;
     }
     
-    NodoGestion* actual = cabeza;
-    
-    while (actual != nullptr) {
-        // Polimorfismo: llama al método correcto según el tipo real del objeto
-        actual->sensor->procesarLectura();
-        actual = actual->siguiente;
+    {
+        METRICA_CRONOMETRAR(HISTOGRAMA_CICLO, 1);
+        if (pool != nullptr) {
+            procesarEnParalelo();
+        } else {
+            for (NodoGestion* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+                // La partición del nodo da el tipo exacto: llamada calificada sin tabla virtual.
+                // Los tipos del usuario usan el polimorfismo
+                switch (actual->tipo) {
+                case SENSOR_TEMPERATURA:
+                    static_cast<SensorTemperatura*>(actual->sensor)->SensorTemperatura::procesarLectura(std::cout);
+                    break;
+                case SENSOR_PRESION:
+                    static_cast<SensorPresion*>(actual->sensor)->SensorPresion::procesarLectura(std::cout);
+                    break;
+                default:
+                    actual->sensor->procesarLectura();
+                    break;
+                }
+            }
+        }
     }
+    publicarLecturasEnMemoria();
     
     std::cout << "========== Procesamiento Completado ==========\n\n";
 }
 
+void SistemaGestion::procesarEnParalelo() {
+    std::vector<SensorBase*> sensores;
+    sensores.reserve(static_cast<std::size_t>(obtenerCantidad()));
+    for (NodoGestion* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+        sensores.push_back(actual->sensor);
+    }
+
+    // Los historiales comparten la arena: en modo concurrente las liberaciones se difieren
+    // sin cerrojo y vuelven a las listas libres en este hilo al terminar la pasada
+    std::vector<std::string> salidas(sensores.size());
+    arena.fijarConcurrente(true);
+    pool->paraCada(static_cast<int>(sensores.size()), [&sensores, &salidas](int i) {
+        if (!sensores[i]->procesaEnParalelo()) return;
+        std::ostringstream salida;
+        sensores[i]->procesarLectura(salida);
+        salidas[i] = salida.str();
+    });
+    arena.fijarConcurrente(false);
+
+    // Los que escriben en std::cout se procesan aquí, en su turno
+    for (std::size_t i = 0; i < salidas.size(); i++) {
+        if (sensores[i]->procesaEnParalelo()) {
+            std::cout << salidas[i];
+        } else {
+            sensores[i]->procesarLectura();
+        }
+    }
+}
+
+void SistemaGestion::procesarPorTipo(std::ostream& salida) {
+    {
+        METRICA_CRONOMETRAR(HISTOGRAMA_CICLO, 1);
+        SensorTemperatura::procesarLote(temperaturas.obtenerSensores(), temperaturas.obtenerCantidad(), salida);
+        SensorPresion::procesarLote(presiones.obtenerSensores(), presiones.obtenerCantidad(), salida);
+        otros.paraCada([&salida](SensorBase* sensor) {
+            sensor->procesarLectura(salida);
+        });
+    }
+    publicarLecturasEnMemoria();
+}
+
+void SistemaGestion::publicarLecturasEnMemoria() const {
+#ifdef SISTEMA_IOT_METRICAS
+    // Solo los tipos conocidos exponen su historial; recorrer las particiones es barato
+    long long lecturas = 0;
+    temperaturas.paraCada([&lecturas](const SensorTemperatura* t) {
+        lecturas += t->obtenerCantidadLecturas();
+    });
+    presiones.paraCada([&lecturas](const SensorPresion* p) {
+        lecturas += p->obtenerCantidadLecturas();
+    });
+    METRICA_FIJAR(INDICADOR_LECTURAS_MEMORIA, lecturas);
+#endif
+}
+
+void SistemaGestion::fijarHilosProcesamiento(int hilos) {
+    delete pool;
+    pool = hilos == 1 ? nullptr : new PoolHilos(hilos);
+    REGISTRO_INFO("[Sistema] Procesamiento con " << obtenerHilosProcesamiento() << " hilo(s).\n");
+}
+
+int SistemaGestion::obtenerHilosProcesamiento() const {
+    return pool != nullptr ? pool->obtenerHilos() : 1;
+}
+
+void SistemaGestion::combinarCuantiles(BosquejoCuantiles<float>& temperatura,
+                                       BosquejoCuantiles<int>& presion) const {
+    temperaturas.paraCada([&temperatura](const SensorTemperatura* t) {
+        temperatura.combinar(t->obtenerCuantiles());
+    });
+    presiones.paraCada([&presion](const SensorPresion* p) {
+        presion.combinar(p->obtenerCuantiles());
+    });
+    // Subclases de los sensores conocidos registradas como tipos propios
+    otros.paraCada([&temperatura, &presion](const SensorBase* sensor) {
+        if (const SensorTemperatura* t = dynamic_cast<const SensorTemperatura*>(sensor)) {
+            temperatura.combinar(t->obtenerCuantiles());
+        } else if (const SensorPresion* p = dynamic_cast<const SensorPresion*>(sensor)) {
+            presion.combinar(p->obtenerCuantiles());
+        }
+    });
+}
+
+void SistemaGestion::combinarUltimos(long long duracionMs, long long ahoraMs, ResumenVentana<float>& temperatura,
+                                     ResumenVentana<int>& presion) const {
+    temperaturas.paraCada([duracionMs, ahoraMs, &temperatura](const SensorTemperatura* t) {
+        ResumenVentana<float> r = t->consultarUltimos(duracionMs, ahoraMs);
+        temperatura.combinar(r.cantidad, r.suma, r.minimo, r.maximo);
+    });
+    presiones.paraCada([duracionMs, ahoraMs, &presion](const SensorPresion* p) {
+        ResumenVentana<int> r = p->consultarUltimos(duracionMs, ahoraMs);
+        presion.combinar(r.cantidad, r.suma, r.minimo, r.maximo);
+    });
+    otros.paraCada([duracionMs, ahoraMs, &temperatura, &presion](const SensorBase* sensor) {
+        if (const SensorTemperatura* t = dynamic_cast<const SensorTemperatura*>(sensor)) {
+            ResumenVentana<float> r = t->consultarUltimos(duracionMs, ahoraMs);
+            temperatura.combinar(r.cantidad, r.suma, r.minimo, r.maximo);
+        } else if (const SensorPresion* p = dynamic_cast<const SensorPresion*>(sensor)) {
+            ResumenVentana<int> r = p->consultarUltimos(duracionMs, ahoraMs);
+            presion.combinar(r.cantidad, r.suma, r.minimo, r.maximo);
+        }
+    });
+}
+
 void SistemaGestion::mostrarTodosSensores() const {
     std::cout << "\n========== Sensores Registrados ==========\n";
     
@@ -93,20 +286,36 @@ void SistemaGestion::mostrarTodosSensores() const {
 }
 
 void SistemaGestion::liberarSistema() {
+    // Los historiales no devuelven sus nodos uno a uno: la arena se reinicia al final
+    arena.fijarDesmontaje(true);
     NodoGestion* actual = cabeza;
     
     while (actual != nullptr) {
         NodoGestion* siguiente = actual->siguiente;
         
-        std::cout << "[Destructor General] Liberando Nodo: " 
-                  << actual->sensor->obtenerNombre() << "\n";
+        REGISTRO_INFO("[Destructor General] Liberando Nodo: " 
+                      << actual->sensor->obtenerNombre() << "\n");
         
         // Destructor virtual asegura llamada correcta al destructor de la subclase
         delete actual->sensor;
-        delete actual;
         
         actual = siguiente;
     }
     
+    // NodoGestion es trivial: los nodos y los historiales se devuelven en bloque
+    nodos.liberarTodo();
+    arena.reiniciar();
+    arena.fijarDesmontaje(false);
+    
+    METRICA_AJUSTAR(INDICADOR_SENSORES, -static_cast<long long>(indice.obtenerCantidad()));
+    indice.vaciar();
+    temperaturas.vaciar();
+    presiones.vaciar();
+    otros.vaciar();
     cabeza = nullptr;
+    cola = nullptr;
+}
+
+ArenaMemoria* SistemaGestion::obtenerArena() {
+    return &arena;
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+/**
+ * @file SumaVerificacion.cpp
+ * @brief Implementación del CRC-32C (SSE4.2 o tabla)
+ */
+
+#include "SumaVerificacion.h"
+#include <cstring>
+
+#if defined(SISTEMA_IOT_SIMD) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CRC_X86 1
+#include <nmmintrin.h>
+#endif
+
+namespace {
+
+const uint32_t POLINOMIO = 0x82F63B78u;  ///< Castagnoli, forma reflejada
+
+/**
+ * @brief Tabla de la versión por bytes (se construye una sola vez)
+ */
+struct TablaCrc {
+    uint32_t valores[256];
+
+    TablaCrc() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int k = 0; k < 8; k++) {
+                crc = (crc & 1u) ? (crc >> 1) ^ POLINOMIO : crc >> 1;
+            }
+            valores[i] = crc;
+        }
+    }
+};
+
+uint32_t crcTabla(const unsigned char* p, std::size_t n, uint32_t crc) {
+    static const TablaCrc tabla;
+    for (std::size_t i = 0; i < n; i++) {
+        crc = tabla.valores[(crc ^ p[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef CRC_X86
+
+__attribute__((target("sse4.2")))
+uint32_t crcSse42(const unsigned char* p, std::size_t n, uint32_t crc) {
+    uint64_t acumulado = crc;
+    while (n >= 8) {
+        uint64_t palabra;
+        std::memcpy(&palabra, p, 8);
+        acumulado = _mm_crc32_u64(acumulado, palabra);
+        p += 8;
+        n -= 8;
+    }
+    uint32_t resto = static_cast<uint32_t>(acumulado);
+    while (n > 0) {
+        resto = _mm_crc32_u8(resto, *p++);
+        n--;
+    }
+    return resto;
+}
+
+/**
+ * @brief true si la CPU soporta SSE4.2 (se consulta una sola vez)
+ */
+bool usarSse42() {
+    static const bool disponible = (__builtin_cpu_init(), __builtin_cpu_supports("sse4.2") != 0);
+    return disponible;
+}
+
+#endif // CRC_X86
+
+}  // namespace
+
+uint32_t calcularCrc32c(const void* datos, std::size_t longitud, uint32_t previo) {
+    const unsigned char* p = static_cast<const unsigned char*>(datos);
+    uint32_t crc = ~previo;
+#ifdef CRC_X86
+    if (usarSse42()) {
+        return ~crcSse42(p, longitud, crc);
+    }
+#endif
+    return ~crcTabla(p, longitud, crc);
+}
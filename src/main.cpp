@@ -5,15 +5,605 @@
  */
 
 #include "SistemaGestion.h"
+#include "SistemaFragmentado.h"
 #include "SensorTemperatura.h"
 #include "SensorPresion.h"
+#include "IngestaLecturas.h"
+#include "ServidorIngesta.h"
+#include "Instantanea.h"
+#include "Metricas.h"
+#include "MotorReglas.h"
+#include "PlanificadorSensores.h"
+#include "ResumenTemporal.h"
+#include "Registro.h"
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Opciones del modo de ingesta
+ */
+struct OpcionesIngesta {
+    const char* fuente;     ///< Puerto serie, pty o archivo de captura; "-" para stdin
+    int hilos;              ///< Hilos de procesamiento (1 = secuencial, 0 = uno por núcleo)
+    int fragmentos;         ///< Fragmentos de gestión (1 = ninguno, 0 = uno por núcleo)
+    const char* restaurar;  ///< Instantánea a cargar antes de ingerir (nullptr = ninguna)
+    const char* guardar;    ///< Instantánea a escribir al terminar (nullptr = ninguna)
+    const char* segmentos;  ///< Directorio de segmentos de los sensores nuevos (nullptr = solo memoria)
+    const char* metricas;   ///< Archivo Prometheus exportado cada segundo (nullptr = ninguno)
+    const char* reglas;     ///< Archivo de reglas de alerta (nullptr = ninguna)
+    bool binario;           ///< Aceptar tramas binarias además del texto
+    int retencion;          ///< Lecturas retenidas por sensor (0 = sin acotar)
+    int edadMaxima;         ///< ms de antigüedad máxima con retención (0 = sin límite)
+    int diezmado;           ///< Factor de submuestreo de las lecturas antiguas con retención (1 = descartar)
+    int resumenes;          ///< ms de la ventana resumida al terminar (0 = sin resúmenes)
+    int cola;               ///< Capacidad de la cola de cada sensor restaurado (0 = registro directo)
+};
+
+/**
+ * @brief Contadores de las alertas consumidas
+ */
+struct ResumenAlertas {
+    long long activadas;  ///< Reglas que empezaron a cumplirse
+    long long resueltas;  ///< Reglas que dejaron de cumplirse
+};
+
+/**
+ * @brief Drena y registra las alertas pendientes del motor
+ * @return Alertas drenadas
+ */
+static int registrarAlertas(MotorReglas& motor, ResumenAlertas& resumen) {
+    EventoAlerta alertas[256];
+    int total = 0;
+    int n;
+    while ((n = motor.drenarAlertas(alertas, 256)) > 0) {
+        for (int i = 0; i < n; i++) {
+            const EventoAlerta& a = alertas[i];
+            if (a.activa) {
+                resumen.activadas++;
+                REGISTRO_AVISO("[Alerta] " << a.sensor << ": " << motor.obtenerNombreRegla(a.regla) << " ("
+                               << motor.obtenerCondicion(a.regla) << ") activada, valor " << a.valor << "\n");
+            } else {
+                resumen.resueltas++;
+                REGISTRO_AVISO("[Alerta] " << a.sensor << ": " << motor.obtenerNombreRegla(a.regla)
+                               << " resuelta, valor " << a.valor << "\n");
+            }
+        }
+        total += n;
+    }
+    return total;
+}
+
+/**
+ * @brief Espera a que el sistema haya registrado todas las lecturas despachadas
+ * @details Un SistemaGestion las registra al despacharlas: no hay nada que esperar
+ */
+static void esperarRegistro(SistemaGestion&) {}
+
+static void esperarRegistro(SistemaFragmentado& sistema) {
+    sistema.sincronizar();
+}
+
+/**
+ * @brief Completa los contadores de la ingesta con los del sistema
+ * @details Con fragmentos, lecturas, descartadas y sensores creados se cuentan en ellos
+ */
+static void completarEstadisticas(SistemaGestion&, EstadisticasIngesta&) {}
+
+static void completarEstadisticas(SistemaFragmentado& sistema, EstadisticasIngesta& e) {
+    EstadisticasIngesta f = sistema.obtenerEstadisticas();
+    e.lecturas = f.lecturas;
+    e.descartadas += f.descartadas;
+    e.sensoresCreados = f.sensoresCreados;
+}
+
+/**
+ * @brief Aplica las lecturas encoladas de todos los sensores
+ * @return Lecturas aplicadas
+ * @details Consumidor único de las colas; con fragmentos no hay colas (ejecutarIngesta() rechaza --cola)
+ */
+static int aplicarPendientes(SistemaGestion& sistema) {
+    int total = 0;
+    sistema.recorrerTemperaturas([&total](SensorTemperatura* s) { total += s->aplicarPendientes(); });
+    sistema.recorrerPresiones([&total](SensorPresion* s) { total += s->aplicarPendientes(); });
+    return total;
+}
+
+static int aplicarPendientes(SistemaFragmentado&) {
+    return 0;
+}
+
+static bool guardarInstantanea(SistemaGestion& sistema, const char* archivo) {
+    return Instantanea::guardar(sistema, archivo);
+}
+
+static bool guardarInstantanea(SistemaFragmentado&, const char*) {
+    // ejecutarIngesta() rechaza antes --guardar con fragmentos
+    return false;
+}
+
+/**
+ * @brief Ingesta la fuente en un sistema ya preparado y procesa los sensores resultantes
+ * @tparam Sistema SistemaGestion o SistemaFragmentado
+ * @return 0 si la fuente se leyó completa, 1 en caso de error
+ */
+template <typename Sistema>
+static int ingerir(Sistema& sistema, MotorReglas& motor, const OpcionesIngesta& opciones) {
+    IngestaLecturas ingesta(sistema);
+    ingesta.fijarSegmentos(opciones.segmentos);
+    ingesta.fijarProtocoloBinario(opciones.binario);
+    if (opciones.reglas != nullptr) {
+        ingesta.fijarReglas(&motor);
+    }
+    if (opciones.retencion > 0) {
+        ingesta.fijarRetencion(PoliticaRetencion(opciones.retencion, opciones.edadMaxima, opciones.diezmado));
+    }
+    ingesta.fijarResumenes(opciones.resumenes > 0);
+    ingesta.fijarModoCola(opciones.cola > 0);
+    if (!ingesta.abrir(opciones.fuente)) {
+        return 1;
+    }
+
+    // Durante la ingesta el registro va al búfer asíncrono: la ruta caliente no espera a
+    // std::cout. Se vuelve al modo síncrono antes del resumen para no mezclarlo
+    Registro::iniciarAsincrono();
+
+    // Las alertas se registran desde otro hilo mientras la ingesta avanza
+    ResumenAlertas alertas = {0, 0};
+    std::atomic<bool> ingestaTerminada(false);
+    std::thread consumidor;
+    if (opciones.reglas != nullptr) {
+        consumidor = std::thread([&motor, &alertas, &ingestaTerminada]() {
+            while (!ingestaTerminada.load(std::memory_order_acquire)) {
+                if (registrarAlertas(motor, alertas) == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        });
+    }
+    // Con --cola, otro hilo vacía las colas de los sensores al historial
+    std::thread aplicador;
+    if (opciones.cola > 0) {
+        aplicador = std::thread([&sistema, &ingestaTerminada]() {
+            while (!ingestaTerminada.load(std::memory_order_acquire)) {
+                if (aplicarPendientes(sistema) == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        });
+    }
+    bool completa = ingesta.procesarFuente();
+    esperarRegistro(sistema);
+    ingestaTerminada.store(true, std::memory_order_release);
+    if (aplicador.joinable()) {
+        aplicador.join();
+        while (aplicarPendientes(sistema) > 0) {
+        }
+    }
+    if (consumidor.joinable()) {
+        consumidor.join();
+        registrarAlertas(motor, alertas);
+    }
+    Registro::detenerAsincrono();
+
+    EstadisticasIngesta e = ingesta.obtenerEstadisticas();
+    completarEstadisticas(sistema, e);
+    std::cout << "\n[Ingesta] Líneas: " << e.lineas << ", lecturas: " << e.lecturas
+              << ", ignoradas: " << e.ignoradas << ", inválidas: " << e.invalidas
+              << ", descartadas: " << e.descartadas
+              << ", sensores creados: " << e.sensoresCreados << "\n";
+    if (opciones.binario) {
+        std::cout << "[Ingesta] Tramas binarias: " << e.tramas << ", inválidas: " << e.tramasInvalidas << "\n";
+    }
+
+    // Cuantiles de toda la flota: se combinan los bosquejos de cada sensor
+    BosquejoCuantiles<float> temperaturas;
+    BosquejoCuantiles<int> presiones;
+    sistema.combinarCuantiles(temperaturas, presiones);
+    const double q[3] = {0.50, 0.95, 0.99};
+    if (temperaturas.obtenerCantidad() > 0) {
+        float t[3];
+        temperaturas.cuantiles(q, t, 3);
+        std::cout << "[Ingesta] Temperatura p50/p95/p99: " << t[0] << " / " << t[1] << " / " << t[2] << "\n";
+    }
+    if (presiones.obtenerCantidad() > 0) {
+        int p[3];
+        presiones.cuantiles(q, p, 3);
+        std::cout << "[Ingesta] Presión p50/p95/p99: " << p[0] << " / " << p[1] << " / " << p[2] << "\n";
+    }
+    if (opciones.resumenes > 0) {
+        // Agregados de la última ventana, combinados desde los resúmenes de cada sensor
+        ResumenVentana<float> t;
+        ResumenVentana<int> p;
+        sistema.combinarUltimos(opciones.resumenes, milisegundosMonotonos(), t, p);
+        std::cout << "[Ingesta] Temperatura últimos " << opciones.resumenes << " ms: " << t.cantidad
+                  << " lecturas, promedio " << t.promedio() << ", mín " << t.minimo << ", máx " << t.maximo << "\n";
+        std::cout << "[Ingesta] Presión últimos " << opciones.resumenes << " ms: " << p.cantidad
+                  << " lecturas, promedio " << p.promedio() << ", mín " << p.minimo << ", máx " << p.maximo << "\n";
+    }
+    if (opciones.reglas != nullptr) {
+        std::cout << "[Reglas] Alertas activadas: " << alertas.activadas << ", resueltas: " << alertas.resueltas
+                  << ", perdidas: " << motor.obtenerPerdidas() << "\n";
+    }
+
+    if (opciones.guardar != nullptr && !guardarInstantanea(sistema, opciones.guardar)) {
+        completa = false;
+    }
+
+    sistema.mostrarTodosSensores();
+    sistema.procesarTodosSensores();
+    if (opciones.metricas != nullptr) {
+        // Última exportación con el ciclo de procesamiento incluido
+        Metricas::detenerExportacion();
+    }
+    return completa ? 0 : 1;
+}
+
+/**
+ * @brief Ingesta las lecturas de una fuente y procesa los sensores resultantes
+ * @param opciones Fuente, hilos, fragmentos, instantáneas, segmentos, métricas y reglas
+ * @return 0 si la fuente se leyó completa, 1 en caso de error
+ */
+static int ejecutarIngesta(const OpcionesIngesta& opciones) {
+    if (opciones.metricas != nullptr) {
+        if (!Metricas::habilitadas()) {
+            REGISTRO_AVISO("[Métricas] Compilado sin SISTEMA_IOT_METRICAS: los valores serán cero.\n");
+        }
+        Metricas::iniciarExportacion(opciones.metricas, 1000);
+    }
+
+    if (opciones.retencion == 0 && (opciones.edadMaxima > 0 || opciones.diezmado > 1)) {
+        REGISTRO_ERROR("[Error] --edad-maxima y --diezmado requieren --retencion.\n");
+        return 1;
+    }
+    if (opciones.retencion > 0 && opciones.segmentos != nullptr) {
+        REGISTRO_ERROR("[Error] La retención no admite segmentos (--retencion/--segmentos).\n");
+        return 1;
+    }
+    if (opciones.cola > 0 && (opciones.restaurar == nullptr || opciones.fragmentos != 1)) {
+        // En modo cola no se crean sensores y el registro no admite cambios concurrentes
+        REGISTRO_ERROR("[Error] --cola requiere --restaurar y no admite fragmentos.\n");
+        return 1;
+    }
+
+    // Declarado antes que el sistema: los sensores lo usan hasta su destrucción
+    MotorReglas motor;
+
+    if (opciones.fragmentos != 1) {
+        if (opciones.restaurar != nullptr || opciones.guardar != nullptr) {
+            REGISTRO_ERROR("[Error] Las instantáneas no admiten fragmentos (--restaurar/--guardar).\n");
+            return 1;
+        }
+        if (opciones.reglas != nullptr && !motor.cargar(opciones.reglas)) {
+            return 1;
+        }
+        SistemaFragmentado sistema(opciones.fragmentos);
+        return ingerir(sistema, motor, opciones);
+    }
+
+    SistemaGestion sistema;
+    sistema.fijarHilosProcesamiento(opciones.hilos);
+    if (opciones.restaurar != nullptr && !Instantanea::restaurar(sistema, opciones.restaurar)) {
+        return 1;
+    }
+
+    if (opciones.reglas != nullptr) {
+        if (!motor.cargar(opciones.reglas)) {
+            return 1;
+        }
+        sistema.recorrerTemperaturas([&motor](SensorTemperatura* s) { s->fijarReglas(&motor); });
+        sistema.recorrerPresiones([&motor](SensorPresion* s) { s->fijarReglas(&motor); });
+    }
+    // Los sensores restaurados reciben lo mismo que IngestaLecturas aplica a los que crea
+    if (opciones.retencion > 0) {
+        PoliticaRetencion politica(opciones.retencion, opciones.edadMaxima, opciones.diezmado);
+        sistema.recorrerTemperaturas([&politica](SensorTemperatura* s) { s->fijarRetencion(politica); });
+        sistema.recorrerPresiones([&politica](SensorPresion* s) { s->fijarRetencion(politica); });
+    }
+    if (opciones.resumenes > 0) {
+        sistema.recorrerTemperaturas([](SensorTemperatura* s) { s->activarResumenes(); });
+        sistema.recorrerPresiones([](SensorPresion* s) { s->activarResumenes(); });
+    }
+    if (opciones.cola > 0) {
+        std::size_t capacidad = static_cast<std::size_t>(opciones.cola);
+        sistema.recorrerTemperaturas([capacidad](SensorTemperatura* s) { s->activarCola(capacidad); });
+        sistema.recorrerPresiones([capacidad](SensorPresion* s) { s->activarCola(capacidad); });
+    }
+    return ingerir(sistema, motor, opciones);
+}
+
+/**
+ * @brief Opciones del modo servidor
+ */
+struct OpcionesServidor {
+    int puerto;                         ///< Puerto TCP local (-1 = no escuchar)
+    std::vector<const char*> fuentes;   ///< Puertos serie, ptys o FIFOs adicionales
+    int hilos;                          ///< Hilos de procesamiento al terminar
+    int fragmentos;                     ///< Fragmentos de gestión (1 = ninguno, 0 = uno por núcleo)
+    const char* segmentos;              ///< Directorio de segmentos de los sensores nuevos
+    const char* metricas;               ///< Archivo Prometheus exportado cada segundo
+    int periodoTemperatura;             ///< ms entre procesamientos de cada sensor de temperatura (0 = solo al terminar)
+    int periodoPresion;                 ///< ms entre procesamientos de cada sensor de presión (0 = solo al terminar)
+    bool binario;                       ///< Aceptar tramas binarias además del texto
+};
+
+/// Milisegundos por tick de la rueda de procesamiento del servidor
+static const int MS_POR_TICK = 100;
+
+/// Servidor en ejecución, para detenerlo desde el manejador de señales
+static ServidorIngesta* servidorActivo = nullptr;
+
+static void detenerServidor(int) {
+    if (servidorActivo != nullptr) servidorActivo->detener();
+}
+
+/**
+ * @brief Atiende las conexiones con un sistema ya preparado y procesa sus sensores
+ * @tparam Sistema SistemaGestion o SistemaFragmentado
+ * @return 0 si el bucle terminó sin errores, 1 en caso contrario
+ */
+template <typename Sistema>
+static int servir(Sistema& sistema, const OpcionesServidor& opciones) {
+    ServidorIngesta servidor(sistema);
+    servidor.obtenerIngesta().fijarSegmentos(opciones.segmentos);
+    servidor.obtenerIngesta().fijarProtocoloBinario(opciones.binario);
+    PlanificadorSensores planificador;
+    if (opciones.periodoTemperatura > 0 || opciones.periodoPresion > 0) {
+        // Periodos en ticks, redondeados hacia arriba (0 = ese tipo no se programa)
+        unsigned temperatura = opciones.periodoTemperatura > 0 ? (opciones.periodoTemperatura + MS_POR_TICK - 1) / MS_POR_TICK : 0;
+        unsigned presion = opciones.periodoPresion > 0 ? (opciones.periodoPresion + MS_POR_TICK - 1) / MS_POR_TICK : 0;
+        servidor.obtenerIngesta().fijarPlanificador(&planificador, temperatura, presion);
+        servidor.fijarPlanificador(&planificador, MS_POR_TICK);
+    }
+    if (opciones.puerto >= 0 && !servidor.escuchar(opciones.puerto)) {
+        return 1;
+    }
+    for (std::size_t i = 0; i < opciones.fuentes.size(); i++) {
+        if (!servidor.agregarFuente(opciones.fuentes[i])) {
+            return 1;
+        }
+    }
+
+    servidorActivo = &servidor;
+    signal(SIGINT, detenerServidor);
+    signal(SIGTERM, detenerServidor);
+    Registro::iniciarAsincrono();
+    bool correcto = servidor.ejecutar();
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    servidorActivo = nullptr;
+    esperarRegistro(sistema);
+    Registro::detenerAsincrono();
+
+    const EstadisticasServidor& s = servidor.obtenerEstadisticas();
+    EstadisticasIngesta e = servidor.obtenerIngesta().obtenerEstadisticas();
+    completarEstadisticas(sistema, e);
+    std::cout << "\n[Servidor] Conexiones aceptadas: " << s.conexionesAceptadas
+              << ", cerradas: " << s.conexionesCerradas
+              << ", abiertas: " << servidor.obtenerConexionesAbiertas()
+              << ", bytes: " << s.bytes << ", rondas: " << s.rondas
+              << ", líneas largas: " << s.lineasLargas << "\n";
+    std::cout << "[Ingesta] Líneas: " << e.lineas << ", lecturas: " << e.lecturas
+              << ", ignoradas: " << e.ignoradas << ", inválidas: " << e.invalidas
+              << ", descartadas: " << e.descartadas
+              << ", sensores creados: " << e.sensoresCreados << "\n";
+    if (opciones.binario) {
+        std::cout << "[Ingesta] Tramas binarias: " << e.tramas << ", inválidas: " << e.tramasInvalidas << "\n";
+    }
+
+    sistema.procesarTodosSensores();
+    if (opciones.metricas != nullptr) {
+        Metricas::detenerExportacion();
+    }
+    return correcto ? 0 : 1;
+}
+
+/**
+ * @brief Atiende muchas conexiones de dispositivos en un bucle epoll hasta SIGINT/SIGTERM
+ * @param opciones Puerto, fuentes, hilos, fragmentos, segmentos, métricas y periodos
+ * @return 0 si el bucle terminó sin errores, 1 en caso contrario
+ * @details Sin puerto, termina al cerrarse todas las fuentes. Con fragmentos, el bucle solo
+ * analiza y los hilos de los fragmentos registran las lecturas. Con periodos, el bucle
+ * procesa cada sensor creado cuando le vence el suyo, en ticks de MS_POR_TICK
+ */
+static int ejecutarServidor(const OpcionesServidor& opciones) {
+    if (opciones.fragmentos != 1 && (opciones.periodoTemperatura > 0 || opciones.periodoPresion > 0)) {
+        REGISTRO_ERROR("[Error] Los periodos de procesamiento no admiten fragmentos (--periodo-temperatura/--periodo-presion).\n");
+        return 1;
+    }
+    if (opciones.metricas != nullptr) {
+        Metricas::iniciarExportacion(opciones.metricas, 1000);
+    }
+
+    if (opciones.fragmentos != 1) {
+        SistemaFragmentado sistema(opciones.fragmentos);
+        return servir(sistema, opciones);
+    }
+
+    SistemaGestion sistema;
+    sistema.fijarHilosProcesamiento(opciones.hilos);
+    return servir(sistema, opciones);
+}
+
+/**
+ * @brief Muestra la forma de invocar el programa
+ * @param programa Nombre con el que se invocó
+ */
+static void mostrarUso(const char* programa) {
+    std::cerr << "Uso: " << programa << "\n"
+              << "     " << programa << " --ingesta <fuente|-> [--hilos n] [--fragmentos n] [--restaurar archivo]\n"
+              << "         [--guardar archivo] [--segmentos directorio] [--metricas archivo.prom] [--reglas archivo]\n"
+              << "         [--protocolo texto|binario] [--retencion n [--edad-maxima ms] [--diezmado f]]\n"
+              << "         [--resumenes ms] [--cola capacidad]\n"
+              << "     " << programa << " --servidor <puerto|-> [--fuente ruta]... [--hilos n] [--fragmentos n]\n"
+              << "         [--segmentos directorio] [--metricas archivo.prom] [--periodo-temperatura ms]\n"
+              << "         [--periodo-presion ms] [--protocolo texto|binario]\n";
+}
+
+/**
+ * @brief Interpreta el valor entero de una opción
+ * @param texto Valor tal como llegó en argv
+ * @param minimo Menor valor admitido
+ * @param maximo Mayor valor admitido
+ * @param valor Destino del valor si es válido
+ * @return false si el texto no es un entero completo dentro del rango
+ */
+static bool leerEntero(const char* texto, long minimo, long maximo, int& valor) {
+    char* fin = nullptr;
+    errno = 0;
+    long leido = strtol(texto, &fin, 10);
+    if (fin == texto || *fin != '\0' || errno != 0 || leido < minimo || leido > maximo) {
+        return false;
+    }
+    valor = static_cast<int>(leido);
+    return true;
+}
+
+/**
+ * @brief Interpreta el valor de --protocolo
+ * @param texto "texto" o "binario"
+ * @param binario Destino: true si se aceptan tramas binarias
+ * @return false si el protocolo no existe
+ */
+static bool leerProtocolo(const char* texto, bool& binario) {
+    if (strcmp(texto, "texto") == 0) {
+        binario = false;
+    } else if (strcmp(texto, "binario") == 0) {
+        binario = true;
+    } else {
+        return false;
+    }
+    return true;
+}
 
 /**
  * @brief Función principal que simula el caso de estudio completo
+ * @details Con "--ingesta <fuente> [--hilos n] [--fragmentos n] [--restaurar archivo] [--guardar archivo]
+ * [--segmentos directorio] [--metricas archivo.prom] [--reglas archivo]
+ * [--protocolo texto|binario] [--retencion n [--edad-maxima ms] [--diezmado f]] [--resumenes ms]
+ * [--cola capacidad]" consume en su lugar el flujo del simulador ESP32 (con
+ * "-" como fuente solo se restaura/guarda). --resumenes muestra al terminar los agregados de
+ * los últimos ms; --cola registra a través de las colas de los sensores restaurados. Con "--servidor <puerto|-> [--fuente ruta]... [--hilos n] [--fragmentos n]
+ * [--segmentos directorio] [--metricas archivo.prom] [--periodo-temperatura ms] [--periodo-presion ms]
+ * [--protocolo texto|binario]" atiende en un bucle epoll las
+ * conexiones TCP a 127.0.0.1:puerto y las fuentes indicadas. Una opción desconocida, sin valor
+ * o con un valor inválido muestra el uso y termina con 1
  * @return 0 si la ejecución fue exitosa
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "--ingesta") == 0) {
+        OpcionesIngesta opciones;
+        opciones.fuente = argv[2];
+        opciones.hilos = 1;
+        opciones.fragmentos = 1;
+        opciones.restaurar = nullptr;
+        opciones.guardar = nullptr;
+        opciones.segmentos = nullptr;
+        opciones.metricas = nullptr;
+        opciones.reglas = nullptr;
+        opciones.binario = false;
+        opciones.retencion = 0;
+        opciones.edadMaxima = 0;
+        opciones.diezmado = 1;
+        opciones.resumenes = 0;
+        opciones.cola = 0;
+        for (int i = 3; i < argc; i += 2) {
+            bool valido = i + 1 < argc;
+            if (!valido) {
+                // Opción final sin valor
+            } else if (strcmp(argv[i], "--hilos") == 0) {
+                valido = leerEntero(argv[i + 1], 0, 1024, opciones.hilos);
+            } else if (strcmp(argv[i], "--fragmentos") == 0) {
+                valido = leerEntero(argv[i + 1], 0, 1024, opciones.fragmentos);
+            } else if (strcmp(argv[i], "--restaurar") == 0) {
+                opciones.restaurar = argv[i + 1];
+            } else if (strcmp(argv[i], "--guardar") == 0) {
+                opciones.guardar = argv[i + 1];
+            } else if (strcmp(argv[i], "--segmentos") == 0) {
+                opciones.segmentos = argv[i + 1];
+            } else if (strcmp(argv[i], "--metricas") == 0) {
+                opciones.metricas = argv[i + 1];
+            } else if (strcmp(argv[i], "--reglas") == 0) {
+                opciones.reglas = argv[i + 1];
+            } else if (strcmp(argv[i], "--protocolo") == 0) {
+                valido = leerProtocolo(argv[i + 1], opciones.binario);
+            } else if (strcmp(argv[i], "--retencion") == 0) {
+                valido = leerEntero(argv[i + 1], 1, 100000000, opciones.retencion);
+            } else if (strcmp(argv[i], "--edad-maxima") == 0) {
+                valido = leerEntero(argv[i + 1], 0, 86400000, opciones.edadMaxima);
+            } else if (strcmp(argv[i], "--diezmado") == 0) {
+                valido = leerEntero(argv[i + 1], 1, 1024, opciones.diezmado);
+            } else if (strcmp(argv[i], "--resumenes") == 0) {
+                valido = leerEntero(argv[i + 1], 1, 86400000, opciones.resumenes);
+            } else if (strcmp(argv[i], "--cola") == 0) {
+                valido = leerEntero(argv[i + 1], 1, 16777216, opciones.cola);
+            } else {
+                valido = false;
+            }
+            if (!valido) {
+                mostrarUso(argv[0]);
+                return 1;
+            }
+        }
+        return ejecutarIngesta(opciones);
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "--servidor") == 0) {
+        OpcionesServidor opciones;
+        opciones.puerto = -1;
+        if (strcmp(argv[2], "-") != 0 && !leerEntero(argv[2], 0, 65535, opciones.puerto)) {
+            mostrarUso(argv[0]);
+            return 1;
+        }
+        opciones.hilos = 1;
+        opciones.fragmentos = 1;
+        opciones.segmentos = nullptr;
+        opciones.metricas = nullptr;
+        opciones.periodoTemperatura = 0;
+        opciones.periodoPresion = 0;
+        opciones.binario = false;
+        for (int i = 3; i < argc; i += 2) {
+            bool valido = i + 1 < argc;
+            if (!valido) {
+                // Opción final sin valor
+            } else if (strcmp(argv[i], "--fuente") == 0) {
+                opciones.fuentes.push_back(argv[i + 1]);
+            } else if (strcmp(argv[i], "--hilos") == 0) {
+                valido = leerEntero(argv[i + 1], 0, 1024, opciones.hilos);
+            } else if (strcmp(argv[i], "--fragmentos") == 0) {
+                valido = leerEntero(argv[i + 1], 0, 1024, opciones.fragmentos);
+            } else if (strcmp(argv[i], "--segmentos") == 0) {
+                opciones.segmentos = argv[i + 1];
+            } else if (strcmp(argv[i], "--metricas") == 0) {
+                opciones.metricas = argv[i + 1];
+            } else if (strcmp(argv[i], "--periodo-temperatura") == 0) {
+                valido = leerEntero(argv[i + 1], 0, 86400000, opciones.periodoTemperatura);
+            } else if (strcmp(argv[i], "--periodo-presion") == 0) {
+                valido = leerEntero(argv[i + 1], 0, 86400000, opciones.periodoPresion);
+            } else if (strcmp(argv[i], "--protocolo") == 0) {
+                valido = leerProtocolo(argv[i + 1], opciones.binario);
+            } else {
+                valido = false;
+            }
+            if (!valido) {
+                mostrarUso(argv[0]);
+                return 1;
+            }
+        }
+        return ejecutarServidor(opciones);
+    }
+
+    if (argc > 1) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+    
     std::cout << "\n╔═══════════════════════════════════════════════════════╗\n";
     std::cout << "║  Sistema de Gestión Polimórfica de Sensores para IoT ║\n";
     std::cout << "╚═══════════════════════════════════════════════════════╝\n";
@@ -25,11 +615,11 @@ int main() {
     std::cout << "\n--- Opción 1: Crear Sensores ---\n";
     
     // Sensor de Temperatura (maneja float)
-    SensorTemperatura* sensorTemp = new SensorTemperatura("T-001");
+    SensorTemperatura* sensorTemp = new SensorTemperatura("T-001", sistema.obtenerArena());
     sistema.agregarSensor(sensorTemp);
     
     // Sensor de Presión (maneja int)
-    SensorPresion* sensorPres = new SensorPresion("P-105");
+    SensorPresion* sensorPres = new SensorPresion("P-105", sistema.obtenerArena());
     sistema.agregarSensor(sensorPres);
     
     // ========== OPCIÓN 2: Registrar Lecturas ==========